@@ -6,6 +6,8 @@
 #include <QApplication>
 #include <QProcess>
 #include <QDebug>
+#include <algorithm>
+#include <iterator>
 
 AIDebugWidget::AIDebugWidget(GameManager* gameManager, QWidget* parent)
     : QWidget(parent)
@@ -20,6 +22,11 @@ AIDebugWidget::AIDebugWidget(GameManager* gameManager, QWidget* parent)
     connect(m_refreshTimer, &QTimer::timeout, this, &AIDebugWidget::onRefreshTimer);
     m_refreshTimer->start();
     
+    // 游戏事件按帧整批到达，这里只累加计数
+    if (m_gameManager) {
+        connect(m_gameManager, &GameManager::tickEvents, this, &AIDebugWidget::onTickEvents);
+    }
+    
     setWindowTitle("🤖 AI调试控制台 - 智能分析面板");
     setMinimumSize(900, 700);
     resize(1000, 800);
@@ -208,9 +215,51 @@ void AIDebugWidget::setupPerformancePanel() {
     memLayout->addWidget(m_memoryLabel);
     memLayout->addWidget(m_memoryUsageBar);
     
+    // 每秒游戏事件数
+    m_eventLabel = new QLabel("⚡ 事件/秒: 吞噬 0 | 分裂 0 | 合并 0 | 喷射 0 | 移除 0", m_performanceGroup);
+    m_eventLabel->setStyleSheet("font-weight: bold; color: #81c784;");
+    
+    // 分阶段耗时：每行一个阶段，最后一行是整帧
+    m_backendLabel = new QLabel("🧱 碰撞后端: -", m_performanceGroup);
+    m_backendLabel->setStyleSheet("color: #b0bec5;");
+    m_backendLabel->setWordWrap(true);
+    
+    m_phaseTable = new QTableWidget(FrameProfiler::PhaseCount + 1, 4, m_performanceGroup);
+    m_phaseTable->setHorizontalHeaderLabels({"⏱️ 阶段", "p50 (ms)", "p99 (ms)", "max (ms)"});
+    m_phaseTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_phaseTable->verticalHeader()->setVisible(false);
+    m_phaseTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_phaseTable->setAlternatingRowColors(true);
+    m_phaseTable->horizontalHeader()->setStyleSheet(
+        "QHeaderView::section { "
+        "background-color: #3a3a3a; "
+        "color: #ffffff; "
+        "font-weight: bold; "
+        "border: 1px solid #555; "
+        "padding: 4px; "
+        "}"
+    );
+    for (int row = 0; row <= FrameProfiler::PhaseCount; ++row) {
+        const QString name = row < FrameProfiler::PhaseCount
+            ? QString::fromUtf8(FrameProfiler::phaseName(static_cast<FrameProfiler::Phase>(row)))
+            : QString("整帧");
+        m_phaseTable->setItem(row, 0, new QTableWidgetItem(name));
+        for (int column = 1; column < 4; ++column) {
+            m_phaseTable->setItem(row, column, new QTableWidgetItem("-"));
+        }
+    }
+    
+    m_hitchLabel = new QLabel("🐢 超预算帧: 0", m_performanceGroup);
+    m_hitchLabel->setStyleSheet("font-weight: bold; color: #e57373;");
+    m_hitchLabel->setWordWrap(true);
+    
     layout->addLayout(fpsLayout);
     layout->addLayout(cpuLayout);
     layout->addLayout(memLayout);
+    layout->addWidget(m_eventLabel);
+    layout->addWidget(m_backendLabel);
+    layout->addWidget(m_phaseTable);
+    layout->addWidget(m_hitchLabel);
 }
 
 void AIDebugWidget::setupDecisionPanel() {
@@ -436,8 +485,8 @@ void AIDebugWidget::updateAIStatus() {
             QString scoreInfo = QString("分数: %1").arg(QString::number(ball->score(), 'f', 0));
             QString radiusInfo = QString("半径: %1").arg(QString::number(ball->radius(), 'f', 1));
             QString posInfo = QString("位置: (%1,%2)")
-                             .arg(QString::number(ball->pos().x(), 'f', 0))
-                             .arg(QString::number(ball->pos().y(), 'f', 0));
+                             .arg(QString::number(ball->position().x(), 'f', 0))
+                             .arg(QString::number(ball->position().y(), 'f', 0));
             
             QString itemText = QString("%1 【%2】 (%3) | %4 | %5 | %6")
                               .arg(aiName, status, strategy, scoreInfo, radiusInfo, posInfo);
@@ -636,8 +685,20 @@ void AIDebugWidget::onRefreshTimer() {
         m_memoryLabel->setText(QString("💾 内存: %1MB").arg(m_perfStats.memoryUsage, 0, 'f', 1));
         m_memoryUsageBar->setValue(static_cast<int>(m_perfStats.memoryUsage));
         
+        int* counts = m_perfStats.eventCounts;
+        const double perSecond = 1000.0 / elapsed;
+        m_eventLabel->setText(QString("⚡ 事件/秒: 吞噬 %1 | 分裂 %2 | 合并 %3 | 喷射 %4 | 移除 %5")
+                              .arg(qRound(counts[GameEvent::EAT] * perSecond))
+                              .arg(qRound(counts[GameEvent::SPLIT] * perSecond))
+                              .arg(qRound(counts[GameEvent::MERGE] * perSecond))
+                              .arg(qRound(counts[GameEvent::EJECT] * perSecond))
+                              .arg(qRound(counts[GameEvent::REMOVED] * perSecond)));
+        
         // 重置计数器
         m_perfStats.actionCount = 0;
+        std::fill(std::begin(m_perfStats.eventCounts), std::end(m_perfStats.eventCounts), 0);
+        
+        updateProfilerStats();
     }
     
     // 每10帧更新一次AI状态（降低更新频率）
@@ -649,6 +710,65 @@ void AIDebugWidget::onRefreshTimer() {
     }
 }
 
+void AIDebugWidget::onTickEvents(const QVector<GameEvent>& events) {
+    for (const GameEvent& event : events) {
+        m_perfStats.eventCounts[event.type]++;
+    }
+}
+
+void AIDebugWidget::updateProfilerStats() {
+    if (!m_gameManager) return;
+    
+    const FrameProfiler* profiler = m_gameManager->profiler();
+    m_backendLabel->setText(QString("🧱 碰撞后端: %1").arg(m_gameManager->collisionBackendInfo()));
+    
+    for (int row = 0; row <= FrameProfiler::PhaseCount; ++row) {
+        const FrameProfiler::PhaseStats stats = row < FrameProfiler::PhaseCount
+            ? profiler->phaseStats(static_cast<FrameProfiler::Phase>(row))
+            : profiler->tickStats();
+        m_phaseTable->item(row, 1)->setText(QString::number(stats.p50Ms, 'f', 3));
+        m_phaseTable->item(row, 2)->setText(QString::number(stats.p99Ms, 'f', 3));
+        m_phaseTable->item(row, 3)->setText(QString::number(stats.maxMs, 'f', 3));
+    }
+    
+    // 新的超预算帧：完整的分阶段耗时和实体数写进日志，标签只显示最近一次
+    const QVector<FrameProfiler::Hitch>& hitches = profiler->hitches();
+    const qint64 hitchCount = profiler->hitchCount();
+    if (hitchCount < m_lastHitchCount) {
+        m_lastHitchCount = 0; // 游戏重置后计数从头开始
+    }
+    const int newHitches = static_cast<int>(qMin<qint64>(hitchCount - m_lastHitchCount, hitches.size()));
+    for (int i = hitches.size() - newHitches; i < hitches.size(); ++i) {
+        const FrameProfiler::Hitch& hitch = hitches[i];
+        QStringList phases;
+        for (int phase = 0; phase < FrameProfiler::PhaseCount; ++phase) {
+            if (phase != FrameProfiler::Paint && hitch.phaseMs[phase] > 0.0) {
+                phases << QString("%1 %2").arg(QString::fromUtf8(FrameProfiler::phaseName(static_cast<FrameProfiler::Phase>(phase))))
+                                          .arg(hitch.phaseMs[phase], 0, 'f', 2);
+            }
+        }
+        addLogEntry(QString("帧 %1 耗时 %2ms（预算 %3ms）: %4 | 分身 %5 食物 %6 孢子 %7 荆棘 %8 AI %9")
+                        .arg(hitch.tick)
+                        .arg(hitch.totalMs, 0, 'f', 2)
+                        .arg(profiler->budgetMs(), 0, 'f', 2)
+                        .arg(phases.join(", "))
+                        .arg(hitch.counts.clones)
+                        .arg(hitch.counts.foods)
+                        .arg(hitch.counts.spores)
+                        .arg(hitch.counts.thorns)
+                        .arg(hitch.counts.aiPlayers), "WARNING");
+    }
+    m_lastHitchCount = hitchCount;
+    
+    if (!hitches.isEmpty()) {
+        const FrameProfiler::Hitch& last = hitches.last();
+        m_hitchLabel->setText(QString("🐢 超预算帧: %1（最近: 帧 %2, %3ms）")
+                              .arg(hitchCount).arg(last.tick).arg(last.totalMs, 0, 'f', 2));
+    } else {
+        m_hitchLabel->setText("🐢 超预算帧: 0");
+    }
+}
+
 void AIDebugWidget::onAIPlayerSelected() {
     QListWidgetItem* currentItem = m_aiPlayersList->currentItem();
     if (!currentItem) {
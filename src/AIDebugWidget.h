@@ -38,6 +38,7 @@ public slots:
     void onAIActionExecuted(const GoBigger::AI::AIAction& action);
     void onAIStrategyChanged(GoBigger::AI::SimpleAIPlayer::AIStrategy strategy);
     void refreshDebugInfo();
+    void onTickEvents(const QVector<GameEvent>& events); // 统计每秒的游戏事件数
 
 private slots:
     void onRefreshTimer();
@@ -49,6 +50,7 @@ private:
     void setupPerformancePanel();
     void setupDecisionPanel();
     void setupLogPanel();
+    void updateProfilerStats(); // 刷新分阶段耗时表，并把新出现的超预算帧写进日志
     
     // UI组件
     QVBoxLayout* m_mainLayout;
@@ -69,6 +71,12 @@ private:
     QLabel* m_fpsLabel;
     QLabel* m_cpuLabel;
     QLabel* m_memoryLabel;
+    QLabel* m_eventLabel;
+    // 分阶段耗时（FrameProfiler的滚动p50/p99）
+    QLabel* m_backendLabel;
+    QTableWidget* m_phaseTable;
+    QLabel* m_hitchLabel;
+    qint64 m_lastHitchCount = 0;
     
     // AI决策信息面板
     QGroupBox* m_decisionGroup;
@@ -94,6 +102,8 @@ private:
         double memoryUsage = 0.0;
         int actionCount = 0;
         int decisionCount = 0;
+        // 游戏事件计数（按GameEvent::Type，每秒清零）
+        int eventCounts[GameEvent::REMOVED + 1] = {};
     } m_perfStats;
     
     // 日志管理
@@ -104,6 +104,7 @@ AIPlayer::AIPlayer(CloneBall* playerBall, QObject* parent)
     // 监听玩家球被销毁的信号
     if (m_playerBall) {
         connect(m_playerBall, &QObject::destroyed, this, &AIPlayer::onPlayerBallDestroyed);
+        connect(m_playerBall, &BaseBall::ballRecycled, this, &AIPlayer::onPlayerBallDestroyed);
     }
     
     qDebug() << "AIPlayer created for ball:" << (m_playerBall ? m_playerBall->ballId() : -1);
@@ -229,7 +230,7 @@ void AIPlayer::extractPlayerFeatures(std::vector<float>& observation) {
     int idx = 0;
     
     // 玩家位置 (归一化到[-1,1])
-    QPointF pos = m_playerBall->pos();
+    QPointF pos = m_playerBall->position();
     observation[idx++] = pos.x() / 400.0f; // 假设游戏区域是800x800
     observation[idx++] = pos.y() / 400.0f;
     
@@ -258,7 +259,7 @@ void AIPlayer::extractEnvironmentFeatures(std::vector<float>& observation) {
     int idx = 50; // 从第50维开始
     
     // 游戏边界距离
-    QPointF pos = m_playerBall->pos();
+    QPointF pos = m_playerBall->position();
     observation[idx++] = (400.0f - pos.x()) / 400.0f;  // 右边界距离
     observation[idx++] = (pos.x() + 400.0f) / 400.0f;  // 左边界距离
     observation[idx++] = (400.0f - pos.y()) / 400.0f;  // 下边界距离
@@ -294,7 +295,7 @@ void AIPlayer::extractNearbyBallsFeatures(std::vector<float>& observation) {
     const int MAX_NEARBY_BALLS = 100; // 最多考虑100个附近的球
     const float VIEW_RADIUS = 200.0f; // 视野半径
     
-    QPointF playerPos = m_playerBall->pos();
+    QPointF playerPos = m_playerBall->position();
     QGraphicsScene* scene = m_playerBall->scene();
     
     // 获取视野范围内的所有球体
@@ -308,7 +309,7 @@ void AIPlayer::extractNearbyBallsFeatures(std::vector<float>& observation) {
     for (auto item : nearbyItems) {
         BaseBall* ball = dynamic_cast<BaseBall*>(item);
         if (ball && ball != m_playerBall) {
-            QPointF ballPos = ball->pos();
+            QPointF ballPos = ball->position();
             float distance = QPointF(ballPos - playerPos).manhattanLength();
             if (distance <= VIEW_RADIUS) {
                 sortedBalls.push_back({distance, ball});
@@ -325,7 +326,7 @@ void AIPlayer::extractNearbyBallsFeatures(std::vector<float>& observation) {
         if (ballCount >= MAX_NEARBY_BALLS) break;
         
         BaseBall* ball = pair.second;
-        QPointF ballPos = ball->pos();
+        QPointF ballPos = ball->position();
         QPointF relativePos = ballPos - playerPos;
         
         // 每个球3个特征: 相对x, 相对y, 类型/大小
@@ -361,7 +362,7 @@ void AIPlayer::executeAction(const AIAction& action) {
     
     // 执行移动
     if (action.dx != 0.0f || action.dy != 0.0f) {
-        QPointF currentPos = m_playerBall->pos();
+        QPointF currentPos = m_playerBall->position();
         QPointF targetDirection(action.dx, action.dy);
         
         // 设置目标方向（CloneBall会处理实际的移动）
@@ -0,0 +1,18 @@
+#ifndef BALLHANDLE_H
+#define BALLHANDLE_H
+
+#include <QtGlobal>
+
+// 球在BallRegistry中的句柄：槽位下标 + 代数
+// 球被注销时槽位的代数加一，之前发出去的句柄随之失效（对象池复用后也不会指到新球上）
+struct BallHandle {
+    int index = -1;
+    quint32 generation = 0;
+
+    bool isNull() const { return index < 0; }
+
+    bool operator==(const BallHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const BallHandle& other) const { return !(*this == other); }
+};
+
+#endif // BALLHANDLE_H
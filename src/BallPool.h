@@ -0,0 +1,92 @@
+#ifndef BALLPOOL_H
+#define BALLPOOL_H
+
+#include <QVector>
+#include <QtGlobal>
+
+class FoodBall;
+class SporeBall;
+class CloneBall;
+
+// 球对象池
+// 被吃掉/过期的球不再deleteLater，而是retire()后放回池里，下次生成同类球时reset()复用，
+// 场景图元一直留在场景中（隐藏），省掉new/delete、addItem/removeItem和数据槽的反复分配。
+// 池里的球已经断开了所有信号、不在任何列表里，只有池持有它。
+template <typename T>
+class BallPool
+{
+public:
+    explicit BallPool(int capacity = 0) : m_capacity(capacity) {}
+    ~BallPool() { clear(); }
+
+    BallPool(const BallPool&) = delete;
+    BallPool& operator=(const BallPool&) = delete;
+
+    // 取出一个空闲的球，池空时返回nullptr（由调用方new一个新的）
+    T* acquire()
+    {
+        if (m_free.isEmpty()) {
+            m_misses++;
+            return nullptr;
+        }
+        m_hits++;
+        return m_free.takeLast();
+    }
+
+    // 放回池中；池满时返回false，由调用方自行释放
+    bool release(T* ball)
+    {
+        if (!ball || m_free.size() >= m_capacity) {
+            return false;
+        }
+        m_free.append(ball);
+        return true;
+    }
+
+    // 直接释放池中所有的球（它们不再被任何地方引用）
+    void clear()
+    {
+        for (T* ball : m_free) {
+            delete ball;
+        }
+        m_free.clear();
+    }
+
+    int size() const { return m_free.size(); }
+    int capacity() const { return m_capacity; }
+    void setCapacity(int capacity) { m_capacity = qMax(0, capacity); }
+
+    // 复用统计：命中 = 从池里取到，未命中 = 需要新建
+    qint64 hits() const { return m_hits; }
+    qint64 misses() const { return m_misses; }
+
+private:
+    QVector<T*> m_free;
+    int m_capacity;
+    qint64 m_hits = 0;
+    qint64 m_misses = 0;
+};
+
+// 按类型分开的对象池，由GameManager持有，CloneBall通过Config里的指针生成分身和孢子
+// 荆棘球数量少、几乎不重生，不做池化
+struct BallPools {
+    BallPool<FoodBall> foods;
+    BallPool<SporeBall> spores;
+    BallPool<CloneBall> clones;
+
+    void setCapacity(int capacity)
+    {
+        foods.setCapacity(capacity);
+        spores.setCapacity(capacity);
+        clones.setCapacity(capacity);
+    }
+
+    void clear()
+    {
+        foods.clear();
+        spores.clear();
+        clones.clear();
+    }
+};
+
+#endif // BALLPOOL_H
@@ -0,0 +1,216 @@
+#include "BallRegistry.h"
+#include "core/data/MortonOrder.h"
+#include <algorithm>
+
+BallHandle BallRegistry::add(BaseBall* ball)
+{
+    if (!ball) {
+        return BallHandle();
+    }
+
+    if (contains(ball)) {
+        return ball->handle();
+    }
+
+    // 分配槽位：优先复用空闲槽位（代数在注销时已经加过）
+    int slotIndex;
+    if (!m_freeSlots.isEmpty()) {
+        slotIndex = m_freeSlots.takeLast();
+    } else {
+        slotIndex = m_slots.size();
+        m_slots.append(Slot());
+    }
+
+    // 在数组末尾开一个空位，把后面每一段的第一个球挪到该段末尾，空位逐段前移到目标段的末尾
+    const int type = ball->ballType();
+    m_dense.append(nullptr);
+    int hole = m_dense.size() - 1;
+    for (int t = TYPE_COUNT - 1; t > type; --t) {
+        const int first = rangeBegin(t);
+        if (first != hole) {
+            moveDense(first, hole);
+        }
+        hole = first;
+        m_rangeEnds[t]++;
+    }
+    m_rangeEnds[type]++;
+
+    Slot& slot = m_slots[slotIndex];
+    slot.ball = ball;
+    slot.denseIndex = hole;
+    slot.pendingRemoval = false;
+    m_dense[hole] = ball;
+
+    BallHandle handle;
+    handle.index = slotIndex;
+    handle.generation = slot.generation;
+    ball->setHandle(handle);
+    return handle;
+}
+
+bool BallRegistry::remove(BaseBall* ball)
+{
+    if (!contains(ball)) {
+        return false;
+    }
+
+    const int slotIndex = ball->handle().index;
+    const int type = ball->ballType();
+
+    // 已登记待移除又被直接注销（很少见），从待移除列表里撤掉
+    if (m_slots[slotIndex].pendingRemoval) {
+        m_pending.removeOne(ball);
+    }
+
+    // 本段最后一个球填进空位，空位再逐段后移到数组末尾
+    // （所以段内顺序不是插入顺序，但只取决于增删和重排的历史，同样的操作序列得到同样的顺序）
+    int hole = m_slots[slotIndex].denseIndex;
+    const int last = rangeEnd(type) - 1;
+    if (last != hole) {
+        moveDense(last, hole);
+    }
+    hole = last;
+    m_rangeEnds[type]--;
+
+    for (int t = type + 1; t < TYPE_COUNT; ++t) {
+        const int lastOfRange = rangeEnd(t) - 1;
+        if (lastOfRange != hole) {
+            moveDense(lastOfRange, hole);
+        }
+        hole = lastOfRange;
+        m_rangeEnds[t]--;
+    }
+    m_dense.removeLast();
+
+    // 代数加一，旧句柄全部失效
+    Slot& slot = m_slots[slotIndex];
+    slot.ball = nullptr;
+    slot.generation++;
+    slot.denseIndex = -1;
+    slot.pendingRemoval = false;
+    m_freeSlots.append(slotIndex);
+
+    ball->setHandle(BallHandle());
+    return true;
+}
+
+BaseBall* BallRegistry::get(const BallHandle& handle) const
+{
+    if (handle.index < 0 || handle.index >= m_slots.size()) {
+        return nullptr;
+    }
+
+    const Slot& slot = m_slots[handle.index];
+    return slot.generation == handle.generation ? slot.ball : nullptr;
+}
+
+bool BallRegistry::contains(const BaseBall* ball) const
+{
+    return slotOf(ball) != nullptr;
+}
+
+void BallRegistry::markForRemoval(BaseBall* ball)
+{
+    if (!contains(ball)) {
+        return;
+    }
+
+    Slot& slot = m_slots[ball->handle().index];
+    if (!slot.pendingRemoval) {
+        slot.pendingRemoval = true;
+        m_pending.append(ball);
+    }
+}
+
+QVector<BaseBall*> BallRegistry::takePendingRemovals()
+{
+    QVector<BaseBall*> pending;
+    pending.swap(m_pending);
+    return pending;
+}
+
+void BallRegistry::clear()
+{
+    for (BaseBall* ball : m_dense) {
+        ball->setHandle(BallHandle());
+    }
+
+    // 槽位保留并推进代数，清空前发出的句柄同样失效
+    m_freeSlots.clear();
+    for (int i = m_slots.size() - 1; i >= 0; --i) {
+        Slot& slot = m_slots[i];
+        if (slot.ball) {
+            slot.ball = nullptr;
+            slot.generation++;
+        }
+        slot.denseIndex = -1;
+        slot.pendingRemoval = false;
+        m_freeSlots.append(i);
+    }
+
+    m_dense.clear();
+    m_pending.clear();
+    for (int& end : m_rangeEnds) {
+        end = 0;
+    }
+}
+
+void BallRegistry::reserve(int count)
+{
+    m_dense.reserve(count);
+    m_slots.reserve(count);
+}
+
+void BallRegistry::sortRangeByMorton(BaseBall::BallType type, float minx, float miny, float maxx, float maxy)
+{
+    const int begin = rangeBegin(type);
+    const int end = rangeEnd(type);
+    if (end - begin < 2) {
+        return;
+    }
+
+    // 键的高32位是Morton码，低32位是球ID，同一格子里的球也有确定的先后
+    m_sortScratch.resize(end - begin);
+    bool sorted = true;
+    for (int i = begin; i < end; ++i) {
+        BaseBall* ball = m_dense[i];
+        const QPointF position = ball->position();
+        const quint64 key = (static_cast<quint64>(MortonOrder::encode(position.x(), position.y(), minx, miny, maxx, maxy)) << 32)
+                          | static_cast<quint32>(ball->ballId());
+        m_sortScratch[i - begin] = qMakePair(key, ball);
+        sorted = sorted && (i == begin || m_sortScratch[i - begin - 1].first <= key);
+    }
+    if (sorted) {
+        return;
+    }
+
+    std::sort(m_sortScratch.begin(), m_sortScratch.end(),
+              [](const QPair<quint64, BaseBall*>& a, const QPair<quint64, BaseBall*>& b) { return a.first < b.first; });
+    for (int i = begin; i < end; ++i) {
+        BaseBall* ball = m_sortScratch[i - begin].second;
+        m_dense[i] = ball;
+        m_slots[ball->handle().index].denseIndex = i;
+    }
+}
+
+void BallRegistry::moveDense(int from, int to)
+{
+    BaseBall* ball = m_dense[from];
+    m_dense[to] = ball;
+    m_slots[ball->handle().index].denseIndex = to;
+}
+
+const BallRegistry::Slot* BallRegistry::slotOf(const BaseBall* ball) const
+{
+    if (!ball) {
+        return nullptr;
+    }
+
+    const BallHandle& handle = ball->handle();
+    if (handle.index < 0 || handle.index >= m_slots.size()) {
+        return nullptr;
+    }
+
+    const Slot& slot = m_slots[handle.index];
+    return (slot.ball == ball && slot.generation == handle.generation) ? &slot : nullptr;
+}
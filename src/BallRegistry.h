@@ -0,0 +1,130 @@
+#ifndef BALLREGISTRY_H
+#define BALLREGISTRY_H
+
+#include <QPair>
+#include <QVector>
+#include "BaseBall.h"
+#include "BallHandle.h"
+
+class CloneBall;
+class FoodBall;
+class SporeBall;
+class ThornsBall;
+
+// 注册表中一段连续球指针的只读视图，遍历时转换成具体类型
+// 注册表增删球之后视图失效，需要重新获取
+template <typename T>
+class BallRange
+{
+public:
+    class const_iterator
+    {
+    public:
+        explicit const_iterator(BaseBall* const* p) : m_p(p) {}
+        T* operator*() const { return static_cast<T*>(*m_p); }
+        const_iterator& operator++() { ++m_p; return *this; }
+        bool operator==(const const_iterator& other) const { return m_p == other.m_p; }
+        bool operator!=(const const_iterator& other) const { return m_p != other.m_p; }
+
+    private:
+        BaseBall* const* m_p;
+    };
+
+    BallRange(BaseBall* const* begin, BaseBall* const* end) : m_begin(begin), m_end(end) {}
+
+    const_iterator begin() const { return const_iterator(m_begin); }
+    const_iterator end() const { return const_iterator(m_end); }
+    int size() const { return static_cast<int>(m_end - m_begin); }
+    bool isEmpty() const { return m_begin == m_end; }
+    T* operator[](int i) const { return static_cast<T*>(m_begin[i]); }
+
+    // 需要在遍历过程中增删球时，先拷贝一份
+    QVector<T*> toVector() const
+    {
+        QVector<T*> result;
+        result.reserve(size());
+        for (BaseBall* const* p = m_begin; p != m_end; ++p) {
+            result.append(static_cast<T*>(*p));
+        }
+        return result;
+    }
+
+private:
+    BaseBall* const* m_begin;
+    BaseBall* const* m_end;
+};
+
+// 稠密球注册表，取代 QHash<int, BaseBall*> + 每种类型一个QVector
+// 所有球的指针放在一个稠密数组里，按类型分成连续的几段（分身、食物、孢子、荆棘），
+// 增删只需要在段边界上交换，代价与类型数有关、与球数无关；句柄通过槽位表O(1)定位。
+// 被吃掉/过期的球先登记到待移除列表，由GameManager在帧末统一注销，
+// 所以一帧之内稠密数组只会追加、不会搬动已有的球（sortRangeByMorton只在帧末数据重排时调用）。
+class BallRegistry
+{
+public:
+    static constexpr int TYPE_COUNT = 4; // 与BaseBall::BallType一一对应
+
+    // 注册球，返回句柄（同时写回ball->handle()）；已注册的球直接返回原句柄
+    BallHandle add(BaseBall* ball);
+
+    // 立即注销，句柄失效；返回球是否在注册表中
+    bool remove(BaseBall* ball);
+
+    // 根据句柄取球，句柄已失效时返回nullptr
+    BaseBall* get(const BallHandle& handle) const;
+    bool contains(const BaseBall* ball) const;
+
+    // 待移除列表：同一个球只登记一次
+    void markForRemoval(BaseBall* ball);
+    bool hasPendingRemovals() const { return !m_pending.isEmpty(); }
+    // 取出并清空待移除列表（交换出来，不拷贝）
+    QVector<BaseBall*> takePendingRemovals();
+
+    void clear();
+
+    // 批量注册前预留容量（总数），避免逐个追加时反复扩容
+    void reserve(int count);
+
+    // 把一种球的段按位置的Morton码重排（同码按球ID），遍历顺序跟上数据存储的Z序；
+    // 只取决于球的位置和ID，与数据存储的内部布局无关，fork出来的世界排出同样的顺序。已经有序时直接返回
+    void sortRangeByMorton(BaseBall::BallType type, float minx, float miny, float maxx, float maxy);
+
+    // 遍历：全部球，或某一类型的连续段
+    const QVector<BaseBall*>& all() const { return m_dense; }
+    int size() const { return m_dense.size(); }
+    int count(BaseBall::BallType type) const { return rangeEnd(type) - rangeBegin(type); }
+
+    template <typename T>
+    BallRange<T> range(BaseBall::BallType type) const
+    {
+        BaseBall* const* data = m_dense.constData();
+        return BallRange<T>(data + rangeBegin(type), data + rangeEnd(type));
+    }
+
+    BallRange<CloneBall> clones() const { return range<CloneBall>(BaseBall::CLONE_BALL); }
+    BallRange<FoodBall> foods() const { return range<FoodBall>(BaseBall::FOOD_BALL); }
+    BallRange<SporeBall> spores() const { return range<SporeBall>(BaseBall::SPORE_BALL); }
+    BallRange<ThornsBall> thorns() const { return range<ThornsBall>(BaseBall::THORNS_BALL); }
+
+private:
+    struct Slot {
+        BaseBall* ball = nullptr;
+        quint32 generation = 0;
+        int denseIndex = -1;
+        bool pendingRemoval = false;
+    };
+
+    QVector<BaseBall*> m_dense;     // 按类型分段的球指针
+    int m_rangeEnds[TYPE_COUNT] = {}; // 每段的结束位置（下一段的开始）
+    QVector<Slot> m_slots;
+    QVector<int> m_freeSlots;
+    QVector<BaseBall*> m_pending;
+    QVector<QPair<quint64, BaseBall*>> m_sortScratch; // sortRangeByMorton复用的缓冲区
+
+    int rangeBegin(int type) const { return type == 0 ? 0 : m_rangeEnds[type - 1]; }
+    int rangeEnd(int type) const { return m_rangeEnds[type]; }
+    void moveDense(int from, int to);
+    const Slot* slotOf(const BaseBall* ball) const;
+};
+
+#endif // BALLREGISTRY_H
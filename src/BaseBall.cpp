@@ -1,29 +1,68 @@
 #include "BaseBall.h"
 #include "GoBiggerConfig.h"
-#include <QDebug>
+#include "core/Trace.h"
 #include <QGraphicsScene>
 #include <cmath>
 
-BaseBall::BaseBall(int ballId, const QPointF& position, float score, const Border& border, BallType type, QGraphicsItem* parent)
+BaseBall::BaseBall(int ballId, const QPointF& position, float score, const Border& border, BallType type,
+                   const BallDataSlot& slot, std::shared_ptr<BallDataStorage> storage, QGraphicsItem* parent)
     : QGraphicsObject(parent)
-    , m_ballId(ballId)
-    , m_score(score)
-    , m_ballType(type)
+    , m_data(slot.data)
+    , m_dataStore(slot.store)
+    , m_storage(std::move(storage))
     , m_border(border)
-    , m_isRemoved(false)
-    , m_velocity(0, 0)
-    , m_acceleration(0, 0)
+    , m_renderedRadius(0.0f)
+    , m_events(nullptr)
 {
+    m_dataStore->bind(m_data, &m_data);
+    
+    m_data->ballId = ballId;
+    m_data->type = type;
+    m_data->score = score;
+    m_data->x = position.x();
+    m_data->y = position.y();
+    resetSweepOrigin();
+    storePreviousPosition();
     updateRadius();
+    
+    m_renderedRadius = m_data->radius;
     setPos(position);
     setFlags(QGraphicsItem::ItemIsMovable | QGraphicsItem::ItemIsSelectable);
 }
 
+BaseBall::~BaseBall()
+{
+    // 先离开场景（场景可能还会查询boundingRect），再归还数据
+    if (scene()) {
+        scene()->removeItem(this);
+    }
+    m_dataStore->release(m_data);
+    m_data = nullptr;
+}
+
 QRectF BaseBall::boundingRect() const
 {
+    // 使用已同步的半径，保证与prepareGeometryChange配对
     qreal margin = 2.0;
-    return QRectF(-m_radius - margin, -m_radius - margin, 
-                  2 * (m_radius + margin), 2 * (m_radius + margin));
+    return QRectF(-m_renderedRadius - margin, -m_renderedRadius - margin, 
+                  2 * (m_renderedRadius + margin), 2 * (m_renderedRadius + margin));
+}
+
+void BaseBall::syncGraphics(qreal alpha)
+{
+    if (m_renderedRadius != m_data->radius) {
+        prepareGeometryChange();
+        m_renderedRadius = m_data->radius;
+    }
+    
+    QPointF renderPos = position();
+    if (alpha < 1.0) {
+        const QPointF previous(m_data->prevX, m_data->prevY);
+        renderPos = previous + (renderPos - previous) * alpha;
+    }
+    if (pos() != renderPos) {
+        setPos(renderPos);
+    }
 }
 
 void BaseBall::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
@@ -34,24 +73,38 @@ void BaseBall::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
     painter->setRenderHint(QPainter::Antialiasing);
     painter->setBrush(QBrush(getBallColor()));
     painter->setPen(QPen(getBallColor().darker(120), 2));
-    painter->drawEllipse(QRectF(-m_radius, -m_radius, 2 * m_radius, 2 * m_radius));
+    const qreal r = radius();
+    painter->drawEllipse(QRectF(-r, -r, 2 * r, 2 * r));
 }
 
 void BaseBall::setScore(float score)
 {
-    if (score != m_score) {
-        m_score = std::max(100.0f, score); // 最小分数为100，对齐GoBigger标准
+    if (score != m_data->score) {
+        m_data->score = std::max(100.0f, score); // 最小分数为100，对齐GoBigger标准
         updateRadius();
-        emit scoreChanged(m_score);
+        GB_TRACE(Score, Debug, "setScore id/score/radius", m_data->ballId, m_data->score, m_data->radius);
         
-        qDebug() << "Ball" << m_ballId << "score updated to" << m_score 
-                 << "radius:" << m_radius;
+        if (m_events) {
+            // scoreChanged留到帧末commitScore()统一发
+            m_data->scoreDirty = true;
+        } else {
+            emit scoreChanged(m_data->score);
+        }
+    }
+}
+
+void BaseBall::commitScore()
+{
+    if (m_data->scoreDirty) {
+        m_data->scoreDirty = false;
+        updateRadius();
+        emit scoreChanged(m_data->score);
     }
 }
 
 void BaseBall::updateRadius()
 {
-    m_radius = GoBiggerConfig::scoreToRadius(m_score);
+    m_data->radius = GoBiggerConfig::scoreToRadius(m_data->score);
 }
 
 void BaseBall::move(const QVector2D& direction, qreal duration)
@@ -59,16 +112,16 @@ void BaseBall::move(const QVector2D& direction, qreal duration)
     // 基础移动实现 - 更丝滑的移动
     if (direction.length() > 0.01) {
         // 使用GoBigger标准速度计算，但更平滑
-        float maxSpeed = GoBiggerConfig::BASE_SPEED / std::sqrt(m_score / GoBiggerConfig::CELL_MIN_SCORE);
+        float maxSpeed = GoBiggerConfig::BASE_SPEED / std::sqrt(m_data->score / GoBiggerConfig::CELL_MIN_SCORE);
         
         // 更平滑的加速度控制
         QVector2D targetVelocity = direction.normalized() * maxSpeed;
-        QVector2D accel = (targetVelocity - m_velocity) * GoBiggerConfig::ACCELERATION_FACTOR; // 降低加速度
+        QVector2D accel = (targetVelocity - velocity()) * GoBiggerConfig::ACCELERATION_FACTOR; // 降低加速度
         
         setAcceleration(accel);
     } else {
         // 没有输入时应用更平滑的阻力
-        setAcceleration(-m_velocity * 1.5f);
+        setAcceleration(-velocity() * 1.5f);
     }
     
     updatePhysics(duration);
@@ -76,16 +129,20 @@ void BaseBall::move(const QVector2D& direction, qreal duration)
 
 void BaseBall::updatePhysics(qreal deltaTime)
 {
+    BaseBallData& d = *m_data;
+    
     // 更新速度
-    m_velocity += m_acceleration * deltaTime;
+    d.vx += d.ax * deltaTime;
+    d.vy += d.ay * deltaTime;
     
     // 应用更平滑的阻力
-    m_velocity *= 0.99f; // 更轻的阻力，让移动更丝滑
+    d.vx *= 0.99f; // 更轻的阻力，让移动更丝滑
+    d.vy *= 0.99f;
     
     // 应用移动
-    if (m_velocity.length() > 0.01) {
-        QPointF displacement(m_velocity.x() * deltaTime, m_velocity.y() * deltaTime);
-        setPos(pos() + displacement);
+    if (d.vx * d.vx + d.vy * d.vy > 0.0001f) {
+        d.x += d.vx * deltaTime;
+        d.y += d.vy * deltaTime;
         checkBorder();
     }
 }
@@ -97,13 +154,10 @@ bool BaseBall::canEat(BaseBall* other) const
     }
     
     // 使用GoBigger标准吞噬比例
-    bool canEatResult = m_score >= other->score() * GoBiggerConfig::EAT_RATIO;
+    bool canEatResult = m_data->score >= other->score() * GoBiggerConfig::EAT_RATIO;
     
-    qDebug() << "canEat check: eater score=" << m_score 
-             << "target score=" << other->score() 
-             << "ratio=" << (m_score / other->score())
-             << "threshold=" << GoBiggerConfig::EAT_RATIO
-             << "result=" << canEatResult;
+    GB_TRACE(Eat, Verbose, "canEat eater/target/ratio/result",
+             m_data->score, other->score(), m_data->score / other->score(), canEatResult);
     
     return canEatResult;
 }
@@ -115,13 +169,20 @@ void BaseBall::eat(BaseBall* other)
     }
     
     float gainedScore = other->score();
-    float newScore = m_score + gainedScore;
+    GB_TRACE(Eat, Debug, "eat eater/eaten/gained/total",
+             m_data->ballId, other->ballId(), gainedScore, m_data->score + gainedScore);
     
-    qDebug() << "Ball" << m_ballId << "eating ball" << other->ballId()
-             << "gained score:" << gainedScore 
-             << "new total score:" << newScore;
+    if (m_events) {
+        // 🔥 分数立即累加（本帧后续的canEat要用），半径一帧只在commitScore里算一次，
+        // 大球一帧吃几十个食物也只刷新一次半径、发一次scoreChanged
+        m_data->score += gainedScore;
+        m_data->scoreDirty = true;
+        other->remove();
+        m_events->record(GameEvent::EAT, this, other, gainedScore);
+        return;
+    }
     
-    setScore(newScore);
+    setScore(m_data->score + gainedScore);
     other->remove();
     
     emit ballEaten(this, other);
@@ -129,27 +190,70 @@ void BaseBall::eat(BaseBall* other)
 
 void BaseBall::remove()
 {
-    if (!m_isRemoved) {
-        m_isRemoved = true;
+    if (!m_data->removed) {
+        m_data->removed = true;
         
         // 🔥 停止所有移动和动画
         setVelocity(QVector2D(0, 0));
         
-        // 🔥 立即从场景中移除，防止"尸体"残留
-        if (scene()) {
-            scene()->removeItem(this);
-        }
-        
-        // 🔥 隐藏物体，确保不会被渲染
+        // 🔥 隐藏物体，确保不会被渲染；图元留在场景里，回收进对象池后可以直接复用
         setVisible(false);
         
-        // 🔥 发出信号让管理器清理引用
-        emit ballRemoved(this);
-        
-        qDebug() << "Ball" << m_ballId << "completely removed from scene and hidden";
+        // 🔥 通知管理器清理引用：受管的球记一条事件，帧末统一注销
+        if (m_events) {
+            m_events->record(GameEvent::REMOVED, this);
+        } else {
+            emit ballRemoved(this);
+        }
+        GB_TRACE(Ball, Debug, "remove id/type", m_data->ballId, m_data->type);
     }
 }
 
+void BaseBall::retire()
+{
+    // 先通知还持有指针的对象（AI等），再断开所有信号，复用后不会串到新球身上
+    emit ballRecycled(this);
+    disconnect(this, nullptr, nullptr, nullptr);
+    m_events = nullptr;
+    
+    m_data->removed = true;
+    m_data->scoreDirty = false;
+    setVelocity(QVector2D(0, 0));
+    setAcceleration(QVector2D(0, 0));
+    setVisible(false);
+}
+
+void BaseBall::reinitialize(int ballId, const QPointF& position, float score, BallType type)
+{
+    m_data->ballId = ballId;
+    m_data->type = type;
+    m_data->score = score;
+    m_data->x = position.x();
+    m_data->y = position.y();
+    m_data->removed = false;
+    resetSweepOrigin();
+    storePreviousPosition();
+    updateRadius();
+    
+    if (m_renderedRadius != m_data->radius) {
+        prepareGeometryChange();
+        m_renderedRadius = m_data->radius;
+    }
+    setPos(position);
+    setVisible(true);
+}
+
+void BaseBall::refreshProxy()
+{
+    if (m_renderedRadius != m_data->radius) {
+        prepareGeometryChange();
+        m_renderedRadius = m_data->radius;
+    }
+    setPos(position());
+    setVisible(!m_data->removed);
+    update();
+}
+
 bool BaseBall::collidesWith(BaseBall* other) const
 {
     if (!other || other == this || other->isRemoved() || this->isRemoved()) {
@@ -157,7 +261,7 @@ bool BaseBall::collidesWith(BaseBall* other) const
     }
     
     qreal distance = distanceTo(other);
-    qreal collisionDistance = (m_radius + other->radius()) * GoBiggerConfig::EAT_DISTANCE_RATIO;
+    qreal collisionDistance = (m_data->radius + other->radius()) * GoBiggerConfig::EAT_DISTANCE_RATIO;
     
     return distance <= collisionDistance;
 }
@@ -166,36 +270,10 @@ qreal BaseBall::distanceTo(BaseBall* other) const
 {
     if (!other) return 0.0;
     
-    QPointF diff = pos() - other->pos();
-    return std::sqrt(diff.x() * diff.x() + diff.y() * diff.y());
+    return m_data->distanceTo(other->data());
 }
 
 void BaseBall::checkBorder()
 {
-    QPointF currentPos = pos();
-    bool posChanged = false;
-    
-    if (currentPos.x() - m_radius < m_border.minx) {
-        currentPos.setX(m_border.minx + m_radius);
-        m_velocity.setX(0);
-        posChanged = true;
-    } else if (currentPos.x() + m_radius > m_border.maxx) {
-        currentPos.setX(m_border.maxx - m_radius);
-        m_velocity.setX(0);
-        posChanged = true;
-    }
-    
-    if (currentPos.y() - m_radius < m_border.miny) {
-        currentPos.setY(m_border.miny + m_radius);
-        m_velocity.setY(0);
-        posChanged = true;
-    } else if (currentPos.y() + m_radius > m_border.maxy) {
-        currentPos.setY(m_border.maxy - m_radius);
-        m_velocity.setY(0);
-        posChanged = true;
-    }
-    
-    if (posChanged) {
-        setPos(currentPos);
-    }
+    m_data->clampToBorder(m_border.minx, m_border.maxx, m_border.miny, m_border.maxy);
 }
@@ -9,7 +9,11 @@
 #include <QStyleOptionGraphicsItem>
 #include <QTimer>
 #include <cmath>
+#include <memory>
 #include "GoBiggerConfig.h"
+#include "BallHandle.h"
+#include "GameEvent.h"
+#include "core/data/BallDataStore.h"
 
 // 边界结构
 struct Border {
@@ -25,6 +29,8 @@ struct Border {
 };
 
 // 球的基础类
+// 物理状态全部存放在m_data指向的纯数据结构里（连续存储于BallDataStorage），
+// QGraphicsObject只作为渲染代理：syncGraphics()把数据同步到场景，paint()只读数据
 class BaseBall : public QGraphicsObject
 {
     Q_OBJECT
@@ -37,30 +43,62 @@ public:
         THORNS_BALL    // 荆棘球
     };
 
-    BaseBall(int ballId, const QPointF& position, float score, const Border& border, BallType type, QGraphicsItem* parent = nullptr);
+    BaseBall(int ballId, const QPointF& position, float score, const Border& border, BallType type,
+             const BallDataSlot& slot, std::shared_ptr<BallDataStorage> storage, QGraphicsItem* parent = nullptr);
     
-    virtual ~BaseBall() = default;
+    virtual ~BaseBall();
 
     // QGraphicsItem必须实现的函数
     QRectF boundingRect() const override;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
 
     // 基础属性访问
-    int ballId() const { return m_ballId; }
-    float score() const { return m_score; }
-    float radius() const { return m_radius; }
-    BallType ballType() const { return m_ballType; }
+    int ballId() const { return m_data->ballId; }
+    float score() const { return m_data->score; }
+    float radius() const { return m_data->radius; }
+    BallType ballType() const { return static_cast<BallType>(m_data->type); }
     const Border& border() const { return m_border; }
-    bool isRemoved() const { return m_isRemoved; }
+    bool isRemoved() const { return m_data->removed; }
     
-    // 位置和速度
-    QVector2D velocity() const { return m_velocity; }
-    QVector2D acceleration() const { return m_acceleration; }
+    // 纯数据访问
+    const BaseBallData& data() const { return *m_data; }
+    const std::shared_ptr<BallDataStorage>& dataStorage() const { return m_storage; }
+    unsigned int queryStamp() const { return m_data->queryStamp; }
+    void setQueryStamp(unsigned int stamp) { m_data->queryStamp = stamp; }
+    int queryOrder() const { return m_data->queryOrder; }
+    void setQueryOrder(int order) { m_data->queryOrder = order; }
+    
+    // 在BallRegistry中的句柄（未注册时为空），由注册表维护
+    const BallHandle& handle() const { return m_handle; }
+    void setHandle(const BallHandle& handle) { m_handle = handle; }
+    
+    // 帧事件缓冲区：受管的球把吞噬/移除等事件记进去，由GameManager帧末统一处理；
+    // 没有缓冲区的球（还没加入GameManager或已回收）照旧直接发信号
+    GameEventBuffer* eventBuffer() const { return m_events; }
+    void setEventBuffer(GameEventBuffer* events) { m_events = events; }
+    
+    // 位置和速度（逻辑位置，pos()只是渲染用的场景坐标）
+    QPointF position() const { return QPointF(m_data->x, m_data->y); }
+    QVector2D velocity() const { return QVector2D(m_data->vx, m_data->vy); }
+    QVector2D acceleration() const { return QVector2D(m_data->ax, m_data->ay); }
+    QPointF sweepOrigin() const { return QPointF(m_data->sweepX, m_data->sweepY); }
     
     // 设置属性
     void setScore(float score);
-    void setVelocity(const QVector2D& velocity) { m_velocity = velocity; }
-    void setAcceleration(const QVector2D& acceleration) { m_acceleration = acceleration; }
+    // 提交本帧累计的分数变化：刷新半径并发一次scoreChanged（没有变化时什么都不做）
+    void commitScore();
+    void setPosition(const QPointF& position) { m_data->x = position.x(); m_data->y = position.y(); }
+    void setVelocity(const QVector2D& velocity) { m_data->vx = velocity.x(); m_data->vy = velocity.y(); }
+    void setAcceleration(const QVector2D& acceleration) { m_data->ax = acceleration.x(); m_data->ay = acceleration.y(); }
+    void resetSweepOrigin() { m_data->sweepX = m_data->x; m_data->sweepY = m_data->y; }
+    void storePreviousPosition() { m_data->prevX = m_data->x; m_data->prevY = m_data->y; }
+    
+    // 渲染代理：把数据同步到QGraphicsItem（位置/几何）
+    // alpha是渲染时刻在上一逻辑帧和当前逻辑帧之间的位置，1表示直接使用当前逻辑位置
+    void syncGraphics(qreal alpha = 1.0);
+    
+    // 🔥 世界快照恢复：用快照里的一条记录（本类型的*BallData，按字节存放）整条覆盖自己的数据
+    virtual void restoreData(const char* record) = 0;
     
     // 核心功能
     virtual void move(const QVector2D& direction, qreal duration);
@@ -68,6 +106,9 @@ public:
     virtual void eat(BaseBall* other);
     virtual void remove();
     
+    // 🔥 对象池回收：通知持有者放手并断开所有信号，图元留在场景里保持隐藏，等待reset()复用
+    virtual void retire();
+    
     // 碰撞检测
     bool collidesWith(BaseBall* other) const;
     qreal distanceTo(BaseBall* other) const;
@@ -82,24 +123,29 @@ signals:
     void ballRemoved(BaseBall* ball);
     void ballEaten(BaseBall* eater, BaseBall* eaten);
     void scoreChanged(float newScore);
+    void ballRecycled(BaseBall* ball); // 即将回收进对象池，之后这个对象会以另一个球的身份出现
 
 protected:
-    // 属性
-    int m_ballId;
-    float m_score;
-    float m_radius;
-    BallType m_ballType;
-    Border m_border;
-    bool m_isRemoved;
+    // 纯数据（可能因存储搬移而被BallDataStore改写）
+    BaseBallData* m_data;
+    BallDataStoreBase* m_dataStore;
+    std::shared_ptr<BallDataStorage> m_storage; // 保证存储比球活得久
     
-    // 物理属性
-    QVector2D m_velocity;
-    QVector2D m_acceleration;
+    Border m_border;
+    float m_renderedRadius; // 上次同步到场景时的半径
+    BallHandle m_handle;
+    GameEventBuffer* m_events;
     
-    // 更新半径
     // 更新半径
     void updateRadius();
     
+    // 从对象池取出复用时重新初始化（与构造函数相同，数据槽和场景图元沿用原来的）
+    // 子类的reset()先清空自己的数据结构，再调用它
+    void reinitialize(int ballId, const QPointF& position, float score, BallType type);
+    
+    // 数据被整条覆盖之后（restoreData）刷新渲染代理：半径、位置、可见性
+    void refreshProxy();
+    
     // 获取球的颜色（由子类实现）
     virtual QColor getBallColor() const = 0;
 };
@@ -0,0 +1,113 @@
+#include "Broadphase.h"
+#include "BaseBall.h"
+#include "QuadTree.h"
+#include "SpatialHashGrid.h"
+#include <QHash>
+
+std::unique_ptr<Broadphase> Broadphase::create(BroadphaseType type, const QRectF& bounds, qreal cellSize)
+{
+    switch (type) {
+        case BroadphaseType::HashGrid:
+            return std::make_unique<SpatialHashGrid>(bounds, cellSize);
+        case BroadphaseType::QuadTree:
+        default:
+            return std::make_unique<QuadTree>(bounds, 6, 8); // 最大深度6，每节点最多8个球
+    }
+}
+
+void Broadphase::rebuild(const QVector<BaseBall*>& allBalls)
+{
+    clear();
+
+    for (BaseBall* ball : allBalls) {
+        insert(ball);
+    }
+}
+
+void Broadphase::forEachCandidate(BaseBall* ball, BallVisitor visitor) const
+{
+    if (!ball || ball->isRemoved()) {
+        return;
+    }
+
+    // 创建一个稍大的查询范围，考虑碰撞检测的误差
+    QRectF range = ballBounds(ball);
+    qreal margin = ball->radius() * 0.1; // 10%的误差范围
+    range.adjust(-margin, -margin, margin, margin);
+
+    forEachInRange(range, [ball, &visitor](BaseBall* other) {
+        if (other != ball) {
+            visitor(other);
+        }
+    });
+}
+
+void Broadphase::forEachSweptCandidate(BaseBall* ball, const QPointF& from, BallVisitor visitor) const
+{
+    if (!ball || ball->isRemoved()) {
+        return;
+    }
+
+    // 起点和终点包围盒的并集覆盖整条扫掠路径
+    const qreal radius = ball->radius();
+    QRectF range = ballBounds(ball).united(QRectF(from.x() - radius, from.y() - radius, radius * 2, radius * 2));
+    qreal margin = radius * 0.1;
+    range.adjust(-margin, -margin, margin, margin);
+
+    forEachInRange(range, [ball, &visitor](BaseBall* other) {
+        if (other != ball) {
+            visitor(other);
+        }
+    });
+}
+
+QVector<BaseBall*> Broadphase::query(const QRectF& range) const
+{
+    QVector<BaseBall*> result;
+    forEachInRange(range, [&result](BaseBall* ball) {
+        result.append(ball);
+    });
+    return result;
+}
+
+QVector<BaseBall*> Broadphase::queryCollisions(BaseBall* ball) const
+{
+    QVector<BaseBall*> result;
+    forEachCandidate(ball, [&result](BaseBall* other) {
+        result.append(other);
+    });
+    return result;
+}
+
+void Broadphase::collectPairs(QVector<BallPair>& pairs) const
+{
+    // 通用实现：按遍历顺序编号，只输出编号更大的候选者，保证每对只出现一次
+    const QVector<BaseBall*> all = balls();
+    QHash<BaseBall*, int> order;
+    order.reserve(all.size());
+    for (int i = 0; i < all.size(); ++i) {
+        order.insert(all[i], i);
+    }
+
+    for (int i = 0; i < all.size(); ++i) {
+        BaseBall* ball = all[i];
+        if (!ball || ball->isRemoved()) continue;
+
+        forEachInRange(ballBounds(ball), [&](BaseBall* other) {
+            if (other != ball && order.value(other, -1) > i) {
+                pairs.append(BallPair(ball, other));
+            }
+        });
+    }
+}
+
+QRectF Broadphase::ballBounds(const BaseBall* ball)
+{
+    if (!ball) return QRectF();
+
+    QPointF pos = ball->position();
+    qreal radius = ball->radius();
+
+    return QRectF(pos.x() - radius, pos.y() - radius,
+                  radius * 2, radius * 2);
+}
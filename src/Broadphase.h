@@ -0,0 +1,88 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include <QVector>
+#include <QPair>
+#include <QRectF>
+#include <QString>
+#include <memory>
+#include <type_traits>
+
+class BaseBall;
+
+// 不拥有的回调引用（类似function_ref）：按值传递，不做堆分配
+// 只在一次forEach调用期间有效，回调里不能修改正在遍历的Broadphase
+class BallVisitor
+{
+public:
+    template<typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, BallVisitor>::value>>
+    BallVisitor(F&& callback)
+        : m_callback(const_cast<void*>(static_cast<const void*>(&callback)))
+        , m_invoke([](void* callback, BaseBall* ball) {
+              (*static_cast<std::remove_reference_t<F>*>(callback))(ball);
+          })
+    {
+    }
+
+    void operator()(BaseBall* ball) const { m_invoke(m_callback, ball); }
+
+private:
+    void* m_callback;
+    void (*m_invoke)(void*, BaseBall*);
+};
+
+// 粗测阶段（broadphase）后端类型
+enum class BroadphaseType {
+    QuadTree,   // 松散四叉树
+    HashGrid    // 均匀空间哈希网格 + 大球旁路列表
+};
+
+// 粗测阶段接口：维护球体的空间索引，回答"哪些球可能相交"
+// 精确的圆形相交判断（collidesWith）仍由调用方完成
+class Broadphase
+{
+public:
+    using BallPair = QPair<BaseBall*, BaseBall*>;
+
+    virtual ~Broadphase() = default;
+
+    // 根据类型创建后端；cellSize只对网格有效，<=0表示根据半径分布自动选择
+    static std::unique_ptr<Broadphase> create(BroadphaseType type, const QRectF& bounds, qreal cellSize = 0.0);
+
+    virtual const char* name() const = 0;
+
+    // 增删改
+    virtual void insert(BaseBall* ball) = 0;
+    virtual void remove(BaseBall* ball) = 0;
+    virtual void update(BaseBall* ball) = 0;   // 球移动或半径变化后调用
+    virtual void clear() = 0;
+    virtual void rebuild(const QVector<BaseBall*>& allBalls);
+
+    virtual bool contains(BaseBall* ball) const = 0;
+    virtual int ballCount() const = 0;
+    virtual QVector<BaseBall*> balls() const = 0;
+
+    // 访问包围盒与range相交的每个球体一次（已跳过被移除的球），不分配内存
+    virtual void forEachInRange(const QRectF& range, BallVisitor visitor) const = 0;
+
+    // 访问与指定球体可能碰撞的每个球体一次（不含自身）
+    void forEachCandidate(BaseBall* ball, BallVisitor visitor) const;
+
+    // 连续碰撞检测用：访问球从from移动到当前位置这一路上可能碰到的球体（不含自身）
+    void forEachSweptCandidate(BaseBall* ball, const QPointF& from, BallVisitor visitor) const;
+
+    // 便捷版本：把结果收集到新的QVector里
+    QVector<BaseBall*> query(const QRectF& range) const;
+    QVector<BaseBall*> queryCollisions(BaseBall* ball) const;
+
+    // 枚举所有包围盒相交的球对，每对只出现一次
+    virtual void collectPairs(QVector<BallPair>& pairs) const;
+
+    // 调试统计（节点数/格子数等）
+    virtual QString statistics() const = 0;
+
+    // 球体的轴对齐包围盒
+    static QRectF ballBounds(const BaseBall* ball);
+};
+
+#endif // BROADPHASE_H
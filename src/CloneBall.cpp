@@ -3,77 +3,99 @@
 #include "FoodBall.h"
 #include "ThornsBall.h"
 #include "GoBiggerConfig.h"
+#include "BallPool.h"
+#include "core/Trace.h"
+#include "core/InputRecorder.h"
 #include <QRandomGenerator>
 #include <QGraphicsScene>
 #include <QDebug>
 #include <QDateTime>
+#include <atomic>
 #include <cmath>
+#include <cstring>
 
 CloneBall::CloneBall(int ballId, const QPointF& position, const Border& border, int teamId, int playerId, 
-                     const Config& config, QGraphicsItem* parent)
-    : BaseBall(ballId, position, GoBiggerConfig::CELL_INIT_SCORE, border, CLONE_BALL, parent) // 使用标准初始分数
+                     const Config& config, QGraphicsItem* parent, std::shared_ptr<BallDataStorage> storage)
+    : BaseBall(ballId, position, GoBiggerConfig::CELL_INIT_SCORE, border, CLONE_BALL,
+               acquireBallData(storage ? &storage->clones : nullptr), storage, parent) // 使用标准初始分数
     , m_config(config)
-    , m_teamId(teamId)
-    , m_playerId(playerId)
-    , m_moveDirection(0, 0)
-    , m_splitVelocity(0, 0)
-    , m_splitVelocityPiece(0, 0)
-    , m_splitFrame(0)
-    , m_frameSinceLastSplit(0)
-    , m_fromSplit(false)
-    , m_fromThorns(false)
     , m_splitParent(nullptr)
-    , m_movementTimer(nullptr)
-    , m_decayTimer(nullptr)
 {
-    initializeTimers();
+    m_data->teamId = teamId;
+    m_data->playerId = playerId;
+    
     updateDirection();
 }
 
 CloneBall::~CloneBall()
 {
-    if (m_movementTimer) {
-        m_movementTimer->stop();
-        delete m_movementTimer;
-    }
-    if (m_decayTimer) {
-        m_decayTimer->stop();
-        delete m_decayTimer;
-    }
 }
 
-void CloneBall::initializeTimers()
+void CloneBall::reset(int ballId, const QPointF& position, int teamId, int playerId, const Config& config)
+{
+    *cloneBallData() = CloneBallData(); // 清掉上一个分身留下的状态
+    reinitialize(ballId, position, GoBiggerConfig::CELL_INIT_SCORE, CLONE_BALL);
+    m_config = config;
+    m_splitParent = nullptr;
+    m_splitChildren.clear();
+    
+    m_data->teamId = teamId;
+    m_data->playerId = playerId;
+    
+    updateDirection();
+}
+
+void CloneBall::restoreData(const char* record)
 {
-    // 移动更新定时器
-    m_movementTimer = new QTimer(this);
-    connect(m_movementTimer, &QTimer::timeout, this, &CloneBall::updateMovement);
-    m_movementTimer->start(16); // ~60 FPS
-    
-    // 分数衰减定时器
-    m_decayTimer = new QTimer(this);
-    connect(m_decayTimer, &QTimer::timeout, this, &CloneBall::updateScoreDecay);
-    m_decayTimer->start(100); // 每100ms检查一次衰减
+    std::memcpy(cloneBallData(), record, sizeof(CloneBallData));
+    m_splitParent = nullptr;
+    m_splitChildren.clear();
+    refreshProxy();
+}
+
+void CloneBall::restoreSplitLinks(CloneBall* parent, const QVector<CloneBall*>& children)
+{
+    m_splitParent = parent;
+    m_splitChildren = children;
+}
+
+int CloneBall::allocateBallId(int fallbackId)
+{
+    return m_config.nextBallId ? (*m_config.nextBallId)++ : fallbackId;
+}
+
+CloneBall* CloneBall::spawnSplitBall(int ballId, const QPointF& position)
+{
+    CloneBall* ball = m_config.pools ? m_config.pools->clones.acquire() : nullptr;
+    if (ball) {
+        ball->reset(ballId, position, teamId(), playerId(), m_config);
+    } else {
+        ball = new CloneBall(ballId, position, m_border, teamId(), playerId(), m_config, nullptr, m_storage);
+    }
+    // 新球在帧末注册之前发生的事件也要进同一个缓冲区
+    ball->setEventBuffer(m_events);
+    return ball;
 }
 
 bool CloneBall::canSplit() const
 {
     // 简化分裂判定，只检查分数
-    return m_score >= GoBiggerConfig::SPLIT_MIN_SCORE;
+    return score() >= GoBiggerConfig::SPLIT_MIN_SCORE;
 }
 
 bool CloneBall::canEject() const
 {
     // 使用GoBigger标准：score >= 3200才能喷射孢子
-    bool canEject = m_score >= GoBiggerConfig::EJECT_MIN_SCORE;
-    qDebug() << "Ball" << m_ballId << "canEject check: score=" << m_score 
-             << "EJECT_MIN_SCORE=" << GoBiggerConfig::EJECT_MIN_SCORE 
-             << "result=" << canEject;
+    bool canEject = score() >= GoBiggerConfig::EJECT_MIN_SCORE;
+    GB_TRACE(Split, Verbose, "canEject id/score/result", ballId(), score(), canEject);
     return canEject;
 }
 
-void CloneBall::setMoveDirection(const QVector2D& direction)
+void CloneBall::setMoveDirection(const QVector2D& input)
 {
-    m_moveDirection = direction.normalized();
+    // 录制输入录像时记下这次操作，之后用量化后的值，与重放时看到的一致
+    const QVector2D direction = m_config.recorder ? m_config.recorder->recordMove(ballId(), input) : input;
+    storeMoveDirection(direction.normalized());
     updateDirection();
     
     // 🔥 移除统一传播机制，让每个球独立控制
@@ -81,7 +103,7 @@ void CloneBall::setMoveDirection(const QVector2D& direction)
     
     // 立即应用移动
     if (direction.length() > 0.01) {
-        move(direction, 0.016); // 以16ms为时间步长移动
+        move(direction, m_config.tickDuration); // 以一个逻辑帧为时间步长移动
     }
 }
 
@@ -94,17 +116,14 @@ void CloneBall::setTargetDirection(const QPointF& direction)
 
 QPointF CloneBall::getVelocity() const
 {
-    return QPointF(m_velocity.x(), m_velocity.y());
+    return QPointF(m_data->vx, m_data->vy);
 }
 
 void CloneBall::split()
 {
     if (canSplit()) {
-        QVector2D splitDirection = m_moveDirection.length() > 0.01 ? m_moveDirection : QVector2D(1, 0);
-        auto newBalls = performSplit(splitDirection);
-        if (!newBalls.isEmpty()) {
-            emit splitPerformed(this, newBalls);
-        }
+        QVector2D splitDirection = moveDirection().length() > 0.01 ? moveDirection() : QVector2D(1, 0);
+        performSplit(splitDirection); // performSplit内部已经通知过了
     }
 }
 
@@ -113,16 +132,13 @@ void CloneBall::ejectSpore(const QPointF& direction)
     if (canEject()) {
         QVector2D ejectDir(direction.x(), direction.y());
         if (ejectDir.length() < 0.01) {
-            ejectDir = m_moveDirection.length() > 0.01 ? m_moveDirection : QVector2D(1, 0);
-        }
-        SporeBall* spore = ejectSpore(ejectDir);
-        if (spore) {
-            emit sporeEjected(this, spore);
+            ejectDir = moveDirection().length() > 0.01 ? moveDirection() : QVector2D(1, 0);
         }
+        ejectSpore(ejectDir); // 内部已经通知过了
     }
 }
 
-QVector<CloneBall*> CloneBall::performSplit(const QVector2D& direction)
+QVector<CloneBall*> CloneBall::performSplit(const QVector2D& requestedDirection)
 {
     QVector<CloneBall*> newBalls;
     
@@ -130,30 +146,25 @@ QVector<CloneBall*> CloneBall::performSplit(const QVector2D& direction)
         return newBalls;
     }
     
+    const QVector2D direction = m_config.recorder ? m_config.recorder->recordSplit(ballId(), requestedDirection)
+                                                  : requestedDirection;
+    
     // 计算分裂后的分数 - 使用GoBigger标准
-    float originalScore = m_score;
-    float splitScore = m_score / 2.0f;
+    float originalScore = score();
+    float splitScore = score() / 2.0f;
     
-    qDebug() << "🔄 Split: Ball" << m_ballId << "Team" << m_teamId 
-             << "Original Score:" << originalScore << "-> Split Score:" << splitScore;
+    GB_TRACE(Split, Info, "split id/team/score/splitScore", ballId(), teamId(), originalScore, splitScore);
     
     // 计算分裂位置 - 参考GoBigger: position + direction * (radius * 2)
-    QVector2D splitDir = direction.length() > 0.01 ? direction.normalized() : m_moveDirection.normalized();
+    QVector2D splitDir = direction.length() > 0.01 ? direction.normalized() : moveDirection().normalized();
     if (splitDir.length() < 0.01) {
         splitDir = QVector2D(1, 0); // 默认向右
     }
     
-    QPointF newPos = pos() + QPointF(splitDir.x() * radius() * 2.0f, splitDir.y() * radius() * 2.0f);
+    QPointF newPos = position() + QPointF(splitDir.x() * radius() * 2.0f, splitDir.y() * radius() * 2.0f);
     
-    // 创建新的球
-    CloneBall* newBall = new CloneBall(
-        m_ballId + 1000, // 临时ID策略
-        newPos,
-        m_border,
-        m_teamId,
-        m_playerId,
-        m_config
-    );
+    // 创建新的球（优先从对象池复用）
+    CloneBall* newBall = spawnSplitBall(allocateBallId(ballId() + 1000), newPos);
     
     // 设置分数
     setScore(splitScore);
@@ -167,88 +178,99 @@ QVector<CloneBall*> CloneBall::performSplit(const QVector2D& direction)
     newBall->setVelocity(originalVelocity);
     
     // 重置分裂计时器
-    m_frameSinceLastSplit = 0;
-    newBall->m_frameSinceLastSplit = 0;
+    cloneBallData()->frameSinceLastSplit = 0;
+    newBall->cloneBallData()->frameSinceLastSplit = 0;
     
     // 设置分裂关系 - 关键：确保新球也继承移动状态
     newBall->setSplitParent(this);
-    newBall->m_moveDirection = m_moveDirection; // 继承移动方向
-    newBall->m_fromSplit = true;
-    m_fromSplit = true; // 原球也标记为分裂状态
-    
-    // 确保新球正确初始化定时器和状态
-    newBall->initializeTimers(); // 确保计时器初始化
+    newBall->storeMoveDirection(moveDirection()); // 继承移动方向
+    newBall->cloneBallData()->fromSplit = true;
+    cloneBallData()->fromSplit = true; // 原球也标记为分裂状态
     
     m_splitChildren.append(newBall);
     
     newBalls.append(newBall);
     
-    // 添加到场景
-    if (scene()) {
+    // 添加到场景（复用的球图元本来就在场景里）
+    if (scene() && newBall->scene() != scene()) {
         scene()->addItem(newBall);
     }
     
-    emit splitPerformed(this, newBalls);
+    notifySplit(newBalls);
     
     return newBalls;
 }
 
-SporeBall* CloneBall::ejectSpore(const QVector2D& direction)
+SporeBall* CloneBall::ejectSpore(const QVector2D& requestedDirection)
 {
     if (!canEject()) {
         return nullptr;
     }
     
+    const QVector2D direction = m_config.recorder ? m_config.recorder->recordEject(ballId(), requestedDirection)
+                                                  : requestedDirection;
+    
     // 确定孢子方向：使用传入的方向参数
     QVector2D sporeDirection;
     if (direction.length() > 0.01) {
         sporeDirection = direction.normalized();
     } else {
         // 如果没有指定方向，使用当前移动方向作为备选
-        sporeDirection = m_moveDirection.length() > 0.01 ? m_moveDirection.normalized() : QVector2D(1, 0);
+        sporeDirection = moveDirection().length() > 0.01 ? moveDirection().normalized() : QVector2D(1, 0);
     }
     
     // 使用GoBigger标准孢子分数和消耗
     float sporeScore = GoBiggerConfig::EJECT_SCORE;
-    float scoreLoss = m_score * GoBiggerConfig::EJECT_COST_RATIO;
+    float scoreLoss = score() * GoBiggerConfig::EJECT_COST_RATIO;
     scoreLoss = std::max(scoreLoss, (float)sporeScore); // 至少消耗孢子分数
     
     // 减少自己的分数
-    setScore(m_score - scoreLoss);
+    setScore(score() - scoreLoss);
     
     // 计算孢子位置：在玩家球边缘外切，避免立即重叠
     float sporeRadius = GoBiggerConfig::scoreToRadius(sporeScore);
     float safeDistance = (radius() + sporeRadius) * 1.5f; // 1.5倍安全距离
     
     // 🔥 修复：直接使用指定方向，不添加随机偏移
-    QPointF sporePos = pos() + QPointF(sporeDirection.x() * safeDistance, 
+    QPointF sporePos = position() + QPointF(sporeDirection.x() * safeDistance, 
                                        sporeDirection.y() * safeDistance);
     
-    // 创建孢子球，使用时间戳确保唯一ID
-    static int sporeIdCounter = 0;
-    sporeIdCounter++;
-    int uniqueId = static_cast<int>(QDateTime::currentMSecsSinceEpoch() % 1000000) + sporeIdCounter;
-    
-    SporeBall* spore = new SporeBall(
-        uniqueId,
-        sporePos,
-        m_border,
-        m_teamId,
-        m_playerId,
-        sporeDirection,  // 🔥 直接使用计算好的方向，不做偏移
-        velocity()       // 玩家球当前速度
-    );
-    
-    // 添加到场景
-    if (scene()) {
+    // 创建孢子球：受管时用GameManager的ID序列（可复现），否则用时间戳确保唯一ID
+    // 计数器是进程级的，BatchEngine的各个世界在不同线程里同时喷射
+    static std::atomic<int> sporeIdCounter{0};
+    int uniqueId = allocateBallId(static_cast<int>(QDateTime::currentMSecsSinceEpoch() % 1000000) + ++sporeIdCounter);
+    
+    SporeBall* spore = m_config.pools ? m_config.pools->spores.acquire() : nullptr;
+    if (spore) {
+        spore->reset(uniqueId, sporePos, teamId(), playerId(), sporeDirection, velocity());
+    } else {
+        spore = new SporeBall(
+            uniqueId,
+            sporePos,
+            m_border,
+            teamId(),
+            playerId(),
+            sporeDirection,  // 🔥 直接使用计算好的方向，不做偏移
+            velocity(),      // 玩家球当前速度
+            SporeBall::Config(),
+            nullptr,
+            m_storage
+        );
+    }
+    
+    // 添加到场景（复用的孢子图元本来就在场景里）
+    if (scene() && spore->scene() != scene()) {
         scene()->addItem(spore);
     }
     
-    emit sporeEjected(this, spore);
+    spore->setEventBuffer(m_events);
+    if (m_events) {
+        m_events->record(GameEvent::EJECT, this, spore);
+    } else {
+        emit sporeEjected(this, spore);
+    }
     
-    qDebug() << "CloneBall" << ballId() << "ejected spore in direction:" 
-             << sporeDirection.x() << sporeDirection.y() 
-             << "at position:" << sporePos.x() << sporePos.y();
+    GB_TRACE(Split, Info, "eject id/dirX/dirY/spore", ballId(), sporeDirection.x(), sporeDirection.y(), spore->ballId());
     
     return spore;
 }
@@ -290,21 +312,21 @@ void CloneBall::move(const QVector2D& direction, qreal duration)
     }
     
     // 🔥 GoBigger风格分裂速度处理
-    if (m_splitVelocity.length() > 0.1) {
+    if (splitVelocity().length() > 0.1) {
         // 分裂速度和移动速度相加
-        QVector2D totalVel = velocity() + m_splitVelocity;
+        QVector2D totalVel = velocity() + splitVelocity();
         setVelocity(totalVel);
         
         // 分裂速度衰减：按帧数逐渐减少
-        m_splitVelocity -= m_splitVelocityPiece;
+        storeSplitVelocity(splitVelocity() - splitVelocityPiece());
         
         // 衰减完成后清零
-        if (m_splitVelocity.length() < 0.1) {
-            m_splitVelocity = QVector2D(0, 0);
+        if (splitVelocity().length() < 0.1) {
+            storeSplitVelocity(QVector2D(0, 0));
         }
         
         // 更新分裂帧计数
-        m_splitFrame++;
+        cloneBallData()->splitFrame++;
     }
     
     // 调用基类物理更新
@@ -320,17 +342,15 @@ bool CloneBall::canEat(BaseBall* other) const
     // 不能吃同队的球（但可以吃同队的孢子）
     if (other->ballType() == CLONE_BALL) {
         CloneBall* otherClone = static_cast<CloneBall*>(other);
-        if (otherClone->teamId() == m_teamId) {
+        if (otherClone->teamId() == teamId()) {
             return false;
         }
     }
     
     // 可以吃孢子球（包括自己的）
     if (other->ballType() == SPORE_BALL) {
-        SporeBall* spore = static_cast<SporeBall*>(other);
-        qDebug() << "CloneBall" << ballId() << "checking spore" << spore->ballId() 
-                 << "player team/id:" << m_teamId << "/" << m_playerId 
-                 << "spore team/id:" << spore->teamId() << "/" << spore->playerId();
+        GB_TRACE(Spore, Verbose, "canEat spore eater/spore/team/sporeTeam",
+                 ballId(), other->ballId(), teamId(), other->data().teamId);
         return true; // 孢子球可以被任何玩家球吞噬
     }
     
@@ -345,26 +365,28 @@ void CloneBall::eat(BaseBall* other)
         if (other->ballType() == BaseBall::THORNS_BALL) {
             ThornsBall* thorns = static_cast<ThornsBall*>(other);
             
-            qDebug() << "CloneBall" << ballId() << "eating thorns ball" << thorns->ballId() 
-                     << "- triggering special split";
+            GB_TRACE(Thorns, Info, "eat thorns eater/thorns", ballId(), thorns->ballId());
             
             // 先增加分数
             BaseBall::eat(other);
             
             // 触发荆棘分裂
             // 注意：这里需要通过信号机制来获取准确的玩家球数量
-            // 暂时发送信号，让GameManager处理
-            emit thornsEaten(this, thorns);
+            // 暂时通知GameManager处理
+            if (m_events) {
+                m_events->record(GameEvent::THORNS_HIT, this, thorns);
+            } else {
+                emit thornsEaten(this, thorns);
+            }
         } else {
             BaseBall::eat(other);
-            qDebug() << "CloneBall" << ballId() << "ate" << other->ballId() << "gaining score:" << other->score();
         }
     }
 }
 
 QColor CloneBall::getBallColor() const
 {
-    QColor teamColor = getTeamColor(m_teamId);
+    QColor teamColor = getTeamColor(teamId());
     
     // 玩家球使用更饱和、更鲜艳的颜色
     teamColor.setHsv(teamColor.hue(), 
@@ -379,28 +401,20 @@ void CloneBall::updatePhysics(qreal deltaTime)
     BaseBall::updatePhysics(deltaTime);
     
     // 增加分裂计时器
-    m_frameSinceLastSplit++;
-    m_splitFrame++;
+    cloneBallData()->frameSinceLastSplit++;
+    cloneBallData()->splitFrame++;
 }
 
-void CloneBall::updateMovement()
+void CloneBall::stepMovement(qreal deltaTime)
 {
-    // 🔥 如果球已被移除，立即停止所有移动和更新
+    // 🔥 如果球已被移除，不再推进
     if (isRemoved()) {
-        if (m_movementTimer) {
-            m_movementTimer->stop();
-        }
-        if (m_decayTimer) {
-            m_decayTimer->stop();
-        }
         return;
     }
     
-    const qreal deltaTime = 0.016; // 16ms ≈ 60 FPS
-    
     // 如果有移动方向，持续应用移动
-    if (m_moveDirection.length() > 0.01) {
-        move(m_moveDirection, deltaTime);
+    if (moveDirection().length() > 0.01) {
+        move(moveDirection(), deltaTime);
     }
     
     // 应用温和的向心力
@@ -409,8 +423,8 @@ void CloneBall::updateMovement()
     updatePhysics(deltaTime);
     
     // 更新分裂状态
-    if (m_splitFrame > 0) {
-        m_splitFrame++;
+    if (cloneData().splitFrame > 0) {
+        cloneBallData()->splitFrame++;
     }
     
     // 检查合并条件
@@ -419,11 +433,8 @@ void CloneBall::updateMovement()
 
 void CloneBall::updateScoreDecay()
 {
-    // 🔥 如果球已被移除，停止分数衰减
+    // 🔥 如果球已被移除，不再衰减
     if (isRemoved()) {
-        if (m_decayTimer) {
-            m_decayTimer->stop();
-        }
         return;
     }
     
@@ -433,7 +444,7 @@ void CloneBall::updateScoreDecay()
 void CloneBall::updateDirection()
 {
     // 更新内部方向向量（用于渲染等）
-    if (m_moveDirection.length() > 0) {
+    if (moveDirection().length() > 0) {
         // 可以在这里添加方向相关的逻辑
     }
 }
@@ -456,24 +467,24 @@ void CloneBall::applySplitVelocity(const QVector2D& direction, bool fromThorns)
         calculateSplitVelocityFromThorns(radius()) :
         calculateSplitVelocityFromSplit(radius());
     
-    m_splitVelocity = direction.normalized() * splitVelMagnitude;
-    m_splitVelocityPiece = m_splitVelocity / m_config.splitVelZeroFrame;
+    storeSplitVelocity(direction.normalized() * splitVelMagnitude);
+    storeSplitVelocityPiece(splitVelocity() / m_config.splitVelZeroFrame);
     
-    m_fromSplit = !fromThorns;
-    m_fromThorns = fromThorns;
+    cloneBallData()->fromSplit = !fromThorns;
+    cloneBallData()->fromThorns = fromThorns;
 }
 
 void CloneBall::applySplitVelocityEnhanced(const QVector2D& direction, qreal velocity, bool fromThorns)
 {
     // 增强的分裂速度应用，支持非线性衰减
-    m_splitVelocity = direction.normalized() * velocity;
+    storeSplitVelocity(direction.normalized() * velocity);
     
     // 非线性衰减：使用平方根衰减而不是线性衰减
     qreal decayFrames = m_config.splitVelZeroFrame;
-    m_splitVelocityPiece = m_splitVelocity / (decayFrames * 0.7); // 稍微减慢衰减
+    storeSplitVelocityPiece(splitVelocity() / (decayFrames * 0.7)); // 稍微减慢衰减
     
-    m_fromSplit = !fromThorns;
-    m_fromThorns = fromThorns;
+    cloneBallData()->fromSplit = !fromThorns;
+    cloneBallData()->fromThorns = fromThorns;
 }
 
 void CloneBall::propagateMovementToGroup(const QVector2D& direction)
@@ -481,10 +492,10 @@ void CloneBall::propagateMovementToGroup(const QVector2D& direction)
     // 统一控制分裂出的所有球 - 移除向心力，改为直接同步移动
     for (CloneBall* child : m_splitChildren) {
         if (child && !child->isRemoved()) {
-            child->m_moveDirection = direction.normalized();
+            child->storeMoveDirection(direction.normalized());
             child->updateDirection();
             // 直接同步移动，避免卡顿
-            child->move(direction, 0.016);
+            child->move(direction, m_config.tickDuration);
         }
     }
     
@@ -493,18 +504,18 @@ void CloneBall::propagateMovementToGroup(const QVector2D& direction)
         QVector<CloneBall*> siblings = m_splitParent->getSplitChildren();
         for (CloneBall* sibling : siblings) {
             if (sibling && sibling != this && !sibling->isRemoved()) {
-                sibling->m_moveDirection = direction.normalized();
+                sibling->storeMoveDirection(direction.normalized());
                 sibling->updateDirection();
                 // 直接同步移动
-                sibling->move(direction, 0.016);
+                sibling->move(direction, m_config.tickDuration);
             }
         }
         
         // 父球也同步移动
         if (m_splitParent && !m_splitParent->isRemoved()) {
-            m_splitParent->m_moveDirection = direction.normalized();
+            m_splitParent->storeMoveDirection(direction.normalized());
             m_splitParent->updateDirection();
-            m_splitParent->move(direction, 0.016);
+            m_splitParent->move(direction, m_config.tickDuration);
         }
     }
 }
@@ -512,9 +523,9 @@ void CloneBall::propagateMovementToGroup(const QVector2D& direction)
 void CloneBall::applyScoreDecay()
 {
     // 使用GoBigger标准衰减
-    if (m_score > GoBiggerConfig::DECAY_START_SCORE) {
-        float decay = m_score * GoBiggerConfig::DECAY_RATE;
-        setScore(std::max((float)GoBiggerConfig::CELL_MIN_SCORE, m_score - decay));
+    if (score() > GoBiggerConfig::DECAY_START_SCORE) {
+        float decay = score() * GoBiggerConfig::DECAY_RATE;
+        setScore(std::max((float)GoBiggerConfig::CELL_MIN_SCORE, score() - decay));
     }
 }
 
@@ -571,7 +582,7 @@ void CloneBall::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
                                 radius() * 0.6, radius() * 0.6));
     
     // 🔥 绘制队伍字母标识（在球中心）
-    QChar teamLetter = GoBiggerConfig::getTeamLetter(m_teamId);
+    QChar teamLetter = GoBiggerConfig::getTeamLetter(teamId());
     QFont font("Arial", static_cast<int>(radius() * 0.6)); // 字体大小基于球半径
     font.setBold(true);
     
@@ -592,8 +603,8 @@ void CloneBall::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
     painter->drawText(textPos, teamLetter);
                                 
     // 绘制移动方向箭头（基于GoBigger的to_arrow实现）
-    if (m_moveDirection.length() > 0.01) {
-        drawDirectionArrow(painter, m_moveDirection, ballColor);
+    if (moveDirection().length() > 0.01) {
+        drawDirectionArrow(painter, moveDirection(), ballColor);
     }
 }
 
@@ -627,6 +638,11 @@ void CloneBall::drawDirectionArrow(QPainter* painter, const QVector2D& direction
 
 // ============ 合并机制实现 ============
 
+int CloneBall::mergeDelayFrameCount() const
+{
+    return qMax(1, qRound(GoBiggerConfig::MERGE_DELAY / m_config.tickDuration));
+}
+
 bool CloneBall::canMergeWith(CloneBall* other) const
 {
     if (!other || other == this || other->isRemoved() || this->isRemoved()) {
@@ -634,26 +650,25 @@ bool CloneBall::canMergeWith(CloneBall* other) const
     }
     
     // 必须是同队同玩家
-    if (other->teamId() != m_teamId || other->playerId() != m_playerId) {
+    if (other->teamId() != teamId() || other->playerId() != playerId()) {
         return false;
     }
     
     // 必须超过合并延迟时间(使用帧计算，假设60FPS)
-    int mergeDelayFrames = GoBiggerConfig::MERGE_DELAY * 60; // 20秒 * 60帧
-    if (m_frameSinceLastSplit < mergeDelayFrames || other->frameSinceLastSplit() < mergeDelayFrames) {
+    const int mergeDelayFrames = mergeDelayFrameCount();
+    if (cloneData().frameSinceLastSplit < mergeDelayFrames || other->frameSinceLastSplit() < mergeDelayFrames) {
         return false;
     }
     
     // 距离必须足够近
     qreal distance = distanceTo(other);
-    qreal mergeDistance = (m_radius + other->radius()) * GoBiggerConfig::RECOMBINE_RADIUS;
+    qreal mergeDistance = (radius() + other->radius()) * GoBiggerConfig::RECOMBINE_RADIUS;
     
     bool canMerge = distance <= mergeDistance;
     
     // 只在成功合并时打印日志，减少输出
     if (canMerge) {
-        qDebug() << "Ball" << m_ballId << "can merge with Ball" << other->ballId() 
-                 << "distance:" << distance << "required:" << mergeDistance;
+        GB_TRACE(Merge, Debug, "canMerge id/other/distance/required", ballId(), other->ballId(), distance, mergeDistance);
     }
     
     return canMerge;
@@ -665,21 +680,23 @@ void CloneBall::mergeWith(CloneBall* other)
         return;
     }
     
-    qDebug() << "🔗 Ball" << m_ballId << "merging with ball" << other->ballId();
-    
-    // 🔥 在合并前发出信号通知AI
-    emit mergePerformed(this, other);
+    // 🔥 在合并前通知AI（事件排在other的REMOVED之前）
+    if (m_events) {
+        m_events->record(GameEvent::MERGE, this, other);
+    } else {
+        emit mergePerformed(this, other);
+    }
     
     // 合并分数
-    float combinedScore = m_score + other->score();
+    float combinedScore = score() + other->score();
     setScore(combinedScore);
     
     // 合并速度(加权平均)
-    QVector2D combinedVelocity = (m_velocity * m_score + other->velocity() * other->score()) / combinedScore;
+    QVector2D combinedVelocity = (velocity() * score() + other->velocity() * other->score()) / combinedScore;
     setVelocity(combinedVelocity);
     
     // 重置分裂计时器
-    m_frameSinceLastSplit = 0;
+    cloneBallData()->frameSinceLastSplit = 0;
     
     // 🔥 彻底移除被合并的球 - 多重保险
     other->remove();
@@ -694,29 +711,21 @@ void CloneBall::mergeWith(CloneBall* other)
         other->setSplitParent(nullptr);
     }
     
-    // 🔥 如果还在场景中，强制移除
-    if (other->scene() && other->scene()->items().contains(other)) {
-        other->scene()->removeItem(other);
-        qDebug() << "Force removed ball" << other->ballId() << "from scene";
-    }
-    
-    qDebug() << "Ball" << m_ballId << "merged with ball" << other->ballId() 
-             << "new score:" << combinedScore;
+    GB_TRACE(Merge, Info, "merge id/other/score", ballId(), other->ballId(), combinedScore);
 }
 
 void CloneBall::checkForMerge()
 {
-    int mergeDelayFrames = GoBiggerConfig::MERGE_DELAY * 60; // 20秒 * 60帧
+    const int mergeDelayFrames = mergeDelayFrameCount();
     
     // 如果刚好过了冷却期，打印调试信息
-    if (m_frameSinceLastSplit == mergeDelayFrames) {
-        qDebug() << "Ball" << m_ballId << "merge cooldown ended, checking for auto-merge";
+    if (cloneData().frameSinceLastSplit == mergeDelayFrames) {
+        GB_TRACE(Merge, Debug, "merge cooldown ended id", ballId());
     }
     
     // 检查与所有子球的合并
     for (CloneBall* child : m_splitChildren) {
         if (child && !child->isRemoved() && canMergeWith(child)) {
-            qDebug() << "Ball" << m_ballId << "auto-merging with child" << child->ballId();
             mergeWith(child);
             return; // 一次只合并一个，下次更新时继续
         }
@@ -724,7 +733,6 @@ void CloneBall::checkForMerge()
     
     // 如果自己是子球，检查与父球的合并
     if (m_splitParent && !m_splitParent->isRemoved() && canMergeWith(m_splitParent)) {
-        qDebug() << "Ball" << m_ballId << "auto-merging with parent" << m_splitParent->ballId();
         m_splitParent->mergeWith(this);
         return; // 自己被合并了，直接返回
     }
@@ -734,7 +742,6 @@ void CloneBall::checkForMerge()
         QVector<CloneBall*> siblings = m_splitParent->getSplitChildren();
         for (CloneBall* sibling : siblings) {
             if (sibling && sibling != this && !sibling->isRemoved() && canMergeWith(sibling)) {
-                qDebug() << "Ball" << m_ballId << "auto-merging with sibling" << sibling->ballId();
                 mergeWith(sibling);
                 return; // 一次只合并一个
             }
@@ -753,24 +760,24 @@ bool CloneBall::shouldRigidCollide(CloneBall* other) const
     }
     
     // 必须是同一玩家的球
-    if (other->teamId() != m_teamId || other->playerId() != m_playerId) {
+    if (other->teamId() != teamId() || other->playerId() != playerId()) {
         return false;
     }
     
     // 只有分裂后未达到合并时间的球才会刚体碰撞
-    int mergeDelayFrames = GoBiggerConfig::MERGE_DELAY * 60; // 20秒 * 60帧
-    return (m_frameSinceLastSplit < mergeDelayFrames || 
+    const int mergeDelayFrames = mergeDelayFrameCount();
+    return (cloneData().frameSinceLastSplit < mergeDelayFrames || 
             other->frameSinceLastSplit() < mergeDelayFrames);
 }
 
 void CloneBall::rigidCollision(CloneBall* other)
 {
-    if (!shouldRigidCollide(other) || other->ballId() == m_ballId) {
+    if (!shouldRigidCollide(other) || other->ballId() == ballId()) {
         return;
     }
     
     // 计算两球间的距离和重叠
-    QPointF p = other->pos() - pos();
+    QPointF p = other->position() - position();
     qreal distance = std::sqrt(p.x() * p.x() + p.y() * p.y());
     qreal totalRadius = radius() + other->radius();
     
@@ -780,9 +787,9 @@ void CloneBall::rigidCollision(CloneBall* other)
         qreal force = std::min(overlap, overlap / (distance + 1e-8));
         
         // 根据分数比例分配推开距离
-        qreal totalScore = m_score + other->score();
+        qreal totalScore = score() + other->score();
         qreal myRatio = other->score() / totalScore;
-        qreal otherRatio = m_score / totalScore;
+        qreal otherRatio = score() / totalScore;
         
         // 单位向量
         QVector2D pushDirection(p.x() / distance, p.y() / distance);
@@ -793,8 +800,8 @@ void CloneBall::rigidCollision(CloneBall* other)
         QPointF otherOffset = QPointF(pushDirection.x() * force * otherRatio, 
                                       pushDirection.y() * force * otherRatio);
         
-        setPos(pos() + myOffset);
-        other->setPos(other->pos() + otherOffset);
+        setPosition(position() + myOffset);
+        other->setPosition(other->position() + otherOffset);
         
         // 检查边界
         checkBorder();
@@ -809,13 +816,13 @@ void CloneBall::addCenteringForce(CloneBall* target)
     }
     
     // 只有在分裂后的重组期间才应用向心力
-    int mergeDelayFrames = GoBiggerConfig::MERGE_DELAY * 60; // 20秒 * 60帧
-    if (m_frameSinceLastSplit >= mergeDelayFrames) {
+    const int mergeDelayFrames = mergeDelayFrameCount();
+    if (cloneData().frameSinceLastSplit >= mergeDelayFrames) {
         return;
     }
     
     // 计算向心力方向（朝向目标球）
-    QPointF direction = target->pos() - pos();
+    QPointF direction = target->position() - position();
     qreal distance = std::sqrt(direction.x() * direction.x() + direction.y() * direction.y());
     
     if (distance > 0.001) {
@@ -837,8 +844,8 @@ void CloneBall::addCenteringForce(CloneBall* target)
 void CloneBall::applyCenteringForce()
 {
     // 只有在分裂后的重组期间才应用向心力
-    int mergeDelayFrames = GoBiggerConfig::MERGE_DELAY * 60; // 20秒 * 60帧
-    if (m_frameSinceLastSplit >= mergeDelayFrames) {
+    const int mergeDelayFrames = mergeDelayFrameCount();
+    if (cloneData().frameSinceLastSplit >= mergeDelayFrames) {
         return;
     }
     
@@ -872,16 +879,16 @@ void CloneBall::applyCenteringForce()
     
     for (CloneBall* ball : targetBalls) {
         float weight = ball->score(); // 使用分数作为权重
-        centerPos += ball->pos() * weight;
+        centerPos += ball->position() * weight;
         totalWeight += weight;
     }
-    centerPos += pos() * m_score;
-    totalWeight += m_score;
+    centerPos += position() * score();
+    totalWeight += score();
     
     centerPos /= totalWeight;
     
     // 计算到质心的距离向量
-    QVector2D toCenter = QVector2D(centerPos - pos());
+    QVector2D toCenter = QVector2D(centerPos - position());
     float distance = toCenter.length();
     
     // 只有当距离超过最小阈值时才应用向心力
@@ -895,7 +902,7 @@ void CloneBall::applyCenteringForce()
         float easeInOut = normalizedDistance * normalizedDistance * (3.0f - 2.0f * normalizedDistance);
         
         // 计算力度，随时间衰减（合并时间越近，向心力越强）
-        float timeDecay = 1.0f - (float)m_frameSinceLastSplit / mergeDelayFrames;
+        float timeDecay = 1.0f - (float)cloneData().frameSinceLastSplit / mergeDelayFrames;
         float maxForce = 0.8f * timeDecay; // 最大向心力随时间递减
         
         float forceStrength = maxForce * easeInOut;
@@ -904,11 +911,21 @@ void CloneBall::applyCenteringForce()
         QVector2D centeringForce = toCenter.normalized() * forceStrength;
         
         // 使用GoBigger的标准加速度系统应用向心力
-        applyGoBiggerMovement(QVector2D(0, 0), centeringForce);
+        accelerate(QVector2D(0, 0), centeringForce);
     }
 }
 
 void CloneBall::applyGoBiggerMovement(const QVector2D& playerInput, const QVector2D& centerForce)
+{
+    QVector2D input = playerInput;
+    QVector2D center = centerForce;
+    if (m_config.recorder) {
+        m_config.recorder->recordSteer(ballId(), input, center);
+    }
+    accelerate(input, center);
+}
+
+void CloneBall::accelerate(const QVector2D& playerInput, const QVector2D& centerForce)
 {
     // GoBigger风格的双重加速度控制，优化向心力平衡
     // 参考原版：given_acc (玩家输入) + given_acc_center (向心力)
@@ -946,8 +963,9 @@ void CloneBall::applyGoBiggerMovement(const QVector2D& playerInput, const QVecto
     float inputRatio = std::max(playerInput.length(), centerForce.length());
     float maxSpeed = GoBiggerConfig::calculateDynamicSpeed(currentRadius, inputRatio);
     
-    // 5. 更新速度（使用标准时间步长）
-    QVector2D newVelocity = velocity() + totalAcc * 0.05f; // 标准帧时间
+    // 5. 更新速度：每个逻辑帧调用一次，按逻辑帧长积分（tickDuration为GoBigger原生的1/20秒时与原版逐帧一致，
+    //    60Hz下每帧加得少，按真实时间算的加速度不变）
+    QVector2D newVelocity = velocity() + totalAcc * static_cast<float>(m_config.tickDuration);
     
     // 6. 限制最大速度
     if (newVelocity.length() > maxSpeed) {
@@ -959,7 +977,7 @@ void CloneBall::applyGoBiggerMovement(const QVector2D& playerInput, const QVecto
     
     // 8. 更新方向（参考原版update_direction） - 只有在有输入时才更新
     if (playerInput.length() > 0.01) {
-        m_moveDirection = playerInput; // 确保方向箭头正确显示
+        storeMoveDirection(playerInput); // 确保方向箭头正确显示
         updateDirection();
     }
 }
@@ -978,16 +996,14 @@ QVector<CloneBall*> CloneBall::performThornsSplit(const QVector2D& direction, in
     int actualNewBalls = std::min(maxNewBalls, availableSlots);
     
     if (actualNewBalls <= 0) {
-        qDebug() << "Cannot split from thorns: already at max ball count";
+        GB_TRACE(Thorns, Debug, "thorns split skipped id/totalBalls", ballId(), totalPlayerBalls);
         return newBalls;
     }
     
-    qDebug() << "Thorns split: total balls=" << totalPlayerBalls 
-             << "max new=" << maxNewBalls 
-             << "actual new=" << actualNewBalls;
+    GB_TRACE(Thorns, Debug, "thorns split id/totalBalls/newBalls", ballId(), totalPlayerBalls, actualNewBalls);
     
     // 2. 计算分数分配
-    float totalScore = m_score;
+    float totalScore = score();
     float newBallScore = std::min(static_cast<float>(GoBiggerConfig::THORNS_SPLIT_MAX_SCORE), 
                                   totalScore / (actualNewBalls + 1)); // +1包括原球
     
@@ -1010,21 +1026,14 @@ QVector<CloneBall*> CloneBall::performThornsSplit(const QVector2D& direction, in
         float separationDistance = radius() + newBallRadius;
         QVector2D offset(std::cos(angle) * separationDistance, 
                         std::sin(angle) * separationDistance);
-        QPointF newPos = pos() + QPointF(offset.x(), offset.y());
+        QPointF newPos = position() + QPointF(offset.x(), offset.y());
         
-        // 创建新球
-        CloneBall* newBall = new CloneBall(
-            m_ballId + 1000 + i, // 临时ID策略
-            newPos,
-            m_border,
-            m_teamId,
-            m_playerId,
-            m_config
-        );
+        // 创建新球（优先从对象池复用）
+        CloneBall* newBall = spawnSplitBall(allocateBallId(ballId() + 1000 + i), newPos);
         
         newBall->setScore(newBallScore);
-        newBall->m_fromThorns = true; // 标记为荆棘分裂
-        newBall->m_frameSinceLastSplit = 0; // 重置冷却计数器
+        newBall->cloneBallData()->fromThorns = true; // 标记为荆棘分裂
+        newBall->cloneBallData()->frameSinceLastSplit = 0; // 重置冷却计数器
         
         // 关键修复：设置分裂关系，让荆棘分裂的球能够相互合并
         newBall->setSplitParent(this);  // 设置父球关系
@@ -1048,41 +1057,53 @@ QVector<CloneBall*> CloneBall::performThornsSplit(const QVector2D& direction, in
     }
     
     // 原球也重置冷却计数器
-    m_frameSinceLastSplit = 0;
+    cloneBallData()->frameSinceLastSplit = 0;
 
-    qDebug() << "Thorns split completed: created" << newBalls.size() 
-             << "new balls with score" << newBallScore 
-             << "each, original ball score:" << m_score;
+    GB_TRACE(Thorns, Verbose, "thorns split done id/newBalls/newScore/score", ballId(), newBalls.size(), newBallScore, score());
 
     if (!newBalls.isEmpty()) {
-        emit splitPerformed(this, newBalls);
+        notifySplit(newBalls);
     }
     
     return newBalls;
 }
 
-void CloneBall::remove()
+void CloneBall::notifySplit(const QVector<CloneBall*>& newBalls)
 {
-    // 🔥 立即停止所有定时器，防止"尸体漂移"
-    if (m_movementTimer) {
-        m_movementTimer->stop();
-    }
-    if (m_decayTimer) {
-        m_decayTimer->stop();
+    if (!m_events) {
+        emit splitPerformed(this, newBalls);
+        return;
     }
     
-    // 清除移动方向，确保球完全停止
-    m_moveDirection = QVector2D(0, 0);
-    m_velocity = QVector2D(0, 0);
-    
-    // 🔥 立即从场景中移除，防止"尸体"残留
-    if (scene()) {
-        scene()->removeItem(this);
-        qDebug() << "CloneBall" << ballId() << "removed from scene";
+    // 每个新球一条记录，同一次分裂的记录连续存放
+    for (CloneBall* newBall : newBalls) {
+        m_events->record(GameEvent::SPLIT, this, newBall);
     }
+}
+
+void CloneBall::remove()
+{
+    // 🔥 清除移动方向，确保球完全停止，防止"尸体漂移"
+    storeMoveDirection(QVector2D(0, 0));
+    setVelocity(QVector2D(0, 0));
     
-    // 调用基类的remove函数
+    // 调用基类的remove函数（隐藏，图元留给对象池复用）
     BaseBall::remove();
+}
+
+void CloneBall::retire()
+{
+    // 复用后这个对象会变成别的球，不能再留在父球/子球的分裂关系里
+    if (m_splitParent) {
+        m_splitParent->m_splitChildren.removeOne(this);
+        m_splitParent = nullptr;
+    }
+    for (CloneBall* child : m_splitChildren) {
+        if (child->m_splitParent == this) {
+            child->m_splitParent = nullptr;
+        }
+    }
+    m_splitChildren.clear();
     
-    qDebug() << "CloneBall" << ballId() << "removed and all timers stopped";
+    BaseBall::retire();
 }
@@ -2,11 +2,12 @@
 #define CLONEBALL_H
 
 #include "BaseBall.h"
-#include <QTimer>
 #include <QVector>
 
 class SporeBall; // 前向声明
 class ThornsBall; // 前向声明
+struct BallPools; // 前向声明
+class InputRecorder; // 前向声明
 
 class CloneBall : public BaseBall
 {
@@ -27,21 +28,36 @@ public:
         qreal scoreDecayMin = 26.0;        // 开始衰减的最小分数
         qreal scoreDecayRatePerFrame = 0.00005; // 每帧的分数衰减率
         qreal centerAccWeight = 10.0;      // 中心加速度权重
+        qreal tickDuration = 1.0 / 60.0;   // 逻辑帧长（秒），用来把秒换算成帧
+        BallPools* pools = nullptr;        // 分身/孢子优先从对象池复用（由GameManager提供）
+        int* nextBallId = nullptr;         // 分裂/喷射时从这里分配ID（由GameManager提供），否则退回临时ID
+        InputRecorder* recorder = nullptr; // 录制输入录像时记下玩家操作（由GameManager提供）
         
         Config() = default;
     };
 
     CloneBall(int ballId, const QPointF& position, const Border& border, int teamId, int playerId, 
-              const Config& config = Config(), QGraphicsItem* parent = nullptr);
+              const Config& config = Config(), QGraphicsItem* parent = nullptr,
+              std::shared_ptr<BallDataStorage> storage = nullptr);
     
     ~CloneBall();
+    
+    // 从对象池取出时重置为一个新的分身球
+    void reset(int ballId, const QPointF& position, int teamId, int playerId, const Config& config);
+    // 快照恢复：分裂关系不在数据里，先清空，数据全部覆盖完之后由restoreSplitLinks接回来
+    void restoreData(const char* record) override;
+    void restoreSplitLinks(CloneBall* parent, const QVector<CloneBall*>& children);
+    CloneBall* getSplitParent() const { return m_splitParent; }
+    QVector<CloneBall*> getSplitChildren() const { return m_splitChildren; }
 
     // 获取属性
-    int teamId() const { return m_teamId; }
-    int playerId() const { return m_playerId; }
+    int teamId() const { return m_data->teamId; }
+    int playerId() const { return m_data->playerId; }
     bool canSplit() const;
     bool canEject() const;
-    int frameSinceLastSplit() const { return m_frameSinceLastSplit; }
+    int frameSinceLastSplit() const { return cloneData().frameSinceLastSplit; }
+    QVector2D moveDirection() const { return QVector2D(cloneData().moveDirX, cloneData().moveDirY); }
+    const CloneBallData& cloneData() const { return *static_cast<const CloneBallData*>(m_data); }
     
     // 玩家操作
     void setMoveDirection(const QVector2D& direction);
@@ -68,7 +84,12 @@ public:
     void move(const QVector2D& direction, qreal duration) override;
     bool canEat(BaseBall* other) const override;
     void eat(BaseBall* other) override;
-    void remove() override;  // 🔥 重写remove函数以停止定时器
+    void remove() override;  // 🔥 重写remove函数以清除移动状态
+    void retire() override;  // 🔥 回收前断开分裂关系
+    
+    // 🔥 逐帧推进：由GameManager::updateBalls()在统一的帧调度里调用
+    void stepMovement(qreal deltaTime);   // 推进一帧移动，步长由调用方决定
+    void updateScoreDecay();
 
 signals:
     void splitPerformed(CloneBall* originalBall, const QVector<CloneBall*>& newBalls);
@@ -81,38 +102,33 @@ protected:
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
     void updatePhysics(qreal deltaTime) override;
 
-private slots:
-    void updateMovement();
-    void updateScoreDecay();
-
 private:
     Config m_config;
-    int m_teamId;
-    int m_playerId;
     
-    // 移动相关
-    QVector2D m_moveDirection;
-    QVector2D m_splitVelocity;
-    QVector2D m_splitVelocityPiece;
-    
-    // 分裂相关
-    int m_splitFrame;
-    int m_frameSinceLastSplit;
-    bool m_fromSplit;
-    bool m_fromThorns;
+    // 移动/分裂状态存放在CloneBallData里
+    CloneBallData* cloneBallData() { return static_cast<CloneBallData*>(m_data); }
+    void storeMoveDirection(const QVector2D& direction) { cloneBallData()->moveDirX = direction.x(); cloneBallData()->moveDirY = direction.y(); }
+    QVector2D splitVelocity() const { return QVector2D(cloneData().splitVelX, cloneData().splitVelY); }
+    void storeSplitVelocity(const QVector2D& v) { cloneBallData()->splitVelX = v.x(); cloneBallData()->splitVelY = v.y(); }
+    QVector2D splitVelocityPiece() const { return QVector2D(cloneData().splitVelPieceX, cloneData().splitVelPieceY); }
+    void storeSplitVelocityPiece(const QVector2D& v) { cloneBallData()->splitVelPieceX = v.x(); cloneBallData()->splitVelPieceY = v.y(); }
     
     // 分裂统一控制
     CloneBall* m_splitParent;        // 分裂来源的父球
     QVector<CloneBall*> m_splitChildren; // 分裂出的子球
     
-    // 定时器
-    QTimer* m_movementTimer;
-    QTimer* m_decayTimer;
-    
     // 初始化
-    void initializeTimers();
     void updateDirection();
     
+    // 分裂出的新球：对象池里有空闲的就复用，否则新建
+    CloneBall* spawnSplitBall(int ballId, const QPointF& position);
+    // 受管时从GameManager的ID序列分配（唯一且可复现），否则用调用方给的临时ID
+    int allocateBallId(int fallbackId);
+    // applyGoBiggerMovement的实际计算；内部的向心力也走这里，不算玩家操作，不录制
+    void accelerate(const QVector2D& playerInput, const QVector2D& centerForce);
+    // 分裂完成的通知：受管时记到帧事件缓冲区，否则发splitPerformed
+    void notifySplit(const QVector<CloneBall*>& newBalls);
+    
     // 分裂相关计算
     qreal calculateSplitVelocityFromSplit(qreal radius) const;
     qreal calculateSplitVelocityFromThorns(qreal radius) const;
@@ -121,8 +137,6 @@ private:
     
     // 分裂统一控制
     void setSplitParent(CloneBall* parent) { m_splitParent = parent; }
-    CloneBall* getSplitParent() const { return m_splitParent; }
-    QVector<CloneBall*> getSplitChildren() const { return m_splitChildren; }
     void propagateMovementToGroup(const QVector2D& direction);
     void addCenteringForce(CloneBall* target); // 新增：向心力方法
     void applyCenteringForce(); // 新增：应用向心力到自身
@@ -130,6 +144,9 @@ private:
     // 得分衰减
     void applyScoreDecay();
     
+    // 合并冷却（GoBiggerConfig::MERGE_DELAY秒）对应的逻辑帧数
+    int mergeDelayFrameCount() const;
+    
     // 团队颜色
     QColor getTeamColor(int teamId) const;
     
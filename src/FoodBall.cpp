@@ -1,29 +1,52 @@
 #include "FoodBall.h"
 #include "GoBiggerConfig.h"
-#include <QRandomGenerator>
+#include "core/SimRandom.h"
 #include <QDebug>
 #include <QDateTime> // 🔥 新增：用于时间戳
+#include <cstring>
 
-FoodBall::FoodBall(int ballId, const QPointF& position, const Border& border, const Config& config, QGraphicsItem* parent)
-    : BaseBall(ballId, position, GoBiggerConfig::FOOD_SCORE, border, FOOD_BALL, parent)
+FoodBall::FoodBall(int ballId, const QPointF& position, const Border& border, const Config& config,
+                   QGraphicsItem* parent, std::shared_ptr<BallDataStorage> storage)
+    : BaseBall(ballId, position, GoBiggerConfig::FOOD_SCORE, border, FOOD_BALL,
+               acquireBallData(storage ? &storage->foods : nullptr), storage, parent)
     , m_config(config)
-    , m_colorIndex(0)
-    , m_createdTime(QDateTime::currentMSecsSinceEpoch()) // 🔥 新增：记录创建时间
 {
+    initializeFood();
+}
+
+void FoodBall::reset(int ballId, const QPointF& position)
+{
+    *foodBallData() = FoodBallData(); // 清掉上一个食物留下的状态
+    reinitialize(ballId, position, GoBiggerConfig::FOOD_SCORE, FOOD_BALL);
+    initializeFood();
+}
+
+void FoodBall::restoreData(const char* record)
+{
+    std::memcpy(foodBallData(), record, sizeof(FoodBallData));
+    refreshProxy();
+}
+
+void FoodBall::initializeFood()
+{
+    foodBallData()->createdTimeMs = QDateTime::currentMSecsSinceEpoch(); // 🔥 新增：记录创建时间
+    
     // 使用GoBigger标准食物分数（固定100分）
     float minScore = GoBiggerConfig::FOOD_MIN_SCORE;
     float maxScore = GoBiggerConfig::FOOD_MAX_SCORE;
     
-    float randomScore = minScore + (maxScore - minScore) * QRandomGenerator::global()->generateDouble();
+    // 与荆棘一样只由ballId决定，保证可复现
+    float randomScore = minScore + (maxScore - minScore) * RandomStream(static_cast<quint64>(ballId())).generateDouble();
     setScore(randomScore);
     
     generateColorIndex();
+    syncGraphics();
 }
 
 // 🔥 新增：生命周期管理方法实现
 qint64 FoodBall::getAge() const
 {
-    return QDateTime::currentMSecsSinceEpoch() - m_createdTime;
+    return QDateTime::currentMSecsSinceEpoch() - foodData().createdTimeMs;
 }
 
 bool FoodBall::isStale(qint64 maxAgeMs) const
@@ -58,13 +81,13 @@ void FoodBall::eat(BaseBall* other)
 
 QColor FoodBall::getBallColor() const
 {
-    return GoBiggerConfig::getStaticFoodColor(m_colorIndex);
+    return GoBiggerConfig::getStaticFoodColor(foodData().colorIndex);
 }
 
 void FoodBall::generateColorIndex()
 {
     // 简单高效：基于ballId生成固定的颜色索引，避免随机数生成开销
-    m_colorIndex = ballId() % 4;
+    foodBallData()->colorIndex = ballId() % 4;
 }
 
 void FoodBall::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
@@ -15,12 +15,24 @@ public:
         Config() = default;
     };
 
-    FoodBall(int ballId, const QPointF& position, const Border& border, const Config& config = Config(), QGraphicsItem* parent = nullptr);
+    FoodBall(int ballId, const QPointF& position, const Border& border, const Config& config = Config(),
+             QGraphicsItem* parent = nullptr, std::shared_ptr<BallDataStorage> storage = nullptr);
+    
+    // 从对象池取出时重置为一个新生成的食物
+    void reset(int ballId, const QPointF& position);
+    void restoreData(const char* record) override;
+    
+    const FoodBallData& foodData() const { return *static_cast<const FoodBallData*>(m_data); }
     
     // 🔥 新增：食物生命周期管理
-    qint64 getCreatedTime() const { return m_createdTime; }
+    qint64 getCreatedTime() const { return foodData().createdTimeMs; }
     qint64 getAge() const; // 获取食物年龄（毫秒）
     bool isStale(qint64 maxAgeMs) const; // 检查是否过期
+    
+    // 🔥 按帧计算的生命周期（固定步长模拟使用，与墙钟时间无关）
+    qint64 createdFrame() const { return foodData().createdFrame; }
+    void setCreatedFrame(qint64 frame) { foodBallData()->createdFrame = frame; }
+    bool isStaleAtFrame(qint64 currentFrame, qint64 maxAgeFrames) const { return foodData().isStaleAtFrame(currentFrame, maxAgeFrames); }
 
     // 重写基类方法
     void move(const QVector2D& direction, qreal duration) override;
@@ -32,10 +44,10 @@ protected:
 
 private:
     Config m_config;
-    int m_colorIndex;  // 使用颜色索引而非QColor对象，节省内存
-    qint64 m_createdTime; // 🔥 新增：食物创建时间戳
     
+    FoodBallData* foodBallData() { return static_cast<FoodBallData*>(m_data); }
     void generateColorIndex();
+    void initializeFood();
 };
 
 #endif // FOODBALL_H
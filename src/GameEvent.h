@@ -0,0 +1,49 @@
+#ifndef GAMEEVENT_H
+#define GAMEEVENT_H
+
+#include <QVector>
+
+class BaseBall;
+
+// 一个逻辑帧内发生的游戏事件
+// 吞噬、分裂、合并、喷射、吃荆棘和移除都只往缓冲区里追加一条记录，不再逐个发Qt信号，
+// GameManager在帧末按顺序统一应用（注册新球、登记移除、提交分数），再把整批事件一次分发给视图和AI
+struct GameEvent {
+    enum Type {
+        EAT,         // subject吃掉other，score为获得的分数
+        SPLIT,       // subject分裂出other（一次分裂出多个球时每个新球一条，连续存放）
+        MERGE,       // subject合并了other（other随后还会有一条REMOVED）
+        EJECT,       // subject喷出孢子other
+        THORNS_HIT,  // subject吃掉荆棘other
+        REMOVED      // subject被吃掉/合并/过期
+    };
+
+    Type type = EAT;
+    BaseBall* subject = nullptr;
+    BaseBall* other = nullptr;
+    float score = 0.0f;
+};
+
+// 每帧的事件缓冲区，由GameManager持有，受管的球通过setEventBuffer()拿到它的指针
+// 分发时把整块数组换出去，缓冲区本身不重新分配
+class GameEventBuffer
+{
+public:
+    void record(GameEvent::Type type, BaseBall* subject, BaseBall* other = nullptr, float score = 0.0f)
+    {
+        m_events.append(GameEvent{type, subject, other, score});
+    }
+
+    bool isEmpty() const { return m_events.isEmpty(); }
+    int size() const { return m_events.size(); }
+    const QVector<GameEvent>& events() const { return m_events; }
+
+    // 与调用方的数组交换（调用方传入清空过的数组，容量得以复用）
+    void swap(QVector<GameEvent>& other) { m_events.swap(other); }
+    void clear() { m_events.clear(); }
+
+private:
+    QVector<GameEvent> m_events;
+};
+
+#endif // GAMEEVENT_H
@@ -6,33 +6,69 @@
 #include "GoBiggerConfig.h"
 #include "QuadTree.h"
 #include "SimpleAIPlayer.h"
+#include "core/Trace.h"
+#include "core/InputReplay.h"
 #include <QGraphicsScene>
 #include <QDebug>
+#include <QThread>
 #include <cmath>
+#include <cstring>
 #include <memory>
 
+namespace {
+    // 玩家球的帧数换算要和逻辑帧长一致，分裂/喷射时从对象池复用，新球沿用GameManager的ID序列，
+    // 玩家操作交给输入录像（没在录制时直接跳过）
+    CloneBall::Config cloneBallConfig(const GameManager::Config& gameConfig, BallPools* pools, int* nextBallId,
+                                      InputRecorder* recorder)
+    {
+        CloneBall::Config config;
+        config.tickDuration = gameConfig.tickDuration;
+        config.pools = gameConfig.ballPoolCapacity > 0 ? pools : nullptr;
+        config.nextBallId = nextBallId;
+        config.recorder = recorder;
+        return config;
+    }
+    
+    // 快照里的配置块（与输入录像同一种编码），读不全的字段保持config原来的值
+    bool readSnapshotConfig(const WorldSnapshot& snapshot, GameManager::Config& config)
+    {
+        const QByteArray block(snapshot.section(WorldSnapshot::ConfigBlock), snapshot.sectionSize(WorldSnapshot::ConfigBlock));
+        ReplayFormat::Reader reader(block);
+        return ReplayFormat::readConfig(reader, config);
+    }
+}
+
 GameManager::GameManager(QGraphicsScene* scene, const Config& config, QObject* parent)
     : QObject(parent)
     , m_scene(scene)
     , m_config(config)
     , m_gameRunning(false)
-    , m_gameTimer(nullptr)
-    , m_foodTimer(nullptr)
-    , m_thornsTimer(nullptr)
-    , m_foodCleanupTimer(nullptr) // 🔥 新增：初始化食物清理定时器
+    , m_scheduler(new TickScheduler(this))
     , m_nextBallId(1)
+    , m_random(m_config.seed != 0 ? m_config.seed : SimRandom::entropySeed())
     , m_foodRefreshFrameCount(0)
     , m_thornsRefreshFrameCount(0)
     , m_foodCleanupIndex(0) // 🔥 新增：初始化清理索引
     , m_defaultAIModelPath("assets/ai_models/exported_models/ai_model_traced.pt")
+    , m_frameCount(0)
+    , m_ballData(std::make_shared<BallDataStorage>())
+    , m_queryStamp(0)
+    , m_dataReorderCursor(0)
+    , m_collisionThreads(m_config.collisionThreads > 0 ? m_config.collisionThreads : qMax(1, QThread::idealThreadCount()))
+    , m_turboRenderEveryTicks(0)
 {
-    // 初始化四叉树 - 使用游戏边界
+    // 初始化粗测空间索引 - 使用游戏边界
     QRectF bounds(m_config.gameBorder.minx, m_config.gameBorder.miny,
                   m_config.gameBorder.maxx - m_config.gameBorder.minx,
                   m_config.gameBorder.maxy - m_config.gameBorder.miny);
-    m_quadTree = std::make_unique<QuadTree>(bounds, 6, 8); // 最大深度6，每节点最多8个球
+    m_broadphase = Broadphase::create(m_config.broadphaseType, bounds, m_config.gridCellSize);
+    
+    // 碰撞检测线程池：主线程自己也处理一块，所以少开一个
+    m_collisionPool.setMaxThreadCount(qMax(1, m_collisionThreads - 1));
+    
+    m_ballPools.setCapacity(m_config.ballPoolCapacity);
     
-    initializeTimers();
+    initializeScheduler();
 }
 
 GameManager::~GameManager()
@@ -46,57 +82,34 @@ GameManager::~GameManager()
     }
     m_aiPlayers.clear();
     
+    m_scheduler->stop();
     clearAllBalls();
-    
-    if (m_gameTimer) {
-        m_gameTimer->stop();
-        delete m_gameTimer;
-    }
-    if (m_foodTimer) {
-        m_foodTimer->stop();
-        delete m_foodTimer;
-    }
-    if (m_thornsTimer) {
-        m_thornsTimer->stop();
-        delete m_thornsTimer;
-    }
-    
-    // 🔥 新增：清理食物清理定时器
-    if (m_foodCleanupTimer) {
-        m_foodCleanupTimer->stop();
-        delete m_foodCleanupTimer;
-    }
 }
 
 void GameManager::startGame()
 {
     if (!m_gameRunning) {
         m_gameRunning = true;
-        m_gameTimer->start();
-        m_foodTimer->start();
-        m_thornsTimer->start();
-        m_foodCleanupTimer->start(); // 🔥 新增：启动食物清理定时器
-        
-        // GoBigger风格初始化：生成初始数量的食物
-        for (int i = 0; i < m_config.initFoodCount; ++i) {
-            QPointF pos = generateRandomFoodPosition();
-            FoodBall* food = new FoodBall(getNextBallId(), pos, m_config.gameBorder);
-            addBall(food);
+        m_inputRecorder.recordStart();
+        if (!m_config.manualTick) {
+            m_scheduler->start(m_config.gameUpdateInterval);
         }
         
-        // GoBigger风格初始化：生成初始数量的荆棘球
+        // GoBigger风格初始化：生成初始数量的食物和荆棘球，一次性批量加入
+        QVector<BaseBall*> initialBalls = createFoodBalls(m_config.initFoodCount);
+        initialBalls.reserve(initialBalls.size() + m_config.initThornsCount);
         for (int i = 0; i < m_config.initThornsCount; ++i) {
-            QPointF pos = generateRandomThornsPosition();
-            int score = m_config.thornsScoreMin + 
-                       QRandomGenerator::global()->bounded(m_config.thornsScoreMax - m_config.thornsScoreMin + 1);
-            ThornsBall* thorns = new ThornsBall(getNextBallId(), pos, m_config.gameBorder);
-            thorns->setScore(score);
-            addBall(thorns);
-            qDebug() << "Created thorns ball" << thorns->ballId() << "at" << pos << "with score" << score;
+            ThornsBall* thorns = createThornsBall(generateRandomThornsPosition());
+            initialBalls.append(thorns);
+            qDebug() << "Created thorns ball" << thorns->ballId() << "at" << thorns->position() << "with score" << thorns->score();
         }
         
+        // 初始球体数量远多于已有的玩家球，addBalls会整体重建一次空间索引
+        addBalls(initialBalls);
+        
         emit gameStarted();
-        qDebug() << "Game started with" << m_config.initFoodCount << "initial food balls and" << m_config.initThornsCount << "initial thorns balls";
+        qDebug() << "Game started with" << m_config.initFoodCount << "initial food balls and" << m_config.initThornsCount << "initial thorns balls"
+                 << "seed" << m_random.seed();
     }
 }
 
@@ -104,17 +117,15 @@ void GameManager::pauseGame()
 {
     if (m_gameRunning) {
         m_gameRunning = false;
-        m_gameTimer->stop();
-        m_foodTimer->stop();
-        m_thornsTimer->stop();
-        m_foodCleanupTimer->stop(); // 🔥 新增：停止食物清理定时器
+        m_inputRecorder.recordPause();
+        m_scheduler->stop(); // 所有球都由调度器推进，停掉它就停住了整个世界
         
         emit gamePaused();
         qDebug() << "Game paused";
     }
 }
 
-void GameManager::resetGame()
+void GameManager::resetGame(quint64 seed)
 {
     pauseGame();
     clearAllBalls();
@@ -122,6 +133,15 @@ void GameManager::resetGame()
     m_foodRefreshFrameCount = 0;  // 重置食物刷新计数器
     m_thornsRefreshFrameCount = 0; // 重置荆棘刷新计数器
     m_foodCleanupIndex = 0; // 🔥 新增：重置食物清理索引
+    m_frameCount = 0;
+    m_scheduler->resetTickCount();
+    m_profiler.reset();
+    // 指定了种子就用它；否则固定种子时重放同一局，不固定时换一个新种子
+    if (seed == 0) {
+        seed = m_config.seed != 0 ? m_config.seed : SimRandom::entropySeed();
+    }
+    m_random.reseed(seed);
+    m_inputRecorder.recordReset(m_random.seed());
     
     emit gameReset();
     qDebug() << "Game reset";
@@ -132,7 +152,7 @@ CloneBall* GameManager::createPlayer(int teamId, int playerId, const QPointF& po
     qDebug() << "🔨 createPlayer called: teamId=" << teamId << "playerId=" << playerId;
     
     // 🔥 修复：更严格的重复创建检查，防止人类玩家被重复创建
-    for (CloneBall* player : m_players) {
+    for (CloneBall* player : m_registry.clones()) {
         if (player && !player->isRemoved() && 
             player->teamId() == teamId && player->playerId() == playerId) {
             qDebug() << "🔨 Player already exists:" << teamId << playerId << "- returning existing player";
@@ -147,15 +167,14 @@ CloneBall* GameManager::createPlayer(int teamId, int playerId, const QPointF& po
         spawnPos,
         m_config.gameBorder,
         teamId,
-        playerId
+        playerId,
+        cloneBallConfig(m_config, &m_ballPools, &m_nextBallId, &m_inputRecorder),
+        nullptr,
+        m_ballData
     );
     
-    addBall(player);
-    m_players.append(player);
-    
-    // 连接玩家特有的信号
-    connect(player, &CloneBall::splitPerformed, this, &GameManager::handlePlayerSplit);
-    connect(player, &CloneBall::sporeEjected, this, &GameManager::handleSporeEjected);
+    addBall(player); // 分裂/喷射等事件通过帧事件缓冲区处理
+    m_inputRecorder.recordJoin(teamId, playerId, position);
     
     emit playerAdded(player);
     qDebug() << "🔨 Player created: teamId=" << teamId << "playerId=" << playerId 
@@ -166,8 +185,7 @@ CloneBall* GameManager::createPlayer(int teamId, int playerId, const QPointF& po
 
 void GameManager::removePlayer(CloneBall* player)
 {
-    if (player && m_players.contains(player)) {
-        m_players.removeOne(player);
+    if (player && m_registry.contains(player)) {
         removeBall(player);
         
         emit playerRemoved(player);
@@ -175,9 +193,17 @@ void GameManager::removePlayer(CloneBall* player)
     }
 }
 
+void GameManager::setPlayerScore(CloneBall* player, float score)
+{
+    if (!player) return;
+    
+    player->setScore(score);
+    m_inputRecorder.recordScore(player->ballId(), score);
+}
+
 CloneBall* GameManager::getPlayer(int teamId, int playerId) const
 {
-    for (CloneBall* player : m_players) {
+    for (CloneBall* player : m_registry.clones()) {
         if (player->teamId() == teamId && player->playerId() == playerId) {
             return player;
         }
@@ -189,78 +215,84 @@ void GameManager::addBall(BaseBall* ball)
 {
     if (!ball) return;
     
-    m_allBalls.insert(ball->ballId(), ball);
+    // 注册表按类型分段存放，分身球段就是玩家球列表
+    m_registry.add(ball);
+    m_broadphase->insert(ball);
     
-    // 根据类型添加到相应的列表
-    switch (ball->ballType()) {
-        case BaseBall::CLONE_BALL:
-            // 玩家球已在createPlayer中处理
-            break;
-        case BaseBall::FOOD_BALL:
-            m_foodBalls.append(static_cast<FoodBall*>(ball));
-            break;
-        case BaseBall::SPORE_BALL:
-            m_sporeBalls.append(static_cast<SporeBall*>(ball));
-            break;
-        case BaseBall::THORNS_BALL:
-            m_thornsBalls.append(static_cast<ThornsBall*>(ball));
-            break;
-    }
-    
-    // 添加到场景
-    if (m_scene && !m_scene->items().contains(ball)) {
+    // 添加到场景（从对象池复用的球图元还在场景里）
+    if (m_scene && ball->scene() != m_scene) {
         m_scene->addItem(ball);
     }
     
-    // 连接信号
-    connectBallSignals(ball);
+    // 挂上帧事件缓冲区
+    attachBall(ball);
     
     emit ballAdded(ball);
 }
 
-void GameManager::removeBall(BaseBall* ball)
+void GameManager::addBalls(const QVector<BaseBall*>& balls)
 {
-    if (!ball) return;
+    if (balls.isEmpty()) return;
     
-    m_allBalls.remove(ball->ballId());
+    // 新球不少于已索引的球时（开局/重置后的初始生成）整体重建一次，比逐个插入快，
+    // 网格也能按实际半径分布重新调整格子大小
+    const bool rebuildIndex = balls.size() >= m_broadphase->ballCount();
     
-    // 从相应的列表中移除
-    switch (ball->ballType()) {
-        case BaseBall::CLONE_BALL:
-            // 玩家球在removePlayer中处理
-            break;
-        case BaseBall::FOOD_BALL:
-            m_foodBalls.removeOne(static_cast<FoodBall*>(ball));
-            break;
-        case BaseBall::SPORE_BALL:
-            m_sporeBalls.removeOne(static_cast<SporeBall*>(ball));
-            break;
-        case BaseBall::THORNS_BALL:
-            m_thornsBalls.removeOne(static_cast<ThornsBall*>(ball));
-            break;
+    m_registry.reserve(m_registry.size() + balls.size());
+    for (BaseBall* ball : balls) {
+        if (!ball) continue;
+        
+        m_registry.add(ball);
+        if (!rebuildIndex) {
+            m_broadphase->insert(ball);
+        }
+        
+        // 场景归属直接看图元自己的scene()，不去搜索场景的图元列表
+        if (m_scene && ball->scene() != m_scene) {
+            m_scene->addItem(ball);
+        }
+        
+        attachBall(ball);
     }
     
-    // 断开信号
-    disconnectBallSignals(ball);
+    if (rebuildIndex) {
+        m_broadphase->rebuild(m_registry.all());
+    }
     
-    // 从场景中移除
-    removeFromScene(ball);
+    emit ballsAdded(balls);
+}
+
+void GameManager::removeBall(BaseBall* ball)
+{
+    if (!ball) return;
+    
+    // 交换删除，O(类型数)
+    m_registry.remove(ball);
+    m_broadphase->remove(ball);
+    
+    // 摘掉帧事件缓冲区
+    detachBall(ball);
+    
+    // 从场景中移除（被吃掉的球已经隐藏，图元留在场景里等对象池复用）
+    if (!ball->isRemoved()) {
+        removeFromScene(ball);
+    }
     
     emit ballRemoved(ball);
 }
 
-QVector<BaseBall*> GameManager::getAllBalls() const
+QVector<CloneBall*> GameManager::getPlayers() const
 {
-    return m_allBalls.values().toVector();
+    return m_registry.clones().toVector();
 }
 
 QVector<BaseBall*> GameManager::getBallsNear(const QPointF& position, qreal radius) const
 {
     QVector<BaseBall*> nearbyBalls;
     
-    for (BaseBall* ball : m_allBalls) {
+    for (BaseBall* ball : m_registry.all()) {
         if (ball && !ball->isRemoved()) {
-            QPointF ballPos = ball->pos();
+            QPointF ballPos = ball->position();
             qreal distance = std::sqrt(std::pow(position.x() - ballPos.x(), 2) + 
                                       std::pow(position.y() - ballPos.y(), 2));
             if (distance <= radius) {
@@ -278,20 +310,10 @@ QVector<BaseBall*> GameManager::getBallsInRect(const QRectF& rect) const
 {
     QVector<BaseBall*> ballsInRect;
     
-    // 遍历所有球，只返回在指定矩形区域内的球
-    for (auto it = m_allBalls.constBegin(); it != m_allBalls.constEnd(); ++it) {
-        BaseBall* ball = it.value();
-        if (ball && !ball->isRemoved()) {
-            QPointF ballPos = ball->pos();
-            // 考虑球的半径，使用包含球心+半径的检查
-            QRectF ballRect(ballPos.x() - ball->radius(), ballPos.y() - ball->radius(),
-                           2 * ball->radius(), 2 * ball->radius());
-            
-            if (rect.intersects(ballRect)) {
-                ballsInRect.append(ball);
-            }
-        }
-    }
+    // 通过空间索引只访问与矩形相交的球（包围盒包含半径），不再遍历所有球
+    m_broadphase->forEachInRange(rect, [&ballsInRect](BaseBall* ball) {
+        ballsInRect.append(ball);
+    });
     
     return ballsInRect;
 }
@@ -301,9 +323,9 @@ QVector<FoodBall*> GameManager::getFoodBallsInRect(const QRectF& rect) const
     QVector<FoodBall*> foodInRect;
     
     // 只遍历食物球，提升性能
-    for (FoodBall* food : m_foodBalls) {
+    for (FoodBall* food : m_registry.foods()) {
         if (food && !food->isRemoved()) {
-            QPointF foodPos = food->pos();
+            QPointF foodPos = food->position();
             // 食物球通常较小，可以简化检查
             if (rect.contains(foodPos)) {
                 foodInRect.append(food);
@@ -319,7 +341,7 @@ QMap<int, float> GameManager::getAllTeamScores() const
     QMap<int, float> teamScores;
     
     // 遍历所有玩家球，按队伍ID累加分数
-    for (CloneBall* player : m_players) {
+    for (CloneBall* player : m_registry.clones()) {
         if (player && !player->isRemoved()) {
             int teamId = player->teamId();
             float score = player->score();
@@ -327,85 +349,156 @@ QMap<int, float> GameManager::getAllTeamScores() const
         }
     }
     
-    // 输出每个队伍的总分数和球数统计（简化版）
-    static int debugCounter = 0;
-    if (++debugCounter % 60 == 0) { // 每秒输出一次
-        for (auto it = teamScores.begin(); it != teamScores.end(); ++it) {
-            int teamId = it.key();
-            float totalScore = it.value();
-            
-            // 统计该队伍的球数
-            int ballCount = 0;
-            for (CloneBall* player : m_players) {
-                if (player && !player->isRemoved() && player->teamId() == teamId) {
-                    ballCount++;
-                }
-            }
-            
-            qDebug() << "🏆 Team" << teamId << "Score:" << static_cast<int>(totalScore) 
-                     << "Balls:" << ballCount;
-        }
+    // 每次取观测都会调到这里，只走追踪（关闭时一次原子读）
+    for (auto it = teamScores.cbegin(); it != teamScores.cend(); ++it) {
+        GB_TRACE(Score, Verbose, "team score team/score", it.key(), it.value());
     }
     
     return teamScores;
 }
 
-void GameManager::initializeTimers()
+void GameManager::initializeScheduler()
+{
+    // 每帧的固定阶段顺序：先推进各球，再做碰撞/合并/清理，最后补充食物和荆棘
+    m_scheduler->addPhase(PHASE_AI, "ai", [this]() { PROFILE_SCOPE(&m_profiler, AI); updateAIPlayers(); });
+    m_scheduler->addPhase(PHASE_BALLS, "balls", [this]() { PROFILE_SCOPE(&m_profiler, Movement); updateBalls(); });
+    m_scheduler->addPhase(PHASE_GAME, "game", [this]() { updateGame(); }); // 内部按子阶段计时
+    m_scheduler->addPhase(PHASE_SPAWN, "food", [this]() { PROFILE_SCOPE(&m_profiler, Spawning); spawnFood(); });     // spawnFood内部按帧数控制频率
+    m_scheduler->addPhase(PHASE_SPAWN, "thorns", [this]() { PROFILE_SCOPE(&m_profiler, Spawning); spawnThorns(); }); // spawnThorns内部按帧数控制频率
+    
+    // 🔥 食物清理原本是15秒一次的定时器，这里换算成帧
+    m_scheduler->addPhase(PHASE_CLEANUP, "cleanup", [this]() { PROFILE_SCOPE(&m_profiler, Removal); cleanupStaleFood(); },
+                          msToTicks(m_config.foodCleanupIntervalMs));
+    
+    // 插值渲染：每帧开始前先记下上一帧的位置
+    if (m_scene && m_config.interpolateRendering) {
+        m_scheduler->addPhase(PHASE_SNAPSHOT, "snapshot", [this]() { storePreviousPositions(); });
+    }
+    m_scheduler->setFixedStep(m_config.tickDuration);
+    
+    // 🔥 分阶段计时：整帧超出预算时连同实体数一起抓快照
+    m_profiler.setBudgetMs(m_config.tickBudgetMs > 0.0 ? m_config.tickBudgetMs : m_config.tickDuration * 1000.0);
+    m_profiler.setEntityCounter([this]() {
+        FrameProfiler::EntityCounts counts;
+        counts.clones = m_registry.count(BaseBall::CLONE_BALL);
+        counts.foods = m_registry.count(BaseBall::FOOD_BALL);
+        counts.spores = m_registry.count(BaseBall::SPORE_BALL);
+        counts.thorns = m_registry.count(BaseBall::THORNS_BALL);
+        counts.aiPlayers = m_aiPlayers.size();
+        return counts;
+    });
+    m_scheduler->setProfiler(&m_profiler);
+}
+
+QString GameManager::collisionBackendInfo() const
+{
+    return QString("%1 %2 | SIMD %3")
+        .arg(QString::fromLatin1(m_broadphase->name()), m_broadphase->statistics(),
+             QString::fromLatin1(NarrowPhase::simdLevel()));
+}
+
+void GameManager::storePreviousPositions()
+{
+    // 食物不会移动，构造时记下的位置一直有效
+    for (CloneBall* player : m_registry.clones()) {
+        player->storePreviousPosition();
+    }
+    for (SporeBall* spore : m_registry.spores()) {
+        spore->storePreviousPosition();
+    }
+    for (ThornsBall* thorns : m_registry.thorns()) {
+        thorns->storePreviousPosition();
+    }
+}
+
+void GameManager::updateAIPlayers()
 {
-    // 游戏更新定时器
-    m_gameTimer = new QTimer(this);
-    connect(m_gameTimer, &QTimer::timeout, this, &GameManager::updateGame);
-    m_gameTimer->setInterval(m_config.gameUpdateInterval);
+    if (m_aiPlayers.isEmpty()) return;
     
-    // 食物生成定时器 (GoBigger风格：基于帧数而非固定时间)
-    m_foodTimer = new QTimer(this);
-    connect(m_foodTimer, &QTimer::timeout, this, &GameManager::spawnFood);
-    m_foodTimer->setInterval(m_config.gameUpdateInterval); // 与游戏更新同频，在spawnFood内部按帧数控制
+    // 拷贝一份：决策过程中球被吃掉会触发AI移除
+    const qreal elapsedMs = m_config.tickDuration * 1000.0;
+    const auto aiPlayers = m_aiPlayers;
+    for (auto aiPlayer : aiPlayers) {
+        if (aiPlayer) {
+            aiPlayer->advanceDecisionClock(elapsedMs);
+        }
+    }
+}
+
+void GameManager::setSimulationSpeed(qreal multiplier)
+{
+    m_scheduler->setSpeedMultiplier(multiplier);
+    qDebug() << "Simulation speed set to" << m_scheduler->speedMultiplier() << "x";
+    emit simulationSpeedChanged(m_scheduler->speedMultiplier(), m_scheduler->isTurbo());
+}
+
+void GameManager::setTurboMode(bool enabled, int renderEveryTicks)
+{
+    m_turboRenderEveryTicks = qMax(0, renderEveryTicks);
     
-    // 荆棘生成定时器 (GoBigger风格：基于帧数)
-    m_thornsTimer = new QTimer(this);
-    connect(m_thornsTimer, &QTimer::timeout, this, &GameManager::spawnThorns);
-    m_thornsTimer->setInterval(m_config.gameUpdateInterval); // 与游戏更新同频，在spawnThorns内部按帧数控制
+    if (enabled != m_scheduler->isTurbo()) {
+        m_scheduler->setTurbo(enabled);
+        
+        // 退出加速模式时场景可能已经落后很多帧，先整体同步一次，插值也从当前位置重新开始
+        if (!enabled) {
+            storePreviousPositions();
+            syncGraphics(1.0);
+        }
+        
+        qDebug() << "Turbo mode" << (enabled ? "enabled" : "disabled")
+                 << "render every" << m_turboRenderEveryTicks << "ticks";
+    }
     
-    // 🔥 新增：食物清理定时器
-    m_foodCleanupTimer = new QTimer(this);
-    connect(m_foodCleanupTimer, &QTimer::timeout, this, &GameManager::cleanupStaleFood);
-    m_foodCleanupTimer->setInterval(m_config.foodCleanupIntervalMs);
+    emit simulationSpeedChanged(m_scheduler->speedMultiplier(), m_scheduler->isTurbo());
 }
 
-void GameManager::connectBallSignals(BaseBall* ball)
+void GameManager::syncGraphics(qreal alpha)
 {
-    if (!ball) return;
-    
-    connect(ball, &BaseBall::ballRemoved, this, &GameManager::handleBallRemoved);
+    if (!m_scene) return;
     
-    // 连接特定类型的信号
-    if (ball->ballType() == BaseBall::THORNS_BALL) {
-        ThornsBall* thorns = static_cast<ThornsBall*>(ball);
-        connect(thorns, &ThornsBall::thornsCollision, this, &GameManager::handleThornsCollision);
-    } else if (ball->ballType() == BaseBall::CLONE_BALL) {
-        CloneBall* clone = static_cast<CloneBall*>(ball);
-        connect(clone, &CloneBall::splitPerformed, this, &GameManager::handlePlayerSplit);
-        connect(clone, &CloneBall::sporeEjected, this, &GameManager::handleSporeEjected);
-        connect(clone, &CloneBall::thornsEaten, this, &GameManager::handleThornsEaten);
+    for (BaseBall* ball : m_registry.all()) {
+        if (ball && !ball->isRemoved()) {
+            ball->syncGraphics(alpha);
+        }
     }
 }
 
-void GameManager::disconnectBallSignals(BaseBall* ball)
+int GameManager::msToTicks(int ms) const
+{
+    return qMax(1, qRound(ms / (m_config.tickDuration * 1000.0)));
+}
+
+
+void GameManager::tick()
+{
+    if (!m_gameRunning) return;
+    
+    m_scheduler->tick();
+}
+
+void GameManager::attachBall(BaseBall* ball)
+{
+    if (!ball) return;
+    
+    // 🔥 不再给每个球connect一串信号：吞噬/分裂/合并/喷射/移除都记到帧事件缓冲区，帧末统一处理
+    ball->setEventBuffer(&m_events);
+}
+
+void GameManager::detachBall(BaseBall* ball)
 {
     if (!ball) return;
     
-    disconnect(ball, nullptr, this, nullptr);
+    ball->setEventBuffer(nullptr);
 }
 
 QPointF GameManager::generateRandomPosition() const
 {
-    QRandomGenerator* rng = QRandomGenerator::global();
+    RandomStream& rng = m_random.stream(SimRandom::Spawn);
     
     qreal x = m_config.gameBorder.minx + 
-              (m_config.gameBorder.maxx - m_config.gameBorder.minx) * rng->generateDouble();
+              (m_config.gameBorder.maxx - m_config.gameBorder.minx) * rng.generateDouble();
     qreal y = m_config.gameBorder.miny + 
-              (m_config.gameBorder.maxy - m_config.gameBorder.miny) * rng->generateDouble();
+              (m_config.gameBorder.maxy - m_config.gameBorder.miny) * rng.generateDouble();
     
     return QPointF(x, y);
 }
@@ -415,6 +508,44 @@ QPointF GameManager::generateRandomFoodPosition() const
     return generateRandomPosition();
 }
 
+FoodBall* GameManager::createFoodBall(const QPointF& position)
+{
+    FoodBall* food = m_ballPools.foods.acquire();
+    if (food) {
+        food->reset(getNextBallId(), position);
+    } else {
+        food = new FoodBall(getNextBallId(), position, m_config.gameBorder, FoodBall::Config(), nullptr, m_ballData);
+    }
+    food->setCreatedFrame(m_frameCount); // 按帧记录出生时间，用于过期清理
+    return food;
+}
+
+QVector<BaseBall*> GameManager::createFoodBalls(int count)
+{
+    QVector<BaseBall*> foods;
+    if (count <= 0) return foods;
+    
+    // 池里不够的部分要新建，先把数据存储扩到位，避免逐个追加时反复搬移
+    const int newCount = qMax(0, count - m_ballPools.foods.size());
+    m_ballData->foods.reserve(m_ballData->foods.size() + newCount);
+    
+    foods.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        foods.append(createFoodBall(generateRandomFoodPosition()));
+    }
+    return foods;
+}
+
+ThornsBall* GameManager::createThornsBall(const QPointF& position)
+{
+    // 使用GoBigger标准的分数范围
+    int score = m_config.thornsScoreMin + 
+               m_random.stream(SimRandom::Thorns).bounded(static_cast<int>(m_config.thornsScoreMax - m_config.thornsScoreMin) + 1);
+    ThornsBall* thorns = new ThornsBall(getNextBallId(), position, m_config.gameBorder, ThornsBall::Config(), nullptr, m_ballData);
+    thorns->setScore(score);
+    return thorns;
+}
+
 QPointF GameManager::generateRandomThornsPosition() const
 {
     // 荆棘生成位置避开玩家球附近
@@ -426,10 +557,10 @@ QPointF GameManager::generateRandomThornsPosition() const
         pos = generateRandomPosition();
         bool tooClose = false;
         
-        for (CloneBall* player : m_players) {
+        for (CloneBall* player : m_registry.clones()) {
             if (player && !player->isRemoved()) {
-                qreal distance = std::sqrt(std::pow(pos.x() - player->pos().x(), 2) + 
-                                          std::pow(pos.y() - player->pos().y(), 2));
+                qreal distance = std::sqrt(std::pow(pos.x() - player->position().x(), 2) + 
+                                          std::pow(pos.y() - player->position().y(), 2));
                 if (distance < 100.0) { // 至少距离玩家100像素
                     tooClose = true;
                     break;
@@ -444,26 +575,79 @@ QPointF GameManager::generateRandomThornsPosition() const
     return pos;
 }
 
-void GameManager::updateGame()
+void GameManager::updateBalls()
 {
     if (!m_gameRunning) return;
     
-    // 更新所有球的物理状态
-    qreal deltaTime = 1.0 / 60.0; // 60 FPS
+    // 分数衰减原本由100ms定时器触发，这里按帧数换算
+    const bool decayFrame = (m_frameCount % msToTicks(GoBiggerConfig::DECAY_INTERVAL_MS)) == 0;
     
-    for (BaseBall* ball : m_allBalls) {
-        if (ball && !ball->isRemoved()) {
-            // 让每个球自己更新移动（对于孢子球和荆棘球很重要）
-            if (ball->ballType() == BaseBall::SPORE_BALL) {
-                SporeBall* spore = static_cast<SporeBall*>(ball);
-                spore->move(QVector2D(0, 0), deltaTime); // 孢子使用自己的移动逻辑
+    // 合并/寿命结束只是登记待移除，帧末才注销，遍历期间注册表不会搬动
+    for (CloneBall* player : m_registry.clones()) {
+        if (player && !player->isRemoved()) {
+            player->stepMovement(m_config.tickDuration);
+            if (decayFrame && !player->isRemoved()) {
+                player->updateScoreDecay();
             }
-            // 🔥 荆棘球也需要更新移动状态（吃孢子后的滑行）
-            else if (ball->ballType() == BaseBall::THORNS_BALL) {
-                ThornsBall* thorns = static_cast<ThornsBall*>(ball);
-                thorns->move(QVector2D(0, 0), deltaTime); // 荆棘球更新移动状态
+        }
+    }
+    
+    for (SporeBall* spore : m_registry.spores()) {
+        if (spore && !spore->isRemoved()) {
+            spore->updateLifetime();
+        }
+    }
+}
+
+void GameManager::reorderBallData()
+{
+    // 按Z序重排后，遍历密集的食物区或从空间索引取候选者时内存访问基本是顺序的。
+    // 注册表里同一种球的段按同样的Z序重排，updateGame和各个范围遍历顺着数据存储走，而不是在里面来回跳。
+    // 每次只排一种球，把开销分摊到多帧；已经有序的会直接跳过
+    const Border& border = m_config.gameBorder;
+    const float minx = border.minx;
+    const float miny = border.miny;
+    const float maxx = border.maxx;
+    const float maxy = border.maxy;
+    
+    BaseBall::BallType type;
+    switch (m_dataReorderCursor) {
+        case 0: m_ballData->foods.sortByMorton(minx, miny, maxx, maxy); type = BaseBall::FOOD_BALL; break;
+        case 1: m_ballData->clones.sortByMorton(minx, miny, maxx, maxy); type = BaseBall::CLONE_BALL; break;
+        case 2: m_ballData->spores.sortByMorton(minx, miny, maxx, maxy); type = BaseBall::SPORE_BALL; break;
+        default: m_ballData->thorns.sortByMorton(minx, miny, maxx, maxy); type = BaseBall::THORNS_BALL; break;
+    }
+    m_registry.sortRangeByMorton(type, minx, miny, maxx, maxy);
+    
+    m_dataReorderCursor = (m_dataReorderCursor + 1) % 4;
+}
+
+void GameManager::updateGame()
+{
+    if (!m_gameRunning) return;
+    
+    m_frameCount++;
+    m_inputRecorder.setTick(m_frameCount);
+    
+    // 更新所有球的物理状态
+    qreal deltaTime = m_config.tickDuration;
+    
+    {
+        PROFILE_SCOPE(&m_profiler, Movement);
+        for (BaseBall* ball : m_registry.all()) {
+            if (ball && !ball->isRemoved()) {
+                // 让每个球自己更新移动（对于孢子球和荆棘球很重要）
+                if (ball->ballType() == BaseBall::SPORE_BALL) {
+                    SporeBall* spore = static_cast<SporeBall*>(ball);
+                    spore->move(QVector2D(0, 0), deltaTime); // 孢子使用自己的移动逻辑
+                }
+                // 🔥 荆棘球也需要更新移动状态（吃孢子后的滑行）
+                else if (ball->ballType() == BaseBall::THORNS_BALL) {
+                    ThornsBall* thorns = static_cast<ThornsBall*>(ball);
+                    thorns->move(QVector2D(0, 0), deltaTime); // 荆棘球更新移动状态
+                }
+                // 其他类型的球通过physics自动更新
             }
-            // 其他类型的球通过physics自动更新
         }
     }
     
@@ -471,33 +655,43 @@ void GameManager::updateGame()
     checkCollisionsOptimized();
     
     // 额外的同玩家分身球合并检查 - 解决复杂分裂后的合并问题
-    QSet<QPair<int, int>> checkedPlayers;
-    for (CloneBall* player : m_players) {
-        if (player && !player->isRemoved()) {
-            QPair<int, int> playerKey(player->teamId(), player->playerId());
-            if (!checkedPlayers.contains(playerKey)) {
-                checkPlayerBallsMerging(player->teamId(), player->playerId());
-                checkedPlayers.insert(playerKey);
+    {
+        PROFILE_SCOPE(&m_profiler, Merging);
+        QSet<QPair<int, int>> checkedPlayers;
+        for (CloneBall* player : m_registry.clones()) {
+            if (player && !player->isRemoved()) {
+                QPair<int, int> playerKey(player->teamId(), player->playerId());
+                if (!checkedPlayers.contains(playerKey)) {
+                    checkPlayerBallsMerging(player->teamId(), player->playerId());
+                    checkedPlayers.insert(playerKey);
+                }
             }
         }
     }
     
-    // 清理已移除的球
-    QVector<BaseBall*> ballsToRemove;
-    for (BaseBall* ball : m_allBalls) {
-        if (ball && ball->isRemoved()) {
-            ballsToRemove.append(ball);
-        }
+    // 🔥 帧末统一处理本帧的事件，再注销被移除的球并回收进对象池：碰撞记录、吞噬列表都已用完，不会再有人访问它们
+    {
+        PROFILE_SCOPE(&m_profiler, Removal);
+        flushTickEvents();
     }
     
-    for (BaseBall* ball : ballsToRemove) {
-        removeBall(ball);
-        ball->deleteLater();
+    // 🔥 帧末没有任何代码持有数据指针，在这里做周期性的Z序重排
+    if (m_config.dataReorderFrames > 0 && m_frameCount % m_config.dataReorderFrames == 0) {
+        reorderBallData();
     }
-
+    
+    // 🔥 把纯数据同步到渲染代理（插值渲染时由视图按显示频率同步；加速模式下跳过或隔帧同步）
+    if (m_scheduler->isTurbo()) {
+        if (m_turboRenderEveryTicks > 0 && m_frameCount % m_turboRenderEveryTicks == 0) {
+            syncGraphics(1.0);
+        }
+    } else if (!m_config.interpolateRendering) {
+        syncGraphics(1.0);
+    }
+    
     // Check for game over
     QSet<int> activeTeams;
-    for (CloneBall* player : m_players) {
+    for (CloneBall* player : m_registry.clones()) {
         if (player && !player->isRemoved()) {
             activeTeams.insert(player->teamId());
         }
@@ -519,7 +713,7 @@ void GameManager::spawnFood()
     
     // 每隔指定帧数进行一次补充
     if (m_foodRefreshFrameCount >= m_config.foodRefreshFrames) {
-        int currentFoodCount = m_foodBalls.size();
+        int currentFoodCount = getFoodCount();
         int leftNum = m_config.maxFoodCount - currentFoodCount;
         
         if (leftNum > 0) {
@@ -530,15 +724,9 @@ void GameManager::spawnFood()
             );
             
             // 批量生成食物，无需复杂的密度检查
-            for (int i = 0; i < todoNum; ++i) {
-                QPointF pos = generateRandomFoodPosition();
-                FoodBall* food = new FoodBall(getNextBallId(), pos, m_config.gameBorder);
-                addBall(food);
-            }
+            addBalls(createFoodBalls(todoNum));
             
-            if (todoNum > 0) {
-                qDebug() << "Spawned" << todoNum << "food balls, total:" << (currentFoodCount + todoNum);
-            }
+            GB_TRACE(Ball, Debug, "spawn food count/total", todoNum, currentFoodCount + todoNum);
         }
         
         // 重置计数器
@@ -553,7 +741,7 @@ void GameManager::spawnThorns()
     
     // 每隔指定帧数进行一次补充
     if (m_thornsRefreshFrameCount >= m_config.thornsRefreshFrames) {
-        int currentThornsCount = m_thornsBalls.size();
+        int currentThornsCount = getThornsCount();
         int leftNum = m_config.maxThornsCount - currentThornsCount;
         
         if (leftNum > 0) {
@@ -564,19 +752,14 @@ void GameManager::spawnThorns()
             );
             
             // 批量生成荆棘球
+            QVector<BaseBall*> newThorns;
+            newThorns.reserve(todoNum);
             for (int i = 0; i < todoNum; ++i) {
-                QPointF pos = generateRandomThornsPosition();
-                // 使用GoBigger标准的分数范围
-                int score = m_config.thornsScoreMin + 
-                           QRandomGenerator::global()->bounded(m_config.thornsScoreMax - m_config.thornsScoreMin + 1);
-                ThornsBall* thorns = new ThornsBall(getNextBallId(), pos, m_config.gameBorder);
-                thorns->setScore(score);
-                addBall(thorns);
+                newThorns.append(createThornsBall(generateRandomThornsPosition()));
             }
+            addBalls(newThorns);
             
-            if (todoNum > 0) {
-                qDebug() << "Spawned" << todoNum << "thorns balls, total:" << (currentThornsCount + todoNum);
-            }
+            GB_TRACE(Ball, Debug, "spawn thorns count/total", todoNum, currentThornsCount + todoNum);
         }
         
         // 重置计数器
@@ -587,54 +770,56 @@ void GameManager::spawnThorns()
 // 🔥 新增：高效的食物清理机制
 void GameManager::cleanupStaleFood()
 {
-    if (m_foodBalls.isEmpty()) {
+    if (getFoodCount() == 0) {
         return;
     }
     
-    int totalFoodCount = m_foodBalls.size();
+    int totalFoodCount = getFoodCount();
     int batchSize = qMin(m_config.foodCleanupBatchSize, totalFoodCount);
     int startIndex = m_foodCleanupIndex % totalFoodCount;
     int cleanedCount = 0;
     
+    // 🔥 按帧计算过期时间，手动驱动时与墙钟时间无关
+    const qint64 maxAgeFrames = msToTicks(m_config.foodMaxAgeMs);
+    
     // 🚀 性能优化：分批检查，每次只检查一部分食物
     for (int i = 0; i < batchSize; ++i) {
         int currentIndex = (startIndex + i) % totalFoodCount;
         
         // 防止索引越界
-        if (currentIndex >= m_foodBalls.size()) {
+        if (currentIndex >= getFoodCount()) {
             break;
         }
         
-        FoodBall* food = m_foodBalls[currentIndex];
+        // 新生成的食物追加在食物段末尾，已有食物的下标不变
+        FoodBall* food = m_registry.foods()[currentIndex];
         if (!food || food->isRemoved()) {
             continue;
         }
         
         // 检查食物是否过期
-        if (food->isStale(m_config.foodMaxAgeMs)) {
+        if (food->isStaleAtFrame(m_frameCount, maxAgeFrames)) {
             // 记录清理位置，在新位置重新生成
             QPointF newPos = generateRandomFoodPosition();
             
-            // 移除过期食物
+            // 移除过期食物（记一条REMOVED事件，下面统一注销）
             food->remove();
-            removeBall(food);
             
             // 在新位置生成新食物
-            FoodBall* newFood = new FoodBall(getNextBallId(), newPos, m_config.gameBorder);
-            addBall(newFood);
+            addBall(createFoodBall(newPos));
             
             cleanedCount++;
         }
     }
     
+    // 清理阶段排在updateGame之后，过期食物在这里直接注销回收，不拖到下一帧
+    flushTickEvents();
+    
     // 更新下次检查的起始索引
     m_foodCleanupIndex = (startIndex + batchSize) % qMax(1, totalFoodCount);
     
-    // 📊 性能监控日志（仅在清理时输出）
     if (cleanedCount > 0) {
-        qDebug() << "🧹 Food cleanup: cleaned" << cleanedCount 
-                 << "stale food items, checked batch size:" << batchSize 
-                 << "total food:" << totalFoodCount;
+        GB_TRACE(Ball, Debug, "food cleanup cleaned/batch/total", cleanedCount, batchSize, totalFoodCount);
     }
 }
 
@@ -674,7 +859,6 @@ void GameManager::checkCollisions()
         // 一次性吃掉所有可以吃的孢子
         for (SporeBall* spore : sporesToEat) {
             if (!spore->isRemoved()) {
-                qDebug() << "Player" << player->ballId() << "eating spore" << spore->ballId();
                 player->eat(spore);
             }
         }
@@ -716,17 +900,11 @@ void GameManager::checkCollisionsBetween(BaseBall* ball1, BaseBall* ball2)
         FoodBall* food = (ball1->ballType() == BaseBall::FOOD_BALL) ? 
                         static_cast<FoodBall*>(ball1) : static_cast<FoodBall*>(ball2);
         
-        qDebug() << "Player-Food collision detected!" 
-                 << "Player radius:" << player->radius() 
-                 << "Food radius:" << food->radius()
-                 << "Player score:" << player->score()
-                 << "Food score:" << food->score();
+        GB_TRACE(Collision, Verbose, "player-food player/food/playerScore/foodScore",
+                 player->ballId(), food->ballId(), player->score(), food->score());
         
         if (player->canEat(food)) {
-            qDebug() << "Player can eat food, eating now...";
             player->eat(food);
-        } else {
-            qDebug() << "Player cannot eat food - size ratio too small";
         }
     }
     
@@ -739,23 +917,12 @@ void GameManager::checkCollisionsBetween(BaseBall* ball1, BaseBall* ball2)
         SporeBall* spore = (ball1->ballType() == BaseBall::SPORE_BALL) ? 
                           static_cast<SporeBall*>(ball1) : static_cast<SporeBall*>(ball2);
         
-        qDebug() << "Player-Spore collision detected!" 
-                 << "Player radius:" << player->radius() 
-                 << "Spore radius:" << spore->radius()
-                 << "Player score:" << player->score()
-                 << "Spore score:" << spore->score()
-                 << "Player team:" << player->teamId()
-                 << "Spore team:" << spore->teamId()
-                 << "Distance:" << player->distanceTo(spore);
+        GB_TRACE(Collision, Verbose, "player-spore player/spore/playerScore/distance",
+                 player->ballId(), spore->ballId(), player->score(), player->distanceTo(spore));
         
         // 孢子球可以被任何玩家球吞噬（包括自己的），符合GoBigger原版
         if (player->canEat(spore)) {
-            qDebug() << "Player CAN eat spore - eating now...";
             player->eat(spore);
-        } else {
-            qDebug() << "Player CANNOT eat spore - score ratio too small"
-                     << "Required ratio:" << GoBiggerConfig::EAT_RATIO
-                     << "Actual ratio:" << (player->score() / spore->score());
         }
     }
     
@@ -790,8 +957,7 @@ void GameManager::checkCollisionsBetween(BaseBall* ball1, BaseBall* ball2)
         SporeBall* spore = (ball1->ballType() == BaseBall::SPORE_BALL) ? 
                           static_cast<SporeBall*>(ball1) : static_cast<SporeBall*>(ball2);
         
-        qDebug() << "Thorns-Spore collision detected! Thorns" << thorns->ballId() 
-                 << "eating spore" << spore->ballId();
+        GB_TRACE(Collision, Verbose, "thorns-spore thorns/spore", thorns->ballId(), spore->ballId());
         
         // 荆棘球吃孢子，获得移动能力
         thorns->eatSpore(spore);
@@ -808,18 +974,9 @@ void GameManager::checkCollisionsBetween(BaseBall* ball1, BaseBall* ball2)
         
         // GoBigger机制：玩家可以吃荆棘球，触发特殊分裂
         if (player->canEat(thorns)) {
-            qDebug() << "Player" << player->ballId() << "eating thorns" << thorns->ballId() 
-                     << "- will trigger special split";
-            
-            // 需要传递当前玩家的总球数，这里先用队友总数估算
-            int totalPlayerBalls = 0;
-            for (CloneBall* p : m_players) {
-                if (p && !p->isRemoved() && p->teamId() == player->teamId() && p->playerId() == player->playerId()) {
-                    totalPlayerBalls++;
-                }
-            }
+            GB_TRACE(Collision, Debug, "player-thorns player/thorns/playerScore", player->ballId(), thorns->ballId(), player->score());
             
-            // 先吃荆棘球 - eat方法内部会调用performThornsSplit
+            // 吃荆棘只记一条THORNS_HIT，帧末handleThornsEaten里按当时的球数炸开
             player->eat(thorns);
         } else {
             // 如果不能吃，则荆棘球造成伤害
@@ -831,7 +988,8 @@ void GameManager::checkCollisionsBetween(BaseBall* ball1, BaseBall* ball2)
 void GameManager::handleBallRemoved(BaseBall* ball)
 {
     if (ball) {
-        removeBall(ball);
+        // 被吃掉/过期的球先登记，帧末统一注销并回收（放回对象池，池满时释放）
+        m_registry.markForRemoval(ball);
     }
 }
 
@@ -841,121 +999,754 @@ void GameManager::handlePlayerSplit(CloneBall* player, const QVector<CloneBall*>
         return;
     }
 
-    qDebug() << "🔄 Handling player split. Original ball:" << player->ballId() 
-             << "New balls created:" << newBalls.size();
+    GB_TRACE(Split, Debug, "player split original/newBalls", player->ballId(), newBalls.size());
 
     for (CloneBall* newBall : newBalls) {
         if (newBall) {
             // 🔥 关键修复：将新分裂的球添加到场景和全局玩家列表
-            if (!m_scene->items().contains(newBall)) {
+            if (m_scene && newBall->scene() != m_scene) {
                  m_scene->addItem(newBall);
             }
-            if (!m_allBalls.contains(newBall->ballId())) {
-                m_allBalls.insert(newBall->ballId(), newBall);
-            }
-            if (!m_players.contains(newBall)) {
-                m_players.append(newBall);
-                qDebug() << "  -> Added new ball" << newBall->ballId() << "to m_players.";
+            if (!m_registry.contains(newBall)) {
+                m_registry.add(newBall);
+                m_broadphase->insert(newBall);
+                GB_TRACE(Split, Verbose, "split ball registered original/ball", player->ballId(), newBall->ballId());
             }
             
-            // 连接新球的信号
-            connectBallSignals(newBall);
+            // 挂上帧事件缓冲区（分裂时已经从父球继承，这里保证一致）
+            attachBall(newBall);
 
             emit playerAdded(newBall);
         }
     }
-    
-    qDebug() << "🔄 Player split complete. Total players now:" << m_players.size();
 }
 
 void GameManager::handleSporeEjected(CloneBall* ball, SporeBall* spore)
 {
     addBall(spore);
-    qDebug() << "Spore ejected by player" << ball->ballId();
+    GB_TRACE(Spore, Debug, "spore ejected player/spore", ball->ballId(), spore->ballId());
 }
 
 void GameManager::clearAllBalls()
 {
     // 清理所有球
-    for (BaseBall* ball : m_allBalls) {
+    for (BaseBall* ball : m_registry.all()) {
         if (ball) {
             removeFromScene(ball);
-            ball->deleteLater();
+            disposeBall(ball);
         }
     }
     
-    m_allBalls.clear();
-    m_players.clear();
-    m_foodBalls.clear();
-    m_sporeBalls.clear();
-    m_thornsBalls.clear();
+    // 待移除的球还在注册表里，上面已经一并释放；池里的空闲球也释放掉，未处理的事件一并丢弃
+    m_registry.clear();
+    m_events.clear();
+    m_broadphase->clear();
+    m_ballPools.clear();
+    
+    // 手动模式：所有引用都已清空，可以直接释放
+    deleteRetiredBalls();
+}
+
+void GameManager::disposeBall(BaseBall* ball)
+{
+    if (!ball) return;
+    
+    if (m_config.manualTick) {
+        // 手动模式通常没有事件循环，deleteLater不会执行；先登记，等持有者都收到通知后由deleteRetiredBalls释放
+        m_retiredBalls.append(ball);
+    } else {
+        ball->deleteLater();
+    }
+}
+
+void GameManager::deleteRetiredBalls()
+{
+    if (m_retiredBalls.isEmpty()) {
+        return;
+    }
+    
+    // 去重，防止同一个球被登记两次；析构时归还数据存储里的槽位
+    QSet<BaseBall*> retired(m_retiredBalls.begin(), m_retiredBalls.end());
+    m_retiredBalls.clear();
+    for (BaseBall* ball : retired) {
+        delete ball;
+    }
+}
+
+void GameManager::flushRemovedBalls()
+{
+    if (!m_registry.hasPendingRemovals()) {
+        return;
+    }
+    
+    // 注销和回收过程中会发信号，先把待移除列表换出来
+    const QVector<BaseBall*> removed = m_registry.takePendingRemovals();
+    
+    // 视图和AI已经在tickEvents里收到了REMOVED，这里只管注销和回收
+    for (BaseBall* ball : removed) {
+        removeBall(ball);
+        ball->retire();
+        recycleBall(ball);
+    }
+}
+
+void GameManager::recycleBall(BaseBall* ball)
+{
+    bool pooled = false;
+    switch (ball->ballType()) {
+        case BaseBall::FOOD_BALL:
+            pooled = m_ballPools.foods.release(static_cast<FoodBall*>(ball));
+            break;
+        case BaseBall::SPORE_BALL:
+            pooled = m_ballPools.spores.release(static_cast<SporeBall*>(ball));
+            break;
+        case BaseBall::CLONE_BALL:
+            pooled = m_ballPools.clones.release(static_cast<CloneBall*>(ball));
+            break;
+        case BaseBall::THORNS_BALL:
+            break;
+    }
+    
+    if (!pooled) {
+        removeFromScene(ball);
+        disposeBall(ball);
+    }
+}
+
+void GameManager::flushTickEvents()
+{
+    // 应用事件时可能产生新事件（荆棘分裂会记SPLIT），处理到缓冲区为空
+    while (!m_events.isEmpty()) {
+        m_dispatchEvents.clear();
+        m_events.swap(m_dispatchEvents);
+        
+        for (int i = 0; i < m_dispatchEvents.size(); ++i) {
+            const GameEvent& event = m_dispatchEvents[i];
+            switch (event.type) {
+                case GameEvent::EAT:
+                    // 一个球本帧吃了多少个，都只在第一次提交时刷新半径
+                    event.subject->commitScore();
+                    break;
+                case GameEvent::SPLIT: {
+                    // 同一次分裂的新球连续存放，合成一次handlePlayerSplit
+                    CloneBall* player = static_cast<CloneBall*>(event.subject);
+                    QVector<CloneBall*> newBalls;
+                    for (; i < m_dispatchEvents.size(); ++i) {
+                        const GameEvent& next = m_dispatchEvents[i];
+                        if (next.type != GameEvent::SPLIT || next.subject != player) break;
+                        CloneBall* newBall = static_cast<CloneBall*>(next.other);
+                        newBall->commitScore();
+                        newBalls.append(newBall);
+                    }
+                    --i;
+                    player->commitScore();
+                    handlePlayerSplit(player, newBalls);
+                    break;
+                }
+                case GameEvent::MERGE:
+                    event.subject->commitScore();
+                    break;
+                case GameEvent::EJECT:
+                    event.subject->commitScore();
+                    handleSporeEjected(static_cast<CloneBall*>(event.subject), static_cast<SporeBall*>(event.other));
+                    break;
+                case GameEvent::THORNS_HIT:
+                    event.subject->commitScore();
+                    handleThornsEaten(static_cast<CloneBall*>(event.subject), static_cast<ThornsBall*>(event.other));
+                    break;
+                case GameEvent::REMOVED:
+                    handleBallRemoved(event.subject);
+                    break;
+            }
+        }
+        
+        // 整批分发给视图和AI，被移除的球此时还没有回收
+        emit tickEvents(m_dispatchEvents);
+        
+        flushRemovedBalls();
+    }
+    
+    m_dispatchEvents.clear();
+    
+    // 手动模式下没进对象池的球（荆棘、池满、关掉对象池时的所有球）在这里释放：
+    // 视图和AI已经在tickEvents里收到REMOVED，retire()也已断开信号和分裂关系，不会再有人持有它们
+    // 否则要等到clearAllBalls，回放、基准和长局里内存和数据槽位会一直涨
+    deleteRetiredBalls();
 }
 
 void GameManager::removeFromScene(BaseBall* ball)
 {
-    if (ball && m_scene && m_scene->items().contains(ball)) {
+    if (ball && m_scene && ball->scene() == m_scene) {
         m_scene->removeItem(ball);
     }
 }
 
+// ============ 世界快照 ============
+
+WorldSnapshot GameManager::snapshot() const
+{
+    if (!m_events.isEmpty() || m_registry.hasPendingRemovals()) {
+        qWarning() << "GameManager::snapshot: called in the middle of a tick";
+        return WorldSnapshot();
+    }
+    
+    // 分身球在注册表里的下标，分裂关系和AI控制的球都按它存
+    const BallRange<CloneBall> clones = m_registry.clones();
+    QHash<const CloneBall*, int> cloneIndex;
+    cloneIndex.reserve(clones.size());
+    int linkCount = 0;
+    for (int i = 0; i < clones.size(); ++i) {
+        cloneIndex.insert(clones[i], i);
+        linkCount += 2 + clones[i]->getSplitChildren().size();
+    }
+    
+    // 球都没了的AI控制器已经不起作用，不存
+    QVector<GoBigger::AI::SimpleAIPlayer*> aiPlayers;
+    int aiBallCount = 0;
+    for (auto aiPlayer : m_aiPlayers) {
+        if (aiPlayer && aiPlayer->getPlayerBall()) {
+            aiPlayers.append(aiPlayer);
+            aiBallCount += aiPlayer->getAllAliveBalls().size();
+        }
+    }
+    
+    // AI的短期记忆：指向球的部分存成球在快照里的全局下标
+    // （注册表的稠密数组本来就按分身、食物、孢子、荆棘分段，与快照里各段首尾相接的顺序相同）
+    QVector<QByteArray> aiMemories;
+    int aiMemorySize = 0;
+    if (!aiPlayers.isEmpty()) {
+        const QVector<BaseBall*>& balls = m_registry.all();
+        QHash<const BaseBall*, qint64> ballIndex;
+        ballIndex.reserve(balls.size());
+        for (int i = 0; i < balls.size(); ++i) {
+            ballIndex.insert(balls[i], i);
+        }
+        auto ballRef = [&ballIndex](const BaseBall* ball) { return ballIndex.value(ball, -1); };
+        for (auto aiPlayer : aiPlayers) {
+            aiMemories.append(aiPlayer->saveMemory(ballRef));
+            aiMemorySize += aiMemories.last().size();
+        }
+    }
+    
+    QByteArray configBlock;
+    ReplayFormat::writeConfig(configBlock, m_config);
+    
+    WorldSnapshot::Header header = WorldSnapshot::makeHeader();
+    for (int type = 0; type < WorldSnapshot::kBallTypeCount; ++type) {
+        header.ballCounts[type] = m_registry.count(static_cast<BaseBall::BallType>(type));
+    }
+    header.linkCount = linkCount;
+    header.aiCount = aiPlayers.size();
+    header.aiBallCount = aiBallCount;
+    header.aiMemorySize = aiMemorySize;
+    header.configSize = configBlock.size();
+    header.running = m_gameRunning ? 1 : 0;
+    header.frameCount = m_frameCount;
+    header.schedulerTicks = m_scheduler->tickCount();
+    header.nextBallId = m_nextBallId;
+    header.foodRefreshFrameCount = m_foodRefreshFrameCount;
+    header.thornsRefreshFrameCount = m_thornsRefreshFrameCount;
+    header.foodCleanupIndex = m_foodCleanupIndex;
+    header.dataReorderCursor = m_dataReorderCursor;
+    header.queryStamp = m_queryStamp;
+    header.seed = m_random.seed();
+    for (int i = 0; i < SimRandom::StreamCount; ++i) {
+        header.streamCounters[i] = m_random.stream(static_cast<SimRandom::Stream>(i)).counter();
+    }
+    
+    WorldSnapshot snapshot(header);
+    if (snapshot.isNull()) {
+        qWarning() << "GameManager::snapshot: world too large for a snapshot";
+        return snapshot;
+    }
+    
+    // 球的数据按注册表顺序逐条拷贝（数据存储里还有对象池占着的槽位，不能整块拷）
+    auto gather = [](const auto& balls, auto data, char* out) {
+        for (auto* ball : balls) {
+            const auto& record = (ball->*data)();
+            std::memcpy(out, &record, sizeof(record));
+            out += sizeof(record);
+        }
+    };
+    gather(clones, &CloneBall::cloneData, snapshot.section(WorldSnapshot::Clones));
+    gather(m_registry.foods(), &FoodBall::foodData, snapshot.section(WorldSnapshot::Foods));
+    gather(m_registry.spores(), &SporeBall::sporeData, snapshot.section(WorldSnapshot::Spores));
+    gather(m_registry.thorns(), &ThornsBall::thornsData, snapshot.section(WorldSnapshot::Thorns));
+    
+    auto indexOf = [&cloneIndex](const CloneBall* ball) { return static_cast<qint32>(cloneIndex.value(ball, -1)); };
+    auto writeIndex = [](char*& out, qint32 index) {
+        std::memcpy(out, &index, sizeof(index));
+        out += sizeof(index);
+    };
+    
+    char* links = snapshot.section(WorldSnapshot::SplitLinks);
+    for (CloneBall* clone : clones) {
+        const QVector<CloneBall*> children = clone->getSplitChildren();
+        writeIndex(links, indexOf(clone->getSplitParent()));
+        writeIndex(links, children.size());
+        for (CloneBall* child : children) {
+            writeIndex(links, indexOf(child));
+        }
+    }
+    
+    char* records = snapshot.section(WorldSnapshot::AIPlayers);
+    char* aiBalls = snapshot.section(WorldSnapshot::AIBalls);
+    char* aiMemory = snapshot.section(WorldSnapshot::AIMemory);
+    for (int a = 0; a < aiPlayers.size(); ++a) {
+        GoBigger::AI::SimpleAIPlayer* aiPlayer = aiPlayers[a];
+        const QVector<CloneBall*> balls = aiPlayer->getAllAliveBalls();
+        WorldSnapshot::AIRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.teamId = aiPlayer->getPlayerBall()->teamId();
+        record.playerId = aiPlayer->getPlayerBall()->playerId();
+        record.strategy = static_cast<qint32>(aiPlayer->getAIStrategy());
+        record.decisionInterval = aiPlayer->getDecisionInterval();
+        record.decisionElapsedMs = aiPlayer->decisionElapsedMs();
+        record.randomCounter = aiPlayer->randomStream().counter();
+        record.active = aiPlayer->isAIActive() ? 1 : 0;
+        record.mainBall = indexOf(aiPlayer->getPlayerBall());
+        record.ballCount = balls.size();
+        record.memorySize = aiMemories[a].size();
+        std::memcpy(records, &record, sizeof(record));
+        records += sizeof(record);
+        for (CloneBall* ball : balls) {
+            writeIndex(aiBalls, indexOf(ball));
+        }
+        std::memcpy(aiMemory, aiMemories[a].constData(), aiMemories[a].size());
+        aiMemory += aiMemories[a].size();
+    }
+    
+    std::memcpy(snapshot.section(WorldSnapshot::ConfigBlock), configBlock.constData(), configBlock.size());
+    return snapshot;
+}
+
+bool GameManager::restore(const WorldSnapshot& snapshot)
+{
+    if (snapshot.isNull()) {
+        qWarning() << "GameManager::restore: empty snapshot";
+        return false;
+    }
+    if (!m_events.isEmpty() || m_registry.hasPendingRemovals()) {
+        qWarning() << "GameManager::restore: called in the middle of a tick";
+        return false;
+    }
+    
+    // 位置都是相对地图边界的，换了地图恢复出来没有意义；其余配置（粗测后端等）允许不同，A/B实验就靠这个
+    Config snapshotConfig;
+    if (!readSnapshotConfig(snapshot, snapshotConfig)) {
+        qWarning() << "GameManager::restore: corrupt config block";
+        return false;
+    }
+    const Border& border = snapshotConfig.gameBorder;
+    if (border.minx != m_config.gameBorder.minx || border.maxx != m_config.gameBorder.maxx ||
+        border.miny != m_config.gameBorder.miny || border.maxy != m_config.gameBorder.maxy) {
+        qWarning() << "GameManager::restore: snapshot was taken on a different map";
+        return false;
+    }
+    
+    // 输入录像表达不了"跳到另一个状态"，录到这里为止
+    if (m_inputRecorder.stop()) {
+        qWarning() << "GameManager::restore: input recording stopped, a replay cannot contain a restore";
+    }
+    
+    const WorldSnapshot::Header header = snapshot.header();
+    
+    // AI控制器先放开手里的球，记下各自的(队伍, 玩家)，恢复完再按快照重新接管球和短期记忆
+    struct AIBinding {
+        GoBigger::AI::SimpleAIPlayer* aiPlayer;
+        int teamId;
+        int playerId;
+    };
+    QVector<AIBinding> bindings;
+    for (auto aiPlayer : m_aiPlayers) {
+        if (!aiPlayer) continue;
+        CloneBall* ball = aiPlayer->getPlayerBall();
+        bindings.append({ aiPlayer, ball ? ball->teamId() : -1, ball ? ball->playerId() : -1 });
+        aiPlayer->releaseBalls();
+    }
+    
+    // 现有的球全部退役（和回收进对象池一样：通知持有者、断开信号、隐藏），按类型留给快照里的球复用
+    QVector<BaseBall*> spare[WorldSnapshot::kBallTypeCount];
+    for (BaseBall* ball : m_registry.all()) {
+        detachBall(ball);
+        ball->retire();
+        spare[ball->ballType()].append(ball);
+    }
+    m_registry.clear();
+    m_broadphase->clear();
+    m_events.clear();
+    
+    // 每条记录整条覆盖进一个球对象：先用退役的，不够再从对象池取或新建，多出来的照常回收
+    QVector<BaseBall*> restored;
+    restored.reserve(snapshot.ballCount());
+    for (int type = 0; type < WorldSnapshot::kBallTypeCount; ++type) {
+        const int count = header.ballCounts[type];
+        const char* record = snapshot.section(static_cast<WorldSnapshot::Section>(type));
+        for (int i = 0; i < count; ++i, record += header.dataSizes[type]) {
+            BaseBall* ball = i < spare[type].size() ? spare[type][i]
+                                                    : acquireBlankBall(static_cast<BaseBall::BallType>(type));
+            ball->restoreData(record);
+            restored.append(ball);
+        }
+        for (int i = count; i < spare[type].size(); ++i) {
+            recycleBall(spare[type][i]);
+        }
+    }
+    deleteRetiredBalls(); // 多出来又进不了池的球都已退役，连续restore时不堆积
+    
+    // 按快照顺序注册（注册表顺序决定每帧的处理顺序），粗测索引整体重建一次
+    m_registry.reserve(restored.size());
+    for (BaseBall* ball : restored) {
+        m_registry.add(ball);
+        if (m_scene && ball->scene() != m_scene) {
+            m_scene->addItem(ball);
+        }
+        attachBall(ball);
+    }
+    m_broadphase->rebuild(m_registry.all());
+    
+    const QVector<CloneBall*> clones = m_registry.clones().toVector();
+    auto cloneAt = [&clones](qint32 index) -> CloneBall* {
+        return index >= 0 && index < clones.size() ? clones[index] : nullptr;
+    };
+    
+    // 分裂关系：每个分身 父球下标, 子球数, 子球下标...
+    const char* links = snapshot.section(WorldSnapshot::SplitLinks);
+    const char* linksEnd = links + snapshot.sectionSize(WorldSnapshot::SplitLinks);
+    auto readIndex = [](const char*& in, const char* end) {
+        qint32 index = -1;
+        if (in + sizeof(index) <= end) {
+            std::memcpy(&index, in, sizeof(index));
+            in += sizeof(index);
+        }
+        return index;
+    };
+    for (CloneBall* clone : clones) {
+        CloneBall* parent = cloneAt(readIndex(links, linksEnd));
+        const int childCount = readIndex(links, linksEnd);
+        QVector<CloneBall*> children;
+        for (int i = 0; i < childCount; ++i) {
+            if (CloneBall* child = cloneAt(readIndex(links, linksEnd))) {
+                children.append(child);
+            }
+        }
+        clone->restoreSplitLinks(parent, children);
+    }
+    
+    m_frameCount = header.frameCount;
+    m_nextBallId = header.nextBallId;
+    m_foodRefreshFrameCount = header.foodRefreshFrameCount;
+    m_thornsRefreshFrameCount = header.thornsRefreshFrameCount;
+    m_foodCleanupIndex = header.foodCleanupIndex;
+    m_dataReorderCursor = header.dataReorderCursor;
+    m_queryStamp = header.queryStamp;
+    m_random.reseed(header.seed);
+    for (int i = 0; i < SimRandom::StreamCount; ++i) {
+        m_random.stream(static_cast<SimRandom::Stream>(i)).setCounter(header.streamCounters[i]);
+    }
+    m_scheduler->setTickCount(header.schedulerTicks);
+    
+    // 运行状态：不走startGame()，那会再生成一批初始食物
+    if (header.running && !m_gameRunning) {
+        m_gameRunning = true;
+        if (!m_config.manualTick) {
+            m_scheduler->start(m_config.gameUpdateInterval);
+        }
+    } else if (!header.running) {
+        pauseGame();
+    }
+    
+    // AI控制器：同一个(队伍, 玩家)的沿用，没有的新建，顺序与快照一致（决策顺序影响分裂/喷射的ID分配）
+    QVector<GoBigger::AI::SimpleAIPlayer*> aiPlayers;
+    const char* records = snapshot.section(WorldSnapshot::AIPlayers);
+    const char* aiBalls = snapshot.section(WorldSnapshot::AIBalls);
+    const char* aiBallsEnd = aiBalls + snapshot.sectionSize(WorldSnapshot::AIBalls);
+    const char* aiMemory = snapshot.section(WorldSnapshot::AIMemory);
+    int aiMemoryLeft = snapshot.sectionSize(WorldSnapshot::AIMemory);
+    auto ballAt = [&restored](qint64 index) -> BaseBall* {
+        return index >= 0 && index < restored.size() ? restored[static_cast<int>(index)] : nullptr;
+    };
+    for (int i = 0; i < header.aiCount; ++i, records += sizeof(WorldSnapshot::AIRecord)) {
+        WorldSnapshot::AIRecord record;
+        std::memcpy(&record, records, sizeof(record));
+        const int memorySize = qBound(0, record.memorySize, aiMemoryLeft);
+        const QByteArray memory(aiMemory, memorySize);
+        aiMemory += memorySize;
+        aiMemoryLeft -= memorySize;
+        
+        QVector<CloneBall*> balls;
+        for (int b = 0; b < record.ballCount; ++b) {
+            if (CloneBall* ball = cloneAt(readIndex(aiBalls, aiBallsEnd))) {
+                balls.append(ball);
+            }
+        }
+        CloneBall* mainBall = cloneAt(record.mainBall);
+        
+        GoBigger::AI::SimpleAIPlayer* aiPlayer = nullptr;
+        for (int b = 0; b < bindings.size(); ++b) {
+            if (bindings[b].teamId == record.teamId && bindings[b].playerId == record.playerId) {
+                aiPlayer = bindings.takeAt(b).aiPlayer;
+                break;
+            }
+        }
+        if (!aiPlayer && mainBall) {
+            aiPlayer = new GoBigger::AI::SimpleAIPlayer(mainBall, this);
+            aiPlayer->setBroadphase(m_broadphase.get());
+            connect(aiPlayer, &GoBigger::AI::SimpleAIPlayer::aiPlayerDestroyed,
+                    this, &GameManager::handleAIPlayerDestroyed);
+            connect(this, &GameManager::tickEvents, aiPlayer, &GoBigger::AI::SimpleAIPlayer::onTickEvents);
+        }
+        if (!aiPlayer) continue;
+        
+        RandomStream stream = m_random.aiStream(record.teamId, record.playerId);
+        stream.setCounter(record.randomCounter);
+        aiPlayer->setRandomStream(stream);
+        aiPlayer->setAIStrategy(static_cast<GoBigger::AI::SimpleAIPlayer::AIStrategy>(record.strategy));
+        aiPlayer->setDecisionInterval(record.decisionInterval);
+        aiPlayer->rebindBalls(mainBall, balls);
+        if (!balls.isEmpty() && !aiPlayer->loadMemory(memory, ballAt)) {
+            qWarning() << "GameManager::restore: corrupt memory for AI" << record.teamId << record.playerId;
+        }
+        if (record.active && !balls.isEmpty()) {
+            aiPlayer->startAI();
+        } else {
+            aiPlayer->stopAI();
+        }
+        aiPlayer->setDecisionElapsedMs(record.decisionElapsedMs);
+        aiPlayers.append(aiPlayer);
+    }
+    
+    // 快照里没有的AI控制器等同于球全没了（发出aiPlayerDestroyed，视图和调试台照常清理）
+    m_aiPlayers = aiPlayers;
+    for (const AIBinding& binding : bindings) {
+        binding.aiPlayer->rebindBalls(nullptr, QVector<CloneBall*>());
+    }
+    
+    emit worldRestored();
+    qDebug() << "World restored at frame" << m_frameCount << "with" << m_registry.size() << "balls and"
+             << m_aiPlayers.size() << "AI players";
+    return true;
+}
+
+std::unique_ptr<GameManager> GameManager::fork() const
+{
+    return fromSnapshot(snapshot(), m_config);
+}
+
+std::unique_ptr<GameManager> GameManager::fromSnapshot(const WorldSnapshot& snapshot)
+{
+    Config config;
+    if (snapshot.isNull() || !readSnapshotConfig(snapshot, config)) {
+        qWarning() << "GameManager::fromSnapshot: invalid snapshot";
+        return nullptr;
+    }
+    return fromSnapshot(snapshot, config);
+}
+
+std::unique_ptr<GameManager> GameManager::fromSnapshot(const WorldSnapshot& snapshot, Config config)
+{
+    if (snapshot.isNull()) {
+        return nullptr;
+    }
+    
+    // 副本是无头的，由调用方逐帧tick()；种子跟快照走，之后resetGame重开的也是同一局
+    config.manualTick = true;
+    config.interpolateRendering = false;
+    config.seed = snapshot.seed();
+    
+    auto world = std::make_unique<GameManager>(nullptr, config);
+    if (!world->restore(snapshot)) {
+        return nullptr;
+    }
+    return world;
+}
+
+BaseBall* GameManager::acquireBlankBall(BaseBall::BallType type)
+{
+    switch (type) {
+        case BaseBall::CLONE_BALL:
+            if (CloneBall* clone = m_ballPools.clones.acquire()) return clone;
+            return new CloneBall(0, QPointF(), m_config.gameBorder, -1, -1,
+                                 cloneBallConfig(m_config, &m_ballPools, &m_nextBallId, &m_inputRecorder),
+                                 nullptr, m_ballData);
+        case BaseBall::FOOD_BALL:
+            if (FoodBall* food = m_ballPools.foods.acquire()) return food;
+            return new FoodBall(0, QPointF(), m_config.gameBorder, FoodBall::Config(), nullptr, m_ballData);
+        case BaseBall::SPORE_BALL:
+            if (SporeBall* spore = m_ballPools.spores.acquire()) return spore;
+            return new SporeBall(0, QPointF(), m_config.gameBorder, -1, -1, QVector2D(1, 0),
+                                 SporeBall::Config(), nullptr, m_ballData);
+        case BaseBall::THORNS_BALL:
+            break;
+    }
+    return new ThornsBall(0, QPointF(), m_config.gameBorder, ThornsBall::Config(), nullptr, m_ballData);
+}
+
 // ============ GoBigger优化碰撞检测实现 ============
 
 void GameManager::checkCollisionsOptimized()
 {
-    // 重建四叉树 - 每帧重建以确保数据最新
-    QVector<BaseBall*> allBalls = getAllBalls();
-    m_quadTree->rebuild(allBalls);
-    
     // GoBigger优化策略1: 只检测移动的球体
     QVector<BaseBall*> movingBalls = getMovingBalls();
     
-    // 性能统计
-    static int frameCount = 0;
-    frameCount++;
-    if (frameCount % 60 == 0) { // 每60帧输出一次统计
-        qDebug() << "Collision optimization stats:"
-                 << "Total balls:" << allBalls.size()
-                 << "Moving balls:" << movingBalls.size()
-                 << "QuadTree nodes:" << m_quadTree->getNodeCount()
-                 << "QuadTree depth:" << m_quadTree->getMaxDepth();
+    // 增量更新空间索引 - 只重新定位移动的球，静止食物保持不动
+    {
+        PROFILE_SCOPE(&m_profiler, Broadphase);
+        for (BaseBall* ball : movingBalls) {
+            m_broadphase->update(ball);
+        }
     }
     
-    // 对每个移动的球体，使用四叉树查找可能碰撞的候选者
-    for (BaseBall* movingBall : movingBalls) {
-        if (!movingBall || movingBall->isRemoved()) continue;
+    // 性能统计由m_profiler按阶段计时，AIDebugWidget显示
+    {
+        PROFILE_SCOPE(&m_profiler, Collisions);
         
-        // 使用四叉树查询可能碰撞的球体
-        QVector<BaseBall*> candidates = m_quadTree->queryCollisions(movingBall);
+        // 两阶段：先并行检测出所有接触（只读），再按固定顺序串行应用吞噬/分裂/推挤，
+        // 所以结果与线程数无关
+        const int movingCount = movingBalls.size();
         
-        // 检查与候选者的碰撞
-        for (BaseBall* candidate : candidates) {
-            if (!candidate || candidate->isRemoved()) continue;
-            if (candidate == movingBall) continue; // 跳过自己
-            
-            if (movingBall->collidesWith(candidate)) {
-                checkCollisionsBetween(movingBall, candidate);
+        // 新一轮查询戳：两个移动球之间的球对只由其中一方记录，每帧只处理一次（规则见detectCollisions）
+        const unsigned int stamp = ++m_queryStamp;
+        for (int i = 0; i < movingCount; ++i) {
+            movingBalls[i]->setQueryStamp(stamp);
+            movingBalls[i]->setQueryOrder(i);
+        }
+        
+        // 阶段1：按移动球列表分块并行检测，主线程处理第一块
+        static constexpr int MIN_BALLS_PER_CHUNK = 32;
+        const int chunkCount = movingCount == 0 ? 0 :
+            qBound(1, (movingCount + MIN_BALLS_PER_CHUNK - 1) / MIN_BALLS_PER_CHUNK, m_collisionThreads);
+        const int chunkSize = chunkCount > 0 ? (movingCount + chunkCount - 1) / chunkCount : 0;
+        if (m_collisionScratch.size() < chunkCount) {
+            m_collisionScratch.resize(chunkCount);
+        }
+        CollisionScratch* scratch = m_collisionScratch.data();
+        
+        // 追踪的帧号按线程存，池里的线程要带上这个世界的帧号
+        const qint64 traceFrame = Trace::frame();
+        for (int chunk = 1; chunk < chunkCount; ++chunk) {
+            const int begin = chunk * chunkSize;
+            const int end = qMin(movingCount, begin + chunkSize);
+            m_collisionPool.start([this, &movingBalls, begin, end, stamp, scratch, chunk, traceFrame]() {
+                Trace::setFrame(traceFrame);
+                detectCollisions(movingBalls, begin, end, stamp, scratch[chunk]);
+            });
+        }
+        if (chunkCount > 0) {
+            detectCollisions(movingBalls, 0, qMin(movingCount, chunkSize), stamp, scratch[0]);
+        }
+        m_collisionPool.waitForDone();
+        
+        // 阶段2：按（移动球序号, 接触先后）的顺序串行应用，前面的结果会让后面的记录失效
+        for (int chunk = 0; chunk < chunkCount; ++chunk) {
+            for (const CollisionRecord& record : scratch[chunk].records) {
+                if (record.mover->isRemoved() || record.other->isRemoved()) continue;
+                checkCollisionsBetween(record.mover, record.other);
+            }
+        }
+        
+        // 下一帧的扫掠路径从这里开始
+        for (BaseBall* ball : movingBalls) {
+            if (ball && !ball->isRemoved()) {
+                ball->resetSweepOrigin();
             }
         }
     }
     
     // 特殊处理：孢子与玩家球的优化碰撞检测
     // 这是GoBigger的一个关键优化：允许一个玩家球在一帧内吃多个孢子
+    PROFILE_SCOPE(&m_profiler, SporeCollisions);
     optimizeSporeCollisions();
 }
 
+void GameManager::detectCollisions(const QVector<BaseBall*>& movingBalls, int begin, int end,
+                                   unsigned int stamp, CollisionScratch& scratch) const
+{
+    // 运行在工作线程里：只读空间索引和球数据，不能修改任何状态，也不输出日志
+    scratch.records.clear();
+    
+    for (int i = begin; i < end; ++i) {
+        BaseBall* movingBall = movingBalls[i];
+        if (movingBall->isRemoved()) continue;
+        
+        // 两个移动球之间的球对只记录一次：需要扫掠的一方负责（都扫掠时位移大的一方），
+        // 否则序号较小的一方负责。按序号去重的话，高速孢子/冲刺分身会跳过排在前面的移动球而穿过去
+        const BaseBallData& moving = movingBall->data();
+        const float travel = sweepTravel(moving);
+        const bool swept = travel >= 0.0f;
+        
+        // 收集候选者，同时把位置/半径/分数打包给窄相内核
+        scratch.candidates.clear();
+        scratch.batch.clear();
+        auto collect = [this, &scratch, stamp, i, travel](BaseBall* candidate) {
+            if (candidate->queryStamp() == stamp) {
+                const int order = candidate->queryOrder();
+                if (order == i) {
+                    return;
+                }
+                const float otherTravel = sweepTravel(candidate->data());
+                if (otherTravel > travel || (otherTravel == travel && order < i)) {
+                    return;
+                }
+            }
+            const BaseBallData& data = candidate->data();
+            scratch.candidates.append(candidate);
+            scratch.batch.append(data.x, data.y, data.radius, data.score);
+        };
+        
+        if (swept) {
+            // 🔥 高速球（孢子、分裂冲刺）：沿本帧路径做扫掠检测，按接触先后处理，避免大步长时穿过荆棘/食物
+            m_broadphase->forEachSweptCandidate(movingBall, movingBall->sweepOrigin(), collect);
+            NarrowPhase::sweep(moving.sweepX, moving.sweepY, moving.x, moving.y, moving.radius, moving.score,
+                               scratch.batch, GoBiggerConfig::EAT_DISTANCE_RATIO, GoBiggerConfig::EAT_RATIO,
+                               scratch.hits);
+        } else {
+            // 窄相：一次测试一组候选者的重叠（与collidesWith相同的判定），只返回命中者
+            m_broadphase->forEachCandidate(movingBall, collect);
+            NarrowPhase::overlap(moving.x, moving.y, moving.radius, moving.score, scratch.batch,
+                                 GoBiggerConfig::EAT_DISTANCE_RATIO, GoBiggerConfig::EAT_RATIO, scratch.hits);
+        }
+        
+        const bool movingIsClone = movingBall->ballType() == BaseBall::CLONE_BALL;
+        for (const NarrowPhase::Hit& hit : scratch.hits) {
+            BaseBall* candidate = scratch.candidates[hit.index];
+            
+            // 吃不动的食物不必进入逐类型的处理
+            if (movingIsClone && candidate->ballType() == BaseBall::FOOD_BALL &&
+                !(hit.flags & NarrowPhase::HIT_EATS_CANDIDATE)) {
+                continue;
+            }
+            
+            scratch.records.append(CollisionRecord{ movingBall, candidate });
+        }
+    }
+}
+
+float GameManager::sweepTravel(const BaseBallData& data) const
+{
+    if (m_config.ccdTravelRatio <= 0.0) {
+        return -1.0f;
+    }
+    const float travelX = data.x - data.sweepX;
+    const float travelY = data.y - data.sweepY;
+    const float travel = travelX * travelX + travelY * travelY;
+    const float threshold = data.radius * m_config.ccdTravelRatio;
+    return travel > threshold * threshold ? travel : -1.0f;
+}
+
 QVector<BaseBall*> GameManager::getMovingBalls() const
 {
     QVector<BaseBall*> movingBalls;
     
     // 玩家球总是被认为是移动的（即使静止，也可能随时移动）
-    for (CloneBall* player : m_players) {
+    for (CloneBall* player : m_registry.clones()) {
         if (player && !player->isRemoved()) {
             movingBalls.append(player);
         }
     }
     
     // 孢子球总是移动的
-    for (SporeBall* spore : m_sporeBalls) {
+    for (SporeBall* spore : m_registry.spores()) {
         if (spore && !spore->isRemoved()) {
             movingBalls.append(spore);
         }
@@ -963,7 +1754,7 @@ QVector<BaseBall*> GameManager::getMovingBalls() const
     
     // 荆棘球：所有荆棘球都参与碰撞检测（无论是否移动）
     // 因为静止的荆棘球也需要检测与孢子的碰撞
-    for (ThornsBall* thorns : m_thornsBalls) {
+    for (ThornsBall* thorns : m_registry.thorns()) {
         if (thorns && !thorns->isRemoved()) {
             movingBalls.append(thorns);
         }
@@ -978,26 +1769,22 @@ QVector<BaseBall*> GameManager::getMovingBalls() const
 void GameManager::optimizeSporeCollisions()
 {
     // 针对孢子的特殊优化：允许玩家球在一帧内吃掉多个孢子
-    for (CloneBall* player : m_players) {
+    for (CloneBall* player : m_registry.clones()) {
         if (!player || player->isRemoved()) continue;
         
-        QVector<SporeBall*> sporesToEat;
-        
-        // 使用四叉树查找附近的孢子
-        QVector<BaseBall*> candidates = m_quadTree->queryCollisions(player);
-        
-        for (BaseBall* candidate : candidates) {
-            if (!candidate || candidate->isRemoved()) continue;
-            if (candidate->ballType() != BaseBall::SPORE_BALL) continue;
+        // 使用空间索引查找附近的孢子（遍历时只收集，吃掉放到遍历之后）
+        m_sporesToEat.clear();
+        m_broadphase->forEachCandidate(player, [this, player](BaseBall* candidate) {
+            if (candidate->ballType() != BaseBall::SPORE_BALL) return;
             
             SporeBall* spore = static_cast<SporeBall*>(candidate);
             if (spore->canBeEaten() && player->collidesWith(spore) && player->canEat(spore)) {
-                sporesToEat.append(spore);
+                m_sporesToEat.append(spore);
             }
-        }
+        });
         
         // 一次性吃掉所有可以吃的孢子
-        for (SporeBall* spore : sporesToEat) {
+        for (SporeBall* spore : m_sporesToEat) {
             if (!spore->isRemoved()) {
                 player->eat(spore);
             }
@@ -1020,7 +1807,7 @@ void GameManager::checkPlayerBallsMerging(int teamId, int playerId)
             
             // 检查两球是否可以合并
             if (ball1->canMergeWith(ball2)) {
-                qDebug() << "GameManager: Auto-merging balls" << ball1->ballId() << "and" << ball2->ballId();
+                GB_TRACE(Merge, Debug, "auto-merge ball1/ball2", ball1->ballId(), ball2->ballId());
                 ball1->mergeWith(ball2);
                 return; // 一次只合并一对球
             }
@@ -1032,7 +1819,7 @@ QVector<CloneBall*> GameManager::getPlayerBalls(int teamId, int playerId) const
 {
     QVector<CloneBall*> playerBalls;
     
-    for (CloneBall* player : m_players) {
+    for (CloneBall* player : m_registry.clones()) {
         if (player && !player->isRemoved() && 
             player->teamId() == teamId && player->playerId() == playerId) {
             playerBalls.append(player);
@@ -1062,23 +1849,24 @@ bool GameManager::addAIPlayer(int teamId, int playerId, const QString& aiModelPa
         startPos,
         m_config.gameBorder,
         teamId,
-        playerId
+        playerId,
+        cloneBallConfig(m_config, &m_ballPools, &m_nextBallId, &m_inputRecorder),
+        nullptr,
+        m_ballData
     );
     
     // 添加到游戏中
-    addBall(playerBall);
-    m_players.append(playerBall);  // 重要：添加到玩家列表中
-    
-    // 连接玩家特有的信号
-    connect(playerBall, &CloneBall::splitPerformed, this, &GameManager::handlePlayerSplit);
-    connect(playerBall, &CloneBall::sporeEjected, this, &GameManager::handleSporeEjected);
-    connect(playerBall, &CloneBall::thornsEaten, this, &GameManager::handleThornsEaten);
+    addBall(playerBall);  // 注册表的分身球段就是玩家列表
+    // 与createPlayer(teamId, playerId)消耗的随机数和ID一样，重放时按普通玩家加入
+    m_inputRecorder.recordJoin(teamId, playerId, QPointF());
     
     // 发出玩家添加信号
     emit playerAdded(playerBall);
     
     // 创建AI控制器
     auto aiPlayer = new GoBigger::AI::SimpleAIPlayer(playerBall, this);
+    aiPlayer->setRandomStream(m_random.aiStream(teamId, playerId));
+    aiPlayer->setBroadphase(m_broadphase.get()); // 无头世界没有场景，附近的球从空间索引查
     
     // 加载AI模型
     if (!aiModelPath.isEmpty()) {
@@ -1114,6 +1902,8 @@ bool GameManager::addAIPlayer(int teamId, int playerId, const QString& aiModelPa
     // 连接AI销毁信号
     connect(aiPlayer, &GoBigger::AI::SimpleAIPlayer::aiPlayerDestroyed,
             this, &GameManager::handleAIPlayerDestroyed);
+    // 分裂/合并/被吃由帧事件批量通知
+    connect(this, &GameManager::tickEvents, aiPlayer, &GoBigger::AI::SimpleAIPlayer::onTickEvents);
     
     // 启动AI控制
     aiPlayer->startAI();
@@ -1145,12 +1935,16 @@ bool GameManager::addAIPlayerWithStrategy(int teamId, int playerId,
         startPos,
         m_config.gameBorder,
         teamId,
-        playerId
+        playerId,
+        cloneBallConfig(m_config, &m_ballPools, &m_nextBallId, &m_inputRecorder),
+        nullptr,
+        m_ballData
     );
     
     // 添加到游戏中
-    addBall(playerBall);
-    m_players.append(playerBall);  // 重要：添加到玩家列表中
+    addBall(playerBall);  // 注册表的分身球段就是玩家列表
+    // 与createPlayer(teamId, playerId)消耗的随机数和ID一样，重放时按普通玩家加入
+    m_inputRecorder.recordJoin(teamId, playerId, QPointF());
     
     qDebug() << "Created CloneBall for AI:" 
              << "teamId=" << teamId 
@@ -1159,16 +1953,13 @@ bool GameManager::addAIPlayerWithStrategy(int teamId, int playerId,
              << "ballId=" << playerBall->ballId()
              << "in scene=" << (playerBall->scene() != nullptr);
     
-    // 连接玩家特有的信号
-    connect(playerBall, &CloneBall::splitPerformed, this, &GameManager::handlePlayerSplit);
-    connect(playerBall, &CloneBall::sporeEjected, this, &GameManager::handleSporeEjected);
-    connect(playerBall, &CloneBall::thornsEaten, this, &GameManager::handleThornsEaten);
-    
     // 发出玩家添加信号
     emit playerAdded(playerBall);
     
     // 创建AI控制器
     auto aiPlayer = new GoBigger::AI::SimpleAIPlayer(playerBall, this);
+    aiPlayer->setRandomStream(m_random.aiStream(teamId, playerId));
+    aiPlayer->setBroadphase(m_broadphase.get()); // 无头世界没有场景，附近的球从空间索引查
     
     // 转换策略类型 - 从前置声明转换到实际枚举
     GoBigger::AI::SimpleAIPlayer::AIStrategy actualStrategy;
@@ -1215,6 +2006,8 @@ bool GameManager::addAIPlayerWithStrategy(int teamId, int playerId,
     // 连接AI销毁信号
     connect(aiPlayer, &GoBigger::AI::SimpleAIPlayer::aiPlayerDestroyed,
             this, &GameManager::handleAIPlayerDestroyed);
+    // 分裂/合并/被吃由帧事件批量通知
+    connect(this, &GameManager::tickEvents, aiPlayer, &GoBigger::AI::SimpleAIPlayer::onTickEvents);
     
     // 启动AI控制
     aiPlayer->startAI();
@@ -1236,9 +2029,8 @@ void GameManager::removeAIPlayer(int teamId, int playerId)
             aiPlayer->stopAI();
             CloneBall* playerBall = aiPlayer->getPlayerBall();
             if (playerBall) {
-                m_players.removeOne(playerBall);  // 从玩家列表中移除
                 emit playerRemoved(playerBall);   // 发出移除信号
-                removeBall(playerBall);
+                removeBall(playerBall);           // 同时从玩家列表中移除
             }
             
             m_aiPlayers.removeAt(i);
@@ -1281,8 +2073,7 @@ void GameManager::removeAllAI()
     for (auto aiPlayer : m_aiPlayers) {
         if (aiPlayer && aiPlayer->getPlayerBall()) {
             CloneBall* playerBall = aiPlayer->getPlayerBall();
-            m_players.removeOne(playerBall);  // 从玩家列表中移除
-            removeBall(playerBall);
+            removeBall(playerBall);  // 同时从玩家列表中移除
         }
         delete aiPlayer;
     }
@@ -1310,11 +2101,8 @@ void GameManager::handleAIPlayerDestroyed(GoBigger::AI::SimpleAIPlayer* aiPlayer
 // 荆棘碰撞处理
 void GameManager::handleThornsCollision(ThornsBall* thorns, BaseBall* other)
 {
-    Q_UNUSED(thorns)
-    Q_UNUSED(other)
-    
     // 荆棘碰撞处理 - 暂时不实现具体逻辑
-    qDebug() << "Thorns collision detected";
+    GB_TRACE(Thorns, Verbose, "thorns collision thorns/other", thorns ? thorns->ballId() : -1, other ? other->ballId() : -1);
 }
 
 // 荆棘被吃掉处理
@@ -1322,8 +2110,12 @@ void GameManager::handleThornsEaten(CloneBall* player, ThornsBall* thorns)
 {
     if (!player || !thorns) return;
     
-    qDebug() << "Player" << player->ballId() << "ate thorns" << thorns->ballId();
-    // 荆棘被吃处理逻辑已在CloneBall::eat中实现
+    GB_TRACE(Thorns, Debug, "thorns eaten player/thorns/playerScore", player->ballId(), thorns->ballId(), player->score());
+    
+    // 🔥 荆棘分裂：分数已经提交，按该玩家现有的球数决定能炸出几个；新球作为SPLIT事件在本轮flush里继续处理
+    if (player->isRemoved()) return;
+    const int totalPlayerBalls = getPlayerBalls(player->teamId(), player->playerId()).size();
+    player->performThornsSplit(player->moveDirection(), totalPlayerBalls);
 }
 
 // 合并完成处理
@@ -1331,11 +2123,8 @@ void GameManager::handleMergePerformed(CloneBall* survivingBall, CloneBall* abso
 {
     if (!survivingBall || !absorbedBall) return;
     
-    qDebug() << "Player ball" << survivingBall->ballId() << "merged with ball" << absorbedBall->ballId();
-    
-    // 从玩家列表中移除被吸收的球
-    m_players.removeOne(absorbedBall);
+    GB_TRACE(Merge, Debug, "merge performed surviving/absorbed", survivingBall->ballId(), absorbedBall->ballId());
     
-    // 从游戏场景中移除被吸收的球
+    // 从玩家列表和游戏场景中移除被吸收的球
     removeBall(absorbedBall);
 }
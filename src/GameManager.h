@@ -2,14 +2,23 @@
 #define GAMEMANAGER_H
 
 #include <QObject>
-#include <QTimer>
 #include <QVector>
 #include <QHash>
 #include <QGraphicsScene>
-#include <QRandomGenerator>
+#include <QThreadPool>
 #include "BaseBall.h"
 #include "GoBiggerConfig.h"
-#include "QuadTree.h"
+#include "Broadphase.h"
+#include "BallPool.h"
+#include "BallRegistry.h"
+#include "GameEvent.h"
+#include "core/NarrowPhase.h"
+#include "core/TickScheduler.h"
+#include "core/FrameProfiler.h"
+#include "core/SimRandom.h"
+#include "core/InputRecorder.h"
+#include "core/WorldSnapshot.h"
+#include <memory>
 
 // Forward declarations
 class CloneBall;
@@ -65,11 +74,33 @@ public:
         qreal playerEjectScoreMin = 6.0;  // 孢子喷射最小分数
         
         // 游戏更新频率
-        int gameUpdateInterval = 16;    // 60 FPS
+        int gameUpdateInterval = 16;    // 调度器轮询间隔（毫秒），每次按实际经过的时间补跑整数个逻辑帧
+        qreal tickDuration = 1.0 / 60.0; // 逻辑帧长（秒）；可以设为GoBigger原生的1/20或1/30省CPU，界面靠插值保持流畅
+        // 为true时由视图按显示频率调用syncGraphics(alpha)做插值渲染，否则每个逻辑帧末直接同步
+        bool interpolateRendering = false;
+        // 整帧耗时预算（毫秒），超出时FrameProfiler抓一份分阶段快照；<=0时取逻辑帧长
+        double tickBudgetMs = 0.0;
+        
+        // 🔥 新增：手动驱动模式（无头训练）
+        // 为true时帧调度器不启动定时器，也不需要场景，由GameEngine逐帧调用tick()
+        bool manualTick = false;
         
         // 碰撞检测配置
+        BroadphaseType broadphaseType = BroadphaseType::QuadTree; // 粗测后端：松散四叉树 / 空间哈希网格
+        qreal gridCellSize = 0.0;       // 网格边长，<=0时根据球半径分布自动选择
         qreal collisionCheckRadius = 50.0;
         qreal eatRatioThreshold = 1.15; // 吃掉其他球的大小比例阈值
+        qreal ccdTravelRatio = 0.5;     // 一帧位移超过半径的这个比例时改用扫掠检测（<=0关闭连续碰撞检测）
+        int collisionThreads = 0;       // 碰撞检测线程数，<=0时取CPU核数；结果与线程数无关
+        
+        // 🔥 数据局部性：每隔多少帧按Z序（Morton码）重排一种球的数据，轮流进行（<=0关闭）
+        int dataReorderFrames = 30;
+        
+        // 🔥 对象池：被吃掉/过期的食物、孢子、分身球回收复用，每种最多缓存这么多个（0关闭复用）
+        int ballPoolCapacity = 1024;
+        
+        // 🔥 随机种子：同一个种子加同样的输入，整局完全一样；0表示每局取一个新种子（可用randomSeed()查到）
+        quint64 seed = 0;
         
         Config() = default;
     };
@@ -80,33 +111,68 @@ public:
     // 游戏控制
     void startGame();
     void pauseGame();
-    void resetGame();
+    void resetGame(quint64 seed = 0); // seed为0时按Config::seed（也为0则取新种子）
     bool isGameRunning() const { return m_gameRunning; }
 
     // 玩家管理
     CloneBall* createPlayer(int teamId, int playerId, const QPointF& position = QPointF());
     void removePlayer(CloneBall* player);
     CloneBall* getPlayer(int teamId, int playerId) const;
-    QVector<CloneBall*> getPlayers() const { return m_players; }
+    QVector<CloneBall*> getPlayers() const;
+    // 从外部直接设定玩家分数（例如BOSS的初始分数）要走这里，输入录像才能重放
+    void setPlayerScore(CloneBall* player, float score);
     
     // 同玩家分身球合并检查 - 新增方法
     void checkPlayerBallsMerging(int teamId, int playerId);
     QVector<CloneBall*> getPlayerBalls(int teamId, int playerId) const;
+    
+    // 一对已经接触的球的交互分派（吞噬/推挤/荆棘/合并），碰撞阶段逐对调用；gobigger-bench也直接测它
+    void checkCollisionsBetween(BaseBall* ball1, BaseBall* ball2);
 
     // 球管理
     void addBall(BaseBall* ball);
+    // 批量加入：一次预留容量，注册表/空间索引/场景一趟完成，只发一次ballsAdded
+    void addBalls(const QVector<BaseBall*>& balls);
     void removeBall(BaseBall* ball);
-    QVector<BaseBall*> getAllBalls() const;
+    const QVector<BaseBall*>& getAllBalls() const { return m_registry.all(); }
+    BaseBall* getBall(const BallHandle& handle) const { return m_registry.get(handle); }
+    const BallRegistry& registry() const { return m_registry; }
     QVector<BaseBall*> getBallsNear(const QPointF& position, qreal radius) const;
     
     // 视野优化 - 只获取指定区域内的球
     QVector<BaseBall*> getBallsInRect(const QRectF& rect) const;
     QVector<FoodBall*> getFoodBallsInRect(const QRectF& rect) const;
+    
+    // 对象池（空闲数量与复用命中统计）
+    const BallPools& ballPools() const { return m_ballPools; }
 
     // 游戏状态
     const Config& config() const { return m_config; }
     int getCurrentBallId() const { return m_nextBallId; }
     
+    // 本局实际使用的种子与各子系统的随机数流
+    quint64 randomSeed() const { return m_random.seed(); }
+    SimRandom& random() { return m_random; }
+    
+    // 🔥 输入录像：记下配置、种子和每一帧的玩家操作，可以无头全速重放（见core/InputReplay.h）
+    // 必须在这一局开始之前（没有球、帧数为0）开始；resetGame会记一条重置继续录
+    bool startInputRecording(const QString& path) { return m_inputRecorder.start(path, *this); }
+    bool stopInputRecording() { return m_inputRecorder.stop(); }
+    const InputRecorder& inputRecorder() const { return m_inputRecorder; }
+    
+    // 🔥 整个世界的快照（见core/WorldSnapshot.h）：RL重置、搜索式AI展开、A/B实验都从同一个状态出发
+    // 只能在两帧之间调用（帧中间的事件和待回收的球没法单独保存），否则返回空快照/false
+    // restore之后原来的球指针和句柄都不再指向原来的球（对象按类型复用），持有者收到worldRestored后重新查找；
+    // 同一个快照恢复出来的几份世界之后逐帧一致，与没被打断的原世界只保证恢复时的状态相同
+    // （粗测索引按注册表顺序重建，接触的处理顺序可能不同）
+    WorldSnapshot snapshot() const;
+    bool restore(const WorldSnapshot& snapshot);
+    // 无头副本（没有场景、手动逐帧），等价于fromSnapshot(snapshot(), config())
+    std::unique_ptr<GameManager> fork() const;
+    // 从快照（比如WorldSnapshot::load读回来的文件）建一个无头世界；不给配置时用快照里记下的配置
+    static std::unique_ptr<GameManager> fromSnapshot(const WorldSnapshot& snapshot);
+    static std::unique_ptr<GameManager> fromSnapshot(const WorldSnapshot& snapshot, Config config);
+    
     // AI玩家管理
     bool addAIPlayer(int teamId, int playerId, const QString& aiModelPath = "");
     // 新增：支持指定AI策略的方法
@@ -122,12 +188,55 @@ public:
     QVector<GoBigger::AI::SimpleAIPlayer*> getAIPlayers() const { return m_aiPlayers; }
     
     // 统计信息
-    int getFoodCount() const { return m_foodBalls.size(); }
-    int getThornsCount() const { return m_thornsBalls.size(); }
-    int getPlayerCount() const { return m_players.size(); }
+    int getFoodCount() const { return m_registry.count(BaseBall::FOOD_BALL); }
+    int getThornsCount() const { return m_registry.count(BaseBall::THORNS_BALL); }
+    int getPlayerCount() const { return m_registry.count(BaseBall::CLONE_BALL); }
     
     // 队伍分数管理
     QMap<int, float> getAllTeamScores() const;
+    
+    // 🔥 帧调度：每帧按TickPhase顺序执行各阶段，暂停时整体停止
+    enum TickPhase {
+        PHASE_SNAPSHOT = -100,  // 记下各球上一帧的位置，供渲染插值（只在开启插值渲染时登记）
+        PHASE_INPUT = 0,        // 玩家输入（GameView登记）
+        PHASE_AI = 50,          // AI决策（按游戏时间计）
+        PHASE_BALLS = 100,      // 球的移动/衰减/寿命
+        PHASE_GAME = 200,       // 碰撞、合并、清理
+        PHASE_SPAWN = 300,      // 食物/荆棘补充
+        PHASE_CLEANUP = 400     // 过期食物清理
+    };
+    TickScheduler* scheduler() const { return m_scheduler; }
+    void tick();               // 推进一帧：手动模式下由GameEngine调用，否则由调度器的定时器调用
+    
+    // 把纯数据同步到渲染代理；alpha为渲染时刻在上一逻辑帧和当前逻辑帧之间的插值系数
+    void syncGraphics(qreal alpha);
+    int msToTicks(int ms) const; // 把毫秒换算成逻辑帧数（至少1帧）
+    
+    // 🔥 模拟速度：倍速按真实时间的倍数推进；加速模式全速推进，不同步场景，
+    // 或者每renderEveryTicks个逻辑帧同步一次（0表示完全不同步），适合只关心结果的AI对战
+    void setSimulationSpeed(qreal multiplier);
+    qreal simulationSpeed() const { return m_scheduler->speedMultiplier(); }
+    void setTurboMode(bool enabled, int renderEveryTicks = 0);
+    bool isTurboMode() const { return m_scheduler->isTurbo(); }
+    int turboRenderInterval() const { return m_turboRenderEveryTicks; }
+    
+    // 游戏循环各阶段（由帧调度器按顺序调用）
+    void updateBalls();        // 推进各球自身的移动/衰减/寿命
+    void reorderBallData();    // 按Z序重排一种球的数据存储（updateGame按dataReorderFrames调用）
+    void updateGame();
+    void spawnFood();
+    void spawnThorns();
+    void cleanupStaleFood();
+    
+    // 🔥 分阶段耗时统计与超预算快照（AIDebugWidget显示，GameView计入绘制耗时）
+    FrameProfiler* profiler() { return &m_profiler; }
+    const FrameProfiler* profiler() const { return &m_profiler; }
+    // 当前粗测/窄相后端及其统计，供调试面板显示
+    QString collisionBackendInfo() const;
+    
+    // 帧计数（每次updateGame推进一帧）
+    qint64 frameCount() const { return m_frameCount; }
+    bool isManualTick() const { return m_config.manualTick; }
 
 signals:
     void gameStarted();
@@ -136,8 +245,13 @@ signals:
     void playerAdded(CloneBall* player);
     void playerRemoved(CloneBall* player);
     void ballAdded(BaseBall* ball);
+    void ballsAdded(const QVector<BaseBall*>& balls);
     void ballRemoved(BaseBall* ball);
+    // 🔥 本帧的全部游戏事件，帧末一次性分发；此时被移除的球还没有回收，指针仍然有效
+    void tickEvents(const QVector<GameEvent>& events);
     void gameOver(int winningTeamId);
+    void simulationSpeedChanged(qreal multiplier, bool turbo);
+    void worldRestored(); // restore()完成，球对象都换了身份
 
 public slots:
     void handlePlayerSplit(CloneBall* player, const QVector<CloneBall*>& newBalls);
@@ -152,18 +266,12 @@ private:
     Config m_config;
     bool m_gameRunning;
     
-    // 定时器
-    QTimer* m_gameTimer;
-    QTimer* m_foodTimer;
-    QTimer* m_thornsTimer;
-    QTimer* m_foodCleanupTimer; // 🔥 新增：食物清理定时器
+    // 统一的帧调度器（取代各个球和GameManager自己的定时器）
+    TickScheduler* m_scheduler;
+    FrameProfiler m_profiler;
     
-    // 球的管理
-    QVector<CloneBall*> m_players;
-    QVector<FoodBall*> m_foodBalls;
-    QVector<SporeBall*> m_sporeBalls;
-    QVector<ThornsBall*> m_thornsBalls;
-    QHash<int, BaseBall*> m_allBalls;
+    // 球的管理：按类型分段的稠密注册表（分身球段就是玩家球列表）
+    BallRegistry m_registry;
     
     // AI玩家管理
     QVector<GoBigger::AI::SimpleAIPlayer*> m_aiPlayers;
@@ -171,6 +279,10 @@ private:
     
     int m_nextBallId;
     
+    // 🔥 本局的随机数源（生成位置、荆棘分数、AI决策），生成位置的几个const函数也要取数
+    mutable SimRandom m_random;
+    InputRecorder m_inputRecorder;
+    
     // GoBigger风格的食物刷新机制
     int m_foodRefreshFrameCount;
     
@@ -181,37 +293,85 @@ private:
     int m_thornsRefreshFrameCount;
     
     // 空间分区优化 - 四叉树
-    std::unique_ptr<QuadTree> m_quadTree;
+    std::unique_ptr<Broadphase> m_broadphase;
     
-    // 初始化
-    void initializeTimers();
-    void connectBallSignals(BaseBall* ball);
-    void disconnectBallSignals(BaseBall* ball);
+    // 🔥 新增：帧计数与手动模式下待释放的球
+    qint64 m_frameCount;
+    QVector<BaseBall*> m_retiredBalls; // 手动模式没有事件循环，deleteLater不会执行；每次flushTickEvents末尾释放
     
-    // 游戏循环
-    void updateGame();
-    void spawnFood();
-    void spawnThorns();
-    void cleanupStaleFood();
+    // 🔥 对象池：本帧被移除的球登记在注册表的待移除列表里，帧末统一retire()后放回池中
+    BallPools m_ballPools;
+    
+    // 🔥 帧事件缓冲区：受管的球把吞噬/分裂/合并/喷射/移除记在这里，帧末统一处理
+    GameEventBuffer m_events;
+    QVector<GameEvent> m_dispatchEvents; // 正在分发的一批（与缓冲区交换，容量跨帧复用）
+    std::shared_ptr<BallDataStorage> m_ballData; // 所有球的纯数据，按类型连续存放
+    
+    // 检测阶段产生的交互记录：mover与other在本帧接触
+    struct CollisionRecord {
+        BaseBall* mover;
+        BaseBall* other;
+    };
+    
+    // 每个检测分块自己的缓冲区（跨帧复用，线程之间不共享）
+    struct CollisionScratch {
+        QVector<BaseBall*> candidates;
+        NarrowPhase::CandidateBatch batch;       // 候选者的x/y/r/score打包，交给SIMD窄相内核
+        std::vector<NarrowPhase::Hit> hits;
+        QVector<CollisionRecord> records;
+    };
+    
+    // 碰撞检测复用的缓冲区、线程池与查询戳
+    QVector<CollisionScratch> m_collisionScratch;
+    QThreadPool m_collisionPool;
+    QVector<SporeBall*> m_sporesToEat;
+    unsigned int m_queryStamp;
+    int m_dataReorderCursor;   // 下一次重排哪种球的数据
+    int m_collisionThreads;    // 碰撞检测分块数上限（含主线程）
+    int m_turboRenderEveryTicks; // 加速模式下的场景同步间隔（帧），0表示不同步
+    
+    // 初始化
+    void initializeScheduler();
+    void storePreviousPositions();
+    void updateAIPlayers();
+    void attachBall(BaseBall* ball);
+    void detachBall(BaseBall* ball);
     
     // 事件处理
     void handleBallRemoved(BaseBall* ball);
+    // 帧末统一应用并分发本帧的事件，最后回收被移除的球
+    void flushTickEvents();
     
     // 生成函数
     QPointF generateRandomPosition() const;
     QPointF generateRandomFoodPosition() const;
     QPointF generateRandomThornsPosition() const;
+    FoodBall* createFoodBall(const QPointF& position);
+    QVector<BaseBall*> createFoodBalls(int count);      // 在随机位置批量生成
+    ThornsBall* createThornsBall(const QPointF& position);
     
     // 碰撞检测 - GoBigger优化版本
     void checkCollisions();
     void checkCollisionsOptimized();
-    void checkCollisionsBetween(BaseBall* ball1, BaseBall* ball2);
     QVector<BaseBall*> getMovingBalls() const;
     void optimizeSporeCollisions();
     
+    // 检测阶段：只读地为movingBalls[begin, end)生成交互记录，可在工作线程中运行
+    void detectCollisions(const QVector<BaseBall*>& movingBalls, int begin, int end,
+                          unsigned int stamp, CollisionScratch& scratch) const;
+    // 本帧位移的平方；不需要扫掠检测时返回-1。决定两个移动球之间的球对由谁检测
+    float sweepTravel(const BaseBallData& data) const;
+    
     // 清理函数
     void clearAllBalls();
     void removeFromScene(BaseBall* ball);
+    void disposeBall(BaseBall* ball);
+    void deleteRetiredBalls();   // 手动模式：释放disposeBall登记的球
+    void flushRemovedBalls();
+    // 已经retire()的球：放回对象池，池满或不入池的类型直接释放
+    void recycleBall(BaseBall* ball);
+    // restore用：对象池里有就取，没有就新建一个空球（数据随后被快照整条覆盖）
+    BaseBall* acquireBlankBall(BaseBall::BallType type);
     
     // ID管理
     int getNextBallId() { return m_nextBallId++; }
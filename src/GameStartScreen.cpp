@@ -355,6 +355,36 @@ void GameStartScreen::setupAdvancedConfigTab() {
     connect(m_timeLimitSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &GameStartScreen::onConfigurationChanged);
     layout->addRow(m_timeLimitLabel, m_timeLimitSpinBox);
     
+    // 模拟速度配置：AI对战只关心结果时可以选加速模式
+    m_simulationSpeedLabel = new QLabel("模拟速度:");
+    m_simulationSpeedComboBox = new QComboBox();
+    m_simulationSpeedComboBox->addItem("1x 正常", 1);
+    m_simulationSpeedComboBox->addItem("2x", 2);
+    m_simulationSpeedComboBox->addItem("4x", 4);
+    m_simulationSpeedComboBox->addItem("8x", 8);
+    m_simulationSpeedComboBox->addItem("⚡ 加速模式（全速）", 0);
+    
+    m_turboRenderLabel = new QLabel("加速模式画面刷新:");
+    m_turboRenderSpinBox = new QSpinBox();
+    m_turboRenderSpinBox->setRange(0, 6000);
+    m_turboRenderSpinBox->setValue(0);
+    m_turboRenderSpinBox->setSuffix(" 帧 (0=不刷新)");
+    m_turboRenderSpinBox->setEnabled(false);
+    
+    connect(m_simulationSpeedComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        m_turboRenderSpinBox->setEnabled(m_simulationSpeedComboBox->currentData().toInt() == 0);
+        onConfigurationChanged();
+    });
+    connect(m_turboRenderSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &GameStartScreen::onConfigurationChanged);
+    layout->addRow(m_simulationSpeedLabel, m_simulationSpeedComboBox);
+    layout->addRow(m_turboRenderLabel, m_turboRenderSpinBox);
+    
+    // 性能分析：录制整局的时间线，文件写在工作目录
+    m_chromeTraceCheckBox = new QCheckBox("录制性能时间线 (chrome://tracing)");
+    m_chromeTraceCheckBox->setChecked(false);
+    connect(m_chromeTraceCheckBox, &QCheckBox::toggled, this, &GameStartScreen::onConfigurationChanged);
+    layout->addRow(m_chromeTraceCheckBox);
+    
     // BOSS模式特殊配置
     m_bossConfigWidget = new QWidget(m_advancedConfigTab);
     setupBossConfigWidget();
@@ -739,6 +769,9 @@ void GameStartScreen::resetConfigurationToDefaults() {
     m_teamModeCheckBox->setChecked(true);
     m_friendlyFireCheckBox->setChecked(false);
     m_timeLimitSpinBox->setValue(0);
+    m_simulationSpeedComboBox->setCurrentIndex(0);
+    m_turboRenderSpinBox->setValue(0);
+    m_chromeTraceCheckBox->setChecked(false);
     
     // 恢复信号
     blockSignals(oldState);
@@ -792,6 +825,9 @@ void GameStartScreen::updateGameConfig() {
     m_gameConfig.enableTeamMode = m_teamModeCheckBox->isChecked();
     m_gameConfig.enableFriendlyFire = m_friendlyFireCheckBox->isChecked();
     m_gameConfig.gameTimeLimit = m_timeLimitSpinBox->value();
+    m_gameConfig.simulationSpeed = m_simulationSpeedComboBox->currentData().toInt();
+    m_gameConfig.turboRenderInterval = m_turboRenderSpinBox->value();
+    m_gameConfig.recordChromeTrace = m_chromeTraceCheckBox->isChecked();
     
     // BOSS模式配置
     if (m_currentMode == GameMode::BOSS_CHALLENGE) {
@@ -1115,6 +1151,9 @@ QJsonObject GameStartScreen::configToJson() const {
     config["teamMode"] = m_teamModeCheckBox->isChecked();
     config["friendlyFire"] = m_friendlyFireCheckBox->isChecked();
     config["timeLimit"] = m_timeLimitSpinBox->value();
+    config["simulationSpeed"] = m_simulationSpeedComboBox->currentData().toInt();
+    config["turboRenderInterval"] = m_turboRenderSpinBox->value();
+    config["chromeTrace"] = m_chromeTraceCheckBox->isChecked();
     
     if (m_currentMode == GameMode::BOSS_CHALLENGE) {
         config["bossScore"] = m_bossScoreSpinBox->value();
@@ -1174,6 +1213,17 @@ void GameStartScreen::configFromJson(const QJsonObject& json) {
     if (json.contains("timeLimit")) {
         m_timeLimitSpinBox->setValue(json["timeLimit"].toInt());
     }
+    if (json.contains("simulationSpeed")) {
+        int index = m_simulationSpeedComboBox->findData(json["simulationSpeed"].toInt());
+        m_simulationSpeedComboBox->setCurrentIndex(qMax(0, index));
+        m_turboRenderSpinBox->setEnabled(m_simulationSpeedComboBox->currentData().toInt() == 0);
+    }
+    if (json.contains("turboRenderInterval")) {
+        m_turboRenderSpinBox->setValue(json["turboRenderInterval"].toInt());
+    }
+    if (json.contains("chromeTrace")) {
+        m_chromeTraceCheckBox->setChecked(json["chromeTrace"].toBool());
+    }
     
     if (m_currentMode == GameMode::BOSS_CHALLENGE) {
         if (json.contains("bossScore")) {
@@ -69,7 +69,14 @@ struct GameConfig {
     // 游戏规则配置
     bool enableTeamMode = true;
     bool enableFriendlyFire = false;
-    int gameTimeLimit = 0; // 0表示无时间限制
+    int gameTimeLimit = 0; // 0表示无时间限制（按游戏时间计）
+    
+    // 模拟速度配置
+    int simulationSpeed = 1;        // 倍速，0表示加速模式（全速推进）
+    int turboRenderInterval = 0;    // 加速模式下每隔多少逻辑帧刷新一次画面，0表示不刷新
+    
+    // 性能分析：把这一局录成Chrome时间线（chrome://tracing / Perfetto）
+    bool recordChromeTrace = false;
 };
 
 class GameStartScreen : public QWidget {
@@ -177,6 +184,11 @@ private:
     QCheckBox* m_friendlyFireCheckBox;
     QLabel* m_timeLimitLabel;
     QSpinBox* m_timeLimitSpinBox;
+    QLabel* m_simulationSpeedLabel;
+    QComboBox* m_simulationSpeedComboBox;
+    QLabel* m_turboRenderLabel;
+    QSpinBox* m_turboRenderSpinBox;
+    QCheckBox* m_chromeTraceCheckBox;
     
     // BOSS模式特殊配置
     QWidget* m_bossConfigWidget;
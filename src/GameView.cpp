@@ -7,6 +7,7 @@
 #include "SimpleAIPlayer.h"
 #include "AIDebugWidget.h"
 #include "GoBiggerConfig.h"
+#include "core/Trace.h"
 #include <QGraphicsScene>
 #include <QKeyEvent>
 #include <QMouseEvent>
@@ -17,6 +18,7 @@
 #include <QColor>
 #include <QVector2D>
 #include <QDebug>
+#include <QDateTime>
 #include <QCursor>
 #include <QPainter>
 #include <QDialog>
@@ -38,7 +40,7 @@ GameView::GameView(QWidget *parent)
     : QGraphicsView(parent)
     , m_gameManager(nullptr)
     , m_mainPlayer(nullptr)
-    , m_inputTimer(nullptr)
+    , m_renderTimer(nullptr)
     , m_zoomFactor(1.0)
     , m_followPlayer(true)
     , m_targetZoom(1.0)
@@ -65,9 +67,9 @@ GameView::GameView(QWidget *parent)
 
 GameView::~GameView()
 {
-    if (m_inputTimer) {
-        m_inputTimer->stop();
-        delete m_inputTimer;
+    if (m_renderTimer) {
+        m_renderTimer->stop();
+        delete m_renderTimer;
     }
     
     if (m_aiDebugWidget) {
@@ -107,6 +109,7 @@ void GameView::initializeView()
     // 创建游戏管理器 - 使用扩大的地图边界
     GameManager::Config config;
     config.gameBorder = Border(-3000, 3000, -3000, 3000); // 6000x6000的游戏边界
+    config.interpolateRendering = true; // 逻辑帧率可以低于显示帧率，渲染时插值
     m_gameManager = new GameManager(scene, config, this);
     
     // 更新AI调试窗口的GameManager引用
@@ -116,10 +119,13 @@ void GameView::initializeView()
         m_aiDebugWidget->hide();
     }
     
-    // 创建输入处理定时器
-    m_inputTimer = new QTimer(this);
-    connect(m_inputTimer, &QTimer::timeout, this, &GameView::updateGameView);
-    m_inputTimer->start(16); // 60 FPS
+    // 输入作为帧调度的第一个阶段，和模拟同步推进，暂停时也一并停止
+    m_gameManager->scheduler()->addPhase(GameManager::PHASE_INPUT, "input", [this]() { processInput(); });
+    
+    // 渲染定时器只负责插值同步、相机和重绘
+    m_renderTimer = new QTimer(this);
+    connect(m_renderTimer, &QTimer::timeout, this, &GameView::updateGameView);
+    m_renderTimer->start(16); // 60 FPS
 }
 
 void GameView::initializePlayer()
@@ -147,7 +153,7 @@ void GameView::initializePlayer()
             m_mainPlayer = player;
             
             // 重新设置视角
-            QPointF playerPos = m_mainPlayer->pos();
+            QPointF playerPos = m_mainPlayer->position();
             float initialRadius = m_mainPlayer->radius();
             float initialVisionSize = initialRadius * 12.0f;
             float viewportSize = std::min(width(), height()) * 0.8f;
@@ -195,7 +201,7 @@ void GameView::initializePlayer()
         m_mainPlayer->setScore(GoBiggerConfig::CELL_INIT_SCORE); // 使用新的标准初始分数
         
         // 🔥 初始视角稳定设置
-        QPointF playerPos = m_mainPlayer->pos();
+        QPointF playerPos = m_mainPlayer->position();
         m_lastCentroid = playerPos;
         
         // 立即设置合理的初始缩放，避免后续计算导致的跳跃
@@ -220,7 +226,7 @@ void GameView::initializePlayer()
         m_stableFrameCount = 0;
         
         qDebug() << "Main player created with ID:" << m_mainPlayer->ballId() 
-                 << "at position:" << m_mainPlayer->pos()
+                 << "at position:" << m_mainPlayer->position()
                  << "with radius:" << m_mainPlayer->radius()
                  << "with score:" << m_mainPlayer->score()
                  << "initial zoom:" << initialZoom;
@@ -237,7 +243,10 @@ void GameView::setupConnections()
         connect(m_gameManager, &GameManager::gameReset, this, &GameView::onGameReset);
         connect(m_gameManager, &GameManager::playerAdded, this, &GameView::onPlayerAdded);
         connect(m_gameManager, &GameManager::playerRemoved, this, &GameView::onPlayerRemoved);
+        connect(m_gameManager, &GameManager::tickEvents, this, &GameView::onTickEvents);
         connect(m_gameManager, &GameManager::gameOver, this, &GameView::onGameOver);
+        connect(m_gameManager, &GameManager::simulationSpeedChanged, this, &GameView::onSimulationSpeedChanged);
+        connect(m_gameManager, &GameManager::worldRestored, this, &GameView::onWorldRestored);
     }
 }
 
@@ -255,6 +264,33 @@ void GameView::pauseGame()
     }
 }
 
+void GameView::setSimulationSpeed(qreal multiplier)
+{
+    if (m_gameManager) {
+        m_gameManager->setSimulationSpeed(qBound(0.25, multiplier, 16.0));
+    }
+}
+
+void GameView::setTurboMode(bool enabled, int renderEveryTicks)
+{
+    if (m_gameManager) {
+        m_gameManager->setTurboMode(enabled, renderEveryTicks);
+    }
+}
+
+void GameView::onSimulationSpeedChanged(qreal multiplier, bool turbo)
+{
+    // 加速模式且完全不同步场景时，连视口重绘也停掉
+    const bool renderSuspended = turbo && m_gameManager->turboRenderInterval() <= 0;
+    viewport()->setUpdatesEnabled(!renderSuspended);
+    if (!renderSuspended) {
+        viewport()->update();
+    }
+    
+    qDebug() << "GameView: simulation speed" << multiplier << "x turbo:" << turbo
+             << "render suspended:" << renderSuspended;
+}
+
 void GameView::resetGame()
 {
     if (m_gameManager) {
@@ -305,6 +341,26 @@ void GameView::keyPressEvent(QKeyEvent *event)
         case Qt::Key_Escape:
             resetGame();
             break;
+        case Qt::Key_BracketRight:
+            setSimulationSpeed(m_gameManager->simulationSpeed() * 2.0);
+            break;
+        case Qt::Key_BracketLeft:
+            setSimulationSpeed(m_gameManager->simulationSpeed() / 2.0);
+            break;
+        case Qt::Key_T:
+            setTurboMode(!m_gameManager->isTurboMode(), m_gameManager->turboRenderInterval());
+            break;
+        case Qt::Key_F9: {
+            // 导出追踪缓冲区（运行期级别由环境变量GOBIGGER_TRACE打开）
+            const QString path = QString("gobigger_trace_%1.txt")
+                                     .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+            if (Trace::dumpToFile(path)) {
+                qDebug() << "Trace dumped to" << path;
+            } else {
+                qWarning() << "Failed to dump trace to" << path;
+            }
+            break;
+        }
         // 移除WASD移动控制，改为鼠标控制
     }
     
@@ -344,7 +400,17 @@ void GameView::wheelEvent(QWheelEvent *event)
 
 void GameView::updateGameView()
 {
-    processInput();
+    // 加速模式下场景由GameManager隔帧同步（或完全不同步），这里不再插值
+    if (m_gameManager->isTurboMode()) {
+        if (m_gameManager->turboRenderInterval() > 0) {
+            updateCamera();
+            viewport()->update();
+        }
+        return;
+    }
+    
+    // 按累加器里剩余的时间在最近两个逻辑帧之间插值
+    m_gameManager->syncGraphics(m_gameManager->scheduler()->alpha());
     updateCamera();
     
     // 🔥 触发UI层重绘，确保排行榜及时更新
@@ -376,7 +442,7 @@ void GameView::processInput()
         if (!ball || ball->isRemoved()) continue;
         
         // 1. 每个球独立计算到鼠标的方向（关键修复！）
-        QPointF ballPos = ball->pos();
+        QPointF ballPos = ball->position();
         QVector2D toMouse(sceneMousePos.x() - ballPos.x(), sceneMousePos.y() - ballPos.y());
         
         // 只有当鼠标距离足够远时才移动（避免在球中心时抖动）
@@ -558,7 +624,7 @@ void GameView::calculateIntelligentZoomGoBigger(const QVector<CloneBall*>& allPl
     for (CloneBall* ball : allPlayerBalls) {
         if (!ball || ball->isRemoved()) continue;
         
-        QPointF pos = ball->pos();
+        QPointF pos = ball->position();
         float radius = ball->radius();
         float score = ball->score();
         
@@ -680,7 +746,7 @@ qreal GameView::calculatePlayerRadius() const
     
     // 如果玩家只有一个球，直接返回球的半径
     // 这里简化处理，实际GoBigger会考虑所有分裂的球
-    QPointF centroid = m_mainPlayer->pos();
+    QPointF centroid = m_mainPlayer->position();
     qreal playerRadius = m_mainPlayer->radius();
     
     // 模拟GoBigger的计算方式：
@@ -702,7 +768,7 @@ QPointF GameView::calculatePlayerCentroid() const
     
     // 简化版本：直接返回主球位置
     // 实际GoBigger会计算所有分裂球的质心
-    return m_mainPlayer->pos();
+    return m_mainPlayer->position();
 }
 
 void GameView::adjustZoom()
@@ -778,7 +844,7 @@ void GameView::handleSplitAction()
         
         if (ball->canSplit()) {
             // 每个球独立计算到鼠标的分裂方向
-            QPointF ballPos = ball->pos();
+            QPointF ballPos = ball->position();
             QVector2D toMouse(sceneMousePos.x() - ballPos.x(), sceneMousePos.y() - ballPos.y());
             
             QVector2D splitDirection;
@@ -828,7 +894,7 @@ void GameView::handleEjectAction()
         
         if (ball->canEject()) {
             // 每个球独立计算到鼠标的喷射方向
-            QPointF ballPos = ball->pos();
+            QPointF ballPos = ball->position();
             QVector2D toMouse(sceneMousePos.x() - ballPos.x(), sceneMousePos.y() - ballPos.y());
             
             QVector2D ejectDirection;
@@ -845,7 +911,7 @@ void GameView::handleEjectAction()
             if (spore) {
                 allSpores.append(spore);
                 qDebug() << "Ball" << ball->ballId() << "ejected spore successfully at position:" 
-                         << spore->pos().x() << spore->pos().y()
+                         << spore->position().x() << spore->position().y()
                          << "with velocity:" << spore->velocity().length();
             } else {
                 qDebug() << "Ball" << ball->ballId() << "failed to create spore";
@@ -870,6 +936,9 @@ QColor GameView::getTeamColor(int teamId) const
 
 void GameView::paintEvent(QPaintEvent *event)
 {
+    // 绘制耗时计入分阶段统计（在逻辑帧之外，每次绘制一个样本）
+    PROFILE_SCOPE(m_gameManager ? m_gameManager->profiler() : nullptr, Paint);
+    
     // 首先调用基类的paintEvent
     QGraphicsView::paintEvent(event);
 
@@ -994,6 +1063,35 @@ void GameView::onPlayerRemoved(CloneBall* player)
     }
 }
 
+void GameView::onTickEvents(const QVector<GameEvent>& events)
+{
+    if (!m_mainPlayer) return;
+    
+    // 只关心主球被吃掉/合并掉；此时球还没回收，换主球之后不会再碰到它
+    for (const GameEvent& event : events) {
+        if (event.type == GameEvent::REMOVED && event.subject == m_mainPlayer) {
+            onPlayerRemoved(m_mainPlayer);
+            break;
+        }
+    }
+}
+
+void GameView::onWorldRestored()
+{
+    // 原来的指针可能已经变成别的球了，按人类玩家的(队伍, 玩家)重新找，取最大的分身
+    m_mainPlayer = nullptr;
+    for (CloneBall* ball : m_gameManager->getPlayerBalls(GoBiggerConfig::HUMAN_TEAM_ID, 0)) {
+        if (!m_mainPlayer || ball->score() > m_mainPlayer->score()) {
+            m_mainPlayer = ball;
+        }
+    }
+    
+    // 镜头从新位置重新稳定
+    m_isInitialStabilizing = true;
+    m_stableFrameCount = 0;
+    qDebug() << "World restored - main player" << (m_mainPlayer ? m_mainPlayer->ballId() : -1);
+}
+
 void GameView::onAIPlayerDestroyed(GoBigger::AI::SimpleAIPlayer* aiPlayer)
 {
     if (!aiPlayer) return;
@@ -1303,7 +1401,7 @@ QPointF GameView::calculatePlayerCentroidAll(const QVector<CloneBall*>& balls) c
     for (CloneBall* ball : balls) {
         if (ball && !ball->isRemoved()) {
             qreal mass = ball->score();
-            centroid += ball->pos() * mass;
+            centroid += ball->pos() * mass; // 用插值后的渲染位置，相机才不会跟着逻辑帧跳动
             totalMass += mass;
         }
     }
@@ -7,6 +7,7 @@
 #include <QSet>
 #include <QVector2D>
 #include <QMap>
+#include "GameEvent.h"
 
 class GameManager;
 class CloneBall;
@@ -28,6 +29,10 @@ public:
     void pauseGame();
     void resetGame();
     bool isGameRunning() const;
+    
+    // 模拟速度（[ / ] 调速，T 切换加速模式）
+    void setSimulationSpeed(qreal multiplier);
+    void setTurboMode(bool enabled, int renderEveryTicks = 0);
 
     // 玩家控制
     CloneBall* getMainPlayer() const { return m_mainPlayer; }
@@ -66,8 +71,11 @@ private slots:
     void onGameReset();
     void onPlayerAdded(CloneBall* player);
     void onPlayerRemoved(CloneBall* player);
+    void onTickEvents(const QVector<GameEvent>& events); // 帧末的整批事件（主球被吃/合并时换主球）
     void onAIPlayerDestroyed(GoBigger::AI::SimpleAIPlayer* aiPlayer); // 新增：处理AI玩家销毁
     void onGameOver(int winningTeamId);
+    void onSimulationSpeedChanged(qreal multiplier, bool turbo);
+    void onWorldRestored(); // 快照恢复后球对象都换了身份，重新找主球
 
 private:
     void showGameOverScreen(int winningTeamId);
@@ -76,7 +84,7 @@ private:
     
     // 输入处理
     QSet<int> m_pressedKeys;
-    QTimer* m_inputTimer;
+    QTimer* m_renderTimer;
     
     // 视图控制
     qreal m_zoomFactor;
@@ -84,6 +84,10 @@ constexpr int FOOD_MAX_AGE_SECONDS = 60;           // 食物最大存活时间
 constexpr int FOOD_CLEANUP_INTERVAL_SECONDS = 15;  // 清理检查间隔：15秒
 constexpr int FOOD_CLEANUP_BATCH_SIZE = 50;        // 每次检查的食物数量
 
+// 🔥 新增：固定步长模拟参数（无头引擎逐帧推进，不依赖定时器）
+constexpr int SIM_FPS = 60;                        // 模拟帧率（对应16ms游戏定时器）
+constexpr int DECAY_INTERVAL_MS = 100;            // 分数衰减间隔（毫秒），按逻辑帧长换算成帧数
+
 // 衰减参数 (参考GoBigger原版)
 constexpr float DECAY_START_SCORE = 2600.0f;       // 开始衰减的分数 (GoBigger标准)
 constexpr float DECAY_RATE = 0.00005f;             // 衰减速率 (GoBigger标准)
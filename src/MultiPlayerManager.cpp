@@ -232,6 +232,20 @@ void MultiPlayerManager::resumeMultiPlayerGame()
     emit gameResumed();
 }
 
+void MultiPlayerManager::setSimulationSpeed(qreal multiplier)
+{
+    if (m_gameManager) {
+        m_gameManager->setSimulationSpeed(multiplier);
+    }
+}
+
+void MultiPlayerManager::setTurboMode(bool enabled, int renderEveryTicks)
+{
+    if (m_gameManager) {
+        m_gameManager->setTurboMode(enabled, renderEveryTicks);
+    }
+}
+
 QVector<PlayerInfo> MultiPlayerManager::getActivePlayers() const
 {
     QVector<PlayerInfo> activePlayers;
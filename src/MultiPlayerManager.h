@@ -48,6 +48,10 @@ public:
     void pauseMultiPlayerGame();
     void resumeMultiPlayerGame();
     
+    // 模拟速度：AI对战只关心结果时可以开加速模式（renderEveryTicks为0时不刷新画面）
+    void setSimulationSpeed(qreal multiplier);
+    void setTurboMode(bool enabled, int renderEveryTicks = 0);
+    
     // 玩家信息
     QVector<PlayerInfo> getAllPlayers() const { return m_players; }
     QVector<PlayerInfo> getActivePlayers() const;
@@ -1,4 +1,5 @@
 #include "ONNXInference.h"
+#include "core/ChromeTrace.h"
 #include <QDebug>
 #include <QFileInfo>
 #include <stdexcept>
@@ -183,6 +184,9 @@ bool ONNXInference::loadModel(const std::string& modelPath) {
 }
 
 std::vector<float> ONNXInference::predict(const std::vector<float>& observation) {
+    ChromeTrace::Span span("ONNXInference::predict", "ai");
+    span.setArg("inputSize", static_cast<qint64>(observation.size()));
+    
 #ifndef HAS_ONNXRUNTIME
     qWarning() << "ONNX Runtime not available, cannot predict";
     return {};
@@ -3,11 +3,35 @@
 #include <QDebug>
 #include <algorithm>
 
-QuadTree::QuadTree(const QRectF& bounds, int maxDepth, int maxBallsPerNode)
-    : m_root(std::make_unique<Node>(bounds))
-    , m_maxDepth(maxDepth)
+namespace {
+    // 深度上限决定了迭代遍历的栈大小：深度优先时每层最多留下3个兄弟节点
+    constexpr int MAX_TREE_DEPTH = 16;
+    constexpr int TRAVERSAL_STACK_SIZE = MAX_TREE_DEPTH * 3 + 4;
+}
+
+QuadTree::QuadTree(const QRectF& bounds, int maxDepth, int maxBallsPerNode, qreal looseness)
+    : m_bounds(bounds)
+    , m_maxDepth(std::clamp(maxDepth, 0, MAX_TREE_DEPTH))
     , m_maxBallsPerNode(maxBallsPerNode)
+    , m_looseness(looseness)
 {
+    resetNodes();
+}
+
+void QuadTree::resetNodes()
+{
+    // 只清空正在使用的球桶，容量留给下一次复用
+    for (int i = 0; i < m_nodes.size(); ++i) {
+        m_buckets[i].clear();
+    }
+
+    m_nodes.clear();
+    m_freeBlocks.clear();
+    m_nodes.append(Node(m_bounds, m_looseness, -1, 0));
+
+    if (m_buckets.isEmpty()) {
+        m_buckets.resize(1);
+    }
 }
 
 void QuadTree::insert(BaseBall* ball)
@@ -15,180 +39,308 @@ void QuadTree::insert(BaseBall* ball)
     if (!ball || ball->isRemoved()) {
         return;
     }
-    
-    insertNode(m_root.get(), ball, 0);
+
+    if (m_ballNodes.contains(ball)) {
+        update(ball);
+        return;
+    }
+
+    insertFrom(0, ball, ballBounds(ball));
+}
+
+void QuadTree::remove(BaseBall* ball)
+{
+    int node = m_ballNodes.value(ball, -1);
+    if (node < 0) {
+        return;
+    }
+
+    m_ballNodes.remove(ball);
+    detach(node, ball);
+    collapse(node);
 }
 
-void QuadTree::insertNode(Node* node, BaseBall* ball, int depth)
+void QuadTree::update(BaseBall* ball)
 {
-    if (!node) return;
-    
-    QRectF ballBounds = getBallBounds(ball);
-    
-    // 检查球体是否在当前节点范围内
-    if (!node->bounds.intersects(ballBounds)) {
+    if (!ball) return;
+
+    int node = m_ballNodes.value(ball, -1);
+    if (node < 0) {
+        insert(ball);
         return;
     }
-    
-    // 如果是叶子节点且球数量未超限，直接添加
-    if (node->isLeaf) {
-        node->balls.append(ball);
-        
-        // 检查是否需要细分
-        if (shouldSubdivide(node, depth)) {
-            subdivide(node);
-            
-            // 重新分配球体到子节点
-            QVector<BaseBall*> ballsToRedistribute = node->balls;
-            node->balls.clear();
-            
-            for (BaseBall* b : ballsToRedistribute) {
-                for (auto& child : node->children) {
-                    insertNode(child.get(), b, depth + 1);
-                }
-            }
+
+    QRectF box = ballBounds(ball);
+    const Node& current = m_nodes[node];
+
+    // 根节点收容越界的球，永远"装得下"
+    if (current.parent < 0 || current.looseBounds.contains(box)) {
+        if (current.isLeaf()) {
+            return;
         }
-    } else {
-        // 不是叶子节点，插入到合适的子节点
-        for (auto& child : node->children) {
-            insertNode(child.get(), ball, depth + 1);
+        // 还能下沉到子节点时才需要移动（球变小或移向节点中心）
+        int child = childFor(node, box.center());
+        if (!m_nodes[child].looseBounds.contains(box)) {
+            return;
         }
     }
+
+    // 向上找到能容纳它的祖先，再从那里向下重新插入
+    detach(node, ball);
+    int target = node;
+    while (m_nodes[target].parent >= 0 && !m_nodes[target].looseBounds.contains(box)) {
+        target = m_nodes[target].parent;
+    }
+    insertFrom(target, ball, box);
+    collapse(node);
 }
 
-void QuadTree::subdivide(Node* node)
+void QuadTree::insertFrom(int start, BaseBall* ball, const QRectF& box)
 {
-    if (!node || !node->isLeaf) return;
-    
-    qreal x = node->bounds.x();
-    qreal y = node->bounds.y();
-    qreal w = node->bounds.width() / 2.0;
-    qreal h = node->bounds.height() / 2.0;
-    
-    // 创建四个子节点：西北、东北、西南、东南
-    node->children[0] = std::make_unique<Node>(QRectF(x, y, w, h));         // NW
-    node->children[1] = std::make_unique<Node>(QRectF(x + w, y, w, h));     // NE
-    node->children[2] = std::make_unique<Node>(QRectF(x, y + h, w, h));     // SW
-    node->children[3] = std::make_unique<Node>(QRectF(x + w, y + h, w, h)); // SE
-    
-    node->isLeaf = false;
+    int node = start;
+    const QPointF center = box.center();
+
+    while (!m_nodes[node].isLeaf()) {
+        int child = childFor(node, center);
+        if (!m_nodes[child].looseBounds.contains(box)) {
+            break;
+        }
+        node = child;
+    }
+
+    attach(node, ball);
+
+    // 叶子节点超出容量时细分，并把能下沉的球分配到子节点
+    if (m_nodes[node].isLeaf() && shouldSubdivide(node)) {
+        pushDown(node);
+    }
 }
 
-bool QuadTree::shouldSubdivide(const Node* node, int depth) const
+void QuadTree::attach(int node, BaseBall* ball)
 {
-    return (node->balls.size() > m_maxBallsPerNode) && (depth < m_maxDepth);
+    m_buckets[node].append(ball);
+    m_ballNodes.insert(ball, node);
+
+    for (int n = node; n >= 0; n = m_nodes[n].parent) {
+        m_nodes[n].subtreeCount++;
+    }
 }
 
-QVector<BaseBall*> QuadTree::query(const QRectF& range) const
+void QuadTree::detach(int node, BaseBall* ball)
 {
-    QVector<BaseBall*> result;
-    queryNode(m_root.get(), range, result);
-    return result;
+    // 交换删除，节点内顺序不重要
+    QVector<BaseBall*>& bucket = m_buckets[node];
+    int index = bucket.indexOf(ball);
+    if (index < 0) return;
+
+    bucket[index] = bucket.last();
+    bucket.removeLast();
+
+    for (int n = node; n >= 0; n = m_nodes[n].parent) {
+        m_nodes[n].subtreeCount--;
+    }
 }
 
-void QuadTree::queryNode(const Node* node, const QRectF& range, QVector<BaseBall*>& result) const
+void QuadTree::pushDown(int node)
 {
-    if (!node || !node->bounds.intersects(range)) {
-        return;
-    }
-    
-    if (node->isLeaf) {
-        // 叶子节点，检查每个球体
-        for (BaseBall* ball : node->balls) {
-            if (ball && !ball->isRemoved()) {
-                QRectF ballBounds = getBallBounds(ball);
-                if (range.intersects(ballBounds)) {
-                    result.append(ball);
-                }
+    // 细分node，把能下沉的球分到子节点；子节点仍然超载时继续细分（显式栈，不递归）
+    int stack[TRAVERSAL_STACK_SIZE];
+    int top = 0;
+    stack[top++] = node;
+
+    while (top > 0) {
+        const int current = stack[--top];
+        subdivide(current);
+
+        QVector<BaseBall*>& bucket = m_buckets[current];
+        int kept = 0;
+        for (int i = 0; i < bucket.size(); ++i) {
+            BaseBall* ball = bucket[i];
+            QRectF box = ballBounds(ball);
+            int child = childFor(current, box.center());
+
+            if (m_nodes[child].looseBounds.contains(box)) {
+                m_buckets[child].append(ball);
+                m_nodes[child].subtreeCount++;
+                m_ballNodes.insert(ball, child);
+            } else {
+                bucket[kept++] = ball; // 太大的球留在当前节点
             }
         }
-    } else {
-        // 非叶子节点，递归查询子节点
-        for (const auto& child : node->children) {
-            queryNode(child.get(), range, result);
+        bucket.resize(kept);
+
+        const int firstChild = m_nodes[current].firstChild;
+        for (int i = 0; i < 4; ++i) {
+            if (shouldSubdivide(firstChild + i)) {
+                stack[top++] = firstChild + i;
+            }
         }
     }
 }
 
-QVector<BaseBall*> QuadTree::queryCollisions(BaseBall* ball) const
+void QuadTree::collapse(int node)
 {
-    if (!ball || ball->isRemoved()) {
-        return QVector<BaseBall*>();
-    }
-    
-    // 创建一个稍大的查询范围，考虑碰撞检测的误差
-    QRectF ballBounds = getBallBounds(ball);
-    qreal margin = ball->radius() * 0.1; // 10%的误差范围
-    ballBounds.adjust(-margin, -margin, margin, margin);
-    
-    QVector<BaseBall*> candidates = query(ballBounds);
-    
-    // 移除自己
-    candidates.removeAll(ball);
-    
-    return candidates;
+    // 子树里的球少到一个节点就能装下时，合并子节点，避免空节点越积越多
+    int candidate = -1;
+    for (int n = m_nodes[node].isLeaf() ? m_nodes[node].parent : node; n >= 0; n = m_nodes[n].parent) {
+        if (!m_nodes[n].isLeaf() && m_nodes[n].subtreeCount <= m_maxBallsPerNode / 2) {
+            candidate = n; // 继续向上找最高的可合并节点
+        }
+    }
+
+    if (candidate < 0) return;
+
+    // 把整棵子树的球收回candidate，子节点块放回空闲列表
+    QVector<BaseBall*>& target = m_buckets[candidate];
+    int stack[TRAVERSAL_STACK_SIZE];
+    int top = 0;
+    stack[top++] = candidate;
+
+    while (top > 0) {
+        const int current = stack[--top];
+        const int firstChild = m_nodes[current].firstChild;
+        if (firstChild < 0) continue;
+
+        for (int i = 0; i < 4; ++i) {
+            const int child = firstChild + i;
+            for (BaseBall* ball : m_buckets[child]) {
+                target.append(ball);
+                m_ballNodes.insert(ball, candidate);
+            }
+            m_buckets[child].clear();
+            stack[top++] = child;
+        }
+
+        m_nodes[current].firstChild = -1;
+        m_freeBlocks.append(firstChild);
+    }
 }
 
-void QuadTree::clear()
+int QuadTree::childFor(int node, const QPointF& center) const
 {
-    if (m_root) {
-        m_root->clear();
-    }
+    const Node& n = m_nodes[node];
+    const QPointF mid = n.bounds.center();
+    int index = (center.x() >= mid.x() ? 1 : 0) + (center.y() >= mid.y() ? 2 : 0);
+    return n.firstChild + index;
 }
 
-void QuadTree::rebuild(const QVector<BaseBall*>& allBalls)
+void QuadTree::subdivide(int node)
 {
-    clear();
-    
-    for (BaseBall* ball : allBalls) {
-        insert(ball);
+    if (!m_nodes[node].isLeaf()) return;
+
+    // 优先复用合并时回收的节点块，否则在数组末尾追加（球桶随之扩展，已有容量保留）
+    int first;
+    if (!m_freeBlocks.isEmpty()) {
+        first = m_freeBlocks.takeLast();
+    } else {
+        first = m_nodes.size();
+        m_nodes.resize(first + 4);
+        if (m_buckets.size() < m_nodes.size()) {
+            m_buckets.resize(m_nodes.size());
+        }
     }
+
+    const QRectF bounds = m_nodes[node].bounds;
+    qreal x = bounds.x();
+    qreal y = bounds.y();
+    qreal w = bounds.width() / 2.0;
+    qreal h = bounds.height() / 2.0;
+    int depth = m_nodes[node].depth + 1;
+
+    // 创建四个子节点：西北、东北、西南、东南（与childFor的象限编号一致）
+    m_nodes[first + 0] = Node(QRectF(x, y, w, h), m_looseness, node, depth);         // NW
+    m_nodes[first + 1] = Node(QRectF(x + w, y, w, h), m_looseness, node, depth);     // NE
+    m_nodes[first + 2] = Node(QRectF(x, y + h, w, h), m_looseness, node, depth);     // SW
+    m_nodes[first + 3] = Node(QRectF(x + w, y + h, w, h), m_looseness, node, depth); // SE
+
+    m_nodes[node].firstChild = first;
 }
 
-QRectF QuadTree::getBallBounds(BaseBall* ball) const
+bool QuadTree::shouldSubdivide(int node) const
 {
-    if (!ball) return QRectF();
-    
-    QPointF pos = ball->pos();
-    qreal radius = ball->radius();
-    
-    return QRectF(pos.x() - radius, pos.y() - radius, 
-                  radius * 2, radius * 2);
+    return (m_buckets[node].size() > m_maxBallsPerNode) && (m_nodes[node].depth < m_maxDepth);
 }
 
-int QuadTree::getNodeCount() const
+void QuadTree::forEachInRange(const QRectF& range, BallVisitor visitor) const
 {
-    return countNodes(m_root.get());
+    int stack[TRAVERSAL_STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const int index = stack[--top];
+        const Node& node = m_nodes[index];
+
+        // 松散边界覆盖了节点内所有球的包围盒
+        if (node.subtreeCount == 0 || !node.looseBounds.intersects(range)) {
+            continue;
+        }
+
+        // 检查存放在本节点的球体
+        for (BaseBall* ball : m_buckets[index]) {
+            if (ball && !ball->isRemoved()) {
+                QRectF box = ballBounds(ball);
+                if (range.intersects(box)) {
+                    visitor(ball);
+                }
+            }
+        }
+
+        if (!node.isLeaf()) {
+            for (int i = 3; i >= 0; --i) {
+                stack[top++] = node.firstChild + i;
+            }
+        }
+    }
 }
 
-int QuadTree::countNodes(const Node* node) const
+void QuadTree::clear()
 {
-    if (!node) return 0;
-    
-    int count = 1; // 当前节点
-    
-    if (!node->isLeaf) {
-        for (const auto& child : node->children) {
-            count += countNodes(child.get());
-        }
+    resetNodes();
+    m_ballNodes.clear();
+}
+
+QVector<BaseBall*> QuadTree::balls() const
+{
+    // 空闲节点的球桶总是空的，直接顺序拼接即可
+    QVector<BaseBall*> result;
+    result.reserve(m_ballNodes.size());
+    for (int i = 0; i < m_nodes.size(); ++i) {
+        result += m_buckets[i];
     }
-    
-    return count;
+    return result;
 }
 
-int QuadTree::getMaxDepth() const
+QString QuadTree::statistics() const
+{
+    return QString("nodes=%1 depth=%2 balls=%3")
+        .arg(getNodeCount())
+        .arg(getMaxDepth())
+        .arg(ballCount());
+}
+
+int QuadTree::getNodeCount() const
 {
-    return getDepth(m_root.get());
+    return m_nodes.size() - m_freeBlocks.size() * 4;
 }
 
-int QuadTree::getDepth(const Node* node) const
+int QuadTree::getMaxDepth() const
 {
-    if (!node || node->isLeaf) return 1;
-    
-    int maxChildDepth = 0;
-    for (const auto& child : node->children) {
-        maxChildDepth = std::max(maxChildDepth, getDepth(child.get()));
+    int maxDepth = 0;
+    int stack[TRAVERSAL_STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& node = m_nodes[stack[--top]];
+        maxDepth = std::max(maxDepth, node.depth + 1);
+
+        if (!node.isLeaf()) {
+            for (int i = 0; i < 4; ++i) {
+                stack[top++] = node.firstChild + i;
+            }
+        }
     }
-    
-    return 1 + maxChildDepth;
+
+    return maxDepth;
 }
@@ -2,67 +2,91 @@
 #define QUADTREE_H
 
 #include <QVector>
+#include <QHash>
 #include <QRectF>
 #include <QPointF>
-#include <memory>
-#include <array>
+#include "Broadphase.h"
 
 class BaseBall;
 
-class QuadTree
+// 松散四叉树（loose quadtree）
+// 每个球只存放在一个节点中：沿球心所在象限下沉，直到子节点的松散边界装不下它为止。
+// 松散边界 = 节点边界向四周各扩展 looseness * 半宽，所以球移动一小段距离时不必换节点。
+// 球移动后调用update(ball)，只有越出所在节点的松散边界（或可以下沉到子节点）时才重新定位，
+// 静止的食物插入一次后不再触碰。
+class QuadTree : public Broadphase
 {
 public:
+    // 节点平铺存放在m_nodes中，用下标互相引用；四个子节点总是连续分配
     struct Node {
         QRectF bounds;
-        QVector<BaseBall*> balls;
-        std::array<std::unique_ptr<Node>, 4> children;
-        bool isLeaf = true;
-        
-        Node(const QRectF& rect) : bounds(rect) {}
-        
-        void clear() {
-            balls.clear();
-            for (auto& child : children) {
-                child.reset();
-            }
-            isLeaf = true;
-        }
+        QRectF looseBounds;
+        int parent = -1;
+        int firstChild = -1;    // 第一个子节点的下标，-1表示叶子
+        int depth = 0;
+        int subtreeCount = 0;   // 子树（含自身）中的球数
+
+        Node() = default;
+        Node(const QRectF& rect, qreal looseness, int parentIndex, int nodeDepth)
+            : bounds(rect)
+            , looseBounds(rect.adjusted(-rect.width() * looseness / 2.0, -rect.height() * looseness / 2.0,
+                                        rect.width() * looseness / 2.0, rect.height() * looseness / 2.0))
+            , parent(parentIndex)
+            , depth(nodeDepth) {}
+
+        bool isLeaf() const { return firstChild < 0; }
     };
 
-    QuadTree(const QRectF& bounds, int maxDepth = 6, int maxBallsPerNode = 8);
-    ~QuadTree() = default;
-
-    // 插入球体
-    void insert(BaseBall* ball);
-    
-    // 查询指定区域内的球体
-    QVector<BaseBall*> query(const QRectF& range) const;
-    
-    // 查询与指定球体可能碰撞的球体
-    QVector<BaseBall*> queryCollisions(BaseBall* ball) const;
-    
-    // 清空四叉树
-    void clear();
-    
-    // 重建四叉树（用于每帧更新）
-    void rebuild(const QVector<BaseBall*>& allBalls);
-    
+    QuadTree(const QRectF& bounds, int maxDepth = 6, int maxBallsPerNode = 8, qreal looseness = 1.0);
+    ~QuadTree() override = default;
+
+    const char* name() const override { return "QuadTree"; }
+
+    // 插入球体（已存在时等同于update）
+    void insert(BaseBall* ball) override;
+
+    // 移除球体
+    void remove(BaseBall* ball) override;
+
+    // 球体移动或半径变化后重新定位（仍在松散边界内时什么也不做）
+    void update(BaseBall* ball) override;
+
+    bool contains(BaseBall* ball) const override { return m_ballNodes.contains(ball); }
+    int ballCount() const override { return m_ballNodes.size(); }
+    QVector<BaseBall*> balls() const override;
+
+    // 访问指定区域内的球体（每个球只存放在一个节点里，天然不重复）
+    void forEachInRange(const QRectF& range, BallVisitor visitor) const override;
+
+    // 清空四叉树（节点数组和球桶只重置，不释放内存）
+    void clear() override;
+
+    QString statistics() const override;
+
     // 获取统计信息
     int getNodeCount() const;
     int getMaxDepth() const;
 
 private:
-    std::unique_ptr<Node> m_root;
+    QRectF m_bounds;
     int m_maxDepth;
     int m_maxBallsPerNode;
-    
-    void insertNode(Node* node, BaseBall* ball, int depth);
-    void queryNode(const Node* node, const QRectF& range, QVector<BaseBall*>& result) const;
-    void subdivide(Node* node);
-    bool shouldSubdivide(const Node* node, int depth) const;
-    QRectF getBallBounds(BaseBall* ball) const;
-    int countNodes(const Node* node) const;
-    int getDepth(const Node* node) const;
+    qreal m_looseness;
+
+    QVector<Node> m_nodes;                 // 节点池，m_nodes[0]是根
+    QVector<QVector<BaseBall*>> m_buckets; // 球桶池，与节点下标一一对应，清空时保留容量
+    QVector<int> m_freeBlocks;             // 合并后回收的四子节点块（首个下标）
+    QHash<BaseBall*, int> m_ballNodes;     // 球 -> 所在节点下标
+
+    void resetNodes();
+    void insertFrom(int start, BaseBall* ball, const QRectF& box);
+    void attach(int node, BaseBall* ball);
+    void detach(int node, BaseBall* ball);
+    void pushDown(int node);
+    void collapse(int node);
+    int childFor(int node, const QPointF& center) const;
+    void subdivide(int node);
+    bool shouldSubdivide(int node) const;
 };
 
 #endif // QUADTREE_H
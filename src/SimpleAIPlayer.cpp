@@ -3,9 +3,12 @@
 #include "CloneBall.h"
 #include "FoodBall.h"
 #include "BaseBall.h"
+#include "Broadphase.h"
+#include "core/ChromeTrace.h"
+#include "core/Trace.h"
+#include "core/ReplayFormat.h"
 #include <QDebug>
 #include <QGraphicsScene>
-#include <QRandomGenerator>
 #include <QPointF>
 #include <QStandardPaths>
 #include <QDir>
@@ -20,10 +23,12 @@ namespace AI {
 SimpleAIPlayer::SimpleAIPlayer(CloneBall* playerBall, QObject* parent)
     : QObject(parent)
     , m_playerBall(nullptr)
-    , m_decisionTimer(new QTimer(this))
     , m_aiActive(false)
     , m_decisionInterval(200) // 默认200ms决策间隔
+    , m_decisionElapsedMs(0.0)
+    , m_decisionCount(0)
     , m_strategy(AIStrategy::FOOD_HUNTER) // 默认食物猎手策略
+    , m_broadphase(nullptr)
     , m_currentTarget(nullptr)
     , m_targetLockFrames(0)
     , m_onnxInference(nullptr) // 🔥 暂时禁用ONNX以避免崩溃
@@ -31,6 +36,8 @@ SimpleAIPlayer::SimpleAIPlayer(CloneBall* playerBall, QObject* parent)
     , m_stuckFrameCount(0)
     , m_lastPosition(0, 0)
     , m_borderCollisionCount(0)
+    , m_escapeAttempt(0)
+    , m_random() // 由持有者设置（GameManager按队伍/玩家从本局种子派生）
     , m_lockedTarget(nullptr) // 🔥 初始化新的目标放弃机制变量
     , m_targetLockDuration(0)
     , m_huntTarget(nullptr) // 🔥 初始化追杀模式变量
@@ -49,19 +56,7 @@ SimpleAIPlayer::SimpleAIPlayer(CloneBall* playerBall, QObject* parent)
         return;
     }
     
-    qDebug() << "🔧 PlayerBall validity checked";
-    
-    // 🔥 验证playerBall是否已经被添加到scene中
-    if (!playerBall->scene()) {
-        qWarning() << "SimpleAIPlayer: PlayerBall not yet added to scene, delaying initialization";
-        // 延迟初始化
-        QTimer::singleShot(100, this, [this, playerBall]() {
-            initializeWithPlayerBall(playerBall);
-        });
-        return;
-    }
-    
-    qDebug() << "🔧 Scene check passed, proceeding with initialization";
+    // 🔥 立即接管：无头世界（基准、训练、fork）没有场景也没有事件循环，不能等球进场景再初始化
     initializeWithPlayerBall(playerBall);
 }
 
@@ -73,30 +68,188 @@ void SimpleAIPlayer::initializeWithPlayerBall(CloneBall* playerBall) {
     
     m_playerBall = playerBall;
     
-    // 连接定时器
-    connect(m_decisionTimer, &QTimer::timeout, this, &SimpleAIPlayer::makeDecision);
-    
     // 监听玩家球被销毁的信号
     connect(m_playerBall, &QObject::destroyed, this, &SimpleAIPlayer::onPlayerBallDestroyed);
-    // 监听球被移除的信号
-    connect(m_playerBall, &BaseBall::ballRemoved, this, &SimpleAIPlayer::onPlayerBallRemoved);
-    // 监听分裂信号
-    connect(m_playerBall, &CloneBall::splitPerformed, this, &SimpleAIPlayer::onSplitPerformed);
-    // 🔥 监听合并信号
-    connect(m_playerBall, &CloneBall::mergePerformed, this, &SimpleAIPlayer::onMergePerformed);
+    // 球被回收进对象池时等同于销毁（之后会以别的球的身份复用）
+    connect(m_playerBall, &BaseBall::ballRecycled, this, &SimpleAIPlayer::onBallDestroyed);
+    // 被吃、分裂、合并由GameManager的tickEvents批量通知（见onTickEvents）
     
     // 初始化分裂球列表
     m_splitBalls.clear();
     m_splitBalls.append(m_playerBall);
     
     // 初始化位置记录
-    m_lastPosition = m_playerBall->pos();
+    m_lastPosition = m_playerBall->position();
     
     qDebug() << "SimpleAIPlayer successfully initialized for ball:" << m_playerBall->ballId()
              << "with strategy:" << static_cast<int>(m_strategy)
              << "scene:" << (m_playerBall->scene() != nullptr);
 }
 
+void SimpleAIPlayer::releaseBalls() {
+    const QVector<CloneBall*> balls = m_splitBalls;
+    for (CloneBall* ball : balls) {
+        if (ball) {
+            disconnect(ball, nullptr, this, nullptr);
+        }
+    }
+    if (m_playerBall) {
+        disconnect(m_playerBall, nullptr, this, nullptr);
+    }
+    m_playerBall = nullptr;
+    m_splitBalls.clear();
+    
+    // 指向球的记忆全部作废，其余的短期状态也回到初始值；快照里有这个AI时随后由loadMemory写回
+    m_currentTarget = nullptr;
+    m_targetLockFrames = 0;
+    m_recentDirections.clear();
+    m_lastAvoidDirection = QPointF();
+    m_stuckFrameCount = 0;
+    m_borderCollisionCount = 0;
+    m_escapeAttempt = 0;
+    m_failedTargetAttempts.clear();
+    m_abandonedTargets.clear();
+    m_lockedTarget = nullptr;
+    m_targetLockDuration = 0;
+    m_huntTarget = nullptr;
+    m_huntModeFrames = 0;
+    m_lastHuntTargetPos = QPointF(0, 0);
+    m_shouldMerge = false;
+    m_splitFrameCount = 0;
+    m_mergeTargetPos = QPointF(0, 0);
+    m_preferredMergeTarget = nullptr;
+}
+
+void SimpleAIPlayer::rebindBalls(CloneBall* mainBall, const QVector<CloneBall*>& balls) {
+    releaseBalls();
+    
+    if (balls.isEmpty()) {
+        stopAI();
+        emit aiPlayerDestroyed(this);
+        return;
+    }
+    
+    // 与initializeWithPlayerBall/onSplitPerformed的连接方式一致
+    m_splitBalls = balls;
+    m_playerBall = balls.contains(mainBall) ? mainBall : balls.first();
+    connect(m_playerBall, &QObject::destroyed, this, &SimpleAIPlayer::onPlayerBallDestroyed);
+    for (CloneBall* ball : balls) {
+        if (ball != m_playerBall) {
+            connect(ball, &QObject::destroyed, this, &SimpleAIPlayer::onBallDestroyed);
+        }
+        connect(ball, &BaseBall::ballRecycled, this, &SimpleAIPlayer::onBallDestroyed);
+    }
+    m_lastPosition = m_playerBall->position();
+}
+
+QByteArray SimpleAIPlayer::saveMemory(const std::function<qint64(const BaseBall*)>& ballRef) const {
+    using namespace ReplayFormat;
+    QByteArray out;
+    auto writeBall = [&](const BaseBall* ball) { writeSigned(out, ball ? ballRef(ball) : -1); };
+    auto writePoint = [&out](const QPointF& point) {
+        writeDouble(out, point.x());
+        writeDouble(out, point.y());
+    };
+    
+    writeBall(m_currentTarget);
+    writeSigned(out, m_targetLockFrames);
+    writeVarint(out, static_cast<quint64>(m_recentDirections.size()));
+    for (const QPointF& direction : m_recentDirections) {
+        writePoint(direction);
+    }
+    writePoint(m_lastAvoidDirection);
+    writeSigned(out, m_stuckFrameCount);
+    writePoint(m_lastPosition);
+    writeSigned(out, m_borderCollisionCount);
+    writeSigned(out, m_escapeAttempt);
+    
+    writeVarint(out, static_cast<quint64>(m_failedTargetAttempts.size()));
+    for (auto it = m_failedTargetAttempts.constBegin(); it != m_failedTargetAttempts.constEnd(); ++it) {
+        writeSigned(out, it.key());
+        writeSigned(out, it.value());
+    }
+    // QSet的遍历顺序取决于插入历史，排好序再写，同样的记忆写出来的字节才一样
+    QList<int> abandoned = m_abandonedTargets.values();
+    std::sort(abandoned.begin(), abandoned.end());
+    writeVarint(out, static_cast<quint64>(abandoned.size()));
+    for (int foodId : abandoned) {
+        writeSigned(out, foodId);
+    }
+    writeBall(m_lockedTarget);
+    writeSigned(out, m_targetLockDuration);
+    
+    writeBall(m_huntTarget);
+    writeSigned(out, m_huntModeFrames);
+    writePoint(m_lastHuntTargetPos);
+    
+    out.append(static_cast<char>(m_shouldMerge ? 1 : 0));
+    writeSigned(out, m_splitFrameCount);
+    writePoint(m_mergeTargetPos);
+    writeBall(m_preferredMergeTarget);
+    return out;
+}
+
+bool SimpleAIPlayer::loadMemory(const QByteArray& memory, const std::function<BaseBall*(qint64)>& ballAt) {
+    ReplayFormat::Reader in(memory);
+    auto readInt = [&in]() { return static_cast<int>(in.signedVarint()); };
+    auto readPoint = [&in]() {
+        const double x = in.float64();
+        const double y = in.float64();
+        return QPointF(x, y);
+    };
+    // 编号对不上类型（快照坏了）时当作没有
+    auto readBall = [&]() -> BaseBall* {
+        const qint64 ref = in.signedVarint();
+        return ref >= 0 ? ballAt(ref) : nullptr;
+    };
+    auto readTyped = [&](BaseBall::BallType type) -> BaseBall* {
+        BaseBall* ball = readBall();
+        return ball && ball->ballType() == type ? ball : nullptr;
+    };
+    auto count = [&in]() { return static_cast<int>(qMin<quint64>(in.varint(), 1 << 16)); };
+    
+    m_currentTarget = readBall();
+    m_targetLockFrames = readInt();
+    m_recentDirections.clear();
+    for (int i = count(); i > 0 && in.ok(); --i) {
+        m_recentDirections.append(readPoint());
+    }
+    m_lastAvoidDirection = readPoint();
+    m_stuckFrameCount = readInt();
+    m_lastPosition = readPoint();
+    m_borderCollisionCount = readInt();
+    m_escapeAttempt = readInt();
+    
+    m_failedTargetAttempts.clear();
+    for (int i = count(); i > 0 && in.ok(); --i) {
+        const int foodId = readInt();
+        m_failedTargetAttempts.insert(foodId, readInt());
+    }
+    m_abandonedTargets.clear();
+    for (int i = count(); i > 0 && in.ok(); --i) {
+        m_abandonedTargets.insert(readInt());
+    }
+    m_lockedTarget = static_cast<FoodBall*>(readTyped(BaseBall::FOOD_BALL));
+    m_targetLockDuration = readInt();
+    
+    m_huntTarget = static_cast<CloneBall*>(readTyped(BaseBall::CLONE_BALL));
+    m_huntModeFrames = readInt();
+    m_lastHuntTargetPos = readPoint();
+    
+    m_shouldMerge = in.byte() != 0;
+    m_splitFrameCount = readInt();
+    m_mergeTargetPos = readPoint();
+    m_preferredMergeTarget = static_cast<CloneBall*>(readTyped(BaseBall::CLONE_BALL));
+    return in.ok();
+}
+
+void SimpleAIPlayer::forgetBall(const BaseBall* ball) {
+    if (m_currentTarget == ball) m_currentTarget = nullptr;
+    if (m_lockedTarget == ball) m_lockedTarget = nullptr;
+    if (m_huntTarget == ball) m_huntTarget = nullptr;
+    if (m_preferredMergeTarget == ball) m_preferredMergeTarget = nullptr;
+}
+
 SimpleAIPlayer::~SimpleAIPlayer() {
     stopAI();
     qDebug() << "SimpleAIPlayer destroyed";
@@ -114,7 +267,7 @@ void SimpleAIPlayer::startAI() {
     }
     
     m_aiActive = true;
-    m_decisionTimer->start(m_decisionInterval);
+    m_decisionElapsedMs = 0.0;
     qDebug() << "AI started for player ball:" << m_playerBall->ballId() 
              << "with decision interval:" << m_decisionInterval << "ms"
              << "strategy:" << static_cast<int>(m_strategy);
@@ -126,14 +279,23 @@ void SimpleAIPlayer::stopAI() {
     }
     
     m_aiActive = false;
-    m_decisionTimer->stop();
     qDebug() << "AI stopped for player ball:" << (m_playerBall ? m_playerBall->ballId() : -1);
 }
 
 void SimpleAIPlayer::setDecisionInterval(int interval_ms) {
     m_decisionInterval = std::max(50, interval_ms); // 最小50ms
-    if (m_aiActive) {
-        m_decisionTimer->start(m_decisionInterval);
+}
+
+void SimpleAIPlayer::advanceDecisionClock(qreal elapsedMs) {
+    if (!m_aiActive) {
+        return;
+    }
+    
+    m_decisionElapsedMs += elapsedMs;
+    if (m_decisionElapsedMs >= m_decisionInterval) {
+        // 一帧最多决策一次，逻辑帧长大于决策间隔时多出的时间不累积
+        m_decisionElapsedMs = std::fmod(m_decisionElapsedMs, static_cast<qreal>(m_decisionInterval));
+        makeDecision();
     }
 }
 
@@ -143,6 +305,11 @@ void SimpleAIPlayer::makeDecision() {
         return;
     }
     
+    // 时间线上每个AI的每次决策一个span，按队伍/玩家区分
+    ChromeTrace::Span span("SimpleAIPlayer::makeDecision", "ai");
+    span.setArg("team", m_playerBall->teamId());
+    span.setArg("player", m_playerBall->playerId());
+    
     // 🔥 检查主球是否已被销毁
     if (m_playerBall->isRemoved()) {
         qDebug() << "Main player ball was removed, stopping AI";
@@ -150,13 +317,6 @@ void SimpleAIPlayer::makeDecision() {
         return;
     }
     
-    // 🔥 检查场景是否仍然有效
-    if (!m_playerBall->scene()) {
-        qWarning() << "Player ball no longer in scene, stopping AI";
-        stopAI();
-        return;
-    }
-    
     // 清理已被移除的分裂球
     m_splitBalls.removeIf([](CloneBall* ball) {
         return !ball || ball->isRemoved();
@@ -168,17 +328,10 @@ void SimpleAIPlayer::makeDecision() {
         return;
     }
     
-    // 🔥 调试：打印当前AI控制的球数量和状态
-    QStringList ballIds;
-    for (CloneBall* ball : m_splitBalls) {
-        if (ball && !ball->isRemoved()) {
-            ballIds << QString::number(ball->ballId());
-        }
-    }
-    if (ballIds.size() != m_splitBalls.size()) {
-        qWarning() << "🚨 Mismatch in ball count! Valid:" << ballIds.size() << "Total:" << m_splitBalls.size();
-    }
-    qDebug() << "🎯 AI Decision: Controlling" << ballIds.size() << "balls:" << ballIds.join(",");
+    GB_TRACE(AI, Debug, "decision team/player/balls/strategy", m_playerBall->teamId(), m_playerBall->playerId(),
+             m_splitBalls.size(), static_cast<int>(m_strategy));
+    
+    m_decisionCount++;
     
     // 🔥 新增：更新合并状态和计数器
     updateMergeStatus();
@@ -214,7 +367,7 @@ void SimpleAIPlayer::makeDecision() {
                 
                 for (CloneBall* otherBall : m_splitBalls) {
                     if (otherBall && !otherBall->isRemoved()) {
-                        QPointF pos = otherBall->pos();
+                        QPointF pos = otherBall->position();
                         float score = otherBall->score();
                         centroid += pos * score;
                         totalScore += score;
@@ -225,14 +378,13 @@ void SimpleAIPlayer::makeDecision() {
                 if (validBalls > 1 && totalScore > 0) {
                     centroid /= totalScore;
                     
-                    QPointF ballPos = ball->pos();
+                    QPointF ballPos = ball->position();
                     float distanceToCenter = QLineF(ballPos, centroid).length();
                     
                     // 只有距离质心太远时才强制聚拢
                     const float criticalDistance = 200.0f; // 提高临界距离
                     if (distanceToCenter > criticalDistance) {
-                        qDebug() << "Ball" << ball->ballId() << "too far from group (" 
-                                 << distanceToCenter << "), forcing gather";
+                        GB_TRACE(AI, Verbose, "gather ball/distance", ball->ballId(), distanceToCenter);
                         
                         QPointF direction = centroid - ballPos;
                         float length = QLineF(QPointF(0,0), direction).length();
@@ -248,7 +400,6 @@ void SimpleAIPlayer::makeDecision() {
             }
             
             // 🔥 为每个球独立执行策略决策
-            qDebug() << "🎯 Making decision for ball" << ball->ballId() << "strategy:" << static_cast<int>(m_strategy);
             
             switch (m_strategy) {
                 case AIStrategy::RANDOM:
@@ -271,7 +422,6 @@ void SimpleAIPlayer::makeDecision() {
             }
             
             // 执行动作
-            qDebug() << "🎯 Executing action for ball" << ball->ballId() << "dx:" << action.dx << "dy:" << action.dy << "type:" << static_cast<int>(action.type);
             executeActionForBall(ball, action);
             
             // 恢复原始主球
@@ -324,8 +474,7 @@ void SimpleAIPlayer::onPlayerBallRemoved() {
         
         if (newMainBall) {
             m_playerBall = newMainBall;
-            qDebug() << "Switched to new main ball:" << newMainBall->ballId() 
-                     << "with score:" << newMainBall->score();
+            GB_TRACE(AI, Debug, "main ball switched ball/score", newMainBall->ballId(), newMainBall->score());
             return; // 继续AI控制
         }
     }
@@ -340,12 +489,12 @@ void SimpleAIPlayer::onPlayerBallRemoved() {
 
 AIAction SimpleAIPlayer::makeRandomDecision() {
     // 随机移动策略
-    float dx = (QRandomGenerator::global()->generateDouble() - 0.5f) * 2.0f; // [-1, 1]
-    float dy = (QRandomGenerator::global()->generateDouble() - 0.5f) * 2.0f; // [-1, 1]
+    float dx = (m_random.generateDouble() - 0.5f) * 2.0f; // [-1, 1]
+    float dy = (m_random.generateDouble() - 0.5f) * 2.0f; // [-1, 1]
     
     // 偶尔执行特殊动作
     ActionType actionType = ActionType::MOVE;
-    int random = QRandomGenerator::global()->bounded(100);
+    int random = m_random.bounded(100);
     
     if (random < 5 && m_playerBall->canSplit()) { // 5%概率分裂
         actionType = ActionType::SPLIT;
@@ -366,7 +515,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
             m_targetLockFrames++;
             // 延长目标锁定时间，减少切换频率
             if (m_targetLockFrames < 15) { // 从10增加到15帧
-                QPointF direction = m_currentTarget->pos() - m_playerBall->pos();
+                QPointF direction = m_currentTarget->position() - m_playerBall->position();
                 float length = QLineF(QPointF(0,0), direction).length();
                 if (length > 0.1f) {
                     QPointF safeDirection = getSafeDirection(direction / length);
@@ -374,7 +523,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
                 }
             } else {
                 // 目标锁定超时后，检查是否应该继续追求该目标
-                QPointF direction = m_currentTarget->pos() - m_playerBall->pos();
+                QPointF direction = m_currentTarget->position() - m_playerBall->position();
                 float distance = QLineF(QPointF(0,0), direction).length();
                 
                 // 如果目标很近，继续追求；否则解锁
@@ -390,7 +539,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
         }
     }
 
-    QPointF playerPos = m_playerBall->pos();
+    QPointF playerPos = m_playerBall->position();
     float playerRadius = m_playerBall->radius();
     float playerScore = m_playerBall->score();
     
@@ -406,7 +555,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
     
     for (auto player : nearbyPlayers) {
         if (player != m_playerBall && player->teamId() != m_playerBall->teamId()) {
-            float distance = QLineF(player->pos(), playerPos).length();
+            float distance = QLineF(player->position(), playerPos).length();
             float threatScore = player->score();
             float radiusRatio = player->radius() / playerRadius;
             
@@ -420,7 +569,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
                 
                 if (distance < 150.0f && sizeAdvantage > 1.3f) {
                     highThreatCount++;
-                    QPointF awayDir = playerPos - player->pos();
+                    QPointF awayDir = playerPos - player->position();
                     float length = QLineF(QPointF(0,0), awayDir).length();
                     if (length > 0.1f) {
                         escapeDirection += QVector2D(awayDir / length) * threatLevel;
@@ -433,7 +582,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
     // 2. 紧急威胁处理 - 高威胁时分裂逃跑
     if (highThreatCount > 0 && totalThreatLevel > 3.0f) {
         escapeDirection = escapeDirection.normalized();
-        qDebug() << "High threat detected, escaping! Threat level:" << totalThreatLevel;
+        GB_TRACE(AI, Debug, "escape ball/threat", m_playerBall->ballId(), totalThreatLevel);
         
         // 🔥 集成边界检测，确保逃跑方向安全
         QPointF safeEscapeDirection = getSafeDirection(QPointF(escapeDirection.x(), escapeDirection.y()));
@@ -449,13 +598,13 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
     // 3. 荆棘球智能避障 - 优化避障逻辑防止打转
     for (auto ball : nearbyBalls) {
         if (ball->ballType() == BaseBall::THORNS_BALL) {
-            float distance = QLineF(ball->pos(), playerPos).length();
+            float distance = QLineF(ball->position(), playerPos).length();
             float thornsScore = ball->score();
             
             if (playerScore > thornsScore * 1.5f) {
                 // 可以安全吃掉荆棘球
                 if (distance < 80.0f && totalThreatLevel < 1.0f) {
-                    QPointF direction = ball->pos() - playerPos;
+                    QPointF direction = ball->position() - playerPos;
                     float length = QLineF(QPointF(0,0), direction).length();
                     if (length > 0.1f) {
                         QPointF safeDirection = getSafeDirection(direction / length);
@@ -464,7 +613,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
                 }
             } else if (distance < playerRadius + ball->radius() + 30.0f) { // 增加安全距离
                 // 🔥 优化：更智能的荆棘球避障，使用切线方向避免打转
-                QPointF awayDirection = playerPos - ball->pos();
+                QPointF awayDirection = playerPos - ball->position();
                 float awayLength = QLineF(QPointF(0,0), awayDirection).length();
                 
                 if (awayLength > 0.1f) {
@@ -476,7 +625,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
                     // 选择更好的切线方向（朝向更多食物的方向）
                     float leftScore = 0, rightScore = 0;
                     for (auto food : nearbyFood) {
-                        QPointF foodDir = food->pos() - playerPos;
+                        QPointF foodDir = food->position() - playerPos;
                         float leftDot = QPointF::dotProduct(foodDir, tangent);
                         float rightDot = QPointF::dotProduct(foodDir, -tangent);
                         if (leftDot > 0) leftScore += food->score();
@@ -509,7 +658,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
         QPointF densityCenter(0, 0);
         
         for (auto food : nearbyFood) {
-            QPointF foodPos = food->pos();
+            QPointF foodPos = food->position();
             float distanceToPlayer = QLineF(foodPos, playerPos).length();
             
             if (distanceToPlayer < densityRadius) {
@@ -528,7 +677,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
             float length = QLineF(QPointF(0,0), direction).length();
             
             if (length > 0.1f) {
-                qDebug() << "High food density detected:" << foodDensity << "foods. Splitting for efficiency!";
+                GB_TRACE(AI, Debug, "split for food ball/density", m_playerBall->ballId(), foodDensity);
                 QPointF safeDirection = getSafeDirection(direction / length);
                 return AIAction(safeDirection.x(), safeDirection.y(), ActionType::SPLIT);
             }
@@ -577,7 +726,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
         cleanupAbandonedTargets();
         
         for (auto food : nearbyFood) {
-            QPointF foodPos = food->pos();
+            QPointF foodPos = food->position();
             float distance = QLineF(foodPos, playerPos).length();
             int foodId = food->ballId();
             
@@ -592,7 +741,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
                 
                 // 如果尝试次数过多且距离较远，放弃目标
                 if (attempts > 8 && distance > 50.0f) {
-                    qDebug() << "Abandoning target food" << foodId << "after" << attempts << "failed attempts";
+                    GB_TRACE(AI, Verbose, "abandon food food/attempts", foodId, attempts);
                     m_abandonedTargets.insert(foodId);
                     m_failedTargetAttempts.remove(foodId);
                     if (m_currentTarget == food) {
@@ -614,7 +763,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
             for (auto player : nearbyPlayers) {
                 if (player != m_playerBall && player->teamId() != m_playerBall->teamId() && 
                     player->score() > playerScore * 1.1f) {
-                    float threatToFood = QLineF(player->pos(), foodPos).length();
+                    float threatToFood = QLineF(player->position(), foodPos).length();
                     if (threatToFood < 70.0f) {
                         pathSafe = false;
                         break;
@@ -626,7 +775,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
                 // 评分：食物价值/距离 + 密度加成 + 当前目标加成
                 float localDensity = 0;
                 for (auto otherFood : nearbyFood) {
-                    if (QLineF(otherFood->pos(), foodPos).length() < 40.0f) {
+                    if (QLineF(otherFood->position(), foodPos).length() < 40.0f) {
                         localDensity += 1.0f;
                     }
                 }
@@ -660,13 +809,12 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
                 
                 // 🔥 检查是否长时间无法获取目标
                 if (m_targetLockDuration > 30) { // 30帧 = 约1.5秒
-                    float distance = QLineF(bestFood->pos(), playerPos).length();
+                    float distance = QLineF(bestFood->position(), playerPos).length();
                     
                     // 如果距离没有显著减少，增加失败计数
                     if (distance > 60.0f) {
                         m_failedTargetAttempts[foodId]++;
-                        qDebug() << "Target food" << foodId << "seems unreachable, failed attempts:" 
-                                 << m_failedTargetAttempts[foodId];
+                        GB_TRACE(AI, Verbose, "food unreachable food/attempts", foodId, m_failedTargetAttempts[foodId]);
                         
                         // 重置锁定，尝试其他目标
                         m_lockedTarget = nullptr;
@@ -676,14 +824,14 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
                         
                         // 如果失败次数过多，临时放弃
                         if (m_failedTargetAttempts[foodId] >= 5) {
-                            qDebug() << "Temporarily abandoning unreachable target" << foodId;
+                            GB_TRACE(AI, Verbose, "food given up food", foodId);
                             return AIAction(0, 0, ActionType::MOVE); // 停止移动，重新评估
                         }
                     }
                 }
             }
             
-            QPointF direction = bestFood->pos() - playerPos;
+            QPointF direction = bestFood->position() - playerPos;
             float length = QLineF(QPointF(0,0), direction).length();
             if (length > 0.1f) {
                 QPointF safeDirection = getSafeDirection(direction / length);
@@ -699,7 +847,7 @@ AIAction SimpleAIPlayer::makeFoodHunterDecision() {
         float totalWeight = 0.0f;
         
         for (auto food : nearbyFood) {
-            QPointF foodPos = food->pos();
+            QPointF foodPos = food->position();
             QPointF direction = foodPos - playerPos;
             float distance = QLineF(QPointF(0,0), direction).length();
             
@@ -742,7 +890,7 @@ AIAction SimpleAIPlayer::makeCoordinatedDecision() {
     
     for (CloneBall* ball : m_splitBalls) {
         if (ball && !ball->isRemoved()) {
-            QPointF pos = ball->pos();
+            QPointF pos = ball->position();
             float score = ball->score();
             centroid += pos * score; // 按分数加权
             totalScore += score;
@@ -761,7 +909,7 @@ AIAction SimpleAIPlayer::makeCoordinatedDecision() {
     float avgDistance = 0.0f;
     for (CloneBall* ball : m_splitBalls) {
         if (ball && !ball->isRemoved()) {
-            float distance = QLineF(ball->pos(), centroid).length();
+            float distance = QLineF(ball->position(), centroid).length();
             maxDistance = std::max(maxDistance, distance);
             avgDistance += distance;
         }
@@ -785,7 +933,7 @@ AIAction SimpleAIPlayer::makeCoordinatedDecision() {
 
     if (canMerge || forceGather) {
         // 朝质心聚拢
-        QPointF direction = centroid - m_playerBall->pos();
+        QPointF direction = centroid - m_playerBall->position();
         float length = QLineF(QPointF(0,0), direction).length();
         
         if (length > 5.0f) { // 如果距离质心较远才移动
@@ -816,7 +964,7 @@ AIAction SimpleAIPlayer::makeCoordinatedFoodHunt() {
     
     for (CloneBall* ball : m_splitBalls) {
         if (ball && !ball->isRemoved()) {
-            QPointF pos = ball->pos();
+            QPointF pos = ball->position();
             float score = ball->score();
             centroid += pos * score;
             totalScore += score;
@@ -838,8 +986,8 @@ AIAction SimpleAIPlayer::makeCoordinatedFoodHunt() {
     for (FoodBall* food : nearbyFood) {
         if (!food || food->isRemoved()) continue;
         
-        QPointF playerPos = m_playerBall->pos();
-        QPointF foodPos = food->pos();
+        QPointF playerPos = m_playerBall->position();
+        QPointF foodPos = food->position();
         
         float distanceToPlayer = QLineF(playerPos, foodPos).length();
         float distanceToCentroid = QLineF(centroid, foodPos).length();
@@ -854,7 +1002,7 @@ AIAction SimpleAIPlayer::makeCoordinatedFoodHunt() {
     }
     
     if (bestFood) {
-        QPointF direction = bestFood->pos() - m_playerBall->pos();
+        QPointF direction = bestFood->position() - m_playerBall->position();
         float length = QLineF(QPointF(0,0), direction).length();
         if (length > 0.1f) {
             QPointF safeDirection = getSafeDirection(direction / length);
@@ -863,7 +1011,7 @@ AIAction SimpleAIPlayer::makeCoordinatedFoodHunt() {
     }
     
     // 如果没有找到合适的食物，向质心缓慢移动
-    QPointF direction = centroid - m_playerBall->pos();
+    QPointF direction = centroid - m_playerBall->position();
     float length = QLineF(QPointF(0,0), direction).length();
     if (length > 10.0f) { // 只有距离质心较远时才移动
         direction = getSafeDirection(direction / length);
@@ -875,11 +1023,11 @@ AIAction SimpleAIPlayer::makeCoordinatedFoodHunt() {
 }
 
 AIAction SimpleAIPlayer::makeAggressiveDecision() {
-    QPointF playerPos = m_playerBall->pos();
+    QPointF playerPos = m_playerBall->position();
     
     // 🔥 锁定追杀模式：一旦锁定目标就不再吃食物，专注追杀
     if (m_huntTarget && !m_huntTarget->isRemoved()) {
-        float distance = QLineF(m_huntTarget->pos(), playerPos).length();
+        float distance = QLineF(m_huntTarget->position(), playerPos).length();
         float maxHuntDistance = 300.0f; // 最大追杀距离
         
         // 检查是否还能继续追杀
@@ -887,10 +1035,10 @@ AIAction SimpleAIPlayer::makeAggressiveDecision() {
         
         if (canStillHunt) {
             m_huntModeFrames++;
-            qDebug() << "🎯 HUNT MODE: Chasing target" << m_huntTarget->ballId() 
-                     << "for" << m_huntModeFrames << "frames, distance:" << distance;
+            GB_TRACE(AI, Verbose, "hunt ball/target/frames/distance", m_playerBall->ballId(), m_huntTarget->ballId(),
+                     m_huntModeFrames, distance);
             
-            QPointF direction = m_huntTarget->pos() - playerPos;
+            QPointF direction = m_huntTarget->position() - playerPos;
             float length = QLineF(QPointF(0,0), direction).length();
             
             if (length > 0.1f) {
@@ -904,7 +1052,7 @@ AIAction SimpleAIPlayer::makeAggressiveDecision() {
                     // 计算拦截位置
                     float myMaxSpeed = 20.0f; // 使用CloneBall默认最大速度
                     float timeToIntercept = distance / (myMaxSpeed + 1.0f);
-                    QPointF predictedPos = m_huntTarget->pos() + targetVel * timeToIntercept;
+                    QPointF predictedPos = m_huntTarget->position() + targetVel * timeToIntercept;
                     
                     QPointF interceptDirection = predictedPos - playerPos;
                     float interceptLength = QLineF(QPointF(0,0), interceptDirection).length();
@@ -938,9 +1086,9 @@ AIAction SimpleAIPlayer::makeAggressiveDecision() {
             }
         } else {
             // 追杀失败，退出追杀模式
-            qDebug() << "🎯 Hunt mode ended for target" << (m_huntTarget ? m_huntTarget->ballId() : -1) 
-                     << "- reason:" << (m_huntTarget->isRemoved() ? "removed" : 
-                                     !m_playerBall->canEat(m_huntTarget) ? "can't eat" : "too far");
+            // 原因：0被移除，1吃不下，2太远
+            GB_TRACE(AI, Debug, "hunt ended ball/target/reason", m_playerBall->ballId(), m_huntTarget->ballId(),
+                     m_huntTarget->isRemoved() ? 0 : !m_playerBall->canEat(m_huntTarget) ? 1 : 2);
             m_huntTarget = nullptr;
             m_huntModeFrames = 0;
         }
@@ -960,7 +1108,7 @@ AIAction SimpleAIPlayer::makeAggressiveDecision() {
             // 🔥 追杀条件调整：更加理性
             if (!m_playerBall->canEat(player)) continue;
             
-            float distance = QLineF(player->pos(), playerPos).length();
+            float distance = QLineF(player->position(), playerPos).length();
             float scoreAdvantage = m_playerBall->score() / std::max(player->score(), 1.0f);
             
             // 🔥 追杀评分：更保守的条件
@@ -994,8 +1142,7 @@ AIAction SimpleAIPlayer::makeAggressiveDecision() {
             // 🔥 分裂状态检测：给分裂目标更多加分
             if (player->radius() < m_playerBall->radius() * 0.7f && scoreAdvantage > 1.2f) {
                 huntScore += 40.0f; // 提高分裂目标的吸引力
-                qDebug() << "🎯 Found potential split target:" << player->ballId() 
-                         << "score advantage:" << scoreAdvantage;
+                GB_TRACE(AI, Verbose, "split target ball/target/advantage", m_playerBall->ballId(), player->ballId(), scoreAdvantage);
             }
             
             // 🔥 安全检查：附近有威胁时降低追杀倾向
@@ -1022,13 +1169,12 @@ AIAction SimpleAIPlayer::makeAggressiveDecision() {
         if (bestHuntTarget) {
             m_huntTarget = bestHuntTarget;
             m_huntModeFrames = 0;
-            m_lastHuntTargetPos = bestHuntTarget->pos();
+            m_lastHuntTargetPos = bestHuntTarget->position();
             
-            qDebug() << "🎯 ENTERING HUNT MODE for target" << bestHuntTarget->ballId() 
-                     << "with score:" << bestHuntScore;
+            GB_TRACE(AI, Debug, "hunt started ball/target/score", m_playerBall->ballId(), bestHuntTarget->ballId(), bestHuntScore);
             
             // 立即开始追杀
-            QPointF direction = bestHuntTarget->pos() - playerPos;
+            QPointF direction = bestHuntTarget->position() - playerPos;
             float length = QLineF(QPointF(0,0), direction).length();
             if (length > 0.1f) {
                 QPointF safeDirection = getSafeDirection(direction / length);
@@ -1045,7 +1191,7 @@ AIAction SimpleAIPlayer::makeAggressiveDecision() {
         } else {
             m_targetLockFrames++;
             if (m_targetLockFrames < 15) { // 延长锁定时间
-                QPointF direction = m_currentTarget->pos() - m_playerBall->pos();
+                QPointF direction = m_currentTarget->position() - m_playerBall->position();
                 float length = QLineF(QPointF(0,0), direction).length();
                 if (length > 0.1f) {
                     QPointF safeDirection = getSafeDirection(direction / length);
@@ -1068,7 +1214,7 @@ AIAction SimpleAIPlayer::makeAggressiveDecision() {
         if (player->teamId() == m_playerBall->teamId()) continue;
         if (!m_playerBall->canEat(player)) continue;
         
-        float distance = QLineF(player->pos(), playerPos).length();
+        float distance = QLineF(player->position(), playerPos).length();
         float scoreAdvantage = m_playerBall->score() / std::max(player->score(), 1.0f);
         
         float attackScore = (scoreAdvantage - 1.0f) * 30.0f + (180.0f - distance) / 180.0f * 20.0f;
@@ -1081,7 +1227,7 @@ AIAction SimpleAIPlayer::makeAggressiveDecision() {
     
     if (bestTarget) {
         m_currentTarget = bestTarget;
-        QPointF direction = bestTarget->pos() - playerPos;
+        QPointF direction = bestTarget->position() - playerPos;
         float length = QLineF(QPointF(0,0), direction).length();
         if (length > 0.1f) {
             QPointF safeDirection = getSafeDirection(direction / length);
@@ -1132,8 +1278,7 @@ void SimpleAIPlayer::executeActionForBall(CloneBall* ball, const AIAction& actio
         return;
     }
     
-    qDebug() << "🎮 Executing action for ball" << ball->ballId() 
-             << "dx:" << action.dx << "dy:" << action.dy << "type:" << static_cast<int>(action.type);
+    GB_TRACE(AI, Verbose, "action ball/dx/dy/type", ball->ballId(), action.dx, action.dy, static_cast<int>(action.type));
     
     // 🔥 为每个球单独进行边界检测
     CloneBall* originalPlayerBall = m_playerBall;
@@ -1175,24 +1320,53 @@ void SimpleAIPlayer::executeActionForBall(CloneBall* ball, const AIAction& actio
     }
 }
 
+void SimpleAIPlayer::forEachBallInRect(const QRectF& rect, const std::function<void(BaseBall*)>& visit) const {
+    // 有空间索引时走索引（无头世界没有场景），否则退回场景查询；已登记移除的球跳过
+    // 索引的遍历顺序取决于它的建立过程（逐个插入和restore后整体重建不同），按球ID排序后再交给策略，
+    // fork出来的世界和原世界才会做出同样的决策
+    if (m_broadphase) {
+        std::vector<BaseBall*> balls;
+        m_broadphase->forEachInRange(rect, [&balls](BaseBall* ball) {
+            if (!ball->isRemoved()) {
+                balls.push_back(ball);
+            }
+        });
+        std::sort(balls.begin(), balls.end(), [](const BaseBall* a, const BaseBall* b) {
+            return a->ballId() < b->ballId();
+        });
+        for (BaseBall* ball : balls) {
+            visit(ball);
+        }
+        return;
+    }
+    
+    if (!m_playerBall || !m_playerBall->scene()) {
+        return;
+    }
+    for (auto item : m_playerBall->scene()->items(rect)) {
+        BaseBall* ball = dynamic_cast<BaseBall*>(item);
+        if (ball && !ball->isRemoved()) {
+            visit(ball);
+        }
+    }
+}
+
 std::vector<BaseBall*> SimpleAIPlayer::getNearbyBalls(float radius) {
     std::vector<BaseBall*> nearbyBalls;
     
-    if (!m_playerBall || !m_playerBall->scene()) {
+    if (!m_playerBall || m_playerBall->isRemoved()) {
         return nearbyBalls;
     }
     
-    QPointF playerPos = m_playerBall->pos();
+    QPointF playerPos = m_playerBall->position();
     QRectF searchRect(playerPos.x() - radius, playerPos.y() - radius, 
                       2 * radius, 2 * radius);
     
-    auto items = m_playerBall->scene()->items(searchRect);
-    for (auto item : items) {
-        BaseBall* ball = dynamic_cast<BaseBall*>(item);
-        if (ball && ball != m_playerBall) {
+    forEachBallInRect(searchRect, [this, &nearbyBalls](BaseBall* ball) {
+        if (ball != m_playerBall) {
             nearbyBalls.push_back(ball);
         }
-    }
+    });
     
     return nearbyBalls;
 }
@@ -1200,21 +1374,19 @@ std::vector<BaseBall*> SimpleAIPlayer::getNearbyBalls(float radius) {
 std::vector<FoodBall*> SimpleAIPlayer::getNearbyFood(float radius) const {
     std::vector<FoodBall*> nearbyFood;
     
-    if (!m_playerBall || !m_playerBall->scene()) {
+    if (!m_playerBall || m_playerBall->isRemoved()) {
         return nearbyFood;
     }
     
-    QPointF playerPos = m_playerBall->pos();
+    QPointF playerPos = m_playerBall->position();
     QRectF searchRect(playerPos.x() - radius, playerPos.y() - radius, 
                       2 * radius, 2 * radius);
     
-    auto items = m_playerBall->scene()->items(searchRect);
-    for (auto item : items) {
-        FoodBall* food = dynamic_cast<FoodBall*>(item);
-        if (food) {
-            nearbyFood.push_back(food);
+    forEachBallInRect(searchRect, [&nearbyFood](BaseBall* ball) {
+        if (ball->ballType() == BaseBall::FOOD_BALL) {
+            nearbyFood.push_back(static_cast<FoodBall*>(ball));
         }
-    }
+    });
     
     return nearbyFood;
 }
@@ -1222,21 +1394,19 @@ std::vector<FoodBall*> SimpleAIPlayer::getNearbyFood(float radius) const {
 std::vector<CloneBall*> SimpleAIPlayer::getNearbyPlayers(float radius) const {
     std::vector<CloneBall*> nearbyPlayers;
     
-    if (!m_playerBall || !m_playerBall->scene()) {
+    if (!m_playerBall || m_playerBall->isRemoved()) {
         return nearbyPlayers;
     }
     
-    QPointF playerPos = m_playerBall->pos();
+    QPointF playerPos = m_playerBall->position();
     QRectF searchRect(playerPos.x() - radius, playerPos.y() - radius, 
                       2 * radius, 2 * radius);
     
-    auto items = m_playerBall->scene()->items(searchRect);
-    for (auto item : items) {
-        CloneBall* player = dynamic_cast<CloneBall*>(item);
-        if (player && player != m_playerBall) {
-            nearbyPlayers.push_back(player);
+    forEachBallInRect(searchRect, [this, &nearbyPlayers](BaseBall* ball) {
+        if (ball->ballType() == BaseBall::CLONE_BALL && ball != m_playerBall) {
+            nearbyPlayers.push_back(static_cast<CloneBall*>(ball));
         }
-    }
+    });
     
     return nearbyPlayers;
 }
@@ -1271,7 +1441,6 @@ bool SimpleAIPlayer::isModelLoaded() const {
 
 AIAction SimpleAIPlayer::makeModelBasedDecision() {
     // 🔥 ONNX暂时禁用，直接回退到食物猎手策略
-    qDebug() << "ONNX disabled for safety, falling back to FOOD_HUNTER strategy";
     return makeFoodHunterDecision();
     
     /* 原ONNX代码暂时注释
@@ -1324,8 +1493,8 @@ AIAction SimpleAIPlayer::makeModelBasedDecision() {
 std::vector<float> SimpleAIPlayer::extractObservation() {
     std::vector<float> observation(m_observationSize, 0.0f);
     
-    if (!m_playerBall || !m_playerBall->scene()) {
-        qWarning() << "Cannot extract observation: no player ball or scene";
+    if (!m_playerBall || m_playerBall->isRemoved()) {
+        qWarning() << "Cannot extract observation: no player ball";
         return observation;
     }
     
@@ -1336,7 +1505,7 @@ std::vector<float> SimpleAIPlayer::extractObservation() {
         int idx = 0;
         
         // 1. 玩家自身信息 (4个特征)
-        QPointF playerPos = m_playerBall->pos();
+        QPointF playerPos = m_playerBall->position();
         float playerSize = m_playerBall->radius();
         
         if (idx + 3 < m_observationSize) {
@@ -1351,7 +1520,7 @@ std::vector<float> SimpleAIPlayer::extractObservation() {
         int maxFood = std::min(static_cast<int>(nearbyFood.size()), 50);
         
         for (int i = 0; i < maxFood && idx + 2 < m_observationSize; ++i) {
-            QPointF foodPos = nearbyFood[i]->pos();
+            QPointF foodPos = nearbyFood[i]->position();
             float relativeX = (foodPos.x() - playerPos.x()) / 200.0f; // 归一化相对位置
             float relativeY = (foodPos.y() - playerPos.y()) / 200.0f;
             float foodSize = nearbyFood[i]->radius() / 10.0f; // 归一化食物大小
@@ -1366,7 +1535,7 @@ std::vector<float> SimpleAIPlayer::extractObservation() {
         int maxPlayers = std::min(static_cast<int>(nearbyPlayers.size()), 20);
         
         for (int i = 0; i < maxPlayers && idx + 3 < m_observationSize; ++i) {
-            QPointF otherPos = nearbyPlayers[i]->pos();
+            QPointF otherPos = nearbyPlayers[i]->position();
             float relativeX = (otherPos.x() - playerPos.x()) / 150.0f;
             float relativeY = (otherPos.y() - playerPos.y()) / 150.0f;
             float otherSize = nearbyPlayers[i]->radius() / 100.0f;
@@ -1381,8 +1550,7 @@ std::vector<float> SimpleAIPlayer::extractObservation() {
         // 4. 填充剩余特征为0（如果有的话）
         // 其余特征保持为0
         
-        qDebug() << "Extracted observation with" << idx << "meaningful features out of" 
-                << m_observationSize << "total features";
+        GB_TRACE(AI, Verbose, "observation features/size", idx, m_observationSize);
         
     } catch (const std::exception& e) {
         qWarning() << "Feature extraction failed:" << e.what();
@@ -1392,8 +1560,7 @@ std::vector<float> SimpleAIPlayer::extractObservation() {
 }
 
 void SimpleAIPlayer::onSplitPerformed(CloneBall* originalBall, const QVector<CloneBall*>& newBalls) {
-    qDebug() << "🔄 Split performed! Original ball count:" << m_splitBalls.size() 
-             << "New balls:" << newBalls.size();
+    GB_TRACE(AI, Debug, "split controlled/newBalls", m_splitBalls.size(), newBalls.size());
     
     // 移除原始球（如果存在）
     m_splitBalls.removeAll(originalBall);
@@ -1403,12 +1570,9 @@ void SimpleAIPlayer::onSplitPerformed(CloneBall* originalBall, const QVector<Clo
         if (ball && !m_splitBalls.contains(ball)) {
             m_splitBalls.append(ball);
             
-            // 🔥 重要：为每个新球连接所有必要的信号
+            // 🔥 重要：为每个新球连接生命周期信号（分裂/合并走tickEvents）
             connect(ball, &QObject::destroyed, this, &SimpleAIPlayer::onBallDestroyed);
-            connect(ball, &CloneBall::splitPerformed, this, &SimpleAIPlayer::onSplitPerformed);
-            connect(ball, &CloneBall::mergePerformed, this, &SimpleAIPlayer::onMergePerformed); // 🔥 新增：连接合并信号
-            
-            qDebug() << "🔄 Added ball" << ball->ballId() << "to AI control";
+            connect(ball, &BaseBall::ballRecycled, this, &SimpleAIPlayer::onBallDestroyed);
         }
     }
     
@@ -1422,22 +1586,60 @@ void SimpleAIPlayer::onSplitPerformed(CloneBall* originalBall, const QVector<Clo
     // 🔥 如果主球不在列表中，选择第一个球作为主球
     if (!m_splitBalls.contains(m_playerBall)) {
         m_playerBall = m_splitBalls.first();
-        qDebug() << "🔄 Updated main ball to:" << m_playerBall->ballId();
+    }
+}
+
+void SimpleAIPlayer::onTickEvents(const QVector<GameEvent>& events) {
+    if (!m_playerBall && m_splitBalls.isEmpty()) {
+        return;
     }
     
-    qDebug() << "🔄 Now controlling" << m_splitBalls.size() << "balls";
+    for (int i = 0; i < events.size(); ++i) {
+        const GameEvent& event = events[i];
+        switch (event.type) {
+            case GameEvent::SPLIT: {
+                CloneBall* originalBall = static_cast<CloneBall*>(event.subject);
+                // 同一次分裂的新球是连续的几条记录，合成一次onSplitPerformed
+                QVector<CloneBall*> newBalls;
+                for (; i < events.size(); ++i) {
+                    if (events[i].type != GameEvent::SPLIT || events[i].subject != originalBall) break;
+                    newBalls.append(static_cast<CloneBall*>(events[i].other));
+                }
+                --i;
+                if (m_splitBalls.contains(originalBall)) {
+                    onSplitPerformed(originalBall, newBalls);
+                }
+                break;
+            }
+            case GameEvent::MERGE: {
+                CloneBall* survivingBall = static_cast<CloneBall*>(event.subject);
+                if (m_splitBalls.contains(survivingBall)) {
+                    onMergePerformed(survivingBall, static_cast<CloneBall*>(event.other));
+                }
+                break;
+            }
+            case GameEvent::REMOVED:
+                // 被移除的球帧末就回收复用了，指向它的记忆当场作废（快照也只能表达注册表里的球）
+                forgetBall(event.subject);
+                if (m_playerBall && event.subject == m_playerBall) {
+                    onPlayerBallRemoved();
+                }
+                break;
+            default:
+                break;
+        }
+    }
 }
 
 void SimpleAIPlayer::onBallDestroyed(QObject* ball) {
     CloneBall* cloneBall = qobject_cast<CloneBall*>(ball);
     if (cloneBall) {
         m_splitBalls.removeAll(cloneBall);
-        qDebug() << "Ball destroyed, now controlling" << m_splitBalls.size() << "balls";
+        GB_TRACE(AI, Debug, "ball lost ball/controlled", cloneBall->ballId(), m_splitBalls.size());
         
         // 如果主球被销毁，选择新的主球
         if (cloneBall == m_playerBall && !m_splitBalls.isEmpty()) {
             m_playerBall = m_splitBalls.first();
-            qDebug() << "Switched main ball to:" << m_playerBall->ballId();
         }
         
         // 如果没有球了，停止AI
@@ -1498,7 +1700,7 @@ QPointF SimpleAIPlayer::getSafeDirection(const QPointF& targetDirection) const
 {
     if (!m_playerBall) return targetDirection;
     
-    QPointF currentPos = m_playerBall->pos();
+    QPointF currentPos = m_playerBall->position();
     
     // 🔥 更严格的卡住检测：降低移动阈值，更快识别卡住状态
     float distanceMoved = QLineF(currentPos, m_lastPosition).length();
@@ -1552,20 +1754,18 @@ QPointF SimpleAIPlayer::getSafeDirection(const QPointF& targetDirection) const
     
     // 🔥 更快的脱困触发：从5帧降低到3帧
     if (m_stuckFrameCount > 3 || isOscillating) {
-        qDebug() << "AI Ball" << m_playerBall->ballId() << "is stuck or oscillating (stuck:" 
-                 << m_stuckFrameCount << "oscillating:" << isOscillating << "), using emergency escape";
+        GB_TRACE(AI, Debug, "stuck ball/frames/oscillating", m_playerBall->ballId(), m_stuckFrameCount, isOscillating);
         
         // 🔥 改进的脱困策略：尝试多个方向
-        static int escapeAttempt = 0;
-        escapeAttempt++;
+        m_escapeAttempt++;
         
         QPointF emergencyDirection;
         
         // 尝试不同的脱困方向
-        switch (escapeAttempt % 4) {
+        switch (m_escapeAttempt % 4) {
             case 0: {
                 // 随机方向
-                float angle = QRandomGenerator::global()->generateDouble() * 2.0 * M_PI;
+                float angle = m_random.generateDouble() * 2.0 * M_PI;
                 emergencyDirection = QPointF(std::cos(angle), std::sin(angle));
                 break;
             }
@@ -1581,7 +1781,7 @@ QPointF SimpleAIPlayer::getSafeDirection(const QPointF& targetDirection) const
                 // 向最近的食物方向移动
                 auto nearbyFood = getNearbyFood(150.0f);
                 if (!nearbyFood.empty()) {
-                    QPointF closestFood = nearbyFood[0]->pos();
+                    QPointF closestFood = nearbyFood[0]->position();
                     emergencyDirection = closestFood - currentPos;
                     float length = QLineF(QPointF(0,0), emergencyDirection).length();
                     if (length > 0.1f) emergencyDirection /= length;
@@ -1620,8 +1820,7 @@ QPointF SimpleAIPlayer::getSafeDirection(const QPointF& targetDirection) const
         
         m_stuckFrameCount = 0; // 重置计数
         m_recentDirections.clear(); // 清除历史
-        
-        qDebug() << "Emergency escape direction:" << emergencyDirection;
+        GB_TRACE(AI, Verbose, "escape direction x/y", emergencyDirection.x(), emergencyDirection.y());
         return emergencyDirection;
     }
     
@@ -1676,7 +1875,7 @@ QPointF SimpleAIPlayer::getSafeDirection(const QPointF& targetDirection) const
         if (m_borderCollisionCount > 2) { // 从3降低到2
             QPointF wallDirection = getWallTangentDirection(currentPos);
             if (wallDirection.manhattanLength() > 0.1f) {
-                qDebug() << "AI Ball" << m_playerBall->ballId() << "using wall-following strategy (attempt" << m_borderCollisionCount << ")";
+                GB_TRACE(AI, Verbose, "wall follow ball/attempt", m_playerBall->ballId(), m_borderCollisionCount);
                 m_borderCollisionCount = 0;
                 return wallDirection;
             }
@@ -1688,8 +1887,7 @@ QPointF SimpleAIPlayer::getSafeDirection(const QPointF& targetDirection) const
             safeDirection /= length;
         }
         
-        qDebug() << "AI Ball" << m_playerBall->ballId() << "avoiding border, direction:" 
-                 << targetDirection << "-> safe:" << safeDirection;
+        GB_TRACE(AI, Verbose, "avoid border ball/safeX/safeY", m_playerBall->ballId(), safeDirection.x(), safeDirection.y());
     } else {
         m_borderCollisionCount = 0; // 重置撞墙计数
     }
@@ -1812,13 +2010,13 @@ bool SimpleAIPlayer::shouldAttemptMerge() const {
     // 1. 追杀任务完成：没有追杀目标或追杀目标已消失
     if (!m_huntTarget || m_huntTarget->isRemoved()) {
         shouldMerge = true;
-        qDebug() << "🔗 Should merge: Hunt target completed/lost";
+        GB_TRACE(AI, Verbose, "should merge reason", 1);
     }
     
     // 2. 分裂时间过长：超过15秒
     if (m_splitFrameCount > 15 * 60) { // 15秒 * 60帧
         shouldMerge = true;
-        qDebug() << "🔗 Should merge: Split too long (" << m_splitFrameCount/60 << "s)";
+        GB_TRACE(AI, Verbose, "should merge reason/frames", 2, m_splitFrameCount);
     }
     
     // 3. 安全环境：附近没有威胁
@@ -1833,7 +2031,7 @@ bool SimpleAIPlayer::shouldAttemptMerge() const {
     }
     if (!hasThreat && m_splitFrameCount > 5 * 60) { // 安全环境下5秒后就可以合并
         shouldMerge = true;
-        qDebug() << "🔗 Should merge: Safe environment";
+        GB_TRACE(AI, Verbose, "should merge reason", 3);
     }
     
     // 4. 分裂球过于分散：最远距离超过400像素
@@ -1842,14 +2040,14 @@ bool SimpleAIPlayer::shouldAttemptMerge() const {
         for (auto ball1 : myBalls) {
             for (auto ball2 : myBalls) {
                 if (ball1 != ball2) {
-                    float dist = QLineF(ball1->pos(), ball2->pos()).length();
+                    float dist = QLineF(ball1->position(), ball2->position()).length();
                     maxDistance = std::max(maxDistance, dist);
                 }
             }
         }
         if (maxDistance > 400.0f) {
             shouldMerge = true;
-            qDebug() << "🔗 Should merge: Balls too scattered (" << maxDistance << "px)";
+            GB_TRACE(AI, Verbose, "should merge reason/distance", 4, maxDistance);
         }
     }
     
@@ -1866,14 +2064,14 @@ CloneBall* SimpleAIPlayer::findBestMergeTarget() const {
     
     CloneBall* bestTarget = nullptr;
     float bestScore = -1.0f;
-    QPointF currentPos = m_playerBall->pos();
+    QPointF currentPos = m_playerBall->position();
     
     for (auto ball : myBalls) {
         if (ball == m_playerBall || !m_playerBall->canMergeWith(ball)) {
             continue;
         }
         
-        float distance = QLineF(currentPos, ball->pos()).length();
+        float distance = QLineF(currentPos, ball->position()).length();
         float ballScore = ball->score();
         
         // 评分：球越大越好，距离越近越好
@@ -1902,8 +2100,8 @@ AIAction SimpleAIPlayer::makeMergeDecision() {
     }
     
     m_preferredMergeTarget = mergeTarget;
-    QPointF targetPos = mergeTarget->pos();
-    QPointF currentPos = m_playerBall->pos();
+    QPointF targetPos = mergeTarget->position();
+    QPointF currentPos = m_playerBall->position();
     
     QPointF direction = targetPos - currentPos;
     float distance = QLineF(QPointF(0,0), direction).length();
@@ -1917,8 +2115,7 @@ AIAction SimpleAIPlayer::makeMergeDecision() {
     // 🔥 安全检查：确保合并路径安全
     QPointF safeDirection = getSafeDirection(direction);
     
-    qDebug() << "🔗 Merging: Moving towards ball at" << targetPos.x() << targetPos.y() 
-             << "distance:" << distance;
+    GB_TRACE(AI, Verbose, "merge move x/y/distance", targetPos.x(), targetPos.y(), distance);
     
     return AIAction(safeDirection.x(), safeDirection.y(), ActionType::MOVE);
 }
@@ -1944,8 +2141,7 @@ void SimpleAIPlayer::updateMergeStatus() {
 }
 
 void SimpleAIPlayer::onMergePerformed(CloneBall* survivingBall, CloneBall* mergedBall) {
-    qDebug() << "🔗 Merge performed! Surviving ball:" << survivingBall->ballId() 
-             << "Merged ball:" << mergedBall->ballId();
+    GB_TRACE(AI, Debug, "merge surviving/merged", survivingBall->ballId(), mergedBall->ballId());
     
     // 移除被合并的球
     m_splitBalls.removeAll(mergedBall);
@@ -1953,27 +2149,22 @@ void SimpleAIPlayer::onMergePerformed(CloneBall* survivingBall, CloneBall* merge
     // 确保合并后的球在列表中并重新连接信号
     if (!m_splitBalls.contains(survivingBall)) {
         m_splitBalls.append(survivingBall);
-        qDebug() << "🔗 Added surviving ball" << survivingBall->ballId() << "to AI control";
     }
     
-    // 🔥 重要：重新连接合并后球的所有信号，确保AI持续控制
+    // 🔥 重要：重新连接合并后球的生命周期信号，确保AI持续控制
     disconnect(survivingBall, nullptr, this, nullptr); // 先断开所有连接
     connect(survivingBall, &QObject::destroyed, this, &SimpleAIPlayer::onBallDestroyed);
-    connect(survivingBall, &CloneBall::splitPerformed, this, &SimpleAIPlayer::onSplitPerformed);
-    connect(survivingBall, &CloneBall::mergePerformed, this, &SimpleAIPlayer::onMergePerformed);
+    connect(survivingBall, &BaseBall::ballRecycled, this, &SimpleAIPlayer::onBallDestroyed);
     
     // 🔥 如果主球被合并了，更新主球引用
     if (m_playerBall == mergedBall) {
         m_playerBall = survivingBall;
-        qDebug() << "🔗 Updated main ball to surviving ball:" << survivingBall->ballId();
     }
     
     // 清理合并目标引用
     if (m_preferredMergeTarget == mergedBall) {
         m_preferredMergeTarget = nullptr;
     }
-    
-    qDebug() << "🔗 Now controlling" << m_splitBalls.size() << "balls after merge";
 }
 
 } // namespace AI
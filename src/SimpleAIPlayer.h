@@ -2,15 +2,18 @@
 #include <QObject>
 #include <QTimer>
 #include <QPointF>
+#include <functional>
 #include <memory>
 #include <vector>
 #include <string>
 #include "CloneBall.h"
 #include "ONNXInference.h"
+#include "core/SimRandom.h"
 
 // Forward declarations
 class BaseBall;
 class FoodBall;
+class Broadphase;
 
 namespace GoBigger {
 namespace AI {
@@ -55,7 +58,8 @@ public:
     SimpleAIPlayer(CloneBall* playerBall, QObject* parent = nullptr);
     ~SimpleAIPlayer();
     
-    // 启动/停止AI控制
+    // 启动/停止AI控制；AI自己不计时，启动后要有人每帧调advanceDecisionClock才会决策
+    // （经GameManager::addAIPlayer*加入的由GameManager推进，自己new出来的要自己登记帧阶段）
     void startAI();
     void stopAI();
     bool isAIActive() const { return m_aiActive; }
@@ -72,10 +76,19 @@ public:
     CloneBall* getLargestBall() const;
     CloneBall* getMainControlBall() const; // 获取主控制球（最大的球）
     
-    // 设置决策间隔（毫秒）
+    // 设置决策间隔（毫秒，按游戏时间计）
     void setDecisionInterval(int interval_ms);
     int getDecisionInterval() const { return m_decisionInterval; }
     
+    // 由帧调度器每个逻辑帧调用，累计够一个决策间隔就做一次决策
+    // 决策节奏跟着游戏时间走，加速/变速时AI的反应频率相对游戏保持不变
+    void advanceDecisionClock(qreal elapsedMs);
+    // 累计真正做过的决策次数（基准用它确认AI确实在工作）
+    quint64 decisionCount() const { return m_decisionCount; }
+    
+    // 附近球的查询走世界的空间索引；没设置时退回场景查询（无头世界没有场景，什么也查不到）
+    void setBroadphase(const Broadphase* broadphase) { m_broadphase = broadphase; }
+    
     // 设置AI策略类型
     enum class AIStrategy {
         RANDOM,      // 随机移动
@@ -91,6 +104,27 @@ public:
     bool loadAIModel(const QString& modelPath);
     bool isModelLoaded() const;
     void setObservationSize(int size) { m_observationSize = size; }
+    
+    // 随机策略/脱困用的随机数流；GameManager按(teamId, playerId)从本局种子派生，
+    // 不经GameManager创建的AI由创建者自己设置，没设置时是固定的默认流（同样可复现）
+    void setRandomStream(const RandomStream& stream) { m_random = stream; }
+    const RandomStream& randomStream() const { return m_random; }
+    
+    // 🔥 世界快照恢复（GameManager::restore）：球对象都换了身份
+    // releaseBalls()断开并忘掉当前的球和指向球的短期记忆（锁定/追杀/合并目标等），不发信号；
+    // rebindBalls()再接管快照里属于自己的球，balls为空时等同于球全没了（停止并发出aiPlayerDestroyed）
+    void releaseBalls();
+    void rebindBalls(CloneBall* mainBall, const QVector<CloneBall*>& balls);
+    // 启发式的短期记忆（目标锁定/放弃、追杀、合并、脱困和防打转的记录）编码成一段字节，快照和fork用
+    // 指向球的记忆写成ballRef给的编号（-1表示没有），读回时由ballAt换回球；loadMemory要在rebindBalls之后调
+    QByteArray saveMemory(const std::function<qint64(const BaseBall*)>& ballRef) const;
+    bool loadMemory(const QByteArray& memory, const std::function<BaseBall*(qint64)>& ballAt);
+    qreal decisionElapsedMs() const { return m_decisionElapsedMs; }
+    void setDecisionElapsedMs(qreal elapsedMs) { m_decisionElapsedMs = elapsedMs; }
+
+public slots:
+    // 🔥 GameManager帧末分发的整批事件：从中挑出自己的球的分裂/合并/被吃
+    void onTickEvents(const QVector<GameEvent>& events);
 
 signals:
     void actionExecuted(const AIAction& action);
@@ -108,10 +142,12 @@ private slots:
 private:
     CloneBall* m_playerBall;
     QVector<CloneBall*> m_splitBalls; // 管理分裂后的所有球体
-    QTimer* m_decisionTimer;
     bool m_aiActive;
     int m_decisionInterval; // 决策间隔（毫秒）
+    qreal m_decisionElapsedMs; // 距上次决策经过的游戏时间
+    quint64 m_decisionCount; // 做过的决策次数
     AIStrategy m_strategy;
+    const Broadphase* m_broadphase; // 所在世界的空间索引（不拥有）
 
     // Target locking
     BaseBall* m_currentTarget;
@@ -127,6 +163,8 @@ private:
     mutable int m_stuckFrameCount; // 卡住的帧数计数
     mutable QPointF m_lastPosition; // 上次的位置
     mutable int m_borderCollisionCount; // 边界碰撞计数
+    mutable int m_escapeAttempt; // 脱困尝试次数，轮换脱困方向
+    mutable RandomStream m_random; // 本AI专属的随机数流
     
     // 🔥 新增：目标放弃机制
     mutable QMap<int, int> m_failedTargetAttempts; // 失败尝试次数 (foodId -> attempts)
@@ -203,6 +241,7 @@ private:
     std::vector<BaseBall*> getNearbyBalls(float radius = 100.0f);
     std::vector<FoodBall*> getNearbyFood(float radius = 150.0f) const;
     std::vector<CloneBall*> getNearbyPlayers(float radius = 120.0f) const;
+    void forEachBallInRect(const QRectF& rect, const std::function<void(BaseBall*)>& visit) const;
 
     // 边界和避障相关
     bool isNearBorder(const QPointF& position, float threshold = 150.0f) const;
@@ -216,6 +255,7 @@ private:
     CloneBall* findBestMergeTarget() const; // 找到最佳合并目标
     AIAction makeMergeDecision(); // 制定合并策略
     void updateMergeStatus(); // 更新合并状态
+    void forgetBall(const BaseBall* ball); // 清掉指向该球的目标记忆
 };
 
 } // namespace AI
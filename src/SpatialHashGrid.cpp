@@ -0,0 +1,305 @@
+#include "SpatialHashGrid.h"
+#include "BaseBall.h"
+#include "GoBiggerConfig.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // 格子总数上限，防止格子过小时表爆炸
+    constexpr int MAX_GRID_CELLS = 1 << 20;
+}
+
+SpatialHashGrid::SpatialHashGrid(const QRectF& bounds, qreal cellSize)
+    : m_bounds(bounds)
+    , m_cellSize(0.0)
+    , m_autoCellSize(cellSize <= 0.0)
+    , m_cols(1)
+    , m_rows(1)
+{
+    setupCells(m_autoCellSize ? defaultCellSize() : cellSize);
+}
+
+qreal SpatialHashGrid::defaultCellSize()
+{
+    QVector<qreal> radii;
+    radii.append(GoBiggerConfig::scoreToRadius(GoBiggerConfig::FOOD_SCORE));
+    return chooseCellSize(radii);
+}
+
+qreal SpatialHashGrid::chooseCellSize(QVector<qreal> radii)
+{
+    if (radii.isEmpty()) {
+        return defaultCellSize();
+    }
+
+    // 90分位：食物占绝大多数，少量大球不会把格子撑大
+    const int index = std::min(static_cast<int>(radii.size() * 0.9), static_cast<int>(radii.size()) - 1);
+    std::nth_element(radii.begin(), radii.begin() + index, radii.end());
+    const qreal radius = std::max(radii[index], static_cast<qreal>(1.0));
+
+    // 格子边长取两倍直径：小球只占一个格子，查询最多扫3x3格
+    return radius * 4.0;
+}
+
+void SpatialHashGrid::setupCells(qreal cellSize)
+{
+    m_cellSize = cellSize;
+    m_cols = std::max(1, static_cast<int>(std::ceil(m_bounds.width() / m_cellSize)));
+    m_rows = std::max(1, static_cast<int>(std::ceil(m_bounds.height() / m_cellSize)));
+
+    while (static_cast<qint64>(m_cols) * m_rows > MAX_GRID_CELLS) {
+        m_cellSize *= 2.0;
+        m_cols = std::max(1, static_cast<int>(std::ceil(m_bounds.width() / m_cellSize)));
+        m_rows = std::max(1, static_cast<int>(std::ceil(m_bounds.height() / m_cellSize)));
+    }
+
+    m_cells = QVector<QVector<BaseBall*>>(m_cols * m_rows);
+    m_largeBalls.clear();
+    m_slots.clear();
+}
+
+int SpatialHashGrid::cellX(qreal x) const
+{
+    int ix = static_cast<int>(std::floor((x - m_bounds.left()) / m_cellSize));
+    return std::clamp(ix, 0, m_cols - 1);
+}
+
+int SpatialHashGrid::cellY(qreal y) const
+{
+    int iy = static_cast<int>(std::floor((y - m_bounds.top()) / m_cellSize));
+    return std::clamp(iy, 0, m_rows - 1);
+}
+
+int SpatialHashGrid::targetCell(BaseBall* ball) const
+{
+    if (ball->radius() * 2.0 > m_cellSize) {
+        return -1;
+    }
+
+    const QPointF pos = ball->position();
+    return cellY(pos.y()) * m_cols + cellX(pos.x());
+}
+
+void SpatialHashGrid::place(BaseBall* ball, int cell)
+{
+    Slot slot;
+    slot.cell = cell;
+
+    if (cell < 0) {
+        slot.index = m_largeBalls.size();
+        m_largeBalls.append(ball);
+    } else {
+        slot.index = m_cells[cell].size();
+        m_cells[cell].append(ball);
+    }
+
+    m_slots.insert(ball, slot);
+}
+
+void SpatialHashGrid::unplace(BaseBall* ball, const Slot& slot)
+{
+    QVector<BaseBall*>& list = slot.cell < 0 ? m_largeBalls : m_cells[slot.cell];
+
+    // 交换删除，并修正被搬过来的球的下标
+    BaseBall* moved = list.last();
+    list[slot.index] = moved;
+    list.removeLast();
+
+    if (moved != ball) {
+        m_slots[moved].index = slot.index;
+    }
+
+    m_slots.remove(ball);
+}
+
+void SpatialHashGrid::insert(BaseBall* ball)
+{
+    if (!ball || ball->isRemoved()) {
+        return;
+    }
+
+    if (m_slots.contains(ball)) {
+        update(ball);
+        return;
+    }
+
+    place(ball, targetCell(ball));
+}
+
+void SpatialHashGrid::remove(BaseBall* ball)
+{
+    auto it = m_slots.constFind(ball);
+    if (it == m_slots.constEnd()) {
+        return;
+    }
+
+    unplace(ball, it.value());
+}
+
+void SpatialHashGrid::update(BaseBall* ball)
+{
+    if (!ball) return;
+
+    auto it = m_slots.constFind(ball);
+    if (it == m_slots.constEnd()) {
+        insert(ball);
+        return;
+    }
+
+    const int cell = targetCell(ball);
+    if (cell == it.value().cell) {
+        return; // 仍在原来的格子里
+    }
+
+    unplace(ball, it.value());
+    place(ball, cell);
+}
+
+void SpatialHashGrid::clear()
+{
+    for (QVector<BaseBall*>& cell : m_cells) {
+        cell.clear();
+    }
+    m_largeBalls.clear();
+    m_slots.clear();
+}
+
+void SpatialHashGrid::rebuild(const QVector<BaseBall*>& allBalls)
+{
+    if (m_autoCellSize) {
+        QVector<qreal> radii;
+        radii.reserve(allBalls.size());
+        for (BaseBall* ball : allBalls) {
+            if (ball && !ball->isRemoved()) {
+                radii.append(ball->radius());
+            }
+        }
+
+        const qreal cellSize = radii.isEmpty() ? defaultCellSize() : chooseCellSize(radii);
+        if (!qFuzzyCompare(cellSize, m_cellSize)) {
+            setupCells(cellSize);
+            qDebug() << "SpatialHashGrid cell size tuned to" << m_cellSize
+                     << "grid" << m_cols << "x" << m_rows;
+        }
+    }
+
+    Broadphase::rebuild(allBalls);
+}
+
+QVector<BaseBall*> SpatialHashGrid::balls() const
+{
+    QVector<BaseBall*> result;
+    result.reserve(m_slots.size());
+
+    for (const QVector<BaseBall*>& cell : m_cells) {
+        result += cell;
+    }
+    result += m_largeBalls;
+
+    return result;
+}
+
+void SpatialHashGrid::forEachInRange(const QRectF& range, BallVisitor visitor) const
+{
+    // 小球的包围盒不会超出所在格子半个边长
+    const qreal margin = m_cellSize / 2.0;
+    const int x0 = cellX(range.left() - margin);
+    const int x1 = cellX(range.right() + margin);
+    const int y0 = cellY(range.top() - margin);
+    const int y1 = cellY(range.bottom() + margin);
+
+    for (int iy = y0; iy <= y1; ++iy) {
+        for (int ix = x0; ix <= x1; ++ix) {
+            for (BaseBall* ball : m_cells[iy * m_cols + ix]) {
+                if (!ball->isRemoved() && range.intersects(ballBounds(ball))) {
+                    visitor(ball);
+                }
+            }
+        }
+    }
+
+    for (BaseBall* ball : m_largeBalls) {
+        if (!ball->isRemoved() && range.intersects(ballBounds(ball))) {
+            visitor(ball);
+        }
+    }
+}
+
+void SpatialHashGrid::collectPairs(QVector<BallPair>& pairs) const
+{
+    // 小球对：本格内部 + 前向半邻域（右、左下、下、右下），每对只访问一次
+    static const int neighborOffsets[4][2] = { {1, 0}, {-1, 1}, {0, 1}, {1, 1} };
+
+    for (int iy = 0; iy < m_rows; ++iy) {
+        for (int ix = 0; ix < m_cols; ++ix) {
+            const QVector<BaseBall*>& cell = m_cells[iy * m_cols + ix];
+            if (cell.isEmpty()) continue;
+
+            for (int i = 0; i < cell.size(); ++i) {
+                BaseBall* a = cell[i];
+                if (a->isRemoved()) continue;
+                const QRectF boxA = ballBounds(a);
+
+                for (int j = i + 1; j < cell.size(); ++j) {
+                    BaseBall* b = cell[j];
+                    if (!b->isRemoved() && boxA.intersects(ballBounds(b))) {
+                        pairs.append(BallPair(a, b));
+                    }
+                }
+
+                for (const auto& offset : neighborOffsets) {
+                    const int nx = ix + offset[0];
+                    const int ny = iy + offset[1];
+                    if (nx < 0 || nx >= m_cols || ny >= m_rows) continue;
+
+                    for (BaseBall* b : m_cells[ny * m_cols + nx]) {
+                        if (!b->isRemoved() && boxA.intersects(ballBounds(b))) {
+                            pairs.append(BallPair(a, b));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // 大球对：与其他大球（只取后面的）以及与所有小球
+    for (int i = 0; i < m_largeBalls.size(); ++i) {
+        BaseBall* a = m_largeBalls[i];
+        if (a->isRemoved()) continue;
+        const QRectF boxA = ballBounds(a);
+
+        for (int j = i + 1; j < m_largeBalls.size(); ++j) {
+            BaseBall* b = m_largeBalls[j];
+            if (!b->isRemoved() && boxA.intersects(ballBounds(b))) {
+                pairs.append(BallPair(a, b));
+            }
+        }
+
+        const qreal margin = m_cellSize / 2.0;
+        const int x0 = cellX(boxA.left() - margin);
+        const int x1 = cellX(boxA.right() + margin);
+        const int y0 = cellY(boxA.top() - margin);
+        const int y1 = cellY(boxA.bottom() + margin);
+
+        for (int iy = y0; iy <= y1; ++iy) {
+            for (int ix = x0; ix <= x1; ++ix) {
+                for (BaseBall* b : m_cells[iy * m_cols + ix]) {
+                    if (!b->isRemoved() && boxA.intersects(ballBounds(b))) {
+                        pairs.append(BallPair(a, b));
+                    }
+                }
+            }
+        }
+    }
+}
+
+QString SpatialHashGrid::statistics() const
+{
+    return QString("cellSize=%1 grid=%2x%3 balls=%4 large=%5")
+        .arg(m_cellSize, 0, 'f', 1)
+        .arg(m_cols)
+        .arg(m_rows)
+        .arg(ballCount())
+        .arg(m_largeBalls.size());
+}
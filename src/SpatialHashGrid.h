@@ -0,0 +1,71 @@
+#ifndef SPATIALHASHGRID_H
+#define SPATIALHASHGRID_H
+
+#include <QVector>
+#include <QHash>
+#include <QRectF>
+#include <QPointF>
+#include "Broadphase.h"
+
+// 均匀空间哈希网格
+// 世界有边界，所以格子坐标直接映射到一张稠密表（越界坐标夹到边缘格子）。
+// 直径不超过格子边长的"小球"只登记在球心所在的一个格子里，查询时把范围向外扩半个格子即可；
+// 更大的球（荆棘、大分身）放在旁路列表里线性检查——GoBigger的半径是双峰分布，
+// 绝大多数是食物，大球只有几十个。
+class SpatialHashGrid : public Broadphase
+{
+public:
+    // cellSize <= 0 时根据半径分布自动选择，并在rebuild时按实际分布重新调整
+    explicit SpatialHashGrid(const QRectF& bounds, qreal cellSize = 0.0);
+    ~SpatialHashGrid() override = default;
+
+    const char* name() const override { return "HashGrid"; }
+
+    void insert(BaseBall* ball) override;
+    void remove(BaseBall* ball) override;
+    void update(BaseBall* ball) override;
+    void clear() override;
+    void rebuild(const QVector<BaseBall*>& allBalls) override;
+
+    bool contains(BaseBall* ball) const override { return m_slots.contains(ball); }
+    int ballCount() const override { return m_slots.size(); }
+    QVector<BaseBall*> balls() const override;
+
+    void forEachInRange(const QRectF& range, BallVisitor visitor) const override;
+    void collectPairs(QVector<BallPair>& pairs) const override;
+
+    QString statistics() const override;
+
+    qreal cellSize() const { return m_cellSize; }
+    int largeBallCount() const { return m_largeBalls.size(); }
+
+    // 根据半径分布选择格子边长：取90分位半径的两倍直径
+    static qreal chooseCellSize(QVector<qreal> radii);
+    // 还没有球时使用的默认值（按GoBigger标准食物半径）
+    static qreal defaultCellSize();
+
+private:
+    // 球的登记位置：cell < 0 表示在大球列表里
+    struct Slot {
+        int cell = -1;
+        int index = -1;
+    };
+
+    QRectF m_bounds;
+    qreal m_cellSize;
+    bool m_autoCellSize;
+    int m_cols;
+    int m_rows;
+    QVector<QVector<BaseBall*>> m_cells;
+    QVector<BaseBall*> m_largeBalls;
+    QHash<BaseBall*, Slot> m_slots;
+
+    void setupCells(qreal cellSize);
+    int cellX(qreal x) const;
+    int cellY(qreal y) const;
+    int targetCell(BaseBall* ball) const;   // 大球返回-1
+    void place(BaseBall* ball, int cell);
+    void unplace(BaseBall* ball, const Slot& slot);
+};
+
+#endif // SPATIALHASHGRID_H
@@ -1,51 +1,67 @@
 #include "SporeBall.h"
 #include "CloneBall.h"
 #include "GoBiggerConfig.h"
+#include "core/Trace.h"
 #include <QRandomGenerator>
 #include <QGraphicsScene>
 #include <QDebug>
 #include <QtMath>
+#include <cstring>
 
 SporeBall::SporeBall(int ballId, const QPointF& position, const Border& border, 
-                     int teamId, int playerId, const QVector2D& direction, const Config& config, QGraphicsItem* parent)
-    : BaseBall(ballId, position, GoBiggerConfig::EJECT_SCORE, border, SPORE_BALL, parent)
+                     int teamId, int playerId, const QVector2D& direction, const Config& config,
+                     QGraphicsItem* parent, std::shared_ptr<BallDataStorage> storage)
+    : BaseBall(ballId, position, GoBiggerConfig::EJECT_SCORE, border, SPORE_BALL,
+               acquireBallData(storage ? &storage->spores : nullptr), storage, parent)
     , m_config(config)
-    , m_teamId(teamId)
-    , m_playerId(playerId)
-    , m_direction(direction.normalized())
-    , m_initialVelocity(GoBiggerConfig::EJECT_SPEED)  // 使用标准的50.0速度
-    , m_velocityPiece(QVector2D(0.0f, 0.0f))
-    , m_moveFrame(0)
-    , m_velocityZeroFrame(GoBiggerConfig::EJECT_VEL_ZERO_FRAME)  // 使用标准的10帧衰减
-    , m_remainingLifetime(GoBiggerConfig::SPORE_LIFESPAN)
-    , m_framesSinceCreation(0)  // 初始化创建帧计数
-    , m_lifetimeTimer(nullptr)
 {
+    initializeData(teamId, playerId, direction);
+    
     // 设置初始速度，基于GoBigger实现
-    QVector2D initialVel = m_direction * m_initialVelocity;
+    QVector2D initialVel = this->direction() * sporeData().initialVelocity;
     setVelocity(initialVel);
-    m_velocityPiece = initialVel / static_cast<float>(m_velocityZeroFrame); // 每帧减少的速度
-    
-    qDebug() << "SporeBall created with initial velocity:" << initialVel.length() 
-             << "direction:" << m_direction.x() << m_direction.y()
-             << "vel_piece:" << m_velocityPiece.length();
+    storeVelocityPiece(initialVel / static_cast<float>(sporeData().velocityZeroFrame)); // 每帧减少的速度
     
-    initializeTimer();
+    GB_TRACE(Spore, Debug, "spore created id/vel/dirX/dirY", m_data->ballId, initialVel.length(), sporeData().dirX, sporeData().dirY);
 }
 
 SporeBall::~SporeBall()
 {
-    if (m_lifetimeTimer) {
-        m_lifetimeTimer->stop();
-        delete m_lifetimeTimer;
-    }
 }
 
-void SporeBall::initializeTimer()
+void SporeBall::reset(int ballId, const QPointF& position, int teamId, int playerId,
+                      const QVector2D& direction, const QVector2D& parentVelocity)
+{
+    *sporeBallData() = SporeBallData(); // 清掉上一个孢子留下的状态
+    reinitialize(ballId, position, GoBiggerConfig::EJECT_SCORE, SPORE_BALL);
+    initializeData(teamId, playerId, direction);
+    
+    // 与构造函数相同：玩家球速度 + 孢子喷射速度，只有喷射部分会衰减
+    QVector2D sporeVelocity = this->direction() * sporeData().initialVelocity;
+    setVelocity(parentVelocity + sporeVelocity);
+    storeVelocityPiece(sporeVelocity / static_cast<float>(sporeData().velocityZeroFrame));
+}
+
+void SporeBall::restoreData(const char* record)
 {
-    m_lifetimeTimer = new QTimer(this);
-    connect(m_lifetimeTimer, &QTimer::timeout, this, &SporeBall::updateLifetime);
-    m_lifetimeTimer->start(16); // ~60 FPS
+    std::memcpy(sporeBallData(), record, sizeof(SporeBallData));
+    refreshProxy();
+}
+
+void SporeBall::initializeData(int teamId, int playerId, const QVector2D& direction)
+{
+    SporeBallData* d = sporeBallData();
+    const QVector2D dir = direction.normalized();
+    
+    d->teamId = teamId;
+    d->playerId = playerId;
+    d->dirX = dir.x();
+    d->dirY = dir.y();
+    d->initialVelocity = GoBiggerConfig::EJECT_SPEED;              // 使用标准的50.0速度
+    d->moveFrame = 0;
+    d->velocityZeroFrame = GoBiggerConfig::EJECT_VEL_ZERO_FRAME;   // 使用标准的10帧衰减
+    d->remainingLifetime = GoBiggerConfig::SPORE_LIFESPAN;
+    d->framesSinceCreation = 0;                                     // 初始化创建帧计数
 }
 
 void SporeBall::move(const QVector2D& direction, qreal duration)
@@ -53,37 +69,34 @@ void SporeBall::move(const QVector2D& direction, qreal duration)
     Q_UNUSED(direction)
     
     // 完全按照GoBigger的实现：直接更新位置
-    if (m_moveFrame < m_velocityZeroFrame) {
+    SporeBallData* d = sporeBallData();
+    if (d->moveFrame < d->velocityZeroFrame) {
         // GoBigger原版逻辑：self.position = self.position + self.vel * duration
         QVector2D currentVel = velocity();
         
         // 更新位置（GoBigger方式）
-        QPointF currentPos = pos();
+        QPointF currentPos = position();
         QPointF displacement(currentVel.x() * duration, currentVel.y() * duration);
         QPointF newPos = currentPos + displacement;
-        setPos(newPos);
+        setPosition(newPos);
         
-        qDebug() << "SporeBall move frame:" << m_moveFrame 
-                 << "pos from (" << currentPos.x() << "," << currentPos.y() << ")"
-                 << "to (" << newPos.x() << "," << newPos.y() << ")"
-                 << "displacement:" << displacement.x() << displacement.y()
-                 << "vel:" << currentVel.length()
-                 << "duration:" << duration;
+        GB_TRACE(Spore, Verbose, "spore move frame/x/y/vel", d->moveFrame, newPos.x(), newPos.y(), currentVel.length());
         
         // 然后减少速度：只减少喷射速度部分，保留继承的速度
-        QVector2D newVel = currentVel - m_velocityPiece;
+        QVector2D newVel = currentVel - velocityPiece();
         
         // 确保速度减少的方向是正确的（沿着喷射方向）
-        qreal projectionLength = QVector2D::dotProduct(newVel, m_direction);
+        const QVector2D sporeDir = this->direction();
+        qreal projectionLength = QVector2D::dotProduct(newVel, sporeDir);
         if (projectionLength > 0) {
             setVelocity(newVel);
         } else {
             // 如果喷射速度已经完全衰减，保留垂直分量
-            QVector2D perpendicularVel = newVel - m_direction * projectionLength;
+            QVector2D perpendicularVel = newVel - sporeDir * projectionLength;
             setVelocity(perpendicularVel);
         }
         
-        m_moveFrame++;
+        d->moveFrame++;
         
         // 检查边界
         checkBorder();
@@ -110,7 +123,7 @@ void SporeBall::eat(BaseBall* other)
 QColor SporeBall::getBallColor() const
 {
     // 孢子球使用半透明的团队颜色
-    QColor teamColor = getTeamColor(m_teamId);
+    QColor teamColor = getTeamColor(teamId());
     teamColor.setAlpha(180); // 半透明效果
     return teamColor;
 }
@@ -127,15 +140,16 @@ void SporeBall::updatePhysics(qreal deltaTime)
 
 void SporeBall::updateLifetime()
 {
-    m_framesSinceCreation++;  // 增加创建后帧计数
-    m_remainingLifetime--;
+    SporeBallData* d = sporeBallData();
+    d->framesSinceCreation++;  // 增加创建后帧计数
+    d->remainingLifetime--;
     
-    if (m_remainingLifetime <= 0) {
+    if (d->remainingLifetime <= 0) {
         emit sporeExpired(this);
         remove();
     } else {
         // 随着生存时间减少，透明度也减少
-        qreal alpha = static_cast<qreal>(m_remainingLifetime) / m_config.lifetimeFrames;
+        qreal alpha = static_cast<qreal>(d->remainingLifetime) / m_config.lifetimeFrames;
         QColor color = getBallColor();
         color.setAlpha(static_cast<int>(alpha * 180));
         
@@ -165,31 +179,20 @@ QColor SporeBall::getTeamColor(int teamId) const
 // 新的构造函数，可以接收玩家球的速度
 SporeBall::SporeBall(int ballId, const QPointF& position, const Border& border, 
                      int teamId, int playerId, const QVector2D& direction, const QVector2D& parentVelocity,
-                     const Config& config, QGraphicsItem* parent)
-    : BaseBall(ballId, position, GoBiggerConfig::EJECT_SCORE, border, SPORE_BALL, parent)
+                     const Config& config, QGraphicsItem* parent, std::shared_ptr<BallDataStorage> storage)
+    : BaseBall(ballId, position, GoBiggerConfig::EJECT_SCORE, border, SPORE_BALL,
+               acquireBallData(storage ? &storage->spores : nullptr), storage, parent)
     , m_config(config)
-    , m_teamId(teamId)
-    , m_playerId(playerId)
-    , m_direction(direction.normalized())
-    , m_initialVelocity(GoBiggerConfig::EJECT_SPEED)
-    , m_velocityPiece(QVector2D(0.0f, 0.0f))
-    , m_moveFrame(0)
-    , m_velocityZeroFrame(GoBiggerConfig::EJECT_VEL_ZERO_FRAME)
-    , m_remainingLifetime(GoBiggerConfig::SPORE_LIFESPAN)
-    , m_framesSinceCreation(0)  // 初始化创建帧计数
-    , m_lifetimeTimer(nullptr)
 {
+    initializeData(teamId, playerId, direction);
+    
     // 计算孢子的初始速度：玩家球速度 + 孢子喷射速度
-    QVector2D sporeVelocity = m_direction * m_initialVelocity;
+    QVector2D sporeVelocity = this->direction() * sporeData().initialVelocity;
     QVector2D totalVelocity = parentVelocity + sporeVelocity;
     
     setVelocity(totalVelocity);
-    m_velocityPiece = sporeVelocity / static_cast<float>(m_velocityZeroFrame); // 只有喷射速度部分会衰减
-    
-    qDebug() << "SporeBall created with parent velocity:" << parentVelocity.length()
-             << "spore velocity:" << sporeVelocity.length()
-             << "total velocity:" << totalVelocity.length()
-             << "direction:" << m_direction.x() << m_direction.y();
+    storeVelocityPiece(sporeVelocity / static_cast<float>(sporeData().velocityZeroFrame)); // 只有喷射速度部分会衰减
     
-    initializeTimer();
+    GB_TRACE(Spore, Debug, "spore reset id/parentVel/sporeVel/totalVel",
+             m_data->ballId, parentVelocity.length(), sporeVelocity.length(), totalVelocity.length());
 }
@@ -2,7 +2,6 @@
 #define SPOREBALL_H
 
 #include "BaseBall.h"
-#include <QTimer>
 
 class SporeBall : public BaseBall
 {
@@ -21,26 +20,37 @@ public:
     };
 
     SporeBall(int ballId, const QPointF& position, const Border& border, 
-              int teamId, int playerId, const QVector2D& direction, const Config& config = Config(), QGraphicsItem* parent = nullptr);
+              int teamId, int playerId, const QVector2D& direction, const Config& config = Config(), QGraphicsItem* parent = nullptr,
+              std::shared_ptr<BallDataStorage> storage = nullptr);
     
     // 重载构造函数，可以接收玩家球的当前速度
     SporeBall(int ballId, const QPointF& position, const Border& border, 
               int teamId, int playerId, const QVector2D& direction, const QVector2D& parentVelocity, 
-              const Config& config = Config(), QGraphicsItem* parent = nullptr);
+              const Config& config = Config(), QGraphicsItem* parent = nullptr,
+              std::shared_ptr<BallDataStorage> storage = nullptr);
     
     ~SporeBall();
+    
+    // 从对象池取出时重置为一个刚喷出的孢子（参数与带玩家速度的构造函数一致）
+    void reset(int ballId, const QPointF& position, int teamId, int playerId,
+               const QVector2D& direction, const QVector2D& parentVelocity);
+    void restoreData(const char* record) override;
 
     // 获取属性
-    int teamId() const { return m_teamId; }
-    int playerId() const { return m_playerId; }
-    int remainingLifetime() const { return m_remainingLifetime; }
-    QVector2D direction() const { return m_direction; }
-    bool canBeEaten() const { return m_framesSinceCreation > 3; } // 3帧后才能被吞噬
+    int teamId() const { return m_data->teamId; }
+    int playerId() const { return m_data->playerId; }
+    int remainingLifetime() const { return sporeData().remainingLifetime; }
+    QVector2D direction() const { return QVector2D(sporeData().dirX, sporeData().dirY); }
+    bool canBeEaten() const { return sporeData().framesSinceCreation > 3; } // 3帧后才能被吞噬
+    const SporeBallData& sporeData() const { return *static_cast<const SporeBallData*>(m_data); }
     
     // 重写基类方法
     void move(const QVector2D& direction, qreal duration) override;
     bool canEat(BaseBall* other) const override;
     void eat(BaseBall* other) override;
+    
+    // 🔥 逐帧推进寿命：由GameManager::updateBalls()在统一的帧调度里调用
+    void updateLifetime();
 
 signals:
     void sporeExpired(SporeBall* spore);
@@ -49,23 +59,15 @@ protected:
     QColor getBallColor() const override;
     void updatePhysics(qreal deltaTime) override;
 
-private slots:
-    void updateLifetime();
-
 private:
     Config m_config;
-    int m_teamId;
-    int m_playerId;
-    QVector2D m_direction;          // 孢子移动方向
-    qreal m_initialVelocity;        // 初始速度
-    QVector2D m_velocityPiece;      // 每帧减少的速度
-    int m_moveFrame;                // 移动帧计数
-    int m_velocityZeroFrame;        // 速度衰减到0的帧数
-    int m_remainingLifetime;
-    int m_framesSinceCreation;      // 创建后经过的帧数
-    QTimer* m_lifetimeTimer;
     
-    void initializeTimer();
+    // 方向/衰减/寿命等状态存放在SporeBallData里
+    SporeBallData* sporeBallData() { return static_cast<SporeBallData*>(m_data); }
+    QVector2D velocityPiece() const { return QVector2D(sporeData().velPieceX, sporeData().velPieceY); }
+    void storeVelocityPiece(const QVector2D& v) { sporeBallData()->velPieceX = v.x(); sporeBallData()->velPieceY = v.y(); }
+    
+    void initializeData(int teamId, int playerId, const QVector2D& direction);
     QColor getTeamColor(int teamId) const;
 };
 
@@ -2,49 +2,58 @@
 #include "CloneBall.h"
 #include "SporeBall.h"
 #include "GoBiggerConfig.h"
-#include <QRandomGenerator>
+#include "core/Trace.h"
+#include "core/SimRandom.h"
 #include <QPainter>
 #include <QPolygonF>
 #include <QDebug>
 #include <cmath>
+#include <cstring>
 
 ThornsBall::ThornsBall(int ballId, const QPointF& position, const Border& border, 
-                       const Config& config, QGraphicsItem* parent)
-    : BaseBall(ballId, position, GoBiggerConfig::THORNS_MIN_SCORE, border, THORNS_BALL, parent)
+                       const Config& config, QGraphicsItem* parent, std::shared_ptr<BallDataStorage> storage)
+    : BaseBall(ballId, position, GoBiggerConfig::THORNS_MIN_SCORE, border, THORNS_BALL,
+               acquireBallData(storage ? &storage->thorns : nullptr), storage, parent)
     , m_config(config)
-    , m_isMoving(false)
-    , m_velocity(0, 0)
-    , m_moveFramesLeft(0)
 {
-    // 生成随机分数
+    // 生成随机分数：只由ballId决定，保证同一个种子可复现（GameManager还会按本局种子重新设置分数）
     float minScore = GoBiggerConfig::THORNS_MIN_SCORE;
     float maxScore = GoBiggerConfig::THORNS_MAX_SCORE;
     
-    float randomScore = minScore + (maxScore - minScore) * QRandomGenerator::global()->generateDouble();
+    float randomScore = minScore + (maxScore - minScore) * RandomStream(static_cast<quint64>(ballId)).generateDouble();
     setScore(randomScore);
     
     generateRandomColor();
 }
 
+void ThornsBall::restoreData(const char* record)
+{
+    std::memcpy(thornsBallData(), record, sizeof(ThornsBallData));
+    generateRandomColor(); // 颜色只由ballId决定
+    refreshProxy();
+}
+
 void ThornsBall::move(const QVector2D& direction, qreal duration)
 {
     // GoBigger荆棘球移动机制：只有吃孢子后才能移动
-    if (m_isMoving && m_moveFramesLeft > 0) {
+    ThornsBallData* d = thornsBallData();
+    if (d->isMoving && d->moveFramesLeft > 0) {
         updateMovement();
         
         // 应用移动
-        QPointF currentPos = pos();
-        QPointF newPos = currentPos + QPointF(m_velocity.x() * duration, m_velocity.y() * duration);
+        QPointF currentPos = position();
+        QPointF newPos = currentPos + QPointF(d->moveVx * duration, d->moveVy * duration);
         
         // 边界检查
         if (m_border.contains(newPos)) {
-            setPos(newPos);
+            setPosition(newPos);
         }
         
-        m_moveFramesLeft--;
-        if (m_moveFramesLeft <= 0) {
-            m_isMoving = false;
-            m_velocity = QVector2D(0, 0);
+        d->moveFramesLeft--;
+        if (d->moveFramesLeft <= 0) {
+            d->isMoving = false;
+            d->moveVx = 0.0f;
+            d->moveVy = 0.0f;
         }
     }
 }
@@ -71,11 +80,8 @@ void ThornsBall::causeCollisionDamage(CloneBall* ball)
         return;
     }
     
-    qDebug() << "ThornsBall collision with CloneBall" << ball->ballId() 
-             << "Original score:" << ball->score();
-    
     // GoBigger标准：如果玩家球分数不足以吃荆棘球，碰撞不产生任何影响
-    qDebug() << "Player ball cannot eat thorns ball - no collision effect";
+    GB_TRACE(Thorns, Verbose, "thorns touch without effect thorns/ball/score", ballId(), ball->ballId(), ball->score());
 }
 
 QColor ThornsBall::getBallColor() const
@@ -120,8 +126,8 @@ void ThornsBall::generateRandomColor()
         QColor(20, 60, 60),    // 深青
     };
     
-    QRandomGenerator* rng = QRandomGenerator::global();
-    m_color = thornsColors[rng->bounded(thornsColors.size())];
+    // 取ballId流的第二个数（第一个给了分数），同一个ID总是同一种颜色
+    m_color = thornsColors[RandomStream(static_cast<quint64>(ballId()), 1).bounded(static_cast<int>(thornsColors.size()))];
 }
 
 void ThornsBall::drawThorns(QPainter* painter)
@@ -167,7 +173,7 @@ void ThornsBall::eatSpore(SporeBall* spore)
 {
     if (!spore || spore->isRemoved()) return;
     
-    qDebug() << "Thorns ball" << ballId() << "eating spore" << spore->ballId();
+    GB_TRACE(Thorns, Debug, "thorns eat spore thorns/spore", ballId(), spore->ballId());
     
     // 获取孢子的运动方向
     QVector2D sporeVelocity = spore->velocity();
@@ -176,28 +182,37 @@ void ThornsBall::eatSpore(SporeBall* spore)
     }
     
     // 增加分数
-    setScore(score() + spore->score());
+    const float gainedScore = spore->score();
+    setScore(score() + gainedScore);
     
     // 标记孢子为已移除
     spore->remove();
+    
+    if (m_events) {
+        m_events->record(GameEvent::EAT, this, spore, gainedScore);
+    }
 }
 
 void ThornsBall::applySporeMovement(const QVector2D& sporeDirection)
 {
     // GoBigger标准：荆棘球获得10的初速度
-    m_velocity = sporeDirection * GoBiggerConfig::THORNS_SPORE_SPEED;
-    m_moveFramesLeft = GoBiggerConfig::THORNS_SPORE_DECAY_FRAMES;
-    m_isMoving = true;
-    
-    qDebug() << "Thorns ball" << ballId() << "gained velocity:" 
-             << m_velocity.x() << m_velocity.y() << "for" << m_moveFramesLeft << "frames";
+    ThornsBallData* d = thornsBallData();
+    const QVector2D moveVelocity = sporeDirection * GoBiggerConfig::THORNS_SPORE_SPEED;
+    d->moveVx = moveVelocity.x();
+    d->moveVy = moveVelocity.y();
+    d->moveFramesLeft = GoBiggerConfig::THORNS_SPORE_DECAY_FRAMES;
+    d->isMoving = true;
+    
+    GB_TRACE(Thorns, Debug, "thorns move id/vx/vy/frames", ballId(), d->moveVx, d->moveVy, d->moveFramesLeft);
 }
 
 void ThornsBall::updateMovement()
 {
-    if (!m_isMoving || m_moveFramesLeft <= 0) return;
+    ThornsBallData* d = thornsBallData();
+    if (!d->isMoving || d->moveFramesLeft <= 0) return;
     
     // GoBigger标准：速度在20帧内均匀衰减到0
-    float decayFactor = static_cast<float>(m_moveFramesLeft) / GoBiggerConfig::THORNS_SPORE_DECAY_FRAMES;
-    m_velocity = m_velocity * decayFactor;
+    float decayFactor = static_cast<float>(d->moveFramesLeft) / GoBiggerConfig::THORNS_SPORE_DECAY_FRAMES;
+    d->moveVx *= decayFactor;
+    d->moveVy *= decayFactor;
 }
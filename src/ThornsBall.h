@@ -20,9 +20,11 @@ public:
     };
 
     ThornsBall(int ballId, const QPointF& position, const Border& border, 
-               const Config& config = Config(), QGraphicsItem* parent = nullptr);
+               const Config& config = Config(), QGraphicsItem* parent = nullptr,
+               std::shared_ptr<BallDataStorage> storage = nullptr);
 
     // 重写基类方法
+    void restoreData(const char* record) override;
     void move(const QVector2D& direction, qreal duration) override;
     bool canEat(BaseBall* other) const override;
     void eat(BaseBall* other) override;
@@ -33,7 +35,8 @@ public:
     
     // GoBigger荆棘运动机制
     void applySporeMovement(const QVector2D& sporeDirection);
-    bool isMoving() const { return m_isMoving; }
+    bool isMoving() const { return thornsData().isMoving; }
+    const ThornsBallData& thornsData() const { return *static_cast<const ThornsBallData*>(m_data); }
     
 signals:
     void thornsCollision(ThornsBall* thorns, class CloneBall* ball);
@@ -46,10 +49,8 @@ private:
     Config m_config;
     QColor m_color;
     
-    // GoBigger荆棘运动状态
-    bool m_isMoving;
-    QVector2D m_velocity;
-    int m_moveFramesLeft;
+    // GoBigger荆棘运动状态存放在ThornsBallData里
+    ThornsBallData* thornsBallData() { return static_cast<ThornsBallData*>(m_data); }
     
     void generateRandomColor();
     void drawThorns(QPainter* painter);
@@ -133,8 +133,8 @@ private slots:
             if (humanPlayer) {
                 logMessage(QString("✅ 人类玩家创建成功，ID: %1, 位置: (%2, %3)")
                           .arg(humanPlayer->ballId())
-                          .arg(humanPlayer->pos().x())
-                          .arg(humanPlayer->pos().y()));
+                          .arg(humanPlayer->position().x())
+                          .arg(humanPlayer->position().y()));
                 
                 logMessage(QString("✅ 玩家在场景中: %1").arg(humanPlayer->scene() != nullptr ? "是" : "否"));
                 
@@ -172,8 +172,8 @@ private slots:
             if (aiPlayerBall) {
                 logMessage(QString("✅ AI玩家球体创建成功，ID: %1, 位置: (%2, %3)")
                           .arg(aiPlayerBall->ballId())
-                          .arg(aiPlayerBall->pos().x())
-                          .arg(aiPlayerBall->pos().y()));
+                          .arg(aiPlayerBall->position().x())
+                          .arg(aiPlayerBall->position().y()));
                 
                 logMessage(QString("✅ AI球在场景中: %1").arg(aiPlayerBall->scene() != nullptr ? "是" : "否"));
                 
@@ -210,7 +210,7 @@ private slots:
             logMessage(QString("目标球体ID: %1").arg(m_aiPlayerBall->ballId()));
             logMessage(QString("目标球体在场景中: %1").arg(m_aiPlayerBall->scene() != nullptr ? "是" : "否"));
             logMessage(QString("球体是否被移除: %1").arg(m_aiPlayerBall->isRemoved() ? "是" : "否"));
-            logMessage(QString("球体位置: (%1, %2)").arg(m_aiPlayerBall->pos().x()).arg(m_aiPlayerBall->pos().y()));
+            logMessage(QString("球体位置: (%1, %2)").arg(m_aiPlayerBall->position().x()).arg(m_aiPlayerBall->position().y()));
             logMessage(QString("球体半径: %1").arg(m_aiPlayerBall->radius()));
             
             // 强制确保球体在场景中
@@ -242,13 +242,24 @@ private slots:
                     
                     if (m_aiController) {
                         logMessage("✅ AI控制器创建成功");
+                        // 与GameManager创建的AI一样从本局种子派生随机数流
+                        m_aiController->setRandomStream(m_gameManager->random().aiStream(m_aiPlayerBall->teamId(),
+                                                                                         m_aiPlayerBall->playerId()));
                         
                         // 连接信号
                         connect(m_aiController, &GoBigger::AI::SimpleAIPlayer::actionExecuted, 
                                 this, &AICrashDebugger::onAIAction);
                         connect(m_aiController, &GoBigger::AI::SimpleAIPlayer::aiPlayerDestroyed,
                                 this, &AICrashDebugger::onAIDestroyed);
-                        
+
+                        // 这个AI不归GameManager管，决策时钟由调试器自己登记的帧阶段推进（startAI之后才会决策）
+                        const qreal elapsedMs = m_gameManager->config().tickDuration * 1000.0;
+                        m_gameManager->scheduler()->addPhase(GameManager::PHASE_AI, "debug_ai", [this, elapsedMs]() {
+                            if (m_aiController) {
+                                m_aiController->advanceDecisionClock(elapsedMs);
+                            }
+                        });
+
                         logMessage("✅ AI信号连接完成");
                         
                         // 等待一会儿
@@ -297,7 +308,7 @@ private slots:
             logMessage(QString("  - 球体ID: %1").arg(m_aiPlayerBall->ballId()));
             logMessage(QString("  - 球体在场景中: %1").arg(m_aiPlayerBall->scene() != nullptr ? "是" : "否"));
             logMessage(QString("  - 球体被移除: %1").arg(m_aiPlayerBall->isRemoved() ? "是" : "否"));
-            logMessage(QString("  - 球体位置: (%1, %2)").arg(m_aiPlayerBall->pos().x()).arg(m_aiPlayerBall->pos().y()));
+            logMessage(QString("  - 球体位置: (%1, %2)").arg(m_aiPlayerBall->position().x()).arg(m_aiPlayerBall->position().y()));
             logMessage(QString("  - AI已激活: %1").arg(m_aiController->isAIActive() ? "是" : "否"));
             
             // 设置更长的决策间隔，降低崩溃风险
@@ -0,0 +1,256 @@
+#include "BatchEngine.h"
+#include <QDebug>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// 常驻工作线程：固定负责[begin, end)这段环境，从创建到销毁都在这个线程里
+class BatchEngine::Worker : public QThread
+{
+public:
+    Worker(BatchEngine* batch, int index, int begin, int end)
+        : m_batch(batch), m_index(index), m_begin(begin), m_end(end) {}
+
+protected:
+    void run() override
+    {
+        if (m_batch->m_config.pinWorkers) {
+            pinToCore(m_index);
+        }
+
+        quint64 seen = 0;
+        Command command = Init;
+        while (command != Quit) {
+            m_batch->runCommand(command, m_begin, m_end);
+
+            QMutexLocker locker(&m_batch->m_mutex);
+            if (--m_batch->m_busyWorkers == 0) {
+                m_batch->m_workDone.wakeAll();
+            }
+            while (m_batch->m_generation == seen) {
+                m_batch->m_workReady.wait(&m_batch->m_mutex);
+            }
+            seen = m_batch->m_generation;
+            command = m_batch->m_command;
+        }
+
+        // 环境里的QObject归这个线程，也在这里销毁
+        m_batch->runCommand(Quit, m_begin, m_end);
+    }
+
+private:
+    BatchEngine* m_batch;
+    int m_index;
+    int m_begin;
+    int m_end;
+
+    static void pinToCore(int index)
+    {
+#ifdef Q_OS_LINUX
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % qMax(1, QThread::idealThreadCount()), &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            qWarning() << "BatchEngine: cannot pin worker" << index;
+        }
+#else
+        Q_UNUSED(index);
+#endif
+    }
+};
+
+BatchEngine::BatchEngine(const Config& config)
+    : m_config(config)
+    , m_command(Init)
+    , m_generation(0)
+    , m_busyWorkers(0)
+    , m_actions(nullptr)
+{
+    m_config.envCount = qMax(1, m_config.envCount);
+    m_config.frameSkip = qMax(1, m_config.frameSkip);
+    // 并行放在环境之间，每个世界内部的碰撞检测不再开线程池
+    m_config.engineConfig.gameConfig.manualTick = true;
+    m_config.engineConfig.gameConfig.collisionThreads = 1;
+
+    const int envCount = m_config.envCount;
+    const int workerCount = qBound(1, m_config.workerCount > 0 ? m_config.workerCount : QThread::idealThreadCount(), envCount);
+
+    m_envs.resize(envCount);
+    const RandomStream seeds(m_config.engineConfig.gameConfig.seed);
+    for (int i = 0; i < envCount; ++i) {
+        m_envs[i].seeds = seeds.derive(static_cast<quint64>(i));
+    }
+
+    m_observations.assign(static_cast<size_t>(envCount) * envObservationSize(), 0.0f);
+    m_rewards.assign(static_cast<size_t>(envCount) * playersPerEnv(), 0.0f);
+    m_dones.assign(envCount, 0);
+    m_episodes.assign(envCount, 0);
+
+    // 环境按连续的一段分给工作线程，相邻环境的数据留在同一个核的缓存里
+    m_busyWorkers = workerCount;
+    for (int w = 0; w < workerCount; ++w) {
+        const int begin = static_cast<int>(static_cast<qint64>(envCount) * w / workerCount);
+        const int end = static_cast<int>(static_cast<qint64>(envCount) * (w + 1) / workerCount);
+        m_workers.push_back(std::make_unique<Worker>(this, w, begin, end));
+    }
+    for (auto& worker : m_workers) {
+        worker->start();
+    }
+
+    // 等所有工作线程建好自己的环境
+    QMutexLocker locker(&m_mutex);
+    while (m_busyWorkers > 0) {
+        m_workDone.wait(&m_mutex);
+    }
+
+    qDebug() << "BatchEngine:" << envCount << "environments on" << workerCount << "workers, frame skip"
+             << m_config.frameSkip << "observation" << envObservationSize() << "floats per environment";
+}
+
+BatchEngine::~BatchEngine()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_command = Quit;
+        ++m_generation;
+        m_workReady.wakeAll();
+    }
+    for (auto& worker : m_workers) {
+        worker->wait();
+    }
+}
+
+void BatchEngine::reset()
+{
+    dispatch(Reset);
+}
+
+void BatchEngine::step(const float* actions)
+{
+    m_actions = actions;
+    dispatch(Step);
+    m_actions = nullptr;
+}
+
+void BatchEngine::dispatch(Command command)
+{
+    QMutexLocker locker(&m_mutex);
+    m_command = command;
+    m_busyWorkers = static_cast<int>(m_workers.size());
+    ++m_generation;
+    m_workReady.wakeAll();
+    while (m_busyWorkers > 0) {
+        m_workDone.wait(&m_mutex);
+    }
+}
+
+void BatchEngine::runCommand(Command command, int begin, int end)
+{
+    const int actionStride = playersPerEnv() * kActionSize;
+    for (int i = begin; i < end; ++i) {
+        switch (command) {
+            case Init:
+                createEnv(i);
+                writeObservation(i);
+                break;
+            case Reset:
+                resetEnv(i);
+                std::fill_n(m_rewards.begin() + static_cast<size_t>(i) * playersPerEnv(), playersPerEnv(), 0.0f);
+                m_dones[i] = 0;
+                writeObservation(i);
+                break;
+            case Step:
+                stepEnv(i, m_actions + static_cast<size_t>(i) * actionStride);
+                writeObservation(i);
+                break;
+            case Quit:
+                m_envs[i].engine.reset();
+                break;
+        }
+    }
+}
+
+void BatchEngine::createEnv(int index)
+{
+    Env& env = m_envs[index];
+
+    // 固定种子时第一局也从环境自己的种子序列里取；GameEngine构造时就开好了第一局
+    GameEngine::Config config = m_config.engineConfig;
+    if (config.gameConfig.seed != 0) {
+        config.gameConfig.seed = env.seeds.generate64();
+    }
+    env.engine = std::make_unique<GameEngine>(config);
+    env.playerIds = env.engine->playerIds();
+    for (int playerId : env.playerIds) {
+        env.actions.insert(playerId, GameEngine::Action());
+    }
+    m_episodes[index] = 1;
+}
+
+void BatchEngine::resetEnv(int index)
+{
+    Env& env = m_envs[index];
+    // 种子为0时GameManager每局取新种子
+    const quint64 seed = m_config.engineConfig.gameConfig.seed != 0 ? env.seeds.generate64() : 0;
+    env.engine->reset(seed);
+    m_episodes[index]++;
+}
+
+void BatchEngine::stepEnv(int index, const float* actions)
+{
+    Env& env = m_envs[index];
+    GameEngine& engine = *env.engine;
+    float* rewards = m_rewards.data() + static_cast<size_t>(index) * playersPerEnv();
+
+    for (int p = 0; p < env.playerIds.size(); ++p) {
+        const float* action = actions + p * kActionSize;
+        GameEngine::Action& slot = env.actions[env.playerIds[p]];
+        slot.direction_x = action[0];
+        slot.direction_y = action[1];
+        slot.action_type = static_cast<int>(action[2]);
+        rewards[p] = -engine.playerScore(env.playerIds[p]);
+    }
+
+    // 跳帧：移动方向每帧重复，分裂/喷射只做一次
+    for (int frame = 0; frame < m_config.frameSkip && !engine.isDone(); ++frame) {
+        if (frame == 1) {
+            for (GameEngine::Action& action : env.actions) {
+                action.action_type = 0;
+            }
+        }
+        engine.step(env.actions);
+    }
+
+    for (int p = 0; p < env.playerIds.size(); ++p) {
+        rewards[p] += engine.playerScore(env.playerIds[p]);
+    }
+
+    m_dones[index] = engine.isDone() ? 1 : 0;
+    if (m_dones[index] && m_config.autoReset) {
+        resetEnv(index);
+    }
+}
+
+void BatchEngine::writeObservation(int index)
+{
+    const GameEngine& engine = *m_envs[index].engine;
+    const Border& border = engine.gameManager()->config().gameBorder;
+
+    float* out = m_observations.data() + static_cast<size_t>(index) * envObservationSize();
+    out[0] = static_cast<float>(engine.frameCount());
+    out[1] = static_cast<float>(engine.config().totalFrames);
+    out[2] = static_cast<float>(border.maxx - border.minx);
+    out[3] = static_cast<float>(border.maxy - border.miny);
+    out += kEnvHeaderSize;
+
+    const int playerSize = m_config.layout.playerSize();
+    for (int playerId : m_envs[index].playerIds) {
+        engine.writeObservation(playerId, m_config.layout, out);
+        out += playerSize;
+    }
+}
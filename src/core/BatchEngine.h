@@ -0,0 +1,106 @@
+#ifndef BATCHENGINE_H
+#define BATCHENGINE_H
+
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+#include <memory>
+#include <vector>
+#include "GameEngine.h"
+
+// 多环境批量引擎：K个互相独立的无头世界按同一节奏推进（强化学习训练用），一个进程、没有事件循环
+//
+// - 环境按连续的一段固定分给工作线程，由该线程创建、推进和销毁：QObject的线程归属就是它，
+//   信号都是直接连接；各世界之间没有共享的可变状态，碰撞检测也不再各开线程池（并行放在环境之间）
+// - step()一次推进全部环境：动作是一块扁平的float数组，每个环境推进frameSkip帧，只在最后一帧写观察；
+//   结束的环境在C++里自动重开一局，rewards/dones记的是结束前的结算，观察已经是新一局的开局
+// - 观察写进一块预先分配的连续缓冲区：环境i从i * envObservationSize()开始，
+//   头部[当前帧, 总帧数, 地图宽, 地图高]后面是各玩家（GameEngine::playerIds()顺序）的GameEngine::FlatLayout
+class BatchEngine
+{
+public:
+    static constexpr int kActionSize = 3;     // [direction_x, direction_y, action_type]，同GameEngine::Action
+    static constexpr int kEnvHeaderSize = 4;
+
+    struct Config {
+        GameEngine::Config engineConfig;      // 每个环境的配置；gameConfig.seed非0时各环境各局的种子都由它派生，整批可复现
+        GameEngine::FlatLayout layout;
+        int envCount = 64;
+        int workerCount = 0;                  // 工作线程数，<=0时取CPU核数（不超过环境数）
+        int frameSkip = 1;                    // 每次step推进的帧数；移动每帧都施加，分裂/喷射只在第一帧
+        bool autoReset = true;
+        bool pinWorkers = false;              // 工作线程绑定到固定的CPU核（目前只在Linux上生效）
+
+        Config() = default;
+    };
+
+    explicit BatchEngine(const Config& config = Config());
+    ~BatchEngine();
+
+    BatchEngine(const BatchEngine&) = delete;
+    BatchEngine& operator=(const BatchEngine&) = delete;
+
+    // 全部环境重开一局并写观察
+    void reset();
+    // actions: envCount() * playersPerEnv() * kActionSize个float，按(环境, 玩家)排列
+    void step(const float* actions);
+
+    int envCount() const { return static_cast<int>(m_envs.size()); }
+    int playersPerEnv() const { return m_config.engineConfig.teamNum * m_config.engineConfig.playerNumPerTeam; }
+    int workerCount() const { return static_cast<int>(m_workers.size()); }
+    int envObservationSize() const { return kEnvHeaderSize + playersPerEnv() * m_config.layout.playerSize(); }
+    const Config& config() const { return m_config; }
+
+    const float* observations() const { return m_observations.data(); }
+    const float* rewards() const { return m_rewards.data(); }  // 每(环境, 玩家)：这一步的分数变化
+    const quint8* dones() const { return m_dones.data(); }     // 这一步是否结束了一局
+    const qint64* episodes() const { return m_episodes.data(); } // 每个环境已经开过几局
+
+    // 只能在两次reset()/step()之间访问（工作线程空闲时）
+    const GameEngine* engine(int index) const { return m_envs[index].engine.get(); }
+
+private:
+    class Worker;
+
+    enum Command {
+        Init,
+        Reset,
+        Step,
+        Quit
+    };
+
+    struct Env {
+        std::unique_ptr<GameEngine> engine;
+        RandomStream seeds;                   // 每开一局取一个种子
+        QVector<int> playerIds;
+        QMap<int, GameEngine::Action> actions; // 跨步复用，不重复分配
+    };
+
+    Config m_config;
+    std::vector<Env> m_envs;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    std::vector<float> m_observations;
+    std::vector<float> m_rewards;
+    std::vector<quint8> m_dones;
+    std::vector<qint64> m_episodes;
+
+    // 主线程与工作线程的同步：每条命令推进一代，工作线程做完自己那段后递减m_busyWorkers
+    QMutex m_mutex;
+    QWaitCondition m_workReady;
+    QWaitCondition m_workDone;
+    Command m_command;
+    quint64 m_generation;
+    int m_busyWorkers;
+    const float* m_actions;
+
+    void dispatch(Command command);
+    // 以下在工作线程里运行，只碰自己那段环境
+    void runCommand(Command command, int begin, int end);
+    void createEnv(int index);
+    void resetEnv(int index);
+    void stepEnv(int index, const float* actions);
+    void writeObservation(int index);
+};
+
+#endif // BATCHENGINE_H
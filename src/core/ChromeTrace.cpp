@@ -0,0 +1,286 @@
+#include "ChromeTrace.h"
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include <memory>
+
+namespace ChromeTrace {
+
+namespace {
+    // 每个线程攒满这么多条事件，整块交给后台线程格式化并写文件
+    constexpr int kChunkSize = 4096;
+
+    struct Event {
+        const char* name;
+        const char* category;
+        qint64 startNs;
+        qint64 durationNs;
+        int tid;
+        const char* argNames[2];
+        qint64 argValues[2];
+    };
+
+    // 每个线程自己的缓冲区：span结束时只锁它（只有交出整块和stop()收尾时才会有别的线程碰）
+    struct ThreadBuffer {
+        QMutex mutex;
+        QVector<Event> events;
+        int tid = 0;
+        QByteArray name;
+    };
+
+    std::atomic<bool> g_recording{false};
+    std::atomic<quint64> g_session{0};   // 每次start()加一，线程在新一段录制里重新登记缓冲区
+    std::atomic<qint64> g_baseNs{0};     // 本段录制开始时的进程时钟读数，录制期间不变
+
+    // 进程级单调时钟，只启动一次；nowNs()并发读不需要加锁
+    const QElapsedTimer& processClock()
+    {
+        static const QElapsedTimer clock = []() {
+            QElapsedTimer timer;
+            timer.start();
+            return timer;
+        }();
+        return clock;
+    }
+
+    // 以下由g_mutex保护（start/stop、线程登记）
+    QMutex g_mutex;
+    QFile g_file;
+    QVector<std::shared_ptr<ThreadBuffer>> g_buffers; // 下标即tid；线程退出后缓冲区仍留到stop()
+    bool g_firstEvent = true;                         // 录制期间只有后台线程写文件
+
+    // 后台写文件：线程交出的整块事件排在这里
+    QMutex g_queueMutex;
+    QWaitCondition g_queueReady;
+    QVector<QVector<Event>> g_queue;
+    bool g_stopFlusher = false;
+    QThread* g_flusher = nullptr;
+
+    struct ThreadSlot {
+        quint64 session = 0;
+        std::shared_ptr<ThreadBuffer> buffer;
+    };
+    thread_local ThreadSlot t_slot;
+
+    // 当前线程在本段录制里的缓冲区，第一次用时登记（只有这时候拿g_mutex）
+    ThreadBuffer* threadBuffer()
+    {
+        const quint64 session = g_session.load(std::memory_order_acquire);
+        if (t_slot.session == session && t_slot.buffer) {
+            return t_slot.buffer.get();
+        }
+
+        QThread* thread = QThread::currentThread();
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->events.reserve(kChunkSize);
+        buffer->name = thread->objectName().toUtf8();
+
+        QMutexLocker locker(&g_mutex);
+        buffer->tid = g_buffers.size();
+        if (buffer->name.isEmpty()) {
+            const bool isMain = QCoreApplication::instance() && thread == QCoreApplication::instance()->thread();
+            buffer->name = isMain ? QByteArray("main") : "thread-" + QByteArray::number(buffer->tid);
+        }
+        g_buffers.append(buffer);
+        t_slot.session = session;
+        t_slot.buffer = buffer;
+        return buffer.get();
+    }
+
+    // 微秒，保留三位小数（纳秒精度）
+    void appendMicros(QByteArray& out, qint64 ns)
+    {
+        out += QByteArray::number(ns / 1000);
+        out += '.';
+        const qint64 frac = ns % 1000;
+        if (frac < 100) out += '0';
+        if (frac < 10) out += '0';
+        out += QByteArray::number(frac);
+    }
+
+    void writeEntry(const QByteArray& entry)
+    {
+        g_file.write(g_firstEvent ? "\n" : ",\n");
+        g_file.write(entry);
+        g_firstEvent = false;
+    }
+
+    // 录制期间只在后台线程调用，start/stop里只在后台线程没运行时调用
+    void writeEvents(const QVector<Event>& events)
+    {
+        QByteArray out;
+        out.reserve(events.size() * 120);
+        for (const Event& e : events) {
+            out += g_firstEvent ? "\n" : ",\n";
+            g_firstEvent = false;
+            out += "{\"name\":\"";
+            out += e.name;
+            out += "\",\"cat\":\"";
+            out += e.category;
+            out += "\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+            out += QByteArray::number(e.tid);
+            out += ",\"ts\":";
+            appendMicros(out, e.startNs);
+            out += ",\"dur\":";
+            appendMicros(out, e.durationNs);
+            if (e.argNames[0]) {
+                out += ",\"args\":{\"";
+                out += e.argNames[0];
+                out += "\":";
+                out += QByteArray::number(e.argValues[0]);
+                if (e.argNames[1]) {
+                    out += ",\"";
+                    out += e.argNames[1];
+                    out += "\":";
+                    out += QByteArray::number(e.argValues[1]);
+                }
+                out += '}';
+            }
+            out += '}';
+        }
+        g_file.write(out);
+    }
+
+    void writeMetadata(const char* kind, int tid, const QByteArray& name)
+    {
+        writeEntry("{\"name\":\"" + QByteArray(kind) + "\",\"ph\":\"M\",\"pid\":1,\"tid\":" +
+                   QByteArray::number(tid) + ",\"args\":{\"name\":\"" + name + "\"}}");
+    }
+
+    void flushLoop()
+    {
+        QMutexLocker locker(&g_queueMutex);
+        for (;;) {
+            while (g_queue.isEmpty() && !g_stopFlusher) {
+                g_queueReady.wait(&g_queueMutex);
+            }
+            if (g_queue.isEmpty()) {
+                return;
+            }
+
+            QVector<QVector<Event>> chunks;
+            chunks.swap(g_queue);
+            locker.unlock();
+            for (const QVector<Event>& chunk : std::as_const(chunks)) {
+                writeEvents(chunk);
+            }
+            locker.relock();
+        }
+    }
+
+    void handOff(QVector<Event>&& chunk)
+    {
+        QMutexLocker locker(&g_queueMutex);
+        g_queue.append(std::move(chunk));
+        g_queueReady.wakeOne();
+    }
+}
+
+bool start(const QString& path)
+{
+    stop();
+
+    QMutexLocker locker(&g_mutex);
+    g_file.setFileName(path);
+    if (!g_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    g_buffers.clear();
+    g_firstEvent = true;
+    g_file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    writeMetadata("process_name", 0, QCoreApplication::applicationName().toUtf8());
+
+    g_stopFlusher = false;
+    g_flusher = QThread::create(flushLoop);
+    g_flusher->setObjectName("chrome-trace");
+    g_flusher->start(QThread::LowPriority);
+
+    g_baseNs.store(processClock().nsecsElapsed(), std::memory_order_relaxed);
+    g_session.fetch_add(1, std::memory_order_release);
+    g_recording.store(true, std::memory_order_release);
+    return true;
+}
+
+bool stop()
+{
+    QMutexLocker locker(&g_mutex);
+    if (!g_recording.exchange(false, std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    {
+        QMutexLocker queueLocker(&g_queueMutex);
+        g_stopFlusher = true;
+        g_queueReady.wakeOne();
+    }
+    g_flusher->wait();
+    delete g_flusher;
+    g_flusher = nullptr;
+
+    // 后台线程已经退出：各线程没攒满的部分和退出后才交出来的整块都在这里写完
+    // 拿过每个缓冲区的锁之后，正在进行的complete()都已结束，不会再有新事件
+    for (const auto& buffer : std::as_const(g_buffers)) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+        writeEvents(buffer->events);
+        buffer->events.clear();
+    }
+    for (const QVector<Event>& chunk : std::as_const(g_queue)) {
+        writeEvents(chunk);
+    }
+    g_queue.clear();
+
+    for (const auto& buffer : std::as_const(g_buffers)) {
+        writeMetadata("thread_name", buffer->tid, buffer->name);
+    }
+    g_file.write("\n]}\n");
+    g_file.close();
+    return true;
+}
+
+bool isRecording()
+{
+    return g_recording.load(std::memory_order_acquire);
+}
+
+QString outputPath()
+{
+    QMutexLocker locker(&g_mutex);
+    return g_file.fileName();
+}
+
+qint64 nowNs()
+{
+    return processClock().nsecsElapsed() - g_baseNs.load(std::memory_order_relaxed);
+}
+
+void complete(const char* name, const char* category, qint64 startNs, qint64 durationNs,
+              const char* argName1, qint64 argValue1, const char* argName2, qint64 argValue2)
+{
+    if (durationNs < 0 || startNs < 0) {
+        return; // 开始于上一段录制的span
+    }
+
+    ThreadBuffer* buffer = threadBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    if (!g_recording.load(std::memory_order_acquire)) {
+        return; // stop()已经收尾
+    }
+
+    buffer->events.append(Event{ name, category, startNs, durationNs, buffer->tid,
+                                 { argName1, argName2 }, { argValue1, argValue2 } });
+    if (buffer->events.size() >= kChunkSize) {
+        QVector<Event> full;
+        full.reserve(kChunkSize);
+        full.swap(buffer->events);
+        handOff(std::move(full));
+    }
+}
+
+} // namespace ChromeTrace
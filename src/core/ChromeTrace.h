@@ -0,0 +1,69 @@
+#ifndef CHROMETRACE_H
+#define CHROMETRACE_H
+
+#include <QString>
+#include <QtGlobal>
+
+// 把一局的时间线录成Trace Event Format（JSON），用chrome://tracing或Perfetto打开
+// - 每个span是一条"X"（complete）事件：名字、类别、起止时间、线程，外加最多2个整数参数
+// - 录制期间事件先攒在各线程自己的缓冲区里（span结束只锁本线程的缓冲区），攒满一块交给后台线程
+//   格式化并追加写入文件：模拟线程上没有格式化和I/O，长时间对局内存也不会涨
+// - 时间取进程级单调时钟减去录制开始时的读数，录制期间基准不变
+// - 没在录制时Span只做一次原子读，可以放在热路径上
+// 录制入口：命令行--chrome-trace <文件>，或者启动界面勾选"录制性能时间线"（见main.cpp）
+namespace ChromeTrace {
+
+// 开始录制到path（覆盖已有文件），已在录制时先结束上一段；失败返回false
+bool start(const QString& path);
+// 写完剩余事件和线程名并关闭文件；没在录制时返回false
+bool stop();
+bool isRecording();
+QString outputPath();
+
+// 自录制开始以来的纳秒数
+qint64 nowNs();
+
+// 一条complete事件；name/category/argName必须是字符串字面量（只存指针）
+void complete(const char* name, const char* category, qint64 startNs, qint64 durationNs,
+              const char* argName1 = nullptr, qint64 argValue1 = 0,
+              const char* argName2 = nullptr, qint64 argValue2 = 0);
+
+// RAII：构造到析构之间记为一个span
+class Span
+{
+public:
+    Span(const char* name, const char* category)
+        : m_name(name), m_category(category), m_startNs(isRecording() ? nowNs() : -1)
+    {
+    }
+    ~Span()
+    {
+        if (m_startNs >= 0 && isRecording()) {
+            complete(m_name, m_category, m_startNs, nowNs() - m_startNs,
+                     m_argNames[0], m_argValues[0], m_argNames[1], m_argValues[1]);
+        }
+    }
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    // 最多两个参数，多出的忽略
+    void setArg(const char* name, qint64 value)
+    {
+        const int slot = m_argNames[0] ? 1 : 0;
+        if (!m_argNames[slot]) {
+            m_argNames[slot] = name;
+            m_argValues[slot] = value;
+        }
+    }
+
+private:
+    const char* m_name;
+    const char* m_category;
+    qint64 m_startNs;
+    const char* m_argNames[2] = {};
+    qint64 m_argValues[2] = {};
+};
+
+} // namespace ChromeTrace
+
+#endif // CHROMETRACE_H
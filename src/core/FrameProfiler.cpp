@@ -0,0 +1,150 @@
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+    const char* const kPhaseNames[FrameProfiler::PhaseCount] = {
+        "移动", "空间索引", "碰撞", "孢子碰撞", "合并", "移除", "生成", "AI决策", "绘制"
+    };
+
+    const char* const kTraceNames[FrameProfiler::PhaseCount] = {
+        "Movement", "Broadphase", "Collisions", "SporeCollisions", "Merging", "Removal", "Spawning", "AI", "Paint"
+    };
+
+    double toMs(qint64 nsecs)
+    {
+        return nsecs / 1e6;
+    }
+}
+
+void FrameProfiler::Window::push(qint64 nsecs)
+{
+    samples[next] = nsecs;
+    next = (next + 1) % WINDOW_SIZE;
+    count = qMin(count + 1, WINDOW_SIZE);
+}
+
+FrameProfiler::PhaseStats FrameProfiler::Window::stats() const
+{
+    PhaseStats result;
+    result.samples = count;
+    if (count == 0) {
+        return result;
+    }
+
+    // 窗口很小，拷贝一份做部分排序即可
+    qint64 sorted[WINDOW_SIZE];
+    std::copy_n(samples, count, sorted);
+    qint64* end = sorted + count;
+
+    qint64* p50 = sorted + (count - 1) / 2;
+    std::nth_element(sorted, p50, end);
+    result.p50Ms = toMs(*p50);
+
+    qint64* p99 = sorted + (count - 1) * 99 / 100;
+    std::nth_element(sorted, p99, end);
+    result.p99Ms = toMs(*p99);
+
+    result.maxMs = toMs(*std::max_element(p99, end));
+    return result;
+}
+
+FrameProfiler::FrameProfiler()
+    : m_enabled(true)
+    , m_budgetMs(0.0)
+    , m_inTick(false)
+    , m_tick(0)
+    , m_current{}
+    , m_hitchCount(0)
+{
+}
+
+void FrameProfiler::beginTick(qint64 tick)
+{
+    if (!m_enabled) {
+        return;
+    }
+
+    m_inTick = true;
+    m_tick = tick;
+    std::fill(std::begin(m_current), std::end(m_current), 0);
+    m_tickTimer.start();
+}
+
+void FrameProfiler::endTick()
+{
+    if (!m_inTick) {
+        return;
+    }
+    m_inTick = false;
+
+    const qint64 total = m_tickTimer.nsecsElapsed();
+    m_tickWindow.push(total);
+
+    // 绘制不在逻辑帧内，它的样本在add()里直接进窗口
+    for (int i = 0; i < PhaseCount; ++i) {
+        if (i != Paint) {
+            m_windows[i].push(m_current[i]);
+        }
+    }
+
+    if (m_budgetMs <= 0.0 || toMs(total) <= m_budgetMs) {
+        return;
+    }
+
+    Hitch hitch;
+    hitch.tick = m_tick;
+    hitch.totalMs = toMs(total);
+    for (int i = 0; i < PhaseCount; ++i) {
+        hitch.phaseMs[i] = toMs(m_current[i]);
+    }
+    if (m_entityCounter) {
+        hitch.counts = m_entityCounter();
+    }
+
+    if (m_hitches.size() >= MAX_HITCHES) {
+        m_hitches.removeFirst();
+    }
+    m_hitches.append(hitch);
+    m_hitchCount++;
+}
+
+void FrameProfiler::add(Phase phase, qint64 nsecs)
+{
+    if (m_inTick) {
+        m_current[phase] += nsecs;
+    } else {
+        m_windows[phase].push(nsecs);
+    }
+}
+
+FrameProfiler::PhaseStats FrameProfiler::phaseStats(Phase phase) const
+{
+    return m_windows[phase].stats();
+}
+
+FrameProfiler::PhaseStats FrameProfiler::tickStats() const
+{
+    return m_tickWindow.stats();
+}
+
+const char* FrameProfiler::phaseName(Phase phase)
+{
+    return phase < PhaseCount ? kPhaseNames[phase] : "?";
+}
+
+const char* FrameProfiler::traceName(Phase phase)
+{
+    return phase < PhaseCount ? kTraceNames[phase] : "?";
+}
+
+void FrameProfiler::reset()
+{
+    m_inTick = false;
+    for (Window& window : m_windows) {
+        window = Window();
+    }
+    m_tickWindow = Window();
+    m_hitches.clear();
+    m_hitchCount = 0;
+}
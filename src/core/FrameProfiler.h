@@ -0,0 +1,149 @@
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <QElapsedTimer>
+#include <QVector>
+#include <QtGlobal>
+#include <functional>
+#include "ChromeTrace.h"
+
+// 按阶段统计逻辑帧耗时：取代checkCollisionsOptimized里每60帧打一次日志的做法
+// - 每个阶段用PROFILE_SCOPE计时，同一帧内多次进入的阶段累加
+// - 帧结束时把各阶段耗时推进滚动窗口，随时可以取p50/p99
+// - 整帧超出预算时自动抓一份快照（各阶段耗时 + 实体数），保留最近的若干份
+// 只在主线程使用；帧之外的计时（例如绘制）直接作为一个样本进入窗口
+// 录制Chrome时间线时，每个计时段同时记为一个span（见ChromeTrace.h）
+class FrameProfiler
+{
+public:
+    enum Phase {
+        Movement,        // 球的移动/衰减/寿命
+        Broadphase,      // 空间索引（四叉树/网格）重新定位
+        Collisions,      // 碰撞检测与应用
+        SporeCollisions, // 孢子的批量吞噬
+        Merging,         // 同玩家分身合并
+        Removal,         // 帧末事件分派、注销与回收、过期食物清理
+        Spawning,        // 食物/荆棘补充
+        AI,              // AI决策
+        Paint,           // 视图绘制（不在逻辑帧内）
+        PhaseCount
+    };
+
+    // 抓快照时记录的实体数
+    struct EntityCounts {
+        int clones = 0;
+        int foods = 0;
+        int spores = 0;
+        int thorns = 0;
+        int aiPlayers = 0;
+    };
+
+    // 超出预算的一帧
+    struct Hitch {
+        qint64 tick = 0;
+        double totalMs = 0.0;
+        double phaseMs[PhaseCount] = {};
+        EntityCounts counts;
+    };
+
+    struct PhaseStats {
+        double p50Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        int samples = 0;
+    };
+
+    // RAII计时，析构时计入对应阶段
+    class Scope
+    {
+    public:
+        Scope(FrameProfiler* profiler, Phase phase)
+            : m_profiler(profiler), m_phase(phase), m_span(traceName(phase), "phase")
+        {
+            if (m_profiler && m_profiler->isEnabled()) {
+                m_timer.start();
+            }
+        }
+        ~Scope()
+        {
+            if (m_timer.isValid()) {
+                m_profiler->add(m_phase, m_timer.nsecsElapsed());
+            }
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameProfiler* m_profiler;
+        Phase m_phase;
+        QElapsedTimer m_timer;
+        ChromeTrace::Span m_span;
+    };
+
+    static constexpr int WINDOW_SIZE = 256;  // 每个阶段保留最近这么多个样本
+    static constexpr int MAX_HITCHES = 32;   // 最多保留的超预算快照
+
+    FrameProfiler();
+
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    bool isEnabled() const { return m_enabled; }
+
+    // 整帧预算（毫秒），<=0时不抓快照
+    void setBudgetMs(double budgetMs) { m_budgetMs = budgetMs; }
+    double budgetMs() const { return m_budgetMs; }
+
+    // 只在真的超出预算时调用，用来填快照里的实体数
+    void setEntityCounter(std::function<EntityCounts()> counter) { m_entityCounter = std::move(counter); }
+
+    // TickScheduler在每个逻辑帧前后调用
+    void beginTick(qint64 tick);
+    void endTick();
+
+    // 帧内累加到当前帧，帧外直接成为一个样本
+    void add(Phase phase, qint64 nsecs);
+
+    PhaseStats phaseStats(Phase phase) const;
+    PhaseStats tickStats() const; // 整帧耗时
+    static const char* phaseName(Phase phase);
+    static const char* traceName(Phase phase); // 时间线里的span名（ASCII）
+
+    const QVector<Hitch>& hitches() const { return m_hitches; } // 从旧到新
+    qint64 hitchCount() const { return m_hitchCount; }          // 累计次数（含已丢弃的）
+
+    void reset();
+
+private:
+    // 定长滚动窗口（纳秒）
+    struct Window {
+        qint64 samples[WINDOW_SIZE] = {};
+        int next = 0;
+        int count = 0;
+
+        void push(qint64 nsecs);
+        PhaseStats stats() const;
+    };
+
+    bool m_enabled;
+    double m_budgetMs;
+    std::function<EntityCounts()> m_entityCounter;
+
+    bool m_inTick;
+    qint64 m_tick;
+    QElapsedTimer m_tickTimer;
+    qint64 m_current[PhaseCount];
+
+    Window m_windows[PhaseCount];
+    Window m_tickWindow;
+
+    QVector<Hitch> m_hitches;
+    qint64 m_hitchCount;
+};
+
+#define FRAME_PROFILER_CONCAT_(a, b) a##b
+#define FRAME_PROFILER_CONCAT(a, b) FRAME_PROFILER_CONCAT_(a, b)
+
+// 用法：PROFILE_SCOPE(m_profiler, Collisions); 计时到所在作用域结束
+#define PROFILE_SCOPE(profiler, phase) \
+    FrameProfiler::Scope FRAME_PROFILER_CONCAT(profileScope_, __LINE__)((profiler), FrameProfiler::phase)
+
+#endif // FRAMEPROFILER_H
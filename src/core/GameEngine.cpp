@@ -0,0 +1,337 @@
+#include "GameEngine.h"
+#include "CloneBall.h"
+#include "FoodBall.h"
+#include "SporeBall.h"
+#include "ThornsBall.h"
+#include "GoBiggerConfig.h"
+#include <QDebug>
+#include <algorithm>
+
+GameEngine::GameEngine(const Config& config)
+    : m_config(config)
+    , m_gameOver(false)
+{
+    // 引擎只支持手动驱动，强制关闭GameManager内部定时器
+    m_config.gameConfig.manualTick = true;
+    m_gameManager = std::make_unique<GameManager>(nullptr, m_config.gameConfig);
+    connectWorld();
+
+    reset();
+}
+
+GameEngine::GameEngine(const Config& config, std::unique_ptr<GameManager> world)
+    : m_config(config)
+    , m_gameManager(std::move(world))
+    , m_gameOver(false)
+{
+    m_config.gameConfig = m_gameManager->config();
+    connectWorld();
+}
+
+GameEngine::~GameEngine() = default;
+
+void GameEngine::connectWorld()
+{
+    // 队伍只剩一支时GameManager会发出gameOver（单队伍对局只按帧数结束）
+    QObject::connect(m_gameManager.get(), &GameManager::gameOver, m_gameManager.get(), [this](int) {
+        if (m_config.teamNum > 1) {
+            m_gameOver = true;
+        }
+    });
+}
+
+void GameEngine::reset(quint64 seed)
+{
+    m_gameManager->resetGame(seed);
+    m_gameOver = false;
+
+    // 先创建玩家，让初始荆棘避开出生点
+    for (int teamId = 0; teamId < m_config.teamNum; ++teamId) {
+        for (int i = 0; i < m_config.playerNumPerTeam; ++i) {
+            m_gameManager->createPlayer(teamId, teamId * m_config.playerNumPerTeam + i);
+        }
+    }
+
+    m_gameManager->startGame();
+}
+
+bool GameEngine::restore(const WorldSnapshot& snapshot)
+{
+    if (!m_gameManager->restore(snapshot)) {
+        return false;
+    }
+    // 剩一支队伍的话下一帧会重新发出gameOver
+    m_gameOver = false;
+    return true;
+}
+
+std::unique_ptr<GameEngine> GameEngine::fork() const
+{
+    std::unique_ptr<GameManager> world = m_gameManager->fork();
+    if (!world) {
+        return nullptr;
+    }
+    std::unique_ptr<GameEngine> engine(new GameEngine(m_config, std::move(world)));
+    engine->m_gameOver = m_gameOver;
+    return engine;
+}
+
+void GameEngine::step(const Action& action)
+{
+    QMap<int, Action> actions;
+    actions.insert(0, action);
+    step(actions);
+}
+
+void GameEngine::step(const QMap<int, Action>& actions)
+{
+    if (isDone()) {
+        return;
+    }
+
+    for (auto it = actions.constBegin(); it != actions.constEnd(); ++it) {
+        applyAction(it.key(), it.value());
+    }
+
+    tick();
+}
+
+void GameEngine::applyAction(int playerId, const Action& action)
+{
+    // 解析动作：方向裁剪到[-1, 1]，动作类型裁剪到[0, 2]
+    QVector2D direction(qBound(-1.0f, action.direction_x, 1.0f),
+                        qBound(-1.0f, action.direction_y, 1.0f));
+    int actionType = qBound(0, action.action_type, 2);
+
+    // 拷贝一份：分裂会向玩家列表追加新球
+    const QVector<CloneBall*> balls = playerBalls(playerId);
+    for (CloneBall* ball : balls) {
+        if (!ball || ball->isRemoved()) continue;
+
+        // 与GameView::processInput一致：GoBigger风格加速度 + 更新移动方向
+        ball->applyGoBiggerMovement(direction, QVector2D(0, 0));
+        ball->setMoveDirection(direction);
+
+        QVector2D actionDir = direction.length() > 0.01f ? direction.normalized() : QVector2D(1, 0);
+        if (actionType == 1 && ball->canEject()) {
+            ball->ejectSpore(actionDir);
+        } else if (actionType == 2 && ball->canSplit()) {
+            ball->performSplit(actionDir);
+        }
+    }
+}
+
+void GameEngine::tick()
+{
+    // 阶段顺序由GameManager的帧调度器统一定义，与界面模式完全一致
+    m_gameManager->tick();
+}
+
+bool GameEngine::isDone() const
+{
+    return m_gameOver || m_gameManager->frameCount() >= m_config.totalFrames;
+}
+
+QVector<int> GameEngine::playerIds() const
+{
+    QVector<int> ids;
+    for (int teamId = 0; teamId < m_config.teamNum; ++teamId) {
+        for (int i = 0; i < m_config.playerNumPerTeam; ++i) {
+            ids.append(teamId * m_config.playerNumPerTeam + i);
+        }
+    }
+    return ids;
+}
+
+float GameEngine::playerScore(int playerId) const
+{
+    float score = 0.0f;
+    for (CloneBall* ball : playerBalls(playerId)) {
+        score += ball->score();
+    }
+    return score;
+}
+
+QVector<CloneBall*> GameEngine::playerBalls(int playerId) const
+{
+    return m_gameManager->getPlayerBalls(teamOf(playerId), playerId);
+}
+
+QRectF GameEngine::playerViewRect(const QVector<CloneBall*>& balls) const
+{
+    if (balls.isEmpty()) {
+        return QRectF();
+    }
+
+    // 所有分身球的包围盒
+    qreal minX = balls.first()->position().x(), maxX = minX;
+    qreal minY = balls.first()->position().y(), maxY = minY;
+    for (CloneBall* ball : balls) {
+        QPointF p = ball->position();
+        qreal r = ball->radius();
+        minX = std::min(minX, p.x() - r);
+        maxX = std::max(maxX, p.x() + r);
+        minY = std::min(minY, p.y() - r);
+        maxY = std::max(maxY, p.y() + r);
+    }
+
+    // 视野为正方形，随体型放大，但不小于最小视野
+    qreal size = std::max(m_config.minViewSize, std::max(maxX - minX, maxY - minY) * m_config.viewScale);
+    QPointF center((minX + maxX) / 2.0, (minY + maxY) / 2.0);
+    return QRectF(center.x() - size / 2.0, center.y() - size / 2.0, size, size);
+}
+
+GameEngine::Observation GameEngine::getObservation() const
+{
+    Observation obs;
+
+    // 全局状态
+    const Border& border = m_gameManager->config().gameBorder;
+    obs.global_state.border = { static_cast<float>(border.maxx - border.minx),
+                                static_cast<float>(border.maxy - border.miny) };
+    obs.global_state.total_frame = m_config.totalFrames;
+    obs.global_state.last_frame_count = frameCount();
+    obs.global_state.leaderboard = m_gameManager->getAllTeamScores();
+
+    // 玩家状态
+    for (int playerId : playerIds()) {
+        PlayerState state;
+        QVector<CloneBall*> balls = playerBalls(playerId);
+
+        for (CloneBall* ball : balls) {
+            state.score += ball->score();
+            state.can_eject = state.can_eject || ball->canEject();
+            state.can_split = state.can_split || ball->canSplit();
+        }
+
+        QRectF view = playerViewRect(balls);
+        if (!balls.isEmpty()) {
+            state.rectangle = { static_cast<float>(view.left()), static_cast<float>(view.top()),
+                                static_cast<float>(view.right()), static_cast<float>(view.bottom()) };
+
+            for (BaseBall* ball : m_gameManager->getBallsInRect(view)) {
+                const float x = ball->position().x();
+                const float y = ball->position().y();
+                const float r = ball->radius();
+                const float s = ball->score();
+                const QVector2D v = ball->velocity();
+
+                switch (ball->ballType()) {
+                    case BaseBall::FOOD_BALL:
+                        state.overlap.food.append({ x, y, r, s });
+                        break;
+                    case BaseBall::THORNS_BALL:
+                        state.overlap.thorns.append({ x, y, r, s, v.x(), v.y() });
+                        break;
+                    case BaseBall::SPORE_BALL:
+                        state.overlap.spore.append({ x, y, r, s, v.x(), v.y() });
+                        break;
+                    case BaseBall::CLONE_BALL: {
+                        CloneBall* clone = static_cast<CloneBall*>(ball);
+                        QVector2D dir = v.length() > 0.01f ? v.normalized() : QVector2D(0, 0);
+                        state.overlap.clone.append({ x, y, r, s, v.x(), v.y(), dir.x(), dir.y(),
+                                                     static_cast<float>(clone->teamId()),
+                                                     static_cast<float>(clone->playerId()) });
+                        break;
+                    }
+                }
+            }
+        }
+
+        obs.player_states.insert(playerId, state);
+    }
+
+    return obs;
+}
+
+void GameEngine::writeObservation(int playerId, const FlatLayout& layout, float* out) const
+{
+    std::fill(out, out + layout.playerSize(), 0.0f);
+
+    const QVector<CloneBall*> balls = playerBalls(playerId);
+    if (balls.isEmpty()) {
+        return;
+    }
+
+    const QRectF view = playerViewRect(balls);
+    float* header = out;
+    header[0] = static_cast<float>(view.left());
+    header[1] = static_cast<float>(view.top());
+    header[2] = static_cast<float>(view.right());
+    header[3] = static_cast<float>(view.bottom());
+    for (CloneBall* ball : balls) {
+        header[4] += ball->score();
+        header[5] = (header[5] != 0.0f || ball->canEject()) ? 1.0f : 0.0f;
+        header[6] = (header[6] != 0.0f || ball->canSplit()) ? 1.0f : 0.0f;
+    }
+
+    // 按类型分开（下标即BaseBall::BallType），超出上限时只留离视野中心最近的
+    QVector<BaseBall*> byType[4];
+    for (BaseBall* ball : m_gameManager->getBallsInRect(view)) {
+        byType[ball->ballType()].append(ball);
+    }
+    const QPointF center = view.center();
+    auto keepNearest = [&center](QVector<BaseBall*>& list, int limit) {
+        limit = std::max(0, limit);
+        if (list.size() <= limit) {
+            return;
+        }
+        auto distance = [&center](const BaseBall* ball) {
+            const QPointF d = ball->position() - center;
+            return d.x() * d.x() + d.y() * d.y();
+        };
+        std::nth_element(list.begin(), list.begin() + limit, list.end(),
+                         [&distance](const BaseBall* a, const BaseBall* b) { return distance(a) < distance(b); });
+        list.resize(limit);
+    };
+    keepNearest(byType[BaseBall::FOOD_BALL], layout.maxFood);
+    keepNearest(byType[BaseBall::THORNS_BALL], layout.maxThorns);
+    keepNearest(byType[BaseBall::SPORE_BALL], layout.maxSpore);
+    keepNearest(byType[BaseBall::CLONE_BALL], layout.maxClone);
+
+    header[7] = byType[BaseBall::FOOD_BALL].size();
+    header[8] = byType[BaseBall::THORNS_BALL].size();
+    header[9] = byType[BaseBall::SPORE_BALL].size();
+    header[10] = byType[BaseBall::CLONE_BALL].size();
+
+    // 字段顺序与getObservation()的Overlap一致
+    float* food = out + FlatLayout::kHeaderSize;
+    for (BaseBall* ball : byType[BaseBall::FOOD_BALL]) {
+        *food++ = ball->position().x();
+        *food++ = ball->position().y();
+        *food++ = ball->radius();
+        *food++ = ball->score();
+    }
+
+    auto writeMoving = [](const QVector<BaseBall*>& list, float* p) {
+        for (BaseBall* ball : list) {
+            const QVector2D v = ball->velocity();
+            *p++ = ball->position().x();
+            *p++ = ball->position().y();
+            *p++ = ball->radius();
+            *p++ = ball->score();
+            *p++ = v.x();
+            *p++ = v.y();
+        }
+    };
+    float* thorns = out + FlatLayout::kHeaderSize + layout.maxFood * 4;
+    writeMoving(byType[BaseBall::THORNS_BALL], thorns);
+    writeMoving(byType[BaseBall::SPORE_BALL], thorns + layout.maxThorns * 6);
+
+    float* clone = out + FlatLayout::kHeaderSize + layout.maxFood * 4 + (layout.maxThorns + layout.maxSpore) * 6;
+    for (BaseBall* ball : byType[BaseBall::CLONE_BALL]) {
+        CloneBall* other = static_cast<CloneBall*>(ball);
+        const QVector2D v = other->velocity();
+        const QVector2D dir = v.length() > 0.01f ? v.normalized() : QVector2D(0, 0);
+        *clone++ = other->position().x();
+        *clone++ = other->position().y();
+        *clone++ = other->radius();
+        *clone++ = other->score();
+        *clone++ = v.x();
+        *clone++ = v.y();
+        *clone++ = dir.x();
+        *clone++ = dir.y();
+        *clone++ = static_cast<float>(other->teamId());
+        *clone++ = static_cast<float>(other->playerId());
+    }
+}
@@ -0,0 +1,125 @@
+#ifndef GAMEENGINE_H
+#define GAMEENGINE_H
+
+#include <QVector>
+#include <QMap>
+#include <QRectF>
+#include <memory>
+#include "GameManager.h"
+
+class CloneBall;
+
+// 无头游戏引擎 - 强化学习环境接口
+// 不依赖QTimer和QGraphicsScene，每次step()固定推进一帧，调用方决定运行速度
+class GameEngine
+{
+public:
+    // 动作格式: [direction_x, direction_y, action_type]
+    struct Action {
+        float direction_x = 0.0f;   // [-1, 1]
+        float direction_y = 0.0f;   // [-1, 1]
+        int action_type = 0;        // 0: 无动作, 1: 吐球, 2: 分裂
+
+        Action() = default;
+        Action(float dx, float dy, int type) : direction_x(dx), direction_y(dy), action_type(type) {}
+    };
+
+    // 视野内对象（每个对象为一个float列表，字段顺序见getObservation()）
+    struct Overlap {
+        QVector<QVector<float>> food;    // [x, y, radius, score]
+        QVector<QVector<float>> thorns;  // [x, y, radius, score, vx, vy]
+        QVector<QVector<float>> spore;   // [x, y, radius, score, vx, vy]
+        QVector<QVector<float>> clone;   // [x, y, radius, score, vx, vy, dir_x, dir_y, team_id, player_id]
+    };
+
+    struct PlayerState {
+        QVector<float> rectangle;        // [x_min, y_min, x_max, y_max]
+        Overlap overlap;
+        float score = 0.0f;
+        bool can_eject = false;
+        bool can_split = false;
+    };
+
+    struct GlobalState {
+        QVector<float> border;           // [map_width, map_height]
+        int total_frame = 0;
+        int last_frame_count = 0;
+        QMap<int, float> leaderboard;    // 队伍ID -> 分数
+    };
+
+    struct Observation {
+        GlobalState global_state;
+        QMap<int, PlayerState> player_states; // player_id -> 状态
+    };
+
+    // 🔥 定长扁平观察（BatchEngine把所有环境写进同一块缓冲区），每个玩家占playerSize()个float：
+    //   [x_min, y_min, x_max, y_max, score, can_eject, can_split, food数, thorns数, spore数, clone数]
+    //   然后依次是maxFood/maxThorns/maxSpore/maxClone个对象，字段同Overlap；超出上限时保留离视野中心近的，不足补0
+    struct FlatLayout {
+        static constexpr int kHeaderSize = 11;
+        int maxFood = 64;
+        int maxThorns = 8;
+        int maxSpore = 16;
+        int maxClone = 16;
+
+        int playerSize() const { return kHeaderSize + maxFood * 4 + (maxThorns + maxSpore) * 6 + maxClone * 10; }
+    };
+
+    struct Config {
+        GameManager::Config gameConfig;
+        int teamNum = 2;                 // 队伍数量
+        int playerNumPerTeam = 1;        // 每队玩家数量，player_id = teamId * playerNumPerTeam + i
+        int totalFrames = 3600 * GoBiggerConfig::SIM_FPS / 20; // 一局总帧数（GoBigger默认3600帧@20fps）
+        qreal minViewSize = 360.0;       // 视野最小边长
+        qreal viewScale = 2.0;           // 视野相对玩家球包围盒的放大倍数
+
+        Config() {
+            gameConfig.manualTick = true;
+            gameConfig.gameBorder = Border(-3000, 3000, -3000, 3000); // 与GameView一致的6000x6000地图
+        }
+    };
+
+    explicit GameEngine(const Config& config = Config());
+    ~GameEngine();
+
+    // 强化学习环境接口
+    void reset(quint64 seed = 0);                    // seed见GameManager::resetGame
+    void step(const Action& action);                 // 单智能体：控制player 0
+    void step(const QMap<int, Action>& actions);     // 多智能体：player_id -> 动作
+    Observation getObservation() const;
+    void writeObservation(int playerId, const FlatLayout& layout, float* out) const;
+    bool isDone() const;
+
+    // 🔥 世界快照（见GameManager::snapshot）：RL重置到同一个局面、搜索式AI展开、A/B实验
+    // fork()得到一个独立的引擎，从当前状态接着跑，互不影响
+    WorldSnapshot snapshot() const { return m_gameManager->snapshot(); }
+    bool restore(const WorldSnapshot& snapshot);
+    std::unique_ptr<GameEngine> fork() const;
+
+    // 状态访问
+    int frameCount() const { return static_cast<int>(m_gameManager->frameCount()); }
+    const Config& config() const { return m_config; }
+    GameManager* gameManager() const { return m_gameManager.get(); }
+    QVector<int> playerIds() const;
+    float playerScore(int playerId) const;           // 该玩家所有分身球的分数之和
+
+private:
+    Config m_config;
+    std::unique_ptr<GameManager> m_gameManager;
+    bool m_gameOver;
+
+    // fork()用：接管一个已经恢复好的世界，不reset
+    GameEngine(const Config& config, std::unique_ptr<GameManager> world);
+    void connectWorld();
+
+    // 单帧的各个阶段
+    void applyAction(int playerId, const Action& action);
+    void tick();
+
+    // 观察辅助
+    QVector<CloneBall*> playerBalls(int playerId) const;
+    QRectF playerViewRect(const QVector<CloneBall*>& balls) const;
+    int teamOf(int playerId) const { return playerId / qMax(1, m_config.playerNumPerTeam); }
+};
+
+#endif // GAMEENGINE_H
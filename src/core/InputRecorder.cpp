@@ -0,0 +1,225 @@
+#include "InputRecorder.h"
+#include "InputReplay.h"
+#include "GameManager.h"
+#include <QDebug>
+
+using namespace ReplayFormat;
+
+namespace {
+    // 攒够这么多字节写一次文件
+    constexpr int kFlushBytes = 64 * 1024;
+}
+
+InputRecorder::InputRecorder()
+    : m_recording(false)
+    , m_bytesWritten(0)
+    , m_tick(0)
+    , m_writtenTick(0)
+    , m_lastBallId(0)
+{
+}
+
+InputRecorder::~InputRecorder()
+{
+    stop();
+}
+
+bool InputRecorder::start(const QString& path, const GameManager& world)
+{
+    stop();
+
+    if (world.isGameRunning() || world.frameCount() != 0 || !world.getAllBalls().isEmpty()) {
+        qWarning() << "InputRecorder: recording must start before the match begins";
+        return false;
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "InputRecorder: cannot open" << path;
+        return false;
+    }
+
+    m_buffer.clear();
+    m_buffer.append(kMagic, sizeof(kMagic));
+    writeVarint(m_buffer, kVersion);
+    writeVarint(m_buffer, world.randomSeed());
+    writeConfig(m_buffer, world.config());
+
+    m_bytesWritten = 0;
+    m_tick = 0;
+    m_writtenTick = 0;
+    m_lastBallId = 0;
+    m_history.clear();
+    m_recording = true;
+    return true;
+}
+
+bool InputRecorder::stop()
+{
+    if (!m_recording) {
+        return false;
+    }
+
+    writeTick();
+    writeOp(OpEnd);
+    flush(true);
+    m_file.close();
+    m_recording = false;
+    return true;
+}
+
+void InputRecorder::recordJoin(int teamId, int playerId, const QPointF& position)
+{
+    if (!m_recording) return;
+
+    writeOp(OpJoin);
+    writeSigned(m_buffer, teamId);
+    writeSigned(m_buffer, playerId);
+    // 原样保存：createPlayer对空位置会随机取点，重放时也要走同一条路
+    const bool hasPosition = !position.isNull();
+    m_buffer += static_cast<char>(hasPosition ? 1 : 0);
+    if (hasPosition) {
+        writeDouble(m_buffer, position.x());
+        writeDouble(m_buffer, position.y());
+    }
+}
+
+void InputRecorder::recordStart()
+{
+    if (m_recording) writeOp(OpStart);
+}
+
+void InputRecorder::recordPause()
+{
+    if (m_recording) writeOp(OpPause);
+}
+
+void InputRecorder::recordReset(quint64 seed)
+{
+    if (!m_recording) return;
+
+    writeOp(OpReset);
+    writeVarint(m_buffer, seed);
+    // 重置后帧数从0重新开始
+    m_tick = 0;
+    m_writtenTick = 0;
+}
+
+void InputRecorder::recordScore(int ballId, float score)
+{
+    if (!m_recording) return;
+
+    writeOp(OpScore);
+    writeSigned(m_buffer, ballId);
+    writeDouble(m_buffer, score);
+}
+
+QVector2D InputRecorder::recordMove(int ballId, const QVector2D& direction)
+{
+    if (!m_recording) return direction;
+
+    const qint32 x = quantize(direction.x());
+    const qint32 y = quantize(direction.y());
+    writeAction(Move, ballId, x, y);
+    return QVector2D(dequantize(x), dequantize(y));
+}
+
+QVector2D InputRecorder::recordSplit(int ballId, const QVector2D& direction)
+{
+    if (!m_recording) return direction;
+
+    const qint32 x = quantize(direction.x());
+    const qint32 y = quantize(direction.y());
+    writeAction(Split, ballId, x, y);
+    return QVector2D(dequantize(x), dequantize(y));
+}
+
+QVector2D InputRecorder::recordEject(int ballId, const QVector2D& direction)
+{
+    if (!m_recording) return direction;
+
+    const qint32 x = quantize(direction.x());
+    const qint32 y = quantize(direction.y());
+    writeAction(Eject, ballId, x, y);
+    return QVector2D(dequantize(x), dequantize(y));
+}
+
+void InputRecorder::recordSteer(int ballId, QVector2D& playerInput, QVector2D& centerForce)
+{
+    if (!m_recording) return;
+
+    const qint32 x = quantize(playerInput.x());
+    const qint32 y = quantize(playerInput.y());
+    const qint32 center[2] = { quantize(centerForce.x()), quantize(centerForce.y()) };
+    writeAction(Steer, ballId, x, y, center);
+    playerInput = QVector2D(dequantize(x), dequantize(y));
+    centerForce = QVector2D(dequantize(center[0]), dequantize(center[1]));
+}
+
+void InputRecorder::writeTick()
+{
+    const qint64 delta = m_tick - m_writtenTick;
+    if (delta <= 0) {
+        return;
+    }
+
+    if (delta == 1) {
+        m_buffer += static_cast<char>(OpNextTick);
+    } else {
+        m_buffer += static_cast<char>(OpTick);
+        writeVarint(m_buffer, static_cast<quint64>(delta));
+    }
+    m_writtenTick = m_tick;
+}
+
+void InputRecorder::writeOp(Op op)
+{
+    writeTick();
+    m_buffer += static_cast<char>(op);
+    flush(false);
+}
+
+void InputRecorder::writeAction(ActionKind kind, int ballId, qint32 x, qint32 y, const qint32* center)
+{
+    writeTick();
+
+    BallVectors& last = m_history[ballId];
+    quint8 op = OpAction | kind;
+    if (ballId == m_lastBallId) op |= kSameBall;
+    if (x == last.x && y == last.y) op |= kSameVector;
+    if (center && center[0] == last.centerX && center[1] == last.centerY) op |= kSameCenter;
+    m_buffer += static_cast<char>(op);
+
+    if (!(op & kSameBall)) {
+        writeSigned(m_buffer, static_cast<qint64>(ballId) - m_lastBallId);
+        m_lastBallId = ballId;
+    }
+    if (!(op & kSameVector)) {
+        writeSigned(m_buffer, static_cast<qint64>(x) - last.x);
+        writeSigned(m_buffer, static_cast<qint64>(y) - last.y);
+        last.x = x;
+        last.y = y;
+    }
+    if (center && !(op & kSameCenter)) {
+        writeSigned(m_buffer, static_cast<qint64>(center[0]) - last.centerX);
+        writeSigned(m_buffer, static_cast<qint64>(center[1]) - last.centerY);
+        last.centerX = center[0];
+        last.centerY = center[1];
+    }
+
+    flush(false);
+}
+
+void InputRecorder::flush(bool force)
+{
+    if (m_buffer.isEmpty() || (!force && m_buffer.size() < kFlushBytes)) {
+        return;
+    }
+
+    m_file.write(m_buffer);
+    m_bytesWritten += m_buffer.size();
+    m_buffer.clear();
+    if (force) {
+        m_file.flush();
+    }
+}
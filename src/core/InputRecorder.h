@@ -0,0 +1,68 @@
+#ifndef INPUTRECORDER_H
+#define INPUTRECORDER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QPointF>
+#include <QString>
+#include <QVector2D>
+#include "ReplayFormat.h"
+
+class GameManager;
+
+// 把一局录成紧凑的输入录像：文件头是配置和种子，之后是逐帧的玩家操作
+// - 玩家操作在CloneBall的入口处记录（setMoveDirection/applyGoBiggerMovement/performSplit/ejectSpore），
+//   人类玩家、AI、GameEngine的动作都经过这里
+// - 加入玩家、开始/暂停/重置也记下来，重放时按同样的顺序调用，随机数和球ID的消耗才一致
+// - 变长整数 + 差分编码，几个玩家一分钟通常只有几KB
+// 重放见InputReplay.h；格式见ReplayFormat.h
+// 只在模拟线程使用；没在录制时各record*只做一次判断
+class InputRecorder
+{
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    // 开始录制world这一局；world必须还没开始（没有球、帧数为0），否则返回false
+    bool start(const QString& path, const GameManager& world);
+    // 写入结束标记并关闭文件；没在录制时返回false
+    bool stop();
+    bool isRecording() const { return m_recording; }
+    QString outputPath() const { return m_file.fileName(); }
+    qint64 bytesWritten() const { return m_bytesWritten + m_buffer.size(); }
+
+    // GameManager每推进一帧调用一次，之后的操作都记在这一帧
+    void setTick(qint64 tick) { m_tick = tick; }
+
+    void recordJoin(int teamId, int playerId, const QPointF& position);
+    void recordStart();
+    void recordPause();
+    void recordReset(quint64 seed);
+    void recordScore(int ballId, float score);
+
+    // 球操作：返回量化后的向量，调用方必须用它代替原值，录制与重放才逐位一致
+    QVector2D recordMove(int ballId, const QVector2D& direction);
+    QVector2D recordSplit(int ballId, const QVector2D& direction);
+    QVector2D recordEject(int ballId, const QVector2D& direction);
+    // Steer有两个向量，原地量化
+    void recordSteer(int ballId, QVector2D& playerInput, QVector2D& centerForce);
+
+private:
+    void writeTick();
+    void writeOp(ReplayFormat::Op op);
+    void writeAction(ReplayFormat::ActionKind kind, int ballId, qint32 x, qint32 y,
+                     const qint32* center = nullptr);
+    void flush(bool force);
+
+    bool m_recording;
+    QFile m_file;
+    QByteArray m_buffer;
+    qint64 m_bytesWritten;
+
+    qint64 m_tick;           // 当前帧
+    qint64 m_writtenTick;    // 事件流已经推进到的帧
+    int m_lastBallId;
+    ReplayFormat::VectorHistory m_history;
+};
+
+#endif // INPUTRECORDER_H
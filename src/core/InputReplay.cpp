@@ -0,0 +1,352 @@
+#include "InputReplay.h"
+#include "CloneBall.h"
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <type_traits>
+
+using namespace ReplayFormat;
+
+namespace ReplayFormat {
+
+void writeConfig(QByteArray& out, const GameManager::Config& config)
+{
+    QByteArray block;
+    writeDouble(block, config.gameBorder.minx);
+    writeDouble(block, config.gameBorder.maxx);
+    writeDouble(block, config.gameBorder.miny);
+    writeDouble(block, config.gameBorder.maxy);
+    writeSigned(block, config.maxFoodCount);
+    writeSigned(block, config.initFoodCount);
+    writeSigned(block, config.foodRefreshFrames);
+    writeDouble(block, config.foodRefreshPercent);
+    writeDouble(block, config.foodScoreMin);
+    writeDouble(block, config.foodScoreMax);
+    writeSigned(block, config.foodCleanupIntervalMs);
+    writeSigned(block, config.foodMaxAgeMs);
+    writeSigned(block, config.foodCleanupBatchSize);
+    writeSigned(block, config.initThornsCount);
+    writeSigned(block, config.maxThornsCount);
+    writeSigned(block, config.thornsRefreshFrames);
+    writeDouble(block, config.thornsRefreshPercent);
+    writeDouble(block, config.thornsScoreMin);
+    writeDouble(block, config.thornsScoreMax);
+    writeDouble(block, config.playerScoreInit);
+    writeDouble(block, config.playerSplitScoreMin);
+    writeDouble(block, config.playerEjectScoreMin);
+    writeDouble(block, config.tickDuration);
+    writeSigned(block, static_cast<int>(config.broadphaseType));
+    writeDouble(block, config.gridCellSize);
+    writeDouble(block, config.collisionCheckRadius);
+    writeDouble(block, config.eatRatioThreshold);
+    writeDouble(block, config.ccdTravelRatio);
+    writeSigned(block, config.dataReorderFrames);
+    writeSigned(block, config.ballPoolCapacity);
+
+    writeVarint(out, static_cast<quint64>(block.size()));
+    out += block;
+}
+
+bool readConfig(Reader& reader, GameManager::Config& config)
+{
+    const quint64 size = reader.varint();
+    if (!reader.ok() || size > 1024 * 1024) {
+        return false;
+    }
+    const QByteArray block = reader.bytes(static_cast<int>(size));
+    if (!reader.ok()) {
+        return false;
+    }
+
+    // 旧版本写的块可能更短：读到头就停，后面的字段保持默认值
+    Reader in(block);
+    auto readInt = [&in](int& field) { if (!in.atEnd()) field = static_cast<int>(in.signedVarint()); };
+    auto readReal = [&in](auto& field) { if (!in.atEnd()) field = static_cast<std::decay_t<decltype(field)>>(in.float64()); };
+
+    readReal(config.gameBorder.minx);
+    readReal(config.gameBorder.maxx);
+    readReal(config.gameBorder.miny);
+    readReal(config.gameBorder.maxy);
+    readInt(config.maxFoodCount);
+    readInt(config.initFoodCount);
+    readInt(config.foodRefreshFrames);
+    readReal(config.foodRefreshPercent);
+    readReal(config.foodScoreMin);
+    readReal(config.foodScoreMax);
+    readInt(config.foodCleanupIntervalMs);
+    readInt(config.foodMaxAgeMs);
+    readInt(config.foodCleanupBatchSize);
+    readInt(config.initThornsCount);
+    readInt(config.maxThornsCount);
+    readInt(config.thornsRefreshFrames);
+    readReal(config.thornsRefreshPercent);
+    readReal(config.thornsScoreMin);
+    readReal(config.thornsScoreMax);
+    readReal(config.playerScoreInit);
+    readReal(config.playerSplitScoreMin);
+    readReal(config.playerEjectScoreMin);
+    readReal(config.tickDuration);
+    int broadphase = static_cast<int>(config.broadphaseType);
+    readInt(broadphase);
+    config.broadphaseType = static_cast<BroadphaseType>(broadphase);
+    readReal(config.gridCellSize);
+    readReal(config.collisionCheckRadius);
+    readReal(config.eatRatioThreshold);
+    readReal(config.ccdTravelRatio);
+    readInt(config.dataReorderFrames);
+    readInt(config.ballPoolCapacity);
+    return in.ok();
+}
+
+} // namespace ReplayFormat
+
+namespace {
+    // 解出一个球操作；history/lastBallId与InputRecorder::writeAction对称地更新
+    struct DecodedAction {
+        ActionKind kind;
+        int ballId;
+        QVector2D vector;
+        QVector2D center;
+    };
+
+    bool decodeAction(Reader& reader, quint8 op, VectorHistory& history, int& lastBallId, DecodedAction& action)
+    {
+        action.kind = static_cast<ActionKind>(op & kKindMask);
+        if (action.kind >= ActionKindCount) {
+            return false;
+        }
+
+        if (!(op & kSameBall)) {
+            lastBallId = static_cast<int>(lastBallId + reader.signedVarint());
+        }
+        action.ballId = lastBallId;
+
+        BallVectors& last = history[action.ballId];
+        if (!(op & kSameVector)) {
+            last.x = static_cast<qint32>(last.x + reader.signedVarint());
+            last.y = static_cast<qint32>(last.y + reader.signedVarint());
+        }
+        action.vector = QVector2D(dequantize(last.x), dequantize(last.y));
+
+        if (action.kind == Steer) {
+            if (!(op & kSameCenter)) {
+                last.centerX = static_cast<qint32>(last.centerX + reader.signedVarint());
+                last.centerY = static_cast<qint32>(last.centerY + reader.signedVarint());
+            }
+            action.center = QVector2D(dequantize(last.centerX), dequantize(last.centerY));
+        }
+        return reader.ok();
+    }
+
+    void skipJoin(Reader& reader)
+    {
+        reader.signedVarint();
+        reader.signedVarint();
+        if (reader.byte()) {
+            reader.float64();
+            reader.float64();
+        }
+    }
+}
+
+InputReplay::InputReplay()
+    : m_eventsOffset(0)
+    , m_seed(0)
+    , m_tickCount(0)
+    , m_actionCount(0)
+{
+}
+
+bool InputReplay::open(const QString& path, QString* error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("cannot open %1").arg(path);
+        return false;
+    }
+    return load(file.readAll(), error);
+}
+
+bool InputReplay::load(const QByteArray& data, QString* error)
+{
+    auto fail = [error](const QString& message) {
+        if (error) *error = message;
+        return false;
+    };
+
+    m_data = data;
+    Reader reader(m_data);
+    if (reader.bytes(sizeof(kMagic)) != QByteArray(kMagic, sizeof(kMagic))) {
+        return fail("not a replay file");
+    }
+    const quint64 version = reader.varint();
+    if (version != kVersion) {
+        return fail(QString("unsupported replay version %1").arg(version));
+    }
+
+    m_seed = reader.varint();
+    m_config = GameManager::Config();
+    if (!readConfig(reader, m_config)) {
+        return fail("corrupt config block");
+    }
+    m_config.seed = m_seed;
+    m_config.manualTick = true;
+    m_config.interpolateRendering = false;
+    m_eventsOffset = reader.position();
+
+    // 先扫一遍：校验格式，顺便统计帧数和操作数
+    VectorHistory history;
+    int lastBallId = 0;
+    m_tickCount = 0;
+    m_actionCount = 0;
+    while (reader.ok() && !reader.atEnd()) {
+        const quint8 op = reader.byte();
+        if (op & OpAction) {
+            DecodedAction action;
+            if (!decodeAction(reader, op, history, lastBallId, action)) {
+                return fail(QString("corrupt action at byte %1").arg(reader.position()));
+            }
+            m_actionCount++;
+            continue;
+        }
+
+        switch (op) {
+        case OpTick: m_tickCount += static_cast<qint64>(reader.varint()); break;
+        case OpNextTick: m_tickCount++; break;
+        case OpJoin: skipJoin(reader); break;
+        case OpStart:
+        case OpPause: break;
+        case OpReset: reader.varint(); break;
+        case OpScore: reader.signedVarint(); reader.float64(); break;
+        case OpEnd: return reader.ok() || fail("truncated replay");
+        default: return fail(QString("unknown op 0x%1 at byte %2").arg(op, 2, 16, QChar('0')).arg(reader.position() - 1));
+        }
+    }
+    // 录制方异常退出时没有结束标记，已有的部分仍然可以重放
+    qWarning() << "InputReplay: replay has no end marker, playing what was recorded";
+    return reader.ok() || fail("truncated replay");
+}
+
+qint64 InputReplay::play(GameManager* world, const std::function<void(GameManager*)>& tick) const
+{
+    if (!world || m_data.isEmpty()) {
+        return 0;
+    }
+
+    Reader reader(m_data);
+    reader.bytes(m_eventsOffset);
+
+    qint64 targetTick = 0;
+    qint64 ticksRun = 0;
+    int missingBalls = 0;
+    auto advance = [&]() {
+        while (world->frameCount() < targetTick && world->isGameRunning()) {
+            if (tick) {
+                tick(world);
+            } else {
+                world->tick();
+            }
+            ticksRun++;
+        }
+    };
+
+    // 球ID -> 分身球；分身球只在帧末回收，帧号变了或者没找到时重建
+    QHash<int, CloneBall*> clones;
+    qint64 clonesFrame = -1;
+    auto findClone = [&](int ballId) -> CloneBall* {
+        CloneBall* ball = clonesFrame == world->frameCount() ? clones.value(ballId, nullptr) : nullptr;
+        if (!ball) {
+            clones.clear();
+            for (CloneBall* clone : world->registry().clones()) {
+                if (clone && !clone->isRemoved()) {
+                    clones.insert(clone->ballId(), clone);
+                }
+            }
+            clonesFrame = world->frameCount();
+            ball = clones.value(ballId, nullptr);
+        }
+        return ball && !ball->isRemoved() ? ball : nullptr;
+    };
+
+    VectorHistory history;
+    int lastBallId = 0;
+    while (reader.ok() && !reader.atEnd()) {
+        const quint8 op = reader.byte();
+        if (op & OpAction) {
+            DecodedAction action;
+            if (!decodeAction(reader, op, history, lastBallId, action)) {
+                break;
+            }
+            advance();
+
+            CloneBall* ball = findClone(action.ballId);
+            if (!ball) {
+                if (missingBalls++ == 0) {
+                    qWarning() << "InputReplay: ball" << action.ballId << "not found at frame" << world->frameCount()
+                               << "- the replay no longer matches the simulation";
+                }
+                continue;
+            }
+
+            switch (action.kind) {
+            case Move: ball->setMoveDirection(action.vector); break;
+            case Steer: ball->applyGoBiggerMovement(action.vector, action.center); break;
+            case Split: ball->performSplit(action.vector); break;
+            case Eject: ball->ejectSpore(action.vector); break;
+            default: break;
+            }
+            continue;
+        }
+
+        switch (op) {
+        case OpTick:
+            targetTick += static_cast<qint64>(reader.varint());
+            advance();
+            break;
+        case OpNextTick:
+            targetTick++;
+            advance();
+            break;
+        case OpJoin: {
+            const int teamId = static_cast<int>(reader.signedVarint());
+            const int playerId = static_cast<int>(reader.signedVarint());
+            QPointF position;
+            if (reader.byte()) {
+                const double x = reader.float64();
+                const double y = reader.float64();
+                position = QPointF(x, y);
+            }
+            world->createPlayer(teamId, playerId, position);
+            break;
+        }
+        case OpScore: {
+            const int ballId = static_cast<int>(reader.signedVarint());
+            const float score = static_cast<float>(reader.float64());
+            if (CloneBall* ball = findClone(ballId)) {
+                ball->setScore(score);
+            }
+            break;
+        }
+        case OpStart:
+            world->startGame();
+            break;
+        case OpPause:
+            world->pauseGame();
+            break;
+        case OpReset:
+            world->resetGame();
+            world->random().reseed(reader.varint());
+            targetTick = 0;
+            clonesFrame = -1;
+            break;
+        case OpEnd:
+            if (missingBalls > 0) {
+                qWarning() << "InputReplay:" << missingBalls << "actions referred to missing balls";
+            }
+            return ticksRun;
+        default:
+            return ticksRun;
+        }
+    }
+    return ticksRun;
+}
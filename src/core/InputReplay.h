@@ -0,0 +1,49 @@
+#ifndef INPUTREPLAY_H
+#define INPUTREPLAY_H
+
+#include <QByteArray>
+#include <QString>
+#include <functional>
+#include "GameManager.h"
+#include "ReplayFormat.h"
+
+// 输入录像的重放（录制见InputRecorder.h）
+// 用录像里的配置和种子新建一个无头世界，按原来的顺序重新发出加入/开始/暂停/重置和每个球的操作，
+// 帧与帧之间不等待，全速推进；模拟是确定性的，所以得到与录制时完全相同的负载，
+// 可以放到性能分析器下反复跑（gobigger-bench --replay）
+// AI玩家只重放它们发出的操作，不重新创建AI控制器，因此不含AI决策本身的耗时
+class InputReplay
+{
+public:
+    InputReplay();
+
+    bool open(const QString& path, QString* error = nullptr);
+    bool load(const QByteArray& data, QString* error = nullptr);
+
+    quint64 seed() const { return m_seed; }
+    // 录制时的配置（种子已填好），改成手动推进，适合无头重放
+    const GameManager::Config& config() const { return m_config; }
+    qint64 tickCount() const { return m_tickCount; }     // 录像覆盖的总帧数（重置前后累加）
+    qint64 actionCount() const { return m_actionCount; } // 球操作数
+
+    // 在world上重放整段录像；world必须是用config()新建、还没开始的世界
+    // tick为空时直接调用world->tick()，否则由它推进一帧（用来计时）
+    // 返回推进的帧数；录像与世界对不上（找不到操作的球）时记一条警告，继续重放
+    qint64 play(GameManager* world, const std::function<void(GameManager*)>& tick = {}) const;
+
+private:
+    QByteArray m_data;
+    int m_eventsOffset;
+    quint64 m_seed;
+    GameManager::Config m_config;
+    qint64 m_tickCount;
+    qint64 m_actionCount;
+};
+
+namespace ReplayFormat {
+    // 录像头里的配置块：只存影响模拟结果的字段，按长度前缀存放，以后追加字段旧文件仍可读
+    void writeConfig(QByteArray& out, const GameManager::Config& config);
+    bool readConfig(Reader& reader, GameManager::Config& config);
+}
+
+#endif // INPUTREPLAY_H
@@ -0,0 +1,233 @@
+#include "NarrowPhase.h"
+#include <algorithm>
+#include <cmath>
+
+// 指令集选择：
+// - 整个程序按AVX2编译（__AVX2__）时直接用AVX2内核
+// - 打开ENABLE_AVX2（NARROWPHASE_ENABLE_AVX2）时只有AVX2内核按目标属性编译，程序其余部分仍是x64基线，
+//   运行时确认CPU和操作系统支持AVX2才走它，否则退回SSE2
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NARROWPHASE_AVX2 1
+#define NARROWPHASE_AVX2_TARGET
+#elif defined(NARROWPHASE_ENABLE_AVX2) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64))
+#include <immintrin.h>
+#define NARROWPHASE_AVX2 1
+#define NARROWPHASE_AVX2_DISPATCH 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#define NARROWPHASE_AVX2_TARGET // MSVC不需要/arch就能用AVX2内建函数
+#else
+#define NARROWPHASE_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NARROWPHASE_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+    inline int lowestBit(unsigned int mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    inline uint8_t eatFlags(float score, float otherScore, float eatRatio)
+    {
+        uint8_t flags = 0;
+        if (score >= otherScore * eatRatio) flags |= NarrowPhase::HIT_EATS_CANDIDATE;
+        if (otherScore >= score * eatRatio) flags |= NarrowPhase::HIT_EATEN_BY_CANDIDATE;
+        return flags;
+    }
+
+    inline void scalarRange(float x, float y, float radius, float score,
+                            const NarrowPhase::CandidateBatch& batch, float distanceRatio, float eatRatio,
+                            int begin, int end, std::vector<NarrowPhase::Hit>& hits)
+    {
+        for (int i = begin; i < end; ++i) {
+            const float dx = batch.x[i] - x;
+            const float dy = batch.y[i] - y;
+            const float reach = (batch.radius[i] + radius) * distanceRatio;
+            if (dx * dx + dy * dy <= reach * reach) {
+                hits.push_back({ i, eatFlags(score, batch.score[i], eatRatio), 1.0f });
+            }
+        }
+    }
+
+#if defined(NARROWPHASE_AVX2)
+    // 一次8个，返回标量尾部的起点
+    NARROWPHASE_AVX2_TARGET
+    int overlapAvx2(float x, float y, float radius, float score,
+                    const NarrowPhase::CandidateBatch& batch, float distanceRatio, float eatRatio,
+                    std::vector<NarrowPhase::Hit>& hits)
+    {
+        const int count = batch.size();
+        const __m256 px = _mm256_set1_ps(x);
+        const __m256 py = _mm256_set1_ps(y);
+        const __m256 pr = _mm256_set1_ps(radius);
+        const __m256 ratio = _mm256_set1_ps(distanceRatio);
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&batch.x[i]), px);
+            const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&batch.y[i]), py);
+            const __m256 reach = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(&batch.radius[i]), pr), ratio);
+            const __m256 dist2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+
+            unsigned int mask = static_cast<unsigned int>(
+                _mm256_movemask_ps(_mm256_cmp_ps(dist2, _mm256_mul_ps(reach, reach), _CMP_LE_OQ)));
+            while (mask) {
+                const int index = i + lowestBit(mask);
+                hits.push_back({ index, eatFlags(score, batch.score[index], eatRatio), 1.0f });
+                mask &= mask - 1;
+            }
+        }
+        return i;
+    }
+
+    bool detectAvx2()
+    {
+#if !defined(NARROWPHASE_AVX2_DISPATCH)
+        return true; // 整个程序按AVX2编译
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+            return false; // 操作系统没有保存YMM寄存器
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    bool avx2Available()
+    {
+        static const bool available = detectAvx2();
+        return available;
+    }
+#endif
+
+#if defined(NARROWPHASE_SSE2)
+    // 一次4个，返回标量尾部的起点
+    int overlapSse2(float x, float y, float radius, float score,
+                    const NarrowPhase::CandidateBatch& batch, float distanceRatio, float eatRatio,
+                    std::vector<NarrowPhase::Hit>& hits)
+    {
+        const int count = batch.size();
+        const __m128 px = _mm_set1_ps(x);
+        const __m128 py = _mm_set1_ps(y);
+        const __m128 pr = _mm_set1_ps(radius);
+        const __m128 ratio = _mm_set1_ps(distanceRatio);
+
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const __m128 dx = _mm_sub_ps(_mm_loadu_ps(&batch.x[i]), px);
+            const __m128 dy = _mm_sub_ps(_mm_loadu_ps(&batch.y[i]), py);
+            const __m128 reach = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&batch.radius[i]), pr), ratio);
+            const __m128 dist2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+            unsigned int mask = static_cast<unsigned int>(
+                _mm_movemask_ps(_mm_cmple_ps(dist2, _mm_mul_ps(reach, reach))));
+            while (mask) {
+                const int index = i + lowestBit(mask);
+                hits.push_back({ index, eatFlags(score, batch.score[index], eatRatio), 1.0f });
+                mask &= mask - 1;
+            }
+        }
+        return i;
+    }
+#endif
+}
+
+namespace NarrowPhase {
+
+void overlap(float x, float y, float radius, float score,
+             const CandidateBatch& batch, float distanceRatio, float eatRatio,
+             std::vector<Hit>& hits)
+{
+    hits.clear();
+    const int count = batch.size();
+    int i = 0;
+
+#if defined(NARROWPHASE_AVX2) && defined(NARROWPHASE_SSE2)
+    i = avx2Available() ? overlapAvx2(x, y, radius, score, batch, distanceRatio, eatRatio, hits)
+                        : overlapSse2(x, y, radius, score, batch, distanceRatio, eatRatio, hits);
+#elif defined(NARROWPHASE_AVX2)
+    i = overlapAvx2(x, y, radius, score, batch, distanceRatio, eatRatio, hits);
+#elif defined(NARROWPHASE_SSE2)
+    i = overlapSse2(x, y, radius, score, batch, distanceRatio, eatRatio, hits);
+#endif
+
+    // 不足一组的尾部（或没有SIMD时的全部）
+    scalarRange(x, y, radius, score, batch, distanceRatio, eatRatio, i, count, hits);
+}
+
+void sweep(float x0, float y0, float x1, float y1, float radius, float score,
+           const CandidateBatch& batch, float distanceRatio, float eatRatio,
+           std::vector<Hit>& hits)
+{
+    hits.clear();
+    const float dx = x1 - x0;
+    const float dy = y1 - y0;
+    const float a = dx * dx + dy * dy;
+
+    for (int i = 0; i < batch.size(); ++i) {
+        // 相对位置 m = p0 - c，解 |m + t*d|^2 = R^2 的较小根
+        const float mx = x0 - batch.x[i];
+        const float my = y0 - batch.y[i];
+        const float reach = (batch.radius[i] + radius) * distanceRatio;
+        const float c = mx * mx + my * my - reach * reach;
+
+        float time;
+        if (c <= 0.0f) {
+            time = 0.0f; // 起点就已经重叠
+        } else {
+            const float b = mx * dx + my * dy;
+            if (b >= 0.0f || a <= 0.0f) continue;   // 没有朝候选者移动
+            const float disc = b * b - a * c;
+            if (disc < 0.0f) continue;              // 路径与候选者擦肩而过
+            time = (-b - std::sqrt(disc)) / a;
+            if (time > 1.0f) continue;              // 本帧还没走到
+        }
+
+        hits.push_back({ i, eatFlags(score, batch.score[i], eatRatio), time });
+    }
+
+    std::stable_sort(hits.begin(), hits.end(), [](const Hit& lhs, const Hit& rhs) {
+        return lhs.time < rhs.time;
+    });
+}
+
+const char* simdLevel()
+{
+#if defined(NARROWPHASE_AVX2) && defined(NARROWPHASE_SSE2)
+    return avx2Available() ? "AVX2" : "SSE2";
+#elif defined(NARROWPHASE_AVX2)
+    return "AVX2";
+#elif defined(NARROWPHASE_SSE2)
+    return "SSE2";
+#else
+    return "Scalar";
+#endif
+}
+
+} // namespace NarrowPhase
@@ -0,0 +1,68 @@
+#ifndef NARROWPHASE_H
+#define NARROWPHASE_H
+
+#include <cstdint>
+#include <vector>
+
+// 窄相碰撞内核：一个移动球 vs 一批打包好的候选者
+// 粗测（Broadphase）给出候选者后，把它们的x/y/r/score按SoA连续存放，
+// 一次比较8个（AVX2）或4个（SSE2），剩余部分走标量；不依赖Qt和BaseBall
+namespace NarrowPhase {
+
+// 候选者批次（SoA），clear()后保留容量，可以每帧复用
+struct CandidateBatch {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> radius;
+    std::vector<float> score;
+
+    void clear()
+    {
+        x.clear();
+        y.clear();
+        radius.clear();
+        score.clear();
+    }
+
+    void append(float px, float py, float r, float s)
+    {
+        x.push_back(px);
+        y.push_back(py);
+        radius.push_back(r);
+        score.push_back(s);
+    }
+
+    int size() const { return static_cast<int>(x.size()); }
+};
+
+// 命中标记
+enum HitFlag : uint8_t {
+    HIT_EATS_CANDIDATE = 1,     // 移动球的分数足以吃掉候选者
+    HIT_EATEN_BY_CANDIDATE = 2  // 候选者的分数足以吃掉移动球
+};
+
+struct Hit {
+    int index;      // 候选者在批次中的下标
+    uint8_t flags;  // HitFlag组合
+    float time;     // 接触时刻（本帧位移的比例，0~1）；离散检测固定为1
+};
+
+// 检测重叠：distance <= (r + ri) * distanceRatio；命中时顺带做双向的吞噬分数比较
+// （score >= other * eatRatio）。hits先被清空，再按下标升序写入命中者
+void overlap(float x, float y, float radius, float score,
+             const CandidateBatch& batch, float distanceRatio, float eatRatio,
+             std::vector<Hit>& hits);
+
+// 连续碰撞检测（扫掠圆）：移动球本帧从(x0,y0)移动到(x1,y1)，候选者视为静止。
+// 求最早的接触时刻t∈[0,1]（距离首次<= (r + ri) * distanceRatio），命中者按t升序写入hits。
+// 只用于少量高速球（孢子、分裂冲刺），走标量路径
+void sweep(float x0, float y0, float x1, float y1, float radius, float score,
+           const CandidateBatch& batch, float distanceRatio, float eatRatio,
+           std::vector<Hit>& hits);
+
+// 实际使用的指令集（"AVX2"/"SSE2"/"Scalar"，AVX2按运行时检测的结果），用于日志
+const char* simdLevel();
+
+} // namespace NarrowPhase
+
+#endif // NARROWPHASE_H
@@ -0,0 +1,179 @@
+#ifndef REPLAYFORMAT_H
+#define REPLAYFORMAT_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QtEndian>
+#include <QtGlobal>
+#include <cmath>
+#include <cstring>
+
+// 输入录像的二进制格式（InputRecorder写，InputReplay读），两边共用这里的编码
+//
+// 文件 = "GBRP" + varint版本 + varint种子 + 配置块 + 事件流
+// 事件流按发生顺序排列，每个事件一个操作码字节：
+//   Tick        varint 帧数增量（下一个事件发生在这么多帧之后）
+//   NextTick    帧数+1（最常见的情况单独一个字节）
+//   Join        zigzag队伍, zigzag玩家, u8有无位置, [f64 x, f64 y]
+//   Start/Pause GameManager::startGame()/pauseGame()
+//   Reset       varint 新种子
+//   Score       zigzag球ID, f64分数（GameManager::setPlayerScore）
+//   End         录制结束（之前的Tick已把帧数推进到最后一帧）
+//   球操作      0x40 | 种类 | 标志；球ID和向量都按该球上一次的值做zigzag差分
+// 向量按1/65536定点量化，录制时就用量化后的值驱动模拟，重放才能逐位一致
+namespace ReplayFormat {
+
+constexpr char kMagic[4] = { 'G', 'B', 'R', 'P' };
+constexpr quint32 kVersion = 1;
+constexpr float kVectorScale = 65536.0f;
+
+enum Op : quint8 {
+    OpTick = 0x01,
+    OpNextTick = 0x02,
+    OpJoin = 0x03,
+    OpStart = 0x04,
+    OpPause = 0x05,
+    OpReset = 0x06,
+    OpScore = 0x07,
+    OpEnd = 0x0F,
+    OpAction = 0x40
+};
+
+// 球操作的种类（操作码低3位），对应CloneBall的几个玩家操作入口
+enum ActionKind : quint8 {
+    Move,   // setMoveDirection
+    Steer,  // applyGoBiggerMovement（输入 + 向心力）
+    Split,  // performSplit
+    Eject,  // ejectSpore
+    ActionKindCount
+};
+
+constexpr quint8 kKindMask = 0x07;
+constexpr quint8 kSameBall = 0x08;    // 与上一个球操作是同一个球，省掉ID
+constexpr quint8 kSameVector = 0x10;  // 向量与该球上一次的相同
+constexpr quint8 kSameCenter = 0x20;  // Steer的向心力与该球上一次的相同
+
+// 每个球上一次的量化向量，差分编码的参照
+struct BallVectors {
+    qint32 x = 0;
+    qint32 y = 0;
+    qint32 centerX = 0;
+    qint32 centerY = 0;
+};
+using VectorHistory = QHash<int, BallVectors>;
+
+inline qint32 quantize(float value)
+{
+    const float clamped = qBound(-30000.0f, value, 30000.0f);
+    return static_cast<qint32>(std::lround(clamped * kVectorScale));
+}
+
+inline float dequantize(qint32 value)
+{
+    return static_cast<float>(value) / kVectorScale;
+}
+
+inline quint64 zigzag(qint64 value)
+{
+    return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+}
+
+inline qint64 unzigzag(quint64 value)
+{
+    return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+inline void writeVarint(QByteArray& out, quint64 value)
+{
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+inline void writeSigned(QByteArray& out, qint64 value)
+{
+    writeVarint(out, zigzag(value));
+}
+
+inline void writeDouble(QByteArray& out, double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits = qToLittleEndian(bits);
+    out.append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+}
+
+// 顺序读取；越界或格式错误后ok()为false，之后读到的都是0
+class Reader
+{
+public:
+    explicit Reader(const QByteArray& data) : m_data(data), m_pos(0), m_ok(true) {}
+
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_pos >= m_data.size(); }
+    int position() const { return m_pos; }
+
+    quint8 byte()
+    {
+        if (m_pos >= m_data.size()) {
+            m_ok = false;
+            return 0;
+        }
+        return static_cast<quint8>(m_data[m_pos++]);
+    }
+
+    quint64 varint()
+    {
+        quint64 value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const quint8 b = byte();
+            value |= static_cast<quint64>(b & 0x7F) << shift;
+            if (!(b & 0x80)) {
+                return value;
+            }
+        }
+        m_ok = false;
+        return 0;
+    }
+
+    qint64 signedVarint() { return unzigzag(varint()); }
+
+    double float64()
+    {
+        if (m_pos + 8 > m_data.size()) {
+            m_ok = false;
+            m_pos = m_data.size();
+            return 0.0;
+        }
+        quint64 bits;
+        std::memcpy(&bits, m_data.constData() + m_pos, sizeof(bits));
+        m_pos += 8;
+        bits = qFromLittleEndian(bits);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    QByteArray bytes(int count)
+    {
+        if (count < 0 || m_pos + count > m_data.size()) {
+            m_ok = false;
+            m_pos = m_data.size();
+            return QByteArray();
+        }
+        const QByteArray result = m_data.mid(m_pos, count);
+        m_pos += count;
+        return result;
+    }
+
+private:
+    const QByteArray& m_data;
+    int m_pos;
+    bool m_ok;
+};
+
+} // namespace ReplayFormat
+
+#endif // REPLAYFORMAT_H
@@ -0,0 +1,31 @@
+#include "SimRandom.h"
+#include <QRandomGenerator>
+
+SimRandom::SimRandom(quint64 seed)
+{
+    reseed(seed);
+}
+
+void SimRandom::reseed(quint64 seed)
+{
+    m_seed = seed;
+    const RandomStream root(seed);
+    for (int i = 0; i < StreamCount; ++i) {
+        m_streams[i] = root.derive(static_cast<quint64>(i));
+    }
+}
+
+RandomStream SimRandom::aiStream(int teamId, int playerId) const
+{
+    const quint64 subkey = (static_cast<quint64>(static_cast<quint32>(teamId)) << 32) | static_cast<quint32>(playerId);
+    return m_streams[AI].derive(subkey);
+}
+
+quint64 SimRandom::entropySeed()
+{
+    quint64 seed = 0;
+    while (seed == 0) {
+        seed = QRandomGenerator::system()->generate64();
+    }
+    return seed;
+}
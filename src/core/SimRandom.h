@@ -0,0 +1,90 @@
+#ifndef SIMRANDOM_H
+#define SIMRANDOM_H
+
+#include <QtGlobal>
+
+// 可复现的随机数：GameManager::Config::seed决定整局（取代QRandomGenerator::global()）
+// - 基于计数器：第n个数 = mix(流密钥, n)，不依赖上一个数，取到第几个就是第几个
+// - 每个子系统一条独立的流，某个子系统多取/少取几个数不会扰动其他子系统
+// - 可能并行执行的部分（例如每个AI玩家）再按键派生子流，执行顺序不影响结果
+// 只有计数器是状态，快照时记下counter()即可原样恢复
+
+// 一条随机数流，接口与QRandomGenerator常用的几个保持一致
+class RandomStream
+{
+public:
+    RandomStream() : m_key(0), m_counter(0) {}
+    explicit RandomStream(quint64 key, quint64 counter = 0) : m_key(key), m_counter(counter) {}
+
+    quint64 generate64() { return mix(m_key, m_counter++); }
+    quint32 generate() { return static_cast<quint32>(generate64() >> 32); }
+
+    // [0, 1)，53位精度
+    double generateDouble() { return (generate64() >> 11) * (1.0 / 9007199254740992.0); }
+
+    // [0, highest)；highest<=0时返回0
+    int bounded(int highest)
+    {
+        if (highest <= 0) return 0;
+        return static_cast<int>((static_cast<quint64>(generate()) * static_cast<quint64>(highest)) >> 32);
+    }
+    // [lowest, highest)
+    int bounded(int lowest, int highest) { return lowest + bounded(highest - lowest); }
+    double bounded(double highest) { return generateDouble() * highest; }
+
+    // 以本流为根派生一条子流，派生不消耗本流的计数
+    RandomStream derive(quint64 subkey) const { return RandomStream(mix(m_key, ~subkey)); }
+
+    quint64 key() const { return m_key; }
+    quint64 counter() const { return m_counter; }
+    void setCounter(quint64 counter) { m_counter = counter; }
+
+    // SplitMix64的终结函数，两轮混合让相邻的键/计数器也互不相关
+    static quint64 mix(quint64 key, quint64 counter)
+    {
+        quint64 z = key + (counter + 1) * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        z ^= key * 0xD6E8FEB86659FD93ULL;
+        z = (z ^ (z >> 32)) * 0xD6E8FEB86659FD93ULL;
+        return z ^ (z >> 32);
+    }
+
+private:
+    quint64 m_key;
+    quint64 m_counter;
+};
+
+// 一局的随机数源：一个种子，每个子系统一条流
+class SimRandom
+{
+public:
+    enum Stream {
+        Spawn,   // 食物/荆棘/玩家出生位置
+        Thorns,  // 荆棘分数
+        AI,      // AI决策（每个AI玩家一条子流，见aiStream）
+        StreamCount
+    };
+
+    explicit SimRandom(quint64 seed = 0);
+
+    // 换种子并把所有流的计数器归零
+    void reseed(quint64 seed);
+    quint64 seed() const { return m_seed; }
+
+    RandomStream& stream(Stream stream) { return m_streams[stream]; }
+    const RandomStream& stream(Stream stream) const { return m_streams[stream]; }
+
+    // 某个AI玩家的专属子流：只取决于种子和(teamId, playerId)，与加入顺序、线程无关
+    RandomStream aiStream(int teamId, int playerId) const;
+
+    // 取一个新种子（Config::seed为0时用），调用方应记录下来以便复现
+    static quint64 entropySeed();
+
+private:
+    quint64 m_seed;
+    RandomStream m_streams[StreamCount];
+};
+
+#endif // SIMRANDOM_H
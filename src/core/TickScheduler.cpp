@@ -0,0 +1,171 @@
+#include "TickScheduler.h"
+#include "Trace.h"
+#include "FrameProfiler.h"
+#include "ChromeTrace.h"
+#include <QTimer>
+#include <algorithm>
+
+namespace {
+    // 加速模式下每次轮询最多占用的时间，超过后交还事件循环处理输入和重绘
+    constexpr qint64 TURBO_SLICE_MS = 12;
+}
+
+TickScheduler::TickScheduler(QObject* parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_tickCount(0)
+    , m_profiler(nullptr)
+    , m_fixedStep(1.0 / 60.0)
+    , m_accumulator(0.0)
+    , m_maxCatchUpTicks(5)
+    , m_speedMultiplier(1.0)
+    , m_turbo(false)
+    , m_pollIntervalMs(16)
+{
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &TickScheduler::advance);
+}
+
+TickScheduler::~TickScheduler()
+{
+    m_timer->stop();
+}
+
+void TickScheduler::addPhase(int order, const QString& name, std::function<void()> callback, int everyTicks)
+{
+    Phase phase{ order, name, std::move(callback), qMax(1, everyTicks) };
+
+    auto it = std::upper_bound(m_phases.begin(), m_phases.end(), order,
+                               [](int value, const Phase& p) { return value < p.order; });
+    m_phases.insert(it, std::move(phase));
+}
+
+void TickScheduler::removePhase(const QString& name)
+{
+    m_phases.erase(std::remove_if(m_phases.begin(), m_phases.end(),
+                                  [&name](const Phase& p) { return p.name == name; }),
+                   m_phases.end());
+}
+
+void TickScheduler::setPhaseInterval(const QString& name, int everyTicks)
+{
+    for (Phase& phase : m_phases) {
+        if (phase.name == name) {
+            phase.everyTicks = qMax(1, everyTicks);
+        }
+    }
+}
+
+void TickScheduler::setFixedStep(qreal seconds)
+{
+    if (seconds > 0.0) {
+        m_fixedStep = seconds;
+    }
+}
+
+void TickScheduler::start(int pollIntervalMs)
+{
+    m_pollIntervalMs = qMax(1, pollIntervalMs);
+    restartClock();
+
+    // 加速模式用0间隔定时器：事件循环一空闲就继续推进
+    m_timer->start(m_turbo ? 0 : m_pollIntervalMs);
+}
+
+void TickScheduler::restartClock()
+{
+    // 暂停或切换速度期间经过的时间不算数
+    m_accumulator = 0.0;
+    m_clock.start();
+}
+
+void TickScheduler::setSpeedMultiplier(qreal multiplier)
+{
+    if (multiplier <= 0.0 || qFuzzyCompare(multiplier, m_speedMultiplier)) {
+        return;
+    }
+
+    m_speedMultiplier = multiplier;
+    restartClock();
+}
+
+void TickScheduler::setTurbo(bool enabled)
+{
+    if (enabled == m_turbo) {
+        return;
+    }
+
+    m_turbo = enabled;
+    restartClock();
+
+    if (m_timer->isActive()) {
+        m_timer->start(m_turbo ? 0 : m_pollIntervalMs);
+    }
+}
+
+void TickScheduler::stop()
+{
+    m_timer->stop();
+}
+
+bool TickScheduler::isRunning() const
+{
+    return m_timer->isActive();
+}
+
+qreal TickScheduler::alpha() const
+{
+    if (m_turbo) {
+        return 1.0;
+    }
+    return qBound(0.0, m_accumulator / m_fixedStep, 1.0);
+}
+
+void TickScheduler::advance()
+{
+    if (m_turbo) {
+        QElapsedTimer slice;
+        slice.start();
+        do {
+            tick();
+        } while (m_turbo && m_timer->isActive() && slice.elapsed() < TURBO_SLICE_MS);
+        return;
+    }
+
+    m_accumulator += m_clock.nsecsElapsed() / 1e9 * m_speedMultiplier;
+    m_clock.restart();
+
+    // 卡顿太久时只补跑有限的帧数，剩下的时间直接丢掉（表现为短暂变慢，而不是越积越多）
+    const qreal maxBacklog = m_fixedStep * m_maxCatchUpTicks * m_speedMultiplier;
+    if (m_accumulator > maxBacklog) {
+        m_accumulator = maxBacklog;
+    }
+
+    while (m_accumulator >= m_fixedStep && m_timer->isActive()) {
+        m_accumulator -= m_fixedStep;
+        tick(); // 阶段回调可能暂停游戏，所以每帧都重新检查定时器
+    }
+}
+
+void TickScheduler::tick()
+{
+    m_tickCount++;
+    Trace::setFrame(m_tickCount); // 追踪记录按逻辑帧打戳
+    ChromeTrace::Span span("tick", "tick");
+    span.setArg("tick", m_tickCount);
+    if (m_profiler) {
+        m_profiler->beginTick(m_tickCount);
+    }
+
+    for (const Phase& phase : std::as_const(m_phases)) {
+        if (m_tickCount % phase.everyTicks == 0) {
+            phase.callback();
+        }
+    }
+
+    if (m_profiler) {
+        m_profiler->endTick();
+    }
+
+    emit ticked(m_tickCount);
+}
@@ -0,0 +1,101 @@
+#ifndef TICKSCHEDULER_H
+#define TICKSCHEDULER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QElapsedTimer>
+#include <functional>
+
+class QTimer;
+class FrameProfiler;
+
+// 统一的帧调度器：每帧按order从小到大依次执行登记的阶段。
+// 取代各个球自带的QTimer——所有逻辑都在同一个定时器回调里按固定顺序推进，
+// stop()之后不会再有任何阶段被执行。无头模式不启动定时器，由调用方直接tick()
+//
+// 定时驱动时使用固定步长累加器：定时器只是轮询，每次把真实经过的时间累加起来，
+// 够几个逻辑帧就执行几次tick()，余下的时间留到下次。这样模拟速度不受定时器抖动影响，
+// 逻辑帧率（例如GoBigger原生的20Hz）也可以低于轮询/显示频率，渲染用alpha()在两帧之间插值。
+// 加速模式下不再看真实时间：每次轮询在一个时间片内尽可能多地tick()，然后把控制权交还事件循环
+class TickScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TickScheduler(QObject* parent = nullptr);
+    ~TickScheduler() override;
+
+    // 登记一个阶段；everyTicks > 1 时每隔这么多帧执行一次（在帧号能整除时）
+    // 阶段回调里不能登记或移除阶段
+    void addPhase(int order, const QString& name, std::function<void()> callback, int everyTicks = 1);
+    void removePhase(const QString& name);
+    void setPhaseInterval(const QString& name, int everyTicks);
+
+    // 固定逻辑步长（秒）
+    void setFixedStep(qreal seconds);
+    qreal fixedStep() const { return m_fixedStep; }
+
+    // 一次轮询最多补跑的逻辑帧数，卡顿时丢弃多出的时间，避免越追越慢
+    void setMaxCatchUpTicks(int ticks) { m_maxCatchUpTicks = qMax(1, ticks); }
+
+    // 定时驱动：每pollIntervalMs轮询一次累加器
+    void start(int pollIntervalMs);
+    void stop();
+    bool isRunning() const;
+
+    // 累加器里不足一帧的剩余时间占步长的比例[0, 1)，即渲染位置在上一帧和当前帧之间的插值系数
+    qreal alpha() const;
+
+    // 速度倍数：真实时间乘以它再累加，2表示两倍速
+    void setSpeedMultiplier(qreal multiplier);
+    qreal speedMultiplier() const { return m_speedMultiplier; }
+
+    // 加速模式：按CPU能力全速推进
+    void setTurbo(bool enabled);
+    bool isTurbo() const { return m_turbo; }
+
+    // 推进一帧（定时器回调或无头调用方）
+    void tick();
+    qint64 tickCount() const { return m_tickCount; }
+    void resetTickCount() { m_tickCount = 0; }
+    // 快照恢复时接着原来的帧号走，按帧间隔执行的阶段才能对齐
+    void setTickCount(qint64 ticks) { m_tickCount = ticks; }
+
+    // 设置后每个逻辑帧前后调用beginTick()/endTick()，统计整帧耗时
+    void setProfiler(FrameProfiler* profiler) { m_profiler = profiler; }
+
+signals:
+    void ticked(qint64 tickCount);
+
+private slots:
+    void advance();
+
+private:
+    struct Phase {
+        int order;
+        QString name;
+        std::function<void()> callback;
+        int everyTicks;
+    };
+
+    QVector<Phase> m_phases;   // 按order排序，order相同时保持登记顺序
+    QTimer* m_timer;
+    qint64 m_tickCount;
+    FrameProfiler* m_profiler;
+
+    // 固定步长累加器
+    QElapsedTimer m_clock;
+    qreal m_fixedStep;
+    qreal m_accumulator;
+    int m_maxCatchUpTicks;
+    qreal m_speedMultiplier;
+
+    // 加速模式
+    bool m_turbo;
+    int m_pollIntervalMs;
+
+    void restartClock();
+};
+
+#endif // TICKSCHEDULER_H
@@ -0,0 +1,180 @@
+#include "Trace.h"
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+#include <algorithm>
+#include <atomic>
+
+namespace Trace {
+
+namespace {
+    // 环形缓冲区容量（2的幂），写满后覆盖最旧的记录
+    constexpr quint64 kCapacity = 1u << 16;
+    constexpr quint64 kMask = kCapacity - 1;
+
+    // 每个槽位带一个序号：0表示正在写，否则等于写入时的全局序号+1。
+    // 读的一方在拷贝前后各看一次序号，不一致说明被覆盖了，丢弃这条
+    struct Slot {
+        std::atomic<quint64> sequence{0};
+        Record record;
+    };
+
+    Slot g_slots[kCapacity];
+    std::atomic<quint64> g_head{0};      // 下一条记录的全局序号
+    std::atomic<quint64> g_clearedAt{0}; // clear()时的序号，之前的记录不再导出
+    thread_local qint64 t_frame = 0;
+    std::atomic<quint8> g_levels[CategoryCount] = {};
+
+    const char* const kCategoryNames[CategoryCount] = {
+        "collision", "eat", "score", "spore", "thorns", "split", "merge", "ball", "ai"
+    };
+
+    const char* const kLevelNames[] = { "off", "error", "info", "debug", "verbose" };
+}
+
+bool isEnabled(Category category, Level level)
+{
+    return static_cast<quint8>(level) <= g_levels[category].load(std::memory_order_relaxed);
+}
+
+void setLevel(Category category, Level level)
+{
+    if (category < CategoryCount) {
+        g_levels[category].store(level, std::memory_order_relaxed);
+    }
+}
+
+void setAllLevels(Level level)
+{
+    for (int i = 0; i < CategoryCount; ++i) {
+        g_levels[i].store(level, std::memory_order_relaxed);
+    }
+}
+
+Level level(Category category)
+{
+    return static_cast<Level>(g_levels[category].load(std::memory_order_relaxed));
+}
+
+void configure(const QString& spec)
+{
+    const QStringList entries = spec.split(',', Qt::SkipEmptyParts);
+    for (const QString& entry : entries) {
+        const QStringList parts = entry.split('=');
+        const QString name = parts.value(0).trimmed().toLower();
+        bool ok = true;
+        const int value = parts.size() > 1 ? parts.value(1).trimmed().toInt(&ok) : static_cast<int>(Verbose);
+        if (!ok) {
+            continue;
+        }
+
+        const Level parsed = static_cast<Level>(qBound(0, value, static_cast<int>(Verbose)));
+        if (name == "all") {
+            setAllLevels(parsed);
+            continue;
+        }
+        for (int i = 0; i < CategoryCount; ++i) {
+            if (name == QLatin1String(kCategoryNames[i])) {
+                setLevel(static_cast<Category>(i), parsed);
+                break;
+            }
+        }
+    }
+}
+
+const char* categoryName(Category category)
+{
+    return category < CategoryCount ? kCategoryNames[category] : "?";
+}
+
+void setFrame(qint64 frame)
+{
+    t_frame = frame;
+}
+
+qint64 frame()
+{
+    return t_frame;
+}
+
+void record(Category category, Level level, const char* label, std::initializer_list<float> args)
+{
+    const quint64 index = g_head.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = g_slots[index & kMask];
+
+    // 先标记为写入中，读者看到0会跳过
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Record& r = slot.record;
+    r.frame = t_frame;
+    r.label = label;
+    r.category = category;
+    r.level = level;
+    r.argCount = static_cast<quint8>(std::min<size_t>(args.size(), kMaxArgs));
+    std::copy_n(args.begin(), r.argCount, r.args);
+
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+QVector<Record> snapshot()
+{
+    const quint64 head = g_head.load(std::memory_order_acquire);
+    const quint64 oldest = head > kCapacity ? head - kCapacity : 0;
+    const quint64 begin = std::max(oldest, g_clearedAt.load(std::memory_order_relaxed));
+
+    QVector<Record> records;
+    records.reserve(static_cast<int>(head - begin));
+    for (quint64 index = begin; index < head; ++index) {
+        const Slot& slot = g_slots[index & kMask];
+        if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+            continue; // 正在写或已被覆盖
+        }
+
+        Record copy = slot.record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != index + 1) {
+            continue; // 拷贝期间被覆盖
+        }
+        records.append(copy);
+    }
+    return records;
+}
+
+int dump(QTextStream& out)
+{
+    const QVector<Record> records = snapshot();
+    for (const Record& r : records) {
+        out << '[' << r.frame << "] " << kCategoryNames[r.category] << '/' << kLevelNames[r.level]
+            << ' ' << (r.label ? r.label : "");
+        for (int i = 0; i < r.argCount; ++i) {
+            out << (i == 0 ? ": " : " ") << r.args[i];
+        }
+        out << '\n';
+    }
+    return records.size();
+}
+
+bool dumpToFile(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    QTextStream out(&file);
+    dump(out);
+    return true;
+}
+
+void clear()
+{
+    g_clearedAt.store(g_head.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+int capacity()
+{
+    return static_cast<int>(kCapacity);
+}
+
+} // namespace Trace
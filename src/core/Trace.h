@@ -0,0 +1,163 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <initializer_list>
+
+class QTextStream;
+
+// 分级追踪：取代模拟热路径上的qDebug()
+// 每个类别有一个编译期级别和一个运行期级别：
+// - 编译期级别之上的GB_TRACE整条语句被if constexpr丢掉，参数都不会求值（Release默认全部编译掉）
+// - 运行期启用的记录只把字面量标签指针和最多4个数值写进无锁环形缓冲区，不做任何字符串格式化，
+//   需要时再dump()成文本（GameView按F9，或者调用dumpToFile）
+//
+// 编译期级别：GOBIGGER_TRACE_LEVEL统一设置，GOBIGGER_TRACE_LEVEL_<类别>单独覆盖（见CMakeLists.txt）
+// 运行期级别：默认全部关闭，用setLevel()或configure("collision=4,eat=3")打开，
+//            启动时读取环境变量GOBIGGER_TRACE（见main.cpp）
+namespace Trace {
+
+enum Category : quint8 {
+    Collision,   // 碰撞分派（GameManager::checkCollisionsBetween）
+    Eat,         // 吞噬判定与吞噬
+    Score,       // 分数变化
+    Spore,       // 孢子的生成与移动
+    Thorns,      // 荆棘的碰撞与吃孢子
+    Split,       // 分裂与喷射
+    Merge,       // 合并
+    Ball,        // 球的生成/移除/回收
+    AI,          // AI决策与执行
+    CategoryCount
+};
+
+enum Level : quint8 {
+    Off = 0,
+    Error = 1,
+    Info = 2,
+    Debug = 3,
+    Verbose = 4
+};
+
+} // namespace Trace
+
+#ifndef GOBIGGER_TRACE_LEVEL
+#  ifdef NDEBUG
+#    define GOBIGGER_TRACE_LEVEL 1
+#  else
+#    define GOBIGGER_TRACE_LEVEL 4
+#  endif
+#endif
+
+#ifndef GOBIGGER_TRACE_LEVEL_COLLISION
+#define GOBIGGER_TRACE_LEVEL_COLLISION GOBIGGER_TRACE_LEVEL
+#endif
+#ifndef GOBIGGER_TRACE_LEVEL_EAT
+#define GOBIGGER_TRACE_LEVEL_EAT GOBIGGER_TRACE_LEVEL
+#endif
+#ifndef GOBIGGER_TRACE_LEVEL_SCORE
+#define GOBIGGER_TRACE_LEVEL_SCORE GOBIGGER_TRACE_LEVEL
+#endif
+#ifndef GOBIGGER_TRACE_LEVEL_SPORE
+#define GOBIGGER_TRACE_LEVEL_SPORE GOBIGGER_TRACE_LEVEL
+#endif
+#ifndef GOBIGGER_TRACE_LEVEL_THORNS
+#define GOBIGGER_TRACE_LEVEL_THORNS GOBIGGER_TRACE_LEVEL
+#endif
+#ifndef GOBIGGER_TRACE_LEVEL_SPLIT
+#define GOBIGGER_TRACE_LEVEL_SPLIT GOBIGGER_TRACE_LEVEL
+#endif
+#ifndef GOBIGGER_TRACE_LEVEL_MERGE
+#define GOBIGGER_TRACE_LEVEL_MERGE GOBIGGER_TRACE_LEVEL
+#endif
+#ifndef GOBIGGER_TRACE_LEVEL_BALL
+#define GOBIGGER_TRACE_LEVEL_BALL GOBIGGER_TRACE_LEVEL
+#endif
+#ifndef GOBIGGER_TRACE_LEVEL_AI
+#define GOBIGGER_TRACE_LEVEL_AI GOBIGGER_TRACE_LEVEL
+#endif
+
+namespace Trace {
+
+// 与Category一一对应
+constexpr int kCompiledLevels[CategoryCount] = {
+    GOBIGGER_TRACE_LEVEL_COLLISION,
+    GOBIGGER_TRACE_LEVEL_EAT,
+    GOBIGGER_TRACE_LEVEL_SCORE,
+    GOBIGGER_TRACE_LEVEL_SPORE,
+    GOBIGGER_TRACE_LEVEL_THORNS,
+    GOBIGGER_TRACE_LEVEL_SPLIT,
+    GOBIGGER_TRACE_LEVEL_MERGE,
+    GOBIGGER_TRACE_LEVEL_BALL,
+    GOBIGGER_TRACE_LEVEL_AI
+};
+
+constexpr bool compiledIn(Category category, Level level)
+{
+    return static_cast<int>(level) <= kCompiledLevels[category];
+}
+
+constexpr int kMaxArgs = 4;
+
+// 一条追踪记录：标签必须是字符串字面量（只存指针）
+struct Record {
+    qint64 frame = 0;
+    const char* label = nullptr;
+    float args[kMaxArgs] = {};
+    quint8 category = 0;
+    quint8 level = 0;
+    quint8 argCount = 0;
+};
+
+// 运行期级别（原子读，任何线程都可以调用）
+bool isEnabled(Category category, Level level);
+void setLevel(Category category, Level level);
+void setAllLevels(Level level);
+Level level(Category category);
+
+// "all=2,collision=4"形式的配置；类别名不区分大小写，未知的名字忽略
+void configure(const QString& spec);
+
+const char* categoryName(Category category);
+
+// 当前线程的逻辑帧号，写进该线程之后的每条记录（TickScheduler::tick在推进世界的线程上设置）
+// 按线程存：BatchEngine的每个工作线程推进各自的世界，互不覆盖；碰撞线程池的任务要自己带上所属世界的帧号
+void setFrame(qint64 frame);
+qint64 frame();
+
+// 写入环形缓冲区（多线程安全，不加锁）；一般通过GB_TRACE调用
+void record(Category category, Level level, const char* label, std::initializer_list<float> args);
+
+// GB_TRACE的落点：数值参数（int/bool/float/double）统一转成float
+template <typename... Args>
+inline void write(Category category, Level level, const char* label, Args... args)
+{
+    static_assert(sizeof...(Args) <= kMaxArgs, "GB_TRACE最多记录4个数值");
+    record(category, level, label, { static_cast<float>(args)... });
+}
+
+// 取出缓冲区里还没被覆盖的记录（按写入顺序），写入中的记录跳过
+QVector<Record> snapshot();
+// 转成文本，返回写出的记录数
+int dump(QTextStream& out);
+bool dumpToFile(const QString& path);
+// 之后的snapshot/dump只包含此后写入的记录
+void clear();
+
+int capacity();
+
+} // namespace Trace
+
+// 用法：GB_TRACE(Eat, Verbose, "canEat eater/target/result", eaterScore, targetScore, result);
+// 第三个参数是字符串字面量标签，后面最多kMaxArgs个数值
+#define GB_TRACE(category, level, ...)                                                          \
+    do {                                                                                        \
+        if constexpr (Trace::compiledIn(Trace::category, Trace::level)) {                       \
+            if (Trace::isEnabled(Trace::category, Trace::level)) {                              \
+                Trace::write(Trace::category, Trace::level, __VA_ARGS__);                       \
+            }                                                                                   \
+        }                                                                                       \
+    } while (0)
+
+#endif // TRACE_H
@@ -0,0 +1,159 @@
+#include "WorldSnapshot.h"
+#include "data/CloneBallData.h"
+#include "data/FoodBallData.h"
+#include "data/SporeBallData.h"
+#include "data/ThornsBallData.h"
+#include <QFile>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+    constexpr char kMagic[4] = { 'G', 'B', 'S', 'N' };
+    // 快照文件不会大到这个程度，超过说明头部被写坏了
+    constexpr qint64 kMaxBytes = qint64(1) << 30;
+
+    static_assert(std::is_trivially_copyable<CloneBallData>::value &&
+                  std::is_trivially_copyable<FoodBallData>::value &&
+                  std::is_trivially_copyable<SporeBallData>::value &&
+                  std::is_trivially_copyable<ThornsBallData>::value,
+                  "ball data records are copied byte-wise into snapshots");
+    static_assert(sizeof(WorldSnapshot::Header) == 144, "Header must not contain implicit padding");
+    static_assert(sizeof(WorldSnapshot::AIRecord) == 48, "AIRecord must not contain implicit padding");
+}
+
+WorldSnapshot::WorldSnapshot(const Header& header)
+{
+    const int total = layout(header, m_offsets);
+    if (total < 0) {
+        return;
+    }
+    m_data.resize(total);
+    std::memcpy(m_data.data(), &header, sizeof(Header));
+}
+
+WorldSnapshot::Header WorldSnapshot::makeHeader()
+{
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.headerSize = sizeof(Header);
+    header.dataSizes[Clones] = sizeof(CloneBallData);
+    header.dataSizes[Foods] = sizeof(FoodBallData);
+    header.dataSizes[Spores] = sizeof(SporeBallData);
+    header.dataSizes[Thorns] = sizeof(ThornsBallData);
+    return header;
+}
+
+WorldSnapshot::Header WorldSnapshot::header() const
+{
+    Header header;
+    if (m_data.size() < static_cast<int>(sizeof(Header))) {
+        return makeHeader();
+    }
+    std::memcpy(&header, m_data.constData(), sizeof(Header));
+    return header;
+}
+
+int WorldSnapshot::ballCount() const
+{
+    const Header h = header();
+    int count = 0;
+    for (int type = 0; type < kBallTypeCount; ++type) {
+        count += h.ballCounts[type];
+    }
+    return count;
+}
+
+int WorldSnapshot::layout(const Header& header, int* offsets)
+{
+    qint64 offset = sizeof(Header);
+    for (int type = 0; type < kBallTypeCount; ++type) {
+        offsets[type] = static_cast<int>(offset);
+        offset += qint64(header.dataSizes[type]) * qMax(0, header.ballCounts[type]);
+    }
+    offsets[SplitLinks] = static_cast<int>(offset);
+    offset += qint64(sizeof(qint32)) * qMax(0, header.linkCount);
+    offsets[AIPlayers] = static_cast<int>(offset);
+    offset += qint64(sizeof(AIRecord)) * qMax(0, header.aiCount);
+    offsets[AIBalls] = static_cast<int>(offset);
+    offset += qint64(sizeof(qint32)) * qMax(0, header.aiBallCount);
+    offsets[AIMemory] = static_cast<int>(offset);
+    offset += qMax(0, header.aiMemorySize);
+    offsets[ConfigBlock] = static_cast<int>(offset);
+    offset += qMax(0, header.configSize);
+    offsets[SectionCount] = static_cast<int>(qMin(offset, kMaxBytes));
+    return offset > kMaxBytes ? -1 : static_cast<int>(offset);
+}
+
+bool WorldSnapshot::save(const QString& path, QString* error) const
+{
+    if (isNull()) {
+        if (error) *error = "empty snapshot";
+        return false;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = QString("cannot open %1").arg(path);
+        return false;
+    }
+    if (file.write(m_data) != m_data.size()) {
+        if (error) *error = QString("cannot write %1").arg(path);
+        return false;
+    }
+    return true;
+}
+
+WorldSnapshot WorldSnapshot::load(const QString& path, QString* error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("cannot open %1").arg(path);
+        return WorldSnapshot();
+    }
+    return fromBytes(file.readAll(), error);
+}
+
+WorldSnapshot WorldSnapshot::fromBytes(const QByteArray& bytes, QString* error)
+{
+    auto fail = [error](const QString& message) {
+        if (error) *error = message;
+        return WorldSnapshot();
+    };
+
+    if (bytes.size() < static_cast<int>(sizeof(Header))) {
+        return fail("not a world snapshot");
+    }
+
+    Header header;
+    std::memcpy(&header, bytes.constData(), sizeof(Header));
+    const Header expected = makeHeader();
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        return fail("not a world snapshot");
+    }
+    if (header.version != kVersion || header.headerSize != sizeof(Header)) {
+        return fail(QString("unsupported snapshot version %1").arg(header.version));
+    }
+    // 记录按字节拷贝，数据结构布局不同（另一个版本或平台写的）就不能用
+    if (std::memcmp(header.dataSizes, expected.dataSizes, sizeof(header.dataSizes)) != 0) {
+        return fail("snapshot was written by an incompatible build");
+    }
+    for (int type = 0; type < kBallTypeCount; ++type) {
+        if (header.ballCounts[type] < 0) {
+            return fail("corrupt snapshot header");
+        }
+    }
+    if (header.linkCount < 0 || header.aiCount < 0 || header.aiBallCount < 0 || header.aiMemorySize < 0 ||
+        header.configSize < 0) {
+        return fail("corrupt snapshot header");
+    }
+
+    WorldSnapshot snapshot;
+    const int total = layout(header, snapshot.m_offsets);
+    if (total != bytes.size()) {
+        return fail(QString("snapshot size mismatch (%1 bytes, header says %2)").arg(bytes.size()).arg(total));
+    }
+    snapshot.m_data = bytes;
+    return snapshot;
+}
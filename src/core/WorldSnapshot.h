@@ -0,0 +1,111 @@
+#ifndef WORLDSNAPSHOT_H
+#define WORLDSNAPSHOT_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include "SimRandom.h"
+
+// 整个世界的快照：一块连续的缓冲区（GameManager::snapshot()生成，restore()/fork()读取）
+//
+// 缓冲区 = 头部 + 分身/食物/孢子/荆棘的纯数据记录 + 分裂关系 + AI控制器及其球和短期记忆 + 配置块
+// - 球的物理状态本来就是纯数据（core/data/*Data.h），按注册表顺序逐条拷贝，恢复时整条覆盖回去
+// - 分裂关系（CloneBall的父球/子球指针）和AI控制的球存成分身段里的下标
+// - 随机数只存种子和各条流的计数器，帧号、ID序列、刷新计数器都在头部
+// - AI控制器存(队伍, 玩家, 策略, 决策时钟, 随机数计数)和启发式的短期记忆（SimpleAIPlayer::saveMemory），
+//   记忆里指向球的部分存成球在前四段里的全局下标，fork出来的世界和原世界之后逐帧一致
+// 文件就是这块缓冲区原样写盘（本机字节序）；数据结构布局变了的旧文件在载入时被拒绝
+class WorldSnapshot
+{
+public:
+    static constexpr quint32 kVersion = 2;
+    static constexpr int kBallTypeCount = 4; // 与BaseBall::BallType一一对应
+
+    // 缓冲区里的各段，前四段与BaseBall::BallType顺序一致
+    enum Section {
+        Clones,
+        Foods,
+        Spores,
+        Thorns,
+        SplitLinks,  // 每个分身：父球下标(-1表示没有), 子球数, 子球下标...（qint32）
+        AIPlayers,   // AIRecord
+        AIBalls,     // 各AI控制的球在分身段里的下标（qint32，按AIRecord顺序首尾相接）
+        AIMemory,    // 各AI的短期记忆（ReplayFormat编码，按AIRecord顺序首尾相接，各占AIRecord::memorySize字节）
+        ConfigBlock, // ReplayFormat::writeConfig写的配置块
+        SectionCount
+    };
+
+    // 字段都显式对齐，没有隐式填充，整块写盘再读回来逐字节一致
+    struct Header {
+        char magic[4];
+        quint32 version;
+        quint32 headerSize;
+        quint32 dataSizes[kBallTypeCount]; // 各类球数据记录的大小
+        qint32 ballCounts[kBallTypeCount];
+        qint32 linkCount;                  // SplitLinks段的qint32个数
+        qint32 aiCount;
+        qint32 configSize;
+        qint32 aiBallCount;
+        qint32 aiMemorySize;               // AIMemory段的字节数
+        quint32 running;
+        quint32 reserved;
+
+        qint64 frameCount;
+        qint64 schedulerTicks;
+        qint32 nextBallId;
+        qint32 foodRefreshFrameCount;
+        qint32 thornsRefreshFrameCount;
+        qint32 foodCleanupIndex;
+        qint32 dataReorderCursor;
+        quint32 queryStamp;
+
+        quint64 seed;
+        quint64 streamCounters[SimRandom::StreamCount];
+    };
+
+    struct AIRecord {
+        qint32 teamId;
+        qint32 playerId;
+        qint32 strategy;          // SimpleAIPlayer::AIStrategy
+        qint32 decisionInterval;  // 毫秒
+        double decisionElapsedMs;
+        quint64 randomCounter;
+        quint32 active;
+        qint32 mainBall;          // 主控球在分身段里的下标，-1表示没有
+        qint32 ballCount;         // 在AIBalls段里占几个
+        qint32 memorySize;        // 在AIMemory段里占几个字节
+    };
+
+    WorldSnapshot() = default;
+    // 按头部里的计数分配整块缓冲区并写入头部，各段由调用方填
+    explicit WorldSnapshot(const Header& header);
+
+    bool isNull() const { return m_data.isEmpty(); }
+    Header header() const;
+    qint64 frameCount() const { return header().frameCount; }
+    quint64 seed() const { return header().seed; }
+    int ballCount() const;
+    int sizeInBytes() const { return static_cast<int>(m_data.size()); }
+    const QByteArray& bytes() const { return m_data; }
+
+    const char* section(Section section) const { return m_data.constData() + m_offsets[section]; }
+    char* section(Section section) { return m_data.data() + m_offsets[section]; }
+    int sectionSize(Section section) const { return m_offsets[section + 1] - m_offsets[section]; }
+
+    // 写盘/读盘；读入时校验魔数、版本、记录大小和总长度
+    bool save(const QString& path, QString* error = nullptr) const;
+    static WorldSnapshot load(const QString& path, QString* error = nullptr);
+    static WorldSnapshot fromBytes(const QByteArray& bytes, QString* error = nullptr);
+
+    // 头部的魔数/版本/记录大小（填好这几项的空头部，计数由调用方填）
+    static Header makeHeader();
+
+private:
+    QByteArray m_data;
+    int m_offsets[SectionCount + 1] = {};
+
+    // 由头部算出各段偏移，返回总长度
+    static int layout(const Header& header, int* offsets);
+};
+
+#endif // WORLDSNAPSHOT_H
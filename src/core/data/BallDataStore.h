@@ -0,0 +1,187 @@
+#ifndef BALLDATASTORE_H
+#define BALLDATASTORE_H
+
+#include <vector>
+#include <cstddef>
+#include "BaseBallData.h"
+#include "MortonOrder.h"
+#include "CloneBallData.h"
+#include "FoodBallData.h"
+#include "SporeBallData.h"
+#include "ThornsBallData.h"
+
+// 球数据存储的类型擦除接口，BaseBall只通过它归还/登记数据
+class BallDataStoreBase
+{
+public:
+    virtual ~BallDataStoreBase() = default;
+
+    // 登记持有者的数据指针地址，数据搬移时会自动改写 *ownerRef
+    virtual void bind(BaseBallData* data, BaseBallData** ownerRef) = 0;
+    virtual void release(BaseBallData* data) = 0;
+};
+
+// 连续存储：同类型的球数据放在一个std::vector里
+// 删除用swap-pop，扩容、交换或重排后通过ownerRef修正持有者手里的指针，
+// 所以任何代码都不能跨越"创建/删除球"或sortByMorton持有裸的BaseBallData指针
+template<typename T>
+class BallDataStore : public BallDataStoreBase
+{
+public:
+    T* acquire()
+    {
+        const bool grows = m_items.size() == m_items.capacity();
+        m_items.emplace_back();
+        m_ownerRefs.push_back(nullptr);
+        if (grows) {
+            patchAll();
+        }
+        return &m_items.back();
+    }
+
+    void bind(BaseBallData* data, BaseBallData** ownerRef) override
+    {
+        const size_t index = indexOf(data);
+        m_ownerRefs[index] = ownerRef;
+        *ownerRef = &m_items[index];
+    }
+
+    void release(BaseBallData* data) override
+    {
+        const size_t index = indexOf(data);
+        const size_t last = m_items.size() - 1;
+        if (index != last) {
+            m_items[index] = m_items[last];
+            m_ownerRefs[index] = m_ownerRefs[last];
+            patch(index);
+        }
+        m_items.pop_back();
+        m_ownerRefs.pop_back();
+    }
+
+    void reserve(size_t count)
+    {
+        if (count > m_items.capacity()) {
+            m_items.reserve(count);
+            m_ownerRefs.reserve(count);
+            patchAll();
+        }
+    }
+
+    // 按位置的Morton码重排（Z序），让空间上相邻的球在内存里也相邻；
+    // 已经有序时直接返回，否则整体搬移并修正所有持有者指针
+    void sortByMorton(float minx, float miny, float maxx, float maxy)
+    {
+        const size_t count = m_items.size();
+        if (count < 2) {
+            return;
+        }
+
+        m_sortKeys.resize(count);
+        m_sortOrder.resize(count);
+        bool sorted = true;
+        for (size_t i = 0; i < count; ++i) {
+            m_sortKeys[i] = MortonOrder::encode(m_items[i].x, m_items[i].y, minx, miny, maxx, maxy);
+            m_sortOrder[i] = static_cast<uint32_t>(i);
+            sorted = sorted && (i == 0 || m_sortKeys[i - 1] <= m_sortKeys[i]);
+        }
+        if (sorted) {
+            return;
+        }
+
+        MortonOrder::radixSort(m_sortKeys, m_sortOrder, m_sortTmpKeys, m_sortTmpOrder);
+
+        m_sortItems.clear();
+        m_sortOwnerRefs.clear();
+        m_sortItems.reserve(count);
+        m_sortOwnerRefs.reserve(count);
+        for (uint32_t index : m_sortOrder) {
+            m_sortItems.push_back(m_items[index]);
+            m_sortOwnerRefs.push_back(m_ownerRefs[index]);
+        }
+
+        // 交换而不是拷贝回去，旧缓冲区留给下一次排序复用
+        m_items.swap(m_sortItems);
+        m_ownerRefs.swap(m_sortOwnerRefs);
+        patchAll();
+    }
+
+    size_t size() const { return m_items.size(); }
+    T* data() { return m_items.data(); }
+    const T* data() const { return m_items.data(); }
+    T& operator[](size_t index) { return m_items[index]; }
+    const T& operator[](size_t index) const { return m_items[index]; }
+
+private:
+    std::vector<T> m_items;
+    std::vector<BaseBallData**> m_ownerRefs;
+
+    // 重排用的临时缓冲区，保留容量避免每次排序都分配
+    std::vector<uint32_t> m_sortKeys;
+    std::vector<uint32_t> m_sortOrder;
+    std::vector<uint32_t> m_sortTmpKeys;
+    std::vector<uint32_t> m_sortTmpOrder;
+    std::vector<T> m_sortItems;
+    std::vector<BaseBallData**> m_sortOwnerRefs;
+
+    size_t indexOf(const BaseBallData* data) const
+    {
+        return static_cast<size_t>(static_cast<const T*>(data) - m_items.data());
+    }
+
+    void patch(size_t index)
+    {
+        if (m_ownerRefs[index]) {
+            *m_ownerRefs[index] = &m_items[index];
+        }
+    }
+
+    void patchAll()
+    {
+        for (size_t i = 0; i < m_items.size(); ++i) {
+            patch(i);
+        }
+    }
+};
+
+// 没有共享存储时（例如单独创建的球），退化为逐个堆分配
+template<typename T>
+class HeapBallDataStore : public BallDataStoreBase
+{
+public:
+    static HeapBallDataStore* instance()
+    {
+        static HeapBallDataStore store;
+        return &store;
+    }
+
+    T* acquire() { return new T(); }
+    void bind(BaseBallData* data, BaseBallData** ownerRef) override { *ownerRef = data; }
+    void release(BaseBallData* data) override { delete static_cast<T*>(data); }
+};
+
+// 一个世界里所有球的数据，按类型分开连续存放
+struct BallDataStorage {
+    BallDataStore<CloneBallData> clones;
+    BallDataStore<FoodBallData> foods;
+    BallDataStore<SporeBallData> spores;
+    BallDataStore<ThornsBallData> thorns;
+};
+
+// 球构造时申请到的数据槽
+struct BallDataSlot {
+    BaseBallData* data;
+    BallDataStoreBase* store;
+};
+
+template<typename T>
+inline BallDataSlot acquireBallData(BallDataStore<T>* store)
+{
+    if (store) {
+        return { store->acquire(), store };
+    }
+    HeapBallDataStore<T>* heap = HeapBallDataStore<T>::instance();
+    return { heap->acquire(), heap };
+}
+
+#endif // BALLDATASTORE_H
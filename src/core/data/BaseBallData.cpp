@@ -0,0 +1,41 @@
+#include "BaseBallData.h"
+#include <cmath>
+
+float BaseBallData::distanceSquaredTo(const BaseBallData& other) const
+{
+    const float dx = x - other.x;
+    const float dy = y - other.y;
+    return dx * dx + dy * dy;
+}
+
+float BaseBallData::distanceTo(const BaseBallData& other) const
+{
+    return std::sqrt(distanceSquaredTo(other));
+}
+
+bool BaseBallData::clampToBorder(float minx, float maxx, float miny, float maxy)
+{
+    bool changed = false;
+
+    if (x - radius < minx) {
+        x = minx + radius;
+        vx = 0.0f;
+        changed = true;
+    } else if (x + radius > maxx) {
+        x = maxx - radius;
+        vx = 0.0f;
+        changed = true;
+    }
+
+    if (y - radius < miny) {
+        y = miny + radius;
+        vy = 0.0f;
+        changed = true;
+    } else if (y + radius > maxy) {
+        y = maxy - radius;
+        vy = 0.0f;
+        changed = true;
+    }
+
+    return changed;
+}
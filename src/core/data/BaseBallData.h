@@ -0,0 +1,51 @@
+#ifndef BASEBALLDATA_H
+#define BASEBALLDATA_H
+
+#include <cstdint>
+
+// 球的纯数据状态（不继承任何Qt类）
+// 所有物理状态都存放在这里，BaseBall及其子类只是持有指向它的指针，
+// QGraphicsObject那一层只负责渲染（见BaseBall::syncGraphics）
+struct BaseBallData {
+    int ballId = 0;
+    int type = 0;               // BaseBall::BallType
+
+    // 位置、速度、加速度
+    float x = 0.0f;
+    float y = 0.0f;
+    float vx = 0.0f;
+    float vy = 0.0f;
+    float ax = 0.0f;
+    float ay = 0.0f;
+
+    // 上一次碰撞检测时的位置，连续碰撞检测用它和当前位置构成本帧的扫掠路径
+    float sweepX = 0.0f;
+    float sweepY = 0.0f;
+
+    // 上一个逻辑帧结束时的位置，渲染时在它和当前位置之间插值
+    float prevX = 0.0f;
+    float prevY = 0.0f;
+
+    // 分数与半径
+    float score = 0.0f;
+    float radius = 0.0f;
+
+    // 归属（食物/荆棘为-1）
+    int teamId = -1;
+    int playerId = -1;
+
+    bool removed = false;
+    bool scoreDirty = false;    // 分数变了，半径和scoreChanged还没提交（帧末由BaseBall::commitScore处理）
+
+    // 碰撞检测的查询戳：等于当前轮次时表示本轮已作为主动方检测过
+    unsigned int queryStamp = 0;
+    int queryOrder = 0;         // 本轮在移动球列表中的序号（queryStamp有效时才有意义）
+
+    float distanceTo(const BaseBallData& other) const;
+    float distanceSquaredTo(const BaseBallData& other) const;
+
+    // 把圆限制在边界内，越界的方向速度清零；返回位置是否被修正
+    bool clampToBorder(float minx, float maxx, float miny, float maxy);
+};
+
+#endif // BASEBALLDATA_H
@@ -0,0 +1,25 @@
+#ifndef CLONEBALLDATA_H
+#define CLONEBALLDATA_H
+
+#include "BaseBallData.h"
+
+// 玩家球（分身球）数据
+struct CloneBallData : BaseBallData {
+    // 移动方向（玩家输入）
+    float moveDirX = 0.0f;
+    float moveDirY = 0.0f;
+
+    // 分裂速度及每帧衰减量
+    float splitVelX = 0.0f;
+    float splitVelY = 0.0f;
+    float splitVelPieceX = 0.0f;
+    float splitVelPieceY = 0.0f;
+
+    // 分裂状态
+    int splitFrame = 0;
+    int frameSinceLastSplit = 0;
+    bool fromSplit = false;
+    bool fromThorns = false;
+};
+
+#endif // CLONEBALLDATA_H
@@ -0,0 +1,11 @@
+#include "FoodBallData.h"
+
+int64_t FoodBallData::ageInFrames(int64_t currentFrame) const
+{
+    return currentFrame - createdFrame;
+}
+
+bool FoodBallData::isStaleAtFrame(int64_t currentFrame, int64_t maxAgeFrames) const
+{
+    return ageInFrames(currentFrame) > maxAgeFrames;
+}
@@ -0,0 +1,16 @@
+#ifndef FOODBALLDATA_H
+#define FOODBALLDATA_H
+
+#include "BaseBallData.h"
+
+// 食物球数据 - 数量最多（FOOD_COUNT_MAX），保持结构尽量小
+struct FoodBallData : BaseBallData {
+    int64_t createdTimeMs = 0;  // 创建时的墙钟时间戳
+    int64_t createdFrame = 0;   // 创建时的游戏帧
+    int colorIndex = 0;         // 固定颜色表索引
+
+    int64_t ageInFrames(int64_t currentFrame) const;
+    bool isStaleAtFrame(int64_t currentFrame, int64_t maxAgeFrames) const;
+};
+
+#endif // FOODBALLDATA_H
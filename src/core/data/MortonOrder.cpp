@@ -0,0 +1,74 @@
+#include "MortonOrder.h"
+#include <algorithm>
+
+namespace {
+    // 把16位整数的比特位隔位展开：abcd -> 0a0b0c0d
+    uint32_t spreadBits(uint32_t v)
+    {
+        v &= 0x0000ffff;
+        v = (v | (v << 8)) & 0x00ff00ff;
+        v = (v | (v << 4)) & 0x0f0f0f0f;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    }
+
+    uint32_t quantize(float value, float minValue, float maxValue)
+    {
+        const float extent = maxValue - minValue;
+        if (extent <= 0.0f) {
+            return 0;
+        }
+        const float t = std::clamp((value - minValue) / extent, 0.0f, 1.0f);
+        return static_cast<uint32_t>(t * 65535.0f);
+    }
+}
+
+namespace MortonOrder {
+
+uint32_t encode(float x, float y, float minx, float miny, float maxx, float maxy)
+{
+    return spreadBits(quantize(x, minx, maxx)) | (spreadBits(quantize(y, miny, maxy)) << 1);
+}
+
+void radixSort(std::vector<uint32_t>& keys, std::vector<uint32_t>& order,
+               std::vector<uint32_t>& tmpKeys, std::vector<uint32_t>& tmpOrder)
+{
+    const size_t n = keys.size();
+    if (n < 2) {
+        return;
+    }
+
+    tmpKeys.resize(n);
+    tmpOrder.resize(n);
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        size_t counts[256] = {};
+        for (size_t i = 0; i < n; ++i) {
+            counts[(keys[i] >> shift) & 0xff]++;
+        }
+
+        // 这一趟所有键都落在同一个桶里，排序结果不变
+        if (counts[(keys[0] >> shift) & 0xff] == n) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (size_t& count : counts) {
+            const size_t bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            const size_t dest = counts[(keys[i] >> shift) & 0xff]++;
+            tmpKeys[dest] = keys[i];
+            tmpOrder[dest] = order[i];
+        }
+
+        keys.swap(tmpKeys);
+        order.swap(tmpOrder);
+    }
+}
+
+} // namespace MortonOrder
@@ -0,0 +1,21 @@
+#ifndef MORTONORDER_H
+#define MORTONORDER_H
+
+#include <cstdint>
+#include <vector>
+
+// Z序（Morton码）工具：把二维位置映射成一维键，键相邻的点在空间上也大致相邻。
+// BallDataStore按它重排数据，让空间上相邻的球在内存里也相邻
+namespace MortonOrder {
+
+// 位置先按世界边界量化到16位网格，再交错x/y的比特位；越界坐标夹到边缘
+uint32_t encode(float x, float y, float minx, float miny, float maxx, float maxy);
+
+// 按keys对order做稳定的LSD基数排序（每趟8位，全部落在同一个桶的趟次跳过）
+// tmpKeys/tmpOrder是调用方复用的临时缓冲区，排序后keys/order为有序结果
+void radixSort(std::vector<uint32_t>& keys, std::vector<uint32_t>& order,
+               std::vector<uint32_t>& tmpKeys, std::vector<uint32_t>& tmpOrder);
+
+} // namespace MortonOrder
+
+#endif // MORTONORDER_H
@@ -0,0 +1,23 @@
+#ifndef SPOREBALLDATA_H
+#define SPOREBALLDATA_H
+
+#include "BaseBallData.h"
+
+// 孢子球数据
+struct SporeBallData : BaseBallData {
+    // 喷射方向与初速度
+    float dirX = 0.0f;
+    float dirY = 0.0f;
+    float initialVelocity = 0.0f;
+
+    // 每帧减少的喷射速度
+    float velPieceX = 0.0f;
+    float velPieceY = 0.0f;
+
+    int moveFrame = 0;              // 移动帧计数
+    int velocityZeroFrame = 0;      // 速度衰减到0的帧数
+    int remainingLifetime = 0;
+    int framesSinceCreation = 0;    // 创建后经过的帧数
+};
+
+#endif // SPOREBALLDATA_H
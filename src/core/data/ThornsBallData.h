@@ -0,0 +1,14 @@
+#ifndef THORNSBALLDATA_H
+#define THORNSBALLDATA_H
+
+#include "BaseBallData.h"
+
+// 荆棘球数据（吃孢子后的滑行状态）
+struct ThornsBallData : BaseBallData {
+    bool isMoving = false;
+    float moveVx = 0.0f;
+    float moveVy = 0.0f;
+    int moveFramesLeft = 0;
+};
+
+#endif // THORNSBALLDATA_H
@@ -0,0 +1,799 @@
+// gobigger-bench：无头性能基准
+// 1. 微基准：QuadTree插入/查询/重建、BaseBall::collidesWith、GameManager::checkCollisionsBetween、AI决策
+// 2. 端到端场景：固定负载下跑若干逻辑帧，统计帧率和p50/p99帧耗时
+// 结果输出为JSON；--baseline给出之前保存的结果时逐项对比，超出阈值的退化让进程以1退出
+// 场景没有产生它要测的负载（比如thorns_splits一个球都没分裂、带AI的场景一次决策都没做）时以2退出
+//
+// 用法：
+//   gobigger-bench --out result.json
+//   gobigger-bench --baseline result.json --threshold 10
+//   gobigger-bench --filter food4000 --ticks 1200
+//   gobigger-bench --replay match.gbr --out replay.json   （重放 --record-replay 录下的一局）
+//   gobigger-bench --batch 64 --ticks 600                 （BatchEngine：64个环境随机动作，按批计时）
+//   gobigger-bench --check-fork 600                        （带AI的世界fork后和原世界各跑600帧，快照必须逐字节一致；
+//                                                           快照里没有AI或AI没做过决策时以2退出）
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QVector2D>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+
+#include "GameManager.h"
+#include "QuadTree.h"
+#include "CloneBall.h"
+#include "FoodBall.h"
+#include "ThornsBall.h"
+#include "SimpleAIPlayer.h"
+#include "core/BatchEngine.h"
+#include "core/InputReplay.h"
+
+namespace {
+
+QTextStream& err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// 基准运行时关掉qDebug刷屏，警告和错误照常输出
+bool g_verbose = false;
+void benchMessageHandler(QtMsgType type, const QMessageLogContext&, const QString& message)
+{
+    if (type == QtDebugMsg && !g_verbose) {
+        return;
+    }
+    err() << message << Qt::endl;
+}
+
+double percentile(QVector<double> samples, double p)
+{
+    if (samples.isEmpty()) {
+        return 0.0;
+    }
+    const int count = static_cast<int>(samples.size());
+    const int index = qBound(0, static_cast<int>(std::ceil(p * count)) - 1, count - 1);
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+// 与GameEngine一致的6000x6000地图，手动驱动、无场景
+GameManager::Config benchConfig(int foodCount, int thornsCount)
+{
+    GameManager::Config config;
+    config.manualTick = true;
+    config.gameBorder = Border(-3000, 3000, -3000, 3000);
+    config.initFoodCount = foodCount;
+    config.maxFoodCount = foodCount;
+    config.initThornsCount = thornsCount;
+    config.maxThornsCount = thornsCount;
+    config.seed = 20240601; // 固定种子：每次跑的都是同一局，结果才能和基线比较
+    return config;
+}
+
+std::unique_ptr<GameManager> makeWorld(int foodCount, int thornsCount)
+{
+    auto world = std::make_unique<GameManager>(nullptr, benchConfig(foodCount, thornsCount));
+    world->startGame();
+    return world;
+}
+
+// ============ 微基准 ============
+
+struct MicroResult {
+    QString name;
+    qint64 ops = 0;
+    double nsPerOp = 0.0; // 所有轮次的平均
+    double p50Ns = 0.0;   // 按轮次统计的每次操作耗时
+    double p99Ns = 0.0;
+};
+
+// 跑rounds轮：每轮先调用setup()（不计时），再计时调用body()，body返回这一轮做了多少次操作
+MicroResult runMicro(const QString& name, int rounds, const std::function<void()>& setup,
+                     const std::function<qint64()>& body)
+{
+    MicroResult result;
+    result.name = name;
+
+    QVector<double> perOp;
+    perOp.reserve(rounds);
+    qint64 totalNs = 0;
+    for (int round = 0; round < rounds; ++round) {
+        if (setup) {
+            setup();
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        const qint64 ops = body();
+        const qint64 ns = timer.nsecsElapsed();
+
+        if (ops > 0) {
+            perOp.append(static_cast<double>(ns) / ops);
+            result.ops += ops;
+            totalNs += ns;
+        }
+    }
+
+    result.nsPerOp = result.ops > 0 ? static_cast<double>(totalNs) / result.ops : 0.0;
+    result.p50Ns = percentile(perOp, 0.50);
+    result.p99Ns = percentile(perOp, 0.99);
+    return result;
+}
+
+// 世界里所有AI累计做过的决策次数
+quint64 totalDecisions(const GameManager* world)
+{
+    quint64 decisions = 0;
+    for (const GoBigger::AI::SimpleAIPlayer* ai : world->getAIPlayers()) {
+        decisions += ai->decisionCount();
+    }
+    return decisions;
+}
+
+QVector<MicroResult> runMicroBenchmarks(int rounds, const QString& filter, bool* invalid)
+{
+    QVector<MicroResult> results;
+    auto wanted = [&filter](const QString& name) { return filter.isEmpty() || name.contains(filter); };
+
+    // 共用一个4000食物的世界作为球的来源
+    std::unique_ptr<GameManager> world = makeWorld(4000, 12);
+    const QVector<BaseBall*> foods = [&world]() {
+        QVector<BaseBall*> balls;
+        for (FoodBall* food : world->registry().foods()) {
+            balls.append(food);
+        }
+        return balls;
+    }();
+    const Border& border = world->config().gameBorder;
+    const QRectF bounds(border.minx, border.miny, border.maxx - border.minx, border.maxy - border.miny);
+
+    // 固定种子的查询矩形，每次运行一样
+    QRandomGenerator rng(20240601);
+    QVector<QRectF> queryRects;
+    for (int i = 0; i < 1024; ++i) {
+        const qreal size = 100.0 + rng.bounded(500.0);
+        queryRects.append(QRectF(border.minx + rng.bounded(bounds.width() - size),
+                                 border.miny + rng.bounded(bounds.height() - size), size, size));
+    }
+
+    std::unique_ptr<QuadTree> tree;
+    if (wanted("quadtree.insert")) {
+        results.append(runMicro("quadtree.insert", rounds,
+            [&]() { tree = std::make_unique<QuadTree>(bounds); },
+            [&]() -> qint64 {
+                for (BaseBall* ball : foods) {
+                    tree->insert(ball);
+                }
+                return foods.size();
+            }));
+    }
+
+    tree = std::make_unique<QuadTree>(bounds);
+    tree->rebuild(foods);
+    if (wanted("quadtree.query")) {
+        qint64 visited = 0;
+        results.append(runMicro("quadtree.query", rounds, nullptr,
+            [&]() -> qint64 {
+                for (const QRectF& rect : queryRects) {
+                    tree->forEachInRange(rect, [&visited](BaseBall*) { ++visited; });
+                }
+                return queryRects.size();
+            }));
+    }
+
+    if (wanted("quadtree.rebuild")) {
+        results.append(runMicro("quadtree.rebuild", rounds, nullptr,
+            [&]() -> qint64 {
+                tree->rebuild(foods);
+                return 1;
+            }));
+    }
+
+    if (wanted("ball.collidesWith")) {
+        int hits = 0;
+        results.append(runMicro("ball.collidesWith", rounds, nullptr,
+            [&]() -> qint64 {
+                qint64 ops = 0;
+                for (int i = 0; i + 1 < foods.size(); i += 2) {
+                    hits += foods[i]->collidesWith(foods[i + 1]) ? 1 : 0;
+                    ++ops;
+                }
+                return ops;
+            }));
+    }
+
+    // 一个大玩家球逐个吃掉身边的食物；每轮重新搭一个小世界（不计时）
+    if (wanted("game.checkCollisionsBetween")) {
+        std::unique_ptr<GameManager> arena;
+        CloneBall* eater = nullptr;
+        QVector<BaseBall*> targets;
+        results.append(runMicro("game.checkCollisionsBetween", rounds,
+            [&]() {
+                arena = makeWorld(512, 0);
+                eater = arena->createPlayer(0, 0, QPointF(0, 0));
+                eater->setScore(50000);
+                targets.clear();
+                for (FoodBall* food : arena->registry().foods()) {
+                    targets.append(food);
+                }
+                for (int i = 0; i < targets.size(); ++i) {
+                    // 全部挪进玩家球里，每一对都会真正走到吞噬（这一轮不再tick，空间索引不用同步）
+                    const qreal angle = i * 0.618 * 2.0 * M_PI;
+                    const qreal distance = eater->radius() * 0.5 * (i % 16) / 16.0;
+                    targets[i]->setPosition(QPointF(std::cos(angle) * distance, std::sin(angle) * distance));
+                }
+            },
+            [&]() -> qint64 {
+                for (BaseBall* target : targets) {
+                    arena->checkCollisionsBetween(eater, target);
+                }
+                return targets.size();
+            }));
+    }
+
+    // AI决策：每种策略一个AI，直接推进一个决策间隔触发一次makeDecision
+    const struct { const char* name; GoBigger::AI::AIStrategy strategy; } strategies[] = {
+        { "ai.decision.food_hunter", GoBigger::AI::AIStrategy::FOOD_HUNTER },
+        { "ai.decision.aggressive", GoBigger::AI::AIStrategy::AGGRESSIVE },
+        { "ai.decision.random", GoBigger::AI::AIStrategy::RANDOM },
+    };
+    for (int i = 0; i < static_cast<int>(std::size(strategies)); ++i) {
+        if (!wanted(strategies[i].name)) continue;
+
+        if (!world->addAIPlayerWithStrategy(10 + i, 0, strategies[i].strategy)) continue;
+        GoBigger::AI::SimpleAIPlayer* ai = world->getAIPlayers().last();
+        ai->startAI();
+        const quint64 decisionsBefore = ai->decisionCount();
+        results.append(runMicro(strategies[i].name, rounds, nullptr,
+            [ai]() -> qint64 {
+                static constexpr int DECISIONS_PER_ROUND = 64;
+                for (int n = 0; n < DECISIONS_PER_ROUND; ++n) {
+                    ai->advanceDecisionClock(ai->getDecisionInterval());
+                }
+                return DECISIONS_PER_ROUND;
+            }));
+        if (ai->decisionCount() == decisionsBefore) {
+            err() << strategies[i].name << ": the AI made no decision, the result does not measure AI work" << Qt::endl;
+            *invalid = true;
+        }
+        ai->stopAI();
+    }
+
+    return results;
+}
+
+// ============ 端到端场景 ============
+
+struct Scenario {
+    QString name;
+    int foodCount = 4000;
+    int thornsCount = 12;
+    int aiCount = 0;          // AI玩家（食物猎手/攻击/随机轮流），每个一支队伍；计时期间一次决策都没有说明AI没在工作
+    int drivenPlayers = 0;    // 由基准自己驱动的玩家
+    float drivenScore = 0.0f;
+    bool expectSplits = false; // 场景的负载就是分裂：一个分裂球都没有说明没测到想测的东西
+    // 每帧tick前对受驱动的玩家施加输入
+    std::function<void(GameManager*, const QVector<int>&)> drive;
+};
+
+struct ScenarioResult {
+    QString name;
+    int ticks = 0;
+    double ticksPerSec = 0.0;
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    int clones = 0;
+    int foods = 0;
+    int spores = 0;
+    int thorns = 0;
+    int splitBalls = 0;       // 计时期间分裂（含荆棘分裂）出的新球总数
+    int peakClones = 0;       // 计时期间分身球数的峰值
+    qint64 aiDecisions = 0;   // 计时期间所有AI做的决策总数
+};
+
+// 所有受驱动玩家的分身球都朝最近的荆棘冲；吃到荆棘的球在帧末炸成最多16个小球，合并回去后再冲
+void driveTowardThorns(GameManager* world, const QVector<int>& teams)
+{
+    for (int team : teams) {
+        for (CloneBall* ball : world->getPlayerBalls(team, 0)) {
+            if (ball->isRemoved()) continue;
+
+            const QPointF position = ball->position();
+            QPointF target = position;
+            qreal best = std::numeric_limits<qreal>::max();
+            for (ThornsBall* thorns : world->registry().thorns()) {
+                const QPointF delta = thorns->position() - position;
+                const qreal distance = delta.x() * delta.x() + delta.y() * delta.y();
+                if (distance < best) {
+                    best = distance;
+                    target = thorns->position();
+                }
+            }
+
+            QVector2D direction(target - position);
+            direction = direction.length() > 0.01f ? direction.normalized() : QVector2D(1, 0);
+            ball->applyGoBiggerMovement(direction, QVector2D(0, 0));
+            ball->setMoveDirection(direction);
+        }
+    }
+}
+
+// 所有受驱动玩家的分身球每帧都尽量喷孢子，方向轮换
+void driveSporeStorm(GameManager* world, const QVector<int>& teams)
+{
+    const qint64 frame = world->frameCount();
+    for (int team : teams) {
+        const QVector<CloneBall*> balls = world->getPlayerBalls(team, 0);
+        for (CloneBall* ball : balls) {
+            if (ball->isRemoved() || !ball->canEject()) continue;
+
+            const qreal angle = (frame * 7 + ball->ballId() * 13) % 360 * M_PI / 180.0;
+            const QVector2D direction(std::cos(angle), std::sin(angle));
+            ball->setMoveDirection(direction);
+            ball->ejectSpore(direction);
+        }
+    }
+}
+
+QVector<Scenario> canonicalScenarios()
+{
+    QVector<Scenario> scenarios;
+    for (int aiCount : { 8, 32, 128 }) {
+        Scenario scenario;
+        scenario.name = QString("food4000_ai%1").arg(aiCount);
+        scenario.aiCount = aiCount;
+        scenarios.append(scenario);
+    }
+
+    Scenario sporeStorm;
+    sporeStorm.name = "spore_storm";
+    sporeStorm.drivenPlayers = 32;
+    sporeStorm.drivenScore = 20000.0f;
+    sporeStorm.drive = driveSporeStorm;
+    scenarios.append(sporeStorm);
+
+    Scenario thornsSplits;
+    thornsSplits.name = "thorns_splits";
+    thornsSplits.thornsCount = 200;
+    thornsSplits.drivenPlayers = 32;
+    thornsSplits.drivenScore = 30000.0f;
+    thornsSplits.expectSplits = true;
+    thornsSplits.drive = driveTowardThorns;
+    scenarios.append(thornsSplits);
+
+    return scenarios;
+}
+
+ScenarioResult makeResult(const QString& name, const QVector<double>& tickMs, qint64 totalNs, GameManager* world)
+{
+    ScenarioResult result;
+    result.name = name;
+    result.ticks = static_cast<int>(tickMs.size());
+    result.ticksPerSec = totalNs > 0 ? tickMs.size() * 1e9 / totalNs : 0.0;
+    result.p50Ms = percentile(tickMs, 0.50);
+    result.p99Ms = percentile(tickMs, 0.99);
+    result.maxMs = tickMs.isEmpty() ? 0.0 : *std::max_element(tickMs.begin(), tickMs.end());
+    result.clones = world->registry().count(BaseBall::CLONE_BALL);
+    result.foods = world->registry().count(BaseBall::FOOD_BALL);
+    result.spores = world->registry().count(BaseBall::SPORE_BALL);
+    result.thorns = world->registry().count(BaseBall::THORNS_BALL);
+    return result;
+}
+
+ScenarioResult runScenario(const Scenario& scenario, int warmupTicks, int measuredTicks)
+{
+    std::unique_ptr<GameManager> world = makeWorld(scenario.foodCount, scenario.thornsCount);
+
+    static const GoBigger::AI::AIStrategy kStrategies[] = {
+        GoBigger::AI::AIStrategy::FOOD_HUNTER,
+        GoBigger::AI::AIStrategy::AGGRESSIVE,
+        GoBigger::AI::AIStrategy::RANDOM,
+    };
+    for (int i = 0; i < scenario.aiCount; ++i) {
+        world->addAIPlayerWithStrategy(1 + i, 0, kStrategies[i % 3]);
+    }
+    world->startAllAI();
+
+    // 受驱动的玩家用AI之后的队伍号
+    QVector<int> drivenTeams;
+    for (int i = 0; i < scenario.drivenPlayers; ++i) {
+        const int team = 1 + scenario.aiCount + i;
+        CloneBall* player = world->createPlayer(team, 0);
+        player->setScore(scenario.drivenScore);
+        drivenTeams.append(team);
+    }
+
+    bool measuring = false;
+    int splitBalls = 0;
+    int peakClones = 0;
+    QObject::connect(world.get(), &GameManager::tickEvents, [&](const QVector<GameEvent>& events) {
+        if (!measuring) return;
+        for (const GameEvent& event : events) {
+            if (event.type == GameEvent::SPLIT) {
+                splitBalls++;
+            }
+        }
+    });
+
+    QVector<double> tickMs;
+    tickMs.reserve(measuredTicks);
+    qint64 totalNs = 0;
+    quint64 decisionsBefore = 0;
+    for (int tick = 0; tick < warmupTicks + measuredTicks; ++tick) {
+        if (tick == warmupTicks) {
+            decisionsBefore = totalDecisions(world.get());
+        }
+        if (scenario.drive) {
+            scenario.drive(world.get(), drivenTeams);
+        }
+        measuring = tick >= warmupTicks;
+
+        QElapsedTimer timer;
+        timer.start();
+        world->tick();
+        const qint64 ns = timer.nsecsElapsed();
+
+        if (measuring) {
+            tickMs.append(ns / 1e6);
+            totalNs += ns;
+            peakClones = qMax(peakClones, world->registry().count(BaseBall::CLONE_BALL));
+        }
+    }
+
+    ScenarioResult result = makeResult(scenario.name, tickMs, totalNs, world.get());
+    result.splitBalls = splitBalls;
+    result.peakClones = peakClones;
+    result.aiDecisions = static_cast<qint64>(totalDecisions(world.get()) - decisionsBefore);
+    return result;
+}
+
+// 全速重放一段输入录像，每一帧都计时；录像里的整局都算在内，不分预热
+ScenarioResult runReplay(const InputReplay& replay, const QString& name)
+{
+    std::unique_ptr<GameManager> world = std::make_unique<GameManager>(nullptr, replay.config());
+
+    QVector<double> tickMs;
+    tickMs.reserve(static_cast<int>(qMin<qint64>(replay.tickCount(), 1 << 20)));
+    qint64 totalNs = 0;
+    replay.play(world.get(), [&](GameManager* w) {
+        QElapsedTimer timer;
+        timer.start();
+        w->tick();
+        const qint64 ns = timer.nsecsElapsed();
+        tickMs.append(ns / 1e6);
+        totalNs += ns;
+    });
+
+    return makeResult(name, tickMs, totalNs, world.get());
+}
+
+// 32个AI的世界预热后fork一份，两份同步推进ticks帧，每帧比较快照
+// 返回进程退出码：0一致；1不一致；2快照里没有AI或AI一次决策都没做（比较不到AI状态，检查无效）
+int checkFork(int warmupTicks, int ticks)
+{
+    std::unique_ptr<GameManager> world = makeWorld(4000, 12);
+    static const GoBigger::AI::AIStrategy kStrategies[] = {
+        GoBigger::AI::AIStrategy::FOOD_HUNTER,
+        GoBigger::AI::AIStrategy::AGGRESSIVE,
+        GoBigger::AI::AIStrategy::RANDOM,
+    };
+    for (int i = 0; i < 32; ++i) {
+        world->addAIPlayerWithStrategy(1 + i, 0, kStrategies[i % 3]);
+    }
+    world->startAllAI();
+    for (int tick = 0; tick < warmupTicks; ++tick) {
+        world->tick();
+    }
+
+    const WorldSnapshot snapshot = world->snapshot();
+    if (snapshot.header().aiCount == 0) {
+        err() << "no AI player in the snapshot, the check does not cover AI state" << Qt::endl;
+        return 2;
+    }
+
+    std::unique_ptr<GameManager> fork = world->fork();
+    if (!fork || fork->snapshot().bytes() != snapshot.bytes()) {
+        err() << "fork differs from its parent right after forking at frame " << world->frameCount() << Qt::endl;
+        return 1;
+    }
+    for (int tick = 0; tick < ticks; ++tick) {
+        world->tick();
+        fork->tick();
+        if (fork->snapshot().bytes() != world->snapshot().bytes()) {
+            err() << "fork diverged from its parent at frame " << world->frameCount() << Qt::endl;
+            return 1;
+        }
+    }
+
+    // fork的AI是新对象，决策计数从0开始；两边都要真的决策过，AI记忆才算被比较到
+    if (totalDecisions(world.get()) == 0 || totalDecisions(fork.get()) == 0) {
+        err() << "no AI decision ran after forking, the check does not cover AI state" << Qt::endl;
+        return 2;
+    }
+    if (world->snapshot().header().aiCount == 0) {
+        err() << "all AI players died before the end, the check does not cover AI state" << Qt::endl;
+        return 2;
+    }
+    err() << "fork and parent identical for " << ticks << " ticks with "
+          << snapshot.header().aiCount << " AI players" << Qt::endl;
+    return 0;
+}
+
+// 多环境批量推进：每次step一批随机动作，帧耗时按整批计；场景里的球数取第0个环境
+ScenarioResult runBatch(int envCount, int warmupTicks, int measuredTicks)
+{
+    BatchEngine::Config config;
+    config.envCount = envCount;
+    config.engineConfig.gameConfig.seed = 1;
+    BatchEngine batch(config);
+
+    QRandomGenerator random(1);
+    std::vector<float> actions(static_cast<size_t>(batch.envCount()) * batch.playersPerEnv() * BatchEngine::kActionSize);
+    QVector<double> tickMs;
+    tickMs.reserve(measuredTicks);
+    qint64 totalNs = 0;
+    for (int tick = 0; tick < warmupTicks + measuredTicks; ++tick) {
+        for (size_t i = 0; i < actions.size(); i += BatchEngine::kActionSize) {
+            actions[i] = static_cast<float>(random.generateDouble() * 2.0 - 1.0);
+            actions[i + 1] = static_cast<float>(random.generateDouble() * 2.0 - 1.0);
+            actions[i + 2] = static_cast<float>(random.bounded(8) == 0 ? random.bounded(1, 3) : 0);
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        batch.step(actions.data());
+        const qint64 ns = timer.nsecsElapsed();
+
+        if (tick >= warmupTicks) {
+            tickMs.append(ns / 1e6);
+            totalNs += ns;
+        }
+    }
+
+    return makeResult(QString("batch:%1envs").arg(batch.envCount()), tickMs, totalNs, batch.engine(0)->gameManager());
+}
+
+// ============ 结果与对比 ============
+
+QJsonObject toJson(const QVector<MicroResult>& micro, const QVector<ScenarioResult>& scenarios)
+{
+    QJsonArray microArray;
+    for (const MicroResult& r : micro) {
+        microArray.append(QJsonObject{
+            { "name", r.name }, { "ops", r.ops }, { "nsPerOp", r.nsPerOp },
+            { "p50Ns", r.p50Ns }, { "p99Ns", r.p99Ns } });
+    }
+
+    QJsonArray scenarioArray;
+    for (const ScenarioResult& r : scenarios) {
+        scenarioArray.append(QJsonObject{
+            { "name", r.name }, { "ticks", r.ticks }, { "ticksPerSec", r.ticksPerSec },
+            { "p50Ms", r.p50Ms }, { "p99Ms", r.p99Ms }, { "maxMs", r.maxMs },
+            { "entities", QJsonObject{ { "clones", r.clones }, { "foods", r.foods },
+                                       { "spores", r.spores }, { "thorns", r.thorns },
+                                       { "peakClones", r.peakClones }, { "splitBalls", r.splitBalls },
+                                       { "aiDecisions", r.aiDecisions } } } });
+    }
+
+    return QJsonObject{
+        { "suite", "gobigger-bench" },
+        { "version", 1 },
+        { "micro", microArray },
+        { "scenarios", scenarioArray } };
+}
+
+// 一项指标与基准线比较；higherIsBetter为false时数值越小越好。返回是否退化
+bool compareMetric(const QString& name, const QString& metric, double baseline, double current,
+                   bool higherIsBetter, double thresholdPercent)
+{
+    if (baseline <= 0.0) {
+        return false;
+    }
+
+    const double change = (current - baseline) / baseline * 100.0;
+    const double worse = higherIsBetter ? -change : change;
+    const bool regressed = worse > thresholdPercent;
+    err() << QString("%1 %2 %3 -> %4 (%5%6%)%7")
+                 .arg(name, -32).arg(metric, -12)
+                 .arg(baseline, 12, 'f', 3).arg(current, 12, 'f', 3)
+                 .arg(change >= 0 ? QString("+") : QString()).arg(change, 0, 'f', 1)
+                 .arg(regressed ? QString("  <-- REGRESSION") : QString())
+          << Qt::endl;
+    return regressed;
+}
+
+// 返回退化项数；只比较两边都有的条目
+int compareWithBaseline(const QJsonObject& baseline, const QJsonObject& current, double thresholdPercent)
+{
+    auto byName = [](const QJsonArray& array) {
+        QHash<QString, QJsonObject> map;
+        for (const QJsonValue& value : array) {
+            map.insert(value.toObject().value("name").toString(), value.toObject());
+        }
+        return map;
+    };
+
+    int regressions = 0;
+    const auto baseMicro = byName(baseline.value("micro").toArray());
+    for (const QJsonValue& value : current.value("micro").toArray()) {
+        const QJsonObject now = value.toObject();
+        const QString name = now.value("name").toString();
+        if (!baseMicro.contains(name)) continue;
+        regressions += compareMetric(name, "ns/op", baseMicro[name].value("nsPerOp").toDouble(),
+                                     now.value("nsPerOp").toDouble(), false, thresholdPercent);
+    }
+
+    const auto baseScenarios = byName(baseline.value("scenarios").toArray());
+    for (const QJsonValue& value : current.value("scenarios").toArray()) {
+        const QJsonObject now = value.toObject();
+        const QString name = now.value("name").toString();
+        if (!baseScenarios.contains(name)) continue;
+        const QJsonObject& base = baseScenarios[name];
+        regressions += compareMetric(name, "ticks/s", base.value("ticksPerSec").toDouble(),
+                                     now.value("ticksPerSec").toDouble(), true, thresholdPercent);
+        regressions += compareMetric(name, "p99 ms", base.value("p99Ms").toDouble(),
+                                     now.value("p99Ms").toDouble(), false, thresholdPercent);
+    }
+    return regressions;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // 球是QGraphicsObject，需要QApplication；没有显示器时用offscreen平台
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    app.setApplicationName("gobigger-bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless micro and end-to-end benchmarks for the simulation.");
+    parser.addHelpOption();
+    QCommandLineOption outOption("out", "Write results as JSON to <file> (default: stdout).", "file");
+    QCommandLineOption baselineOption("baseline", "Compare against a saved result <file>; exit 1 on regression.", "file");
+    QCommandLineOption thresholdOption("threshold", "Regression threshold in percent (default 10).", "percent", "10");
+    QCommandLineOption filterOption("filter", "Only run benchmarks whose name contains <text>.", "text");
+    QCommandLineOption ticksOption("ticks", "Measured ticks per scenario (default 600).", "n", "600");
+    QCommandLineOption warmupOption("warmup", "Warm-up ticks per scenario (default 120).", "n", "120");
+    QCommandLineOption roundsOption("rounds", "Rounds per microbenchmark (default 50).", "n", "50");
+    QCommandLineOption microOnlyOption("micro-only", "Skip end-to-end scenarios.");
+    QCommandLineOption scenariosOnlyOption("scenarios-only", "Skip microbenchmarks.");
+    QCommandLineOption verboseOption("verbose", "Keep qDebug output from the game code.");
+    QCommandLineOption replayOption("replay", "Replay a recorded match <file> at full speed instead of the built-in benchmarks.", "file");
+    QCommandLineOption batchOption("batch", "Step <n> environments through BatchEngine instead of the built-in benchmarks.", "n");
+    QCommandLineOption checkForkOption("check-fork", "Fork a world with AI players and check that fork and parent stay identical for <n> ticks.", "n");
+    parser.addOptions({ outOption, baselineOption, thresholdOption, filterOption, ticksOption, warmupOption,
+                        roundsOption, microOnlyOption, scenariosOnlyOption, verboseOption, replayOption, batchOption,
+                        checkForkOption });
+    parser.process(app);
+
+    g_verbose = parser.isSet(verboseOption);
+    qInstallMessageHandler(benchMessageHandler);
+
+    const QString filter = parser.value(filterOption);
+    const int measuredTicks = qMax(1, parser.value(ticksOption).toInt());
+    const int warmupTicks = qMax(0, parser.value(warmupOption).toInt());
+    const int rounds = qMax(1, parser.value(roundsOption).toInt());
+
+    // --check-fork：只做一致性检查，不出基准结果
+    if (parser.isSet(checkForkOption)) {
+        return checkFork(warmupTicks, qMax(1, parser.value(checkForkOption).toInt()));
+    }
+
+    // --replay：只跑录像，结果作为名为"replay:<文件名>"的场景输出，同样可以和基准线对比
+    QVector<MicroResult> micro;
+    QVector<ScenarioResult> scenarios;
+    if (parser.isSet(replayOption)) {
+        InputReplay replay;
+        QString error;
+        if (!replay.open(parser.value(replayOption), &error)) {
+            err() << "Cannot load replay: " << error << Qt::endl;
+            return 2;
+        }
+
+        const QString name = "replay:" + QFileInfo(parser.value(replayOption)).completeBaseName();
+        const ScenarioResult r = runReplay(replay, name);
+        scenarios.append(r);
+        err() << QString("%1 %2 ticks/s (p50 %3 ms, p99 %4 ms, max %5 ms) seed %6, %7 ticks, %8 actions")
+                     .arg(r.name, -32).arg(r.ticksPerSec, 12, 'f', 1)
+                     .arg(r.p50Ms, 0, 'f', 3).arg(r.p99Ms, 0, 'f', 3).arg(r.maxMs, 0, 'f', 3)
+                     .arg(replay.seed()).arg(r.ticks).arg(replay.actionCount())
+              << Qt::endl;
+    }
+
+    // --batch：结果名为"batch:<环境数>envs"，ticks/s是每秒的批次数
+    if (parser.isSet(batchOption)) {
+        const int envCount = qMax(1, parser.value(batchOption).toInt());
+        const ScenarioResult r = runBatch(envCount, warmupTicks, measuredTicks);
+        scenarios.append(r);
+        err() << QString("%1 %2 ticks/s (p50 %3 ms, p99 %4 ms, max %5 ms) %6 env-frames/s")
+                     .arg(r.name, -32).arg(r.ticksPerSec, 12, 'f', 1)
+                     .arg(r.p50Ms, 0, 'f', 3).arg(r.p99Ms, 0, 'f', 3).arg(r.maxMs, 0, 'f', 3)
+                     .arg(r.ticksPerSec * envCount, 0, 'f', 0)
+              << Qt::endl;
+    }
+
+    const bool builtIn = !parser.isSet(replayOption) && !parser.isSet(batchOption);
+    // 场景没有产生它要测的负载时结果不可信，照常输出但以2退出
+    bool invalidScenario = false;
+    if (!parser.isSet(scenariosOnlyOption) && builtIn) {
+        micro = runMicroBenchmarks(rounds, filter, &invalidScenario);
+        for (const MicroResult& r : micro) {
+            err() << QString("%1 %2 ns/op (p50 %3, p99 %4)")
+                         .arg(r.name, -32).arg(r.nsPerOp, 12, 'f', 1).arg(r.p50Ns, 0, 'f', 1).arg(r.p99Ns, 0, 'f', 1)
+                  << Qt::endl;
+        }
+    }
+
+    if (!parser.isSet(microOnlyOption) && builtIn) {
+        for (const Scenario& scenario : canonicalScenarios()) {
+            if (!filter.isEmpty() && !scenario.name.contains(filter)) continue;
+
+            const ScenarioResult r = runScenario(scenario, warmupTicks, measuredTicks);
+            scenarios.append(r);
+            err() << QString("%1 %2 ticks/s (p50 %3 ms, p99 %4 ms, max %5 ms) clones %6 (peak %7, %8 split) spores %9 decisions %10")
+                         .arg(r.name, -32).arg(r.ticksPerSec, 12, 'f', 1)
+                         .arg(r.p50Ms, 0, 'f', 3).arg(r.p99Ms, 0, 'f', 3).arg(r.maxMs, 0, 'f', 3)
+                         .arg(r.clones).arg(r.peakClones).arg(r.splitBalls).arg(r.spores).arg(r.aiDecisions)
+                  << Qt::endl;
+            if (scenario.expectSplits && r.splitBalls == 0) {
+                err() << r.name << ": no balls split while measuring, the result does not measure splits" << Qt::endl;
+                invalidScenario = true;
+            }
+            if (scenario.aiCount > 0 && r.aiDecisions == 0) {
+                err() << r.name << ": no AI decision ran while measuring, the result does not measure AI work" << Qt::endl;
+                invalidScenario = true;
+            }
+        }
+    }
+
+    const QJsonObject results = toJson(micro, scenarios);
+    const QByteArray json = QJsonDocument(results).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outOption)) {
+        QFile file(parser.value(outOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err() << "Cannot write " << file.fileName() << Qt::endl;
+            return 2;
+        }
+        file.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+
+    if (parser.isSet(baselineOption)) {
+        QFile file(parser.value(baselineOption));
+        if (!file.open(QIODevice::ReadOnly)) {
+            err() << "Cannot read baseline " << file.fileName() << Qt::endl;
+            return 2;
+        }
+
+        const QJsonObject baseline = QJsonDocument::fromJson(file.readAll()).object();
+        err() << Qt::endl << "Comparison with " << file.fileName()
+              << " (threshold " << parser.value(thresholdOption) << "%):" << Qt::endl;
+        const int regressions = compareWithBaseline(baseline, results, parser.value(thresholdOption).toDouble());
+        err() << regressions << " regression(s)" << Qt::endl;
+        if (invalidScenario) {
+            return 2;
+        }
+        return regressions > 0 ? 1 : 0;
+    }
+
+    return invalidScenario ? 2 : 0;
+}
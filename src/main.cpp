@@ -6,11 +6,15 @@
 #include <QLabel>
 #include <QTimer>
 #include <QMessageBox>
+#include <QCommandLineParser>
+#include <QDateTime>
 #include <QDebug>
 #include "GameView.h"
 #include "GameManager.h"
 #include "CloneBall.h"
 #include "GameStartScreen.h"
+#include "core/Trace.h"
+#include "core/ChromeTrace.h"
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -20,6 +24,9 @@ public:
         setupUI();
     }
     
+    // --record-replay <文件>：每一局的输入录到这个文件（新开一局会覆盖）
+    void setReplayRecordingPath(const QString& path) { m_replayRecordingPath = path; }
+    
 private slots:
     void onStartGameRequested(const GameConfig& config) {
         // 隐藏启动界面
@@ -38,6 +45,14 @@ private slots:
         // 应用游戏配置
         applyGameConfig(config);
         
+        // 启动界面勾选了录制时间线：这一局录到带时间戳的文件里（命令行已经在录时沿用命令行的文件）
+        if (config.recordChromeTrace && !ChromeTrace::isRecording()) {
+            const QString path = QString("gobigger_timeline_%1.json")
+                                     .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+            m_recordingFromLauncher = ChromeTrace::start(path);
+            qDebug() << (m_recordingFromLauncher ? "Recording timeline to" : "Failed to open timeline file") << path;
+        }
+        
         // 显示主窗口
         show();
         raise();
@@ -59,6 +74,24 @@ private slots:
             m_gameView->pauseGame();
         }
         
+        // 启动界面开的时间线录制随这一局结束
+        if (m_recordingFromLauncher) {
+            m_recordingFromLauncher = false;
+            const QString path = ChromeTrace::outputPath();
+            if (ChromeTrace::stop()) {
+                qDebug() << "Timeline saved to" << path;
+            }
+        }
+        
+        // 输入录像随这一局结束
+        if (m_gameView && m_gameView->getGameManager()) {
+            GameManager* world = m_gameView->getGameManager();
+            const QString path = world->inputRecorder().outputPath();
+            if (world->stopInputRecording()) {
+                qDebug() << "Input replay saved to" << path;
+            }
+        }
+        
         // 隐藏主窗口
         hide();
         
@@ -202,6 +235,16 @@ private:
     void applyGameConfig(const GameConfig& config) {
         if (!m_gameView) return;
         
+        // 输入录像要从空世界开始：先清空世界再开录，接下来的重置和创建玩家都会录进去
+        if (!m_replayRecordingPath.isEmpty() && m_gameView->getGameManager()) {
+            GameManager* world = m_gameView->getGameManager();
+            world->stopInputRecording();
+            world->resetGame();
+            if (!world->startInputRecording(m_replayRecordingPath)) {
+                qWarning() << "Failed to start input replay recording" << m_replayRecordingPath;
+            }
+        }
+        
         // 重置游戏
         m_gameView->resetGame();
         
@@ -236,16 +279,31 @@ private:
             break;
         }
         
-        // 应用时间限制
-        if (config.gameTimeLimit > 0) {
-            QTimer::singleShot(config.gameTimeLimit * 1000, [this, config]() {
-                if (m_gameView && m_gameView->isGameRunning()) {
+        // 应用模拟速度
+        if (config.simulationSpeed <= 0) {
+            m_gameView->setTurboMode(true, config.turboRenderInterval);
+        } else {
+            m_gameView->setTurboMode(false);
+            m_gameView->setSimulationSpeed(config.simulationSpeed);
+        }
+        
+        // 应用时间限制（按游戏帧数计，倍速和加速模式下同样准确）
+        QObject::disconnect(m_timeLimitConnection);
+        if (config.gameTimeLimit > 0 && gameManager) {
+            const qint64 limitFrames = gameManager->msToTicks(config.gameTimeLimit * 1000);
+            m_timeLimitConnection = connect(gameManager->scheduler(), &TickScheduler::ticked, this,
+                [this, gameManager, limitFrames, config](qint64) {
+                    if (gameManager->frameCount() < limitFrames) return;
+                    
+                    QObject::disconnect(m_timeLimitConnection);
                     m_gameView->pauseGame();
-                    QMessageBox::information(this, "游戏结束", 
-                        QString("时间到！游戏结束。\n时间限制：%1秒").arg(config.gameTimeLimit));
-                }
-            });
-            qDebug() << "Set game time limit to" << config.gameTimeLimit << "seconds";
+                    // 不在帧回调里弹模态对话框
+                    QTimer::singleShot(0, this, [this, config]() {
+                        QMessageBox::information(this, "游戏结束", 
+                            QString("时间到！游戏结束。\n时间限制：%1秒").arg(config.gameTimeLimit));
+                    });
+                });
+            qDebug() << "Set game time limit to" << config.gameTimeLimit << "seconds (" << limitFrames << "frames)";
         }
     }
     
@@ -352,7 +410,7 @@ private:
                 // 为BOSS设置更高的初始分数
                 CloneBall* bossPlayer = gameManager->getPlayer(bossTeamId, bossPlayerIdCounter - 1);
                 if (bossPlayer) {
-                    bossPlayer->setScore(config.bossInitialScore);
+                    gameManager->setPlayerScore(bossPlayer, config.bossInitialScore);
                     qDebug() << "Set BOSS initial score to" << config.bossInitialScore;
                 }
             }
@@ -370,7 +428,7 @@ private:
                 // 为BOSS设置更高的初始分数
                 CloneBall* bossPlayer = gameManager->getPlayer(bossTeamId, bossPlayerIdCounter - 1);
                 if (bossPlayer) {
-                    bossPlayer->setScore(config.bossInitialScore);
+                    gameManager->setPlayerScore(bossPlayer, config.bossInitialScore);
                     qDebug() << "Set BOSS initial score to" << config.bossInitialScore;
                 }
             }
@@ -448,6 +506,9 @@ private:
     GameView* m_gameView = nullptr;
     QLabel* m_statusLabel = nullptr;
     QTimer* m_statusTimer = nullptr;
+    QMetaObject::Connection m_timeLimitConnection;
+    bool m_recordingFromLauncher = false;
+    QString m_replayRecordingPath;
 };
 
 #include "main.moc"
@@ -461,8 +522,29 @@ int main(int argc, char *argv[])
     app.setApplicationVersion("2.0");
     app.setOrganizationName("AI Development Team");
     
+    // 追踪的运行期级别，例如 GOBIGGER_TRACE=collision=4,eat=3（编译期级别见CMakeLists.txt）
+    Trace::configure(qEnvironmentVariable("GOBIGGER_TRACE"));
+    
+    // --chrome-trace <文件>：整个会话录成Chrome时间线，退出时写完
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption chromeTraceOption("chrome-trace", "Record a Trace Event Format timeline to <file>.", "file");
+    parser.addOption(chromeTraceOption);
+    // --record-replay <文件>：录下每一局的输入，之后可以用 gobigger-bench --replay 无头重放
+    QCommandLineOption recordReplayOption("record-replay", "Record match input to <file> for headless replay.", "file");
+    parser.addOption(recordReplayOption);
+    parser.process(app);
+    if (parser.isSet(chromeTraceOption)) {
+        const QString path = parser.value(chromeTraceOption);
+        if (!ChromeTrace::start(path)) {
+            qWarning() << "Failed to open timeline file" << path;
+        }
+    }
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, []() { ChromeTrace::stop(); });
+    
     // 创建并显示主窗口（它会自动显示启动界面）
     MainWindow mainWindow;
+    mainWindow.setReplayRecordingPath(parser.value(recordReplayOption));
     
     return app.exec();
 }
\ No newline at end of file